@@ -22,6 +22,7 @@ class TtLazyConan(ConanFile):
         "enable_asan": [True, False],
         "enable_ubsan": [True, False],
         "enable_clang_tidy": [True, False],
+        "with_blas": [True, False],
     }
     default_options = {
         "shared": False,
@@ -29,6 +30,7 @@ class TtLazyConan(ConanFile):
         "enable_asan": False,
         "enable_ubsan": False,
         "enable_clang_tidy": False,
+        "with_blas": False,
     }
 
     # Sources are located in the same place as this recipe, copy them to the recipe
@@ -60,6 +62,8 @@ class TtLazyConan(ConanFile):
         tc.cache_variables["ENABLE_ASAN"] = self.options.enable_asan
         tc.cache_variables["ENABLE_UBSAN"] = self.options.enable_ubsan
         tc.cache_variables["ENABLE_CLANG_TIDY"] = self.options.enable_clang_tidy
+        # Links whichever system BLAS is installed (not a Conan package), so builds stay offline
+        tc.cache_variables["TT_LAZY_BLAS"] = self.options.with_blas
 
         # Set defaults based on build type
         if self.settings.build_type == "Debug":
@@ -0,0 +1,80 @@
+#pragma once
+#include "gemm.hpp"
+#include "small_gemm.hpp"
+
+#include <cstddef>
+
+namespace math {
+namespace aot {
+
+// Kernels called by ahead-of-time generated code (see src/tape/CodeGenerator.hpp). Every
+// shape is a template parameter, so each call site compiles to fixed trip counts and leading
+// dimensions, and the elementwise loops are unrolled and vectorized for that size. Operands
+// are contiguous row-major buffers; outputs of elementwise kernels may alias an input.
+
+// c[M x N] = op(a) * op(b) (+ bias[N]) (ReLU). Tiny untransposed products are unrolled for
+// their shape (small_gemm.hpp) and single rows stream b through gemv.
+template <size_t M, size_t N, size_t K, bool TRANSPOSE_A, bool TRANSPOSE_B, bool RELU>
+inline void matmul(const float* a, const float* b, const float* bias, float* c) {
+    constexpr size_t LDA = TRANSPOSE_A ? M : K;
+    constexpr size_t LDB = TRANSPOSE_B ? K : N;
+    if constexpr (!TRANSPOSE_A && !TRANSPOSE_B && M <= SMALL_GEMM_MAX_M && N <= SMALL_GEMM_MAX_N &&
+                  K <= SMALL_GEMM_MAX_K) {
+        small_gemm<M, N, K>(a, b, bias, RELU, c);
+    } else if constexpr (M == 1) {
+        gemv(N, K, a, b, LDB, TRANSPOSE_B, c, bias, RELU);
+    } else {
+        gemm(M, N, K, a, LDA, TRANSPOSE_A, b, LDB, TRANSPOSE_B, c, N, bias, RELU);
+    }
+}
+
+template <size_t N>
+inline void relu(const float* x, float* y) {
+    for (size_t i = 0; i < N; ++i) {
+        y[i] = x[i] > 0.0f ? x[i] : 0.0f;
+    }
+}
+
+template <size_t N>
+inline void add(const float* a, const float* b, float* y) {
+    for (size_t i = 0; i < N; ++i) {
+        y[i] = a[i] + b[i];
+    }
+}
+
+// y[ROWS x COLS] = a[ROWS x COLS] + row[COLS] on every row
+template <size_t ROWS, size_t COLS>
+inline void add_row(const float* a, const float* row, float* y) {
+    for (size_t r = 0; r < ROWS; ++r) {
+        for (size_t c = 0; c < COLS; ++c) {
+            y[r * COLS + c] = a[r * COLS + c] + row[c];
+        }
+    }
+}
+
+template <size_t N>
+inline void multiply(const float* a, const float* b, float* y) {
+    for (size_t i = 0; i < N; ++i) {
+        y[i] = a[i] * b[i];
+    }
+}
+
+// Sums x viewed as [OUTER, REDUCED, INNER] over its middle dimension into y[OUTER x INNER]
+template <size_t OUTER, size_t REDUCED, size_t INNER>
+inline void reduce_sum(const float* x, float* y) {
+    for (size_t o = 0; o < OUTER; ++o) {
+        float* out = y + o * INNER;
+        for (size_t i = 0; i < INNER; ++i) {
+            out[i] = 0.0f;
+        }
+        for (size_t r = 0; r < REDUCED; ++r) {
+            const float* in = x + (o * REDUCED + r) * INNER;
+            for (size_t i = 0; i < INNER; ++i) {
+                out[i] += in[i];
+            }
+        }
+    }
+}
+
+}  // namespace aot
+}  // namespace math
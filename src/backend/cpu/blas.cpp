@@ -0,0 +1,117 @@
+#include "blas.hpp"
+
+#include <stdexcept>
+
+#ifdef TT_LAZY_HAVE_BLAS
+#include <cblas.h>
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+// Thread-count controls of the common BLAS libraries; weak, so whichever one is linked is found
+extern "C" void openblas_set_num_threads(int threads) __attribute__((weak));
+extern "C" void bli_thread_set_num_threads(long threads) __attribute__((weak));  // NOLINT(google-runtime-int)
+#endif
+
+namespace math {
+
+#ifdef TT_LAZY_HAVE_BLAS
+
+namespace {
+
+// BLAS calls are made from the executor's thread, never from inside parallel_for, so the two
+// pools take turns; sizing BLAS's pool like ours (the process's thread budget, or
+// $TT_LAZY_BLAS_THREADS) keeps it from oversubscribing the cores the rest of the tape uses.
+// The budget is checked on every call: it changes in the forked workers of a sharded runtime,
+// which inherit the parent's BLAS setting.
+void configure_threads() {
+    static const int fixed = [] {
+        const char* env = std::getenv("TT_LAZY_BLAS_THREADS");  // NOLINT(concurrency-mt-unsafe)
+        return env != nullptr ? std::max(1, std::atoi(env)) : 0;
+    }();
+    static std::atomic<int> configured{0};
+    static std::mutex mutex;
+
+    int threads = fixed > 0 ? fixed : static_cast<int>(thread_budget());
+    if (configured.load(std::memory_order_acquire) == threads) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (openblas_set_num_threads != nullptr) {
+        openblas_set_num_threads(threads);
+    }
+    if (bli_thread_set_num_threads != nullptr) {
+        bli_thread_set_num_threads(threads);
+    }
+    configured.store(threads, std::memory_order_release);
+}
+
+int blas_int(size_t value) {
+    return static_cast<int>(value);
+}
+
+}  // namespace
+
+bool blas_available() {
+    return true;
+}
+
+const char* blas_name() {
+    if (openblas_set_num_threads != nullptr) {
+        return "OpenBLAS";
+    }
+    return bli_thread_set_num_threads != nullptr ? "BLIS" : "BLAS";
+}
+
+void blas_sgemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b,
+                size_t ldb, bool transpose_b, float* c, size_t ldc) {
+    configure_threads();
+    cblas_sgemm(CblasRowMajor, transpose_a ? CblasTrans : CblasNoTrans, transpose_b ? CblasTrans : CblasNoTrans,
+                blas_int(m), blas_int(n), blas_int(k), 1.0f, a, blas_int(lda), b, blas_int(ldb), 0.0f, c,
+                blas_int(ldc));
+}
+
+void blas_sgemv(size_t n, size_t k, const float* x, const float* b, size_t ldb, bool transpose_b, float* y) {
+    configure_threads();
+    // y = op(b)^T x: b is [k x n] (or [n x k] when transposed) in row-major order
+    if (transpose_b) {
+        cblas_sgemv(CblasRowMajor, CblasNoTrans, blas_int(n), blas_int(k), 1.0f, b, blas_int(ldb), x, 1, 0.0f, y, 1);
+    } else {
+        cblas_sgemv(CblasRowMajor, CblasTrans, blas_int(k), blas_int(n), 1.0f, b, blas_int(ldb), x, 1, 0.0f, y, 1);
+    }
+}
+
+#else
+
+namespace {
+
+[[noreturn]] void unavailable() {
+    throw std::runtime_error("tt_math_lib was built without BLAS (configure with -DTT_LAZY_BLAS=ON)");
+}
+
+}  // namespace
+
+bool blas_available() {
+    return false;
+}
+
+const char* blas_name() {
+    return "none";
+}
+
+void blas_sgemm(size_t, size_t, size_t, const float*, size_t, bool, const float*, size_t, bool, float*, size_t) {
+    unavailable();
+}
+
+void blas_sgemv(size_t, size_t, const float*, const float*, size_t, bool, float*) {
+    unavailable();
+}
+
+#endif
+
+}  // namespace math
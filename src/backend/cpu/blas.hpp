@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+
+namespace math {
+
+// External BLAS (OpenBLAS, BLIS, ...), linked when tt_math_lib is built with TT_LAZY_BLAS and
+// one is found. The wrappers take row-major float32 operands like gemm() / gemv() in
+// gemm.hpp and throw std::runtime_error in builds without BLAS.
+bool blas_available();
+const char* blas_name();  // e.g. "OpenBLAS", or "none"
+
+// c[m x n] = op(a) * op(b) through cblas_sgemm
+void blas_sgemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b,
+                size_t ldb, bool transpose_b, float* c, size_t ldc);
+
+// y[n] = x[k] * op(b) through cblas_sgemv
+void blas_sgemv(size_t n, size_t k, const float* x, const float* b, size_t ldb, bool transpose_b, float* y);
+
+}  // namespace math
@@ -0,0 +1,217 @@
+#include "Tensor.hpp"
+#include "gemm.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace math {
+
+namespace {
+
+// Output pixels per work item: a few packed left blocks of the GEMM, so the weights packed
+// for an item are reused across them
+constexpr size_t PIXELS_PER_ITEM = 4 * GemmBlocking{}.mc;
+
+// Smallest number of multiply-adds worth handing to another thread
+constexpr size_t MIN_FLOPS_PER_THREAD = size_t{1} << 18U;
+
+struct ConvGeometry {
+    size_t batch = 0;
+    size_t channels = 0;
+    size_t height = 0;
+    size_t width = 0;
+    size_t out_channels = 0;
+    size_t kernel_h = 0;
+    size_t kernel_w = 0;
+    size_t out_h = 0;
+    size_t out_w = 0;
+    size_t group_channels = 0;      // Input channels per group
+    size_t group_out_channels = 0;  // Output channels per group
+};
+
+// One step of the GEMM depth: an input channel at a kernel offset
+struct Tap {
+    size_t channel_offset;  // Offset of the channel within an image
+    int64_t dy;
+    int64_t dx;
+    size_t weight_offset;  // Offset within one output channel's [C/groups, KH, KW] weights
+};
+
+ConvGeometry conv_geometry(const Tensor& input, const Tensor& weight, const Tensor& bias,
+                           const Conv2dParams& params) {
+    if (input.rank() != 4 || weight.rank() != 4) {
+        throw std::runtime_error("Conv2D requires a 4-D input and [C_out, C_in / groups, KH, KW] weights");
+    }
+    if (params.stride_h == 0 || params.stride_w == 0 || params.dilation_h == 0 || params.dilation_w == 0 ||
+        params.groups == 0) {
+        throw std::runtime_error("Conv2D: stride, dilation and groups must be positive");
+    }
+
+    ConvGeometry g;
+    g.batch = input.size(0);
+    g.channels = params.channels_last ? input.size(3) : input.size(1);
+    g.height = params.channels_last ? input.size(1) : input.size(2);
+    g.width = params.channels_last ? input.size(2) : input.size(3);
+    g.out_channels = weight.size(0);
+    g.kernel_h = weight.size(2);
+    g.kernel_w = weight.size(3);
+    if (g.channels % params.groups != 0 || g.out_channels % params.groups != 0) {
+        throw std::runtime_error("Conv2D: " + std::to_string(params.groups) + " groups do not divide " +
+                                 std::to_string(g.channels) + " input and " + std::to_string(g.out_channels) +
+                                 " output channels");
+    }
+    g.group_channels = g.channels / params.groups;
+    g.group_out_channels = g.out_channels / params.groups;
+    if (weight.size(1) != g.group_channels) {
+        throw std::runtime_error("Conv2D: weights expect " + std::to_string(weight.size(1) * params.groups) +
+                                 " input channels, got " + std::to_string(g.channels));
+    }
+    if (bias && bias.total_elements() != g.out_channels) {
+        throw std::runtime_error("Conv2D: bias has " + std::to_string(bias.total_elements()) + " values for " +
+                                 std::to_string(g.out_channels) + " output channels");
+    }
+
+    size_t span_h = params.dilation_h * (g.kernel_h - 1) + 1;
+    size_t span_w = params.dilation_w * (g.kernel_w - 1) + 1;
+    size_t padded_h = g.height + 2 * params.pad_h;
+    size_t padded_w = g.width + 2 * params.pad_w;
+    if (g.kernel_h == 0 || g.kernel_w == 0 || padded_h < span_h || padded_w < span_w) {
+        throw std::runtime_error("Conv2D: kernel does not fit the padded input");
+    }
+    g.out_h = (padded_h - span_h) / params.stride_h + 1;
+    g.out_w = (padded_w - span_w) / params.stride_w + 1;
+    return g;
+}
+
+std::vector<uint32_t> conv_output_shape(const ConvGeometry& g, const Conv2dParams& params) {
+    auto dims = [](size_t value) { return static_cast<uint32_t>(value); };
+    if (params.channels_last) {
+        return {dims(g.batch), dims(g.out_h), dims(g.out_w), dims(g.out_channels)};
+    }
+    return {dims(g.batch), dims(g.out_channels), dims(g.out_h), dims(g.out_w)};
+}
+
+}  // namespace
+
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias, const Conv2dParams& params) {
+    Tensor result(conv_output_shape(conv_geometry(input, weight, bias, params), params));
+    conv2d(input, weight, bias, result, params);
+    return result;
+}
+
+void conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias, Tensor& out, const Conv2dParams& params) {
+    ConvGeometry g = conv_geometry(input, weight, bias, params);
+    check_output(out, conv_output_shape(g, params), "Conv2D");
+
+    // Element strides of the input; NHWC walks the depth channel-fastest so consecutive
+    // depths read consecutive floats
+    size_t channel_stride = params.channels_last ? 1 : g.height * g.width;
+    size_t row_stride = params.channels_last ? g.width * g.channels : g.width;
+    size_t column_stride = params.channels_last ? g.channels : 1;
+    size_t image_size = g.channels * g.height * g.width;
+    size_t kernel_area = g.kernel_h * g.kernel_w;
+
+    size_t depth = g.group_channels * kernel_area;
+    std::vector<Tap> taps;
+    taps.reserve(depth);
+    for (size_t p = 0; p < depth; ++p) {
+        size_t c = params.channels_last ? p % g.group_channels : p / kernel_area;
+        size_t tap = params.channels_last ? p / g.group_channels : p % kernel_area;
+        size_t kh = tap / g.kernel_w;
+        size_t kw = tap % g.kernel_w;
+        taps.push_back({c * channel_stride, static_cast<int64_t>(kh * params.dilation_h),
+                        static_cast<int64_t>(kw * params.dilation_w), c * kernel_area + kh * g.kernel_w + kw});
+    }
+
+    const float* input_data = input.const_data_ptr();
+    const float* weight_data = weight.const_data_ptr();
+    const float* bias_data = bias ? bias.const_data_ptr() : nullptr;
+    float* output_data = out.data_ptr();
+
+    size_t pixels = g.out_h * g.out_w;
+    size_t blocks = (pixels + PIXELS_PER_ITEM - 1) / PIXELS_PER_ITEM;
+    size_t items = g.batch * params.groups * blocks;
+    size_t flops_per_item = std::min(pixels, PIXELS_PER_ITEM) * g.group_out_channels * depth;
+    size_t grain = std::max<size_t>(1, MIN_FLOPS_PER_THREAD / std::max<size_t>(1, flops_per_item));
+
+    parallel_for(items, grain, [&](size_t begin, size_t end) {
+        for (size_t item = begin; item < end; ++item) {
+            size_t image = item / (params.groups * blocks);
+            size_t group = item / blocks % params.groups;
+            size_t first_pixel = item % blocks * PIXELS_PER_ITEM;
+            size_t count = std::min(PIXELS_PER_ITEM, pixels - first_pixel);
+
+            // Implicit im2col: the left operand row of an output pixel is synthesized while
+            // packing, with zeros where the kernel hangs over the padding
+            const float* group_input =
+                input_data + image * image_size + group * g.group_channels * channel_stride;
+            PackLhs pack_lhs = [&](size_t row, size_t rows, size_t depth_begin, size_t depths, float* dst) noexcept {
+                for (size_t r0 = 0; r0 < rows; r0 += GEMM_MR) {
+                    int64_t base_y[GEMM_MR];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+                    int64_t base_x[GEMM_MR];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+                    for (size_t i = 0; i < GEMM_MR; ++i) {
+                        size_t pixel = first_pixel + row + r0 + i;
+                        bool valid = r0 + i < rows;
+                        // Rows past the end are pushed out of the image so they pack as zeros
+                        base_y[i] = valid ? static_cast<int64_t>(pixel / g.out_w * params.stride_h) -
+                                                static_cast<int64_t>(params.pad_h)
+                                          : -static_cast<int64_t>(g.height) - taps.back().dy - 1;
+                        base_x[i] = valid ? static_cast<int64_t>(pixel % g.out_w * params.stride_w) -
+                                                static_cast<int64_t>(params.pad_w)
+                                          : 0;
+                    }
+                    for (size_t p = 0; p < depths; ++p) {
+                        const Tap& tap = taps[depth_begin + p];
+                        const float* channel = group_input + tap.channel_offset;
+                        for (size_t i = 0; i < GEMM_MR; ++i) {
+                            int64_t y = base_y[i] + tap.dy;
+                            int64_t x = base_x[i] + tap.dx;
+                            bool inside = y >= 0 && y < static_cast<int64_t>(g.height) && x >= 0 &&
+                                          x < static_cast<int64_t>(g.width);
+                            dst[i] = inside ? channel[static_cast<size_t>(y) * row_stride +
+                                                      static_cast<size_t>(x) * column_stride]
+                                            : 0.0f;
+                        }
+                        dst += GEMM_MR;
+                    }
+                }
+            };
+
+            // Right operand: the group's weights, read as [depth, C_out / groups]
+            const float* group_weights = weight_data + group * g.group_out_channels * depth;
+            PackRhs pack_rhs = [&](size_t depth_begin, size_t depths, size_t col, size_t cols, float* dst) noexcept {
+                for (size_t c0 = 0; c0 < cols; c0 += GEMM_NR) {
+                    size_t panel_cols = std::min(GEMM_NR, cols - c0);
+                    for (size_t p = 0; p < depths; ++p) {
+                        size_t offset = taps[depth_begin + p].weight_offset;
+                        for (size_t j = 0; j < GEMM_NR; ++j) {
+                            dst[j] = j < panel_cols ? group_weights[(col + c0 + j) * depth + offset] : 0.0f;
+                        }
+                        dst += GEMM_NR;
+                    }
+                }
+            };
+
+            GemmOutput output;
+            size_t first_channel = group * g.group_out_channels;
+            if (params.channels_last) {
+                output.data = output_data + (image * pixels + first_pixel) * g.out_channels + first_channel;
+                output.row_stride = static_cast<std::ptrdiff_t>(g.out_channels);
+                output.col_stride = 1;
+            } else {
+                output.data = output_data + (image * g.out_channels + first_channel) * pixels + first_pixel;
+                output.row_stride = 1;
+                output.col_stride = static_cast<std::ptrdiff_t>(pixels);
+            }
+            output.bias = bias_data ? bias_data + first_channel : nullptr;
+            output.relu = params.relu;
+            gemm_packed(count, g.group_out_channels, depth, pack_lhs, pack_rhs, output);
+        }
+    });
+}
+
+}  // namespace math
@@ -1,113 +1,156 @@
 #include "Tensor.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
 
 #include <algorithm>
 #include <stdexcept>
+#include <string>
 
 namespace math {
 
 Tensor relu(const Tensor& input) {
-    std::vector<uint32_t> shape(
-        input.shape(),
-        input.shape() +
-            input
-                .rank());  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with known bounds
-    Tensor result(shape);
+    Tensor result(input.dims());
+    relu(input, result);
+    return result;
+}
+
+void relu(const Tensor& input, Tensor& out) {
+    check_output(out, input.dims(), "ReLU");
 
     // Apply ReLU element-wise: max(0, x)
     const float* input_data = input.const_data_ptr();
-    float* result_data = result.data_ptr();
+    float* result_data = out.data_ptr();
     for (size_t i = 0; i < input.total_elements(); ++i) {
         result_data[i] = std::max(
             0.0f,
             input_data
                 [i]);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with bounds checking
     }
+}
 
+Tensor relu_backward(const Tensor& grad, const Tensor& output) {
+    Tensor result(output.dims());
+    relu_backward(grad, output, result);
     return result;
 }
 
-Tensor add(const Tensor& a, const Tensor& b) {
-    // Check if shapes can be broadcast
-    std::vector<uint32_t> a_shape(
-        a.shape(),
-        a.shape() +
-            a.rank());  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with known bounds
-    std::vector<uint32_t> b_shape(
-        b.shape(),
-        b.shape() +
-            b.rank());  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with known bounds
-
-    if (!Tensor::can_broadcast(a_shape, b_shape)) {
-        throw std::runtime_error("Cannot broadcast shapes for addition");
+void relu_backward(const Tensor& grad, const Tensor& output, Tensor& out) {
+    if (grad.dims() != output.dims()) {
+        throw std::runtime_error("ReLUBackward: gradient and forward output shapes differ");
     }
+    check_output(out, output.dims(), "ReLUBackward");
+
+    // Elementwise, so `out` may be the gradient's own buffer
+    const float* grad_data = grad.const_data_ptr();
+    const float* output_data = output.const_data_ptr();
+    float* result_data = out.data_ptr();
+    for (size_t i = 0; i < output.total_elements(); ++i) {
+        result_data[i] = output_data[i] > 0.0f ? grad_data[i] : 0.0f;
+    }
+}
 
-    auto output_shape = Tensor::broadcast_shapes(a_shape, b_shape);
-    Tensor result(output_shape);
+namespace {
 
-    // Perform element-wise addition
+// Output shape of a broadcasting elementwise operation
+Shape broadcast_output(const Tensor& a, const Tensor& b, const char* what) {
+    try {
+        return Shape::broadcast(a.dims(), b.dims());
+    } catch (const std::runtime_error&) {
+        throw std::runtime_error(std::string("Cannot broadcast shapes for ") + what);
+    }
+}
+
+// Strides of `operand` over the dimensions of `shape`, which it broadcasts into: its own
+// contiguous strides along the dimensions it has, 0 along the ones it repeats
+SmallVector<size_t, Shape::INLINE_RANK> broadcast_strides(const Shape& operand, const Shape& shape) {
+    SmallVector<size_t, Shape::INLINE_RANK> strides(shape.rank(), 0);
+    size_t offset = shape.rank() - operand.rank();
+    for (size_t i = 0; i < operand.rank(); ++i) {
+        if (operand[i] != 1) {
+            strides[offset + i] = operand.stride(i);
+        }
+    }
+    return strides;
+}
+
+// out = op(a, b) elementwise, broadcasting a and b to the shape of `out`. Same shapes are a flat
+// loop; otherwise each innermost row is a loop over the operands' strides along the last dimension
+// and an index over the outer dimensions moves the operand offsets between rows.
+template <typename Op>
+void broadcast_apply(const Tensor& a, const Tensor& b, Tensor& out, const Shape& shape, Op op) {
     const float* a_data = a.const_data_ptr();
     const float* b_data = b.const_data_ptr();
-    float* result_data = result.data_ptr();
-
-    if (a_shape == b_shape) {
-        // Same shapes - simple element-wise addition
-        for (size_t i = 0; i < a.total_elements(); ++i) {
-            result_data[i] =
-                a_data[i] +
-                b_data
-                    [i];  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with bounds checking
+    float* result_data = out.data_ptr();
+    if (a.dims() == b.dims()) {
+        for (size_t i = 0; i < shape.numel(); ++i) {
+            result_data[i] = op(a_data[i], b_data[i]);
         }
-    } else {
-        // Basic broadcasting support for bias addition (e.g., [N, M] + [1, M])
-        if (a_shape.size() == 2 && b_shape.size() == 2 && b_shape[0] == 1 && a_shape[1] == b_shape[1]) {
-            // Broadcasting [N, M] + [1, M] -> [N, M]
-            size_t batch_size = a_shape[0];
-            size_t feature_size = a_shape[1];
-
-            for (size_t batch = 0; batch < batch_size; ++batch) {
-                for (size_t feat = 0; feat < feature_size; ++feat) {
-                    size_t a_idx = batch * feature_size + feat;
-                    size_t b_idx = feat;  // b has shape [1, M], so only varies by feature
-                    result_data[a_idx] =
-                        a_data[a_idx] +
-                        b_data
-                            [b_idx];  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) - Safe array access with bounds checking
-                }
+        return;
+    }
+    if (shape.numel() == 0) {
+        return;
+    }
+
+    size_t rank = shape.rank();
+    SmallVector<size_t, Shape::INLINE_RANK> a_strides = broadcast_strides(a.dims(), shape);
+    SmallVector<size_t, Shape::INLINE_RANK> b_strides = broadcast_strides(b.dims(), shape);
+    SmallVector<uint32_t, Shape::INLINE_RANK> index(rank, 0);
+    size_t row = shape[rank - 1];
+    size_t a_step = a_strides[rank - 1];
+    size_t b_step = b_strides[rank - 1];
+    size_t a_offset = 0;
+    size_t b_offset = 0;
+    for (size_t start = 0; start < shape.numel(); start += row) {
+        const float* a_row = a_data + a_offset;
+        const float* b_row = b_data + b_offset;
+        float* result_row = result_data + start;
+        if (a_step == 1 && b_step == 1) {
+            for (size_t j = 0; j < row; ++j) {
+                result_row[j] = op(a_row[j], b_row[j]);
             }
         } else {
-            throw std::runtime_error("Broadcasting addition not implemented for these shapes");
+            for (size_t j = 0; j < row; ++j) {
+                result_row[j] = op(a_row[j * a_step], b_row[j * b_step]);
+            }
         }
-    }
 
-    return result;
+        for (size_t d = rank - 1; d-- > 0;) {
+            if (++index[d] < shape[d]) {
+                a_offset += a_strides[d];
+                b_offset += b_strides[d];
+                break;
+            }
+            index[d] = 0;
+            a_offset -= (shape[d] - 1) * a_strides[d];
+            b_offset -= (shape[d] - 1) * b_strides[d];
+        }
+    }
 }
 
-Tensor multiply(const Tensor& a, const Tensor& b) {
-    // Check if shapes can be broadcast
-    std::vector<uint32_t> a_shape(a.shape(), a.shape() + a.rank());
-    std::vector<uint32_t> b_shape(b.shape(), b.shape() + b.rank());
+}  // namespace
 
-    if (!Tensor::can_broadcast(a_shape, b_shape)) {
-        throw std::runtime_error("Cannot broadcast shapes for multiplication");
-    }
+Tensor add(const Tensor& a, const Tensor& b) {
+    Tensor result(broadcast_output(a, b, "addition"));
+    add(a, b, result);
+    return result;
+}
 
-    auto output_shape = Tensor::broadcast_shapes(a_shape, b_shape);
-    Tensor result(output_shape);
-
-    // Perform element-wise multiplication
-    // This is a simplified implementation for same-shaped tensors
-    if (a_shape == b_shape) {
-        const float* a_data = a.const_data_ptr();
-        const float* b_data = b.const_data_ptr();
-        float* result_data = result.data_ptr();
-        for (size_t i = 0; i < a.total_elements(); ++i) {
-            result_data[i] = a_data[i] * b_data[i];
-        }
-    } else {
-        throw std::runtime_error("Broadcasting multiplication not fully implemented");
-    }
+void add(const Tensor& a, const Tensor& b, Tensor& out) {
+    Shape shape = broadcast_output(a, b, "addition");
+    check_output(out, shape, "Add");
+    broadcast_apply(a, b, out, shape, [](float x, float y) { return x + y; });
+}
 
+Tensor multiply(const Tensor& a, const Tensor& b) {
+    Tensor result(broadcast_output(a, b, "multiplication"));
+    multiply(a, b, result);
     return result;
 }
 
+void multiply(const Tensor& a, const Tensor& b, Tensor& out) {
+    Shape shape = broadcast_output(a, b, "multiplication");
+    check_output(out, shape, "Multiply");
+    broadcast_apply(a, b, out, shape, [](float x, float y) { return x * y; });
+}
+
 }  // namespace math
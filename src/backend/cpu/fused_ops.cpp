@@ -1,4 +1,8 @@
 #include "Tensor.hpp"
+#include "gemm.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+#include "small_gemm.hpp"
 
 #include <algorithm>
 #include <stdexcept>
@@ -6,6 +10,12 @@
 namespace math {
 
 Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, bool has_relu) {
+    Tensor result({input.size(0), weights.size(1)});
+    fused_mlp(input, weights, bias, result, has_relu);
+    return result;
+}
+
+void fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out, bool has_relu) {
     // Validate inputs are materialized
     if (!input.is_evaluated() || !weights.is_evaluated() || !bias.is_evaluated()) {
         throw std::runtime_error("Fused MLP requires materialized input tensors");
@@ -24,43 +34,55 @@ Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias,
         throw std::runtime_error("Incompatible shapes for MLP: bias features don't match weight columns");
     }
 
-    // Create output tensor
     std::vector<uint32_t> output_shape = {static_cast<uint32_t>(batch_size), static_cast<uint32_t>(output_features)};
-    Tensor result(output_shape);
-
-    // Get data pointers
-    const float* input_data = input.const_data_ptr();
-    const float* weights_data = weights.const_data_ptr();
-    const float* bias_data = bias.const_data_ptr();
-    float* result_data = result.data_ptr();
+    check_output(out, output_shape, "FusedMLP");
 
-    // Fused computation: MatMul + Add + (optional ReLU)
-    // This is more efficient than separate operations
-    for (size_t batch = 0; batch < batch_size; ++batch) {
-        for (size_t out_feat = 0; out_feat < output_features; ++out_feat) {
-            // Compute dot product: input[batch, :] @ weights[:, out_feat]
-            float sum = 0.0f;
-            for (size_t in_feat = 0; in_feat < input_features; ++in_feat) {
-                size_t input_idx = batch * input_features + in_feat;
-                size_t weight_idx = in_feat * output_features + out_feat;
-                sum += input_data[input_idx] * weights_data[weight_idx];
-            }
+    // Bias and ReLU are applied in the GEMM epilogue, while each output tile is still hot
+    gemm(batch_size, output_features, input_features, input.const_data_ptr(), input_features, false,
+         weights.const_data_ptr(), output_features, false, out.data_ptr(), output_features, bias.const_data_ptr(),
+         has_relu);
+}
 
-            // Add bias
-            sum += bias_data[out_feat];  // bias has shape [1, output_features]
+void fused_mlp_gemv(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out, bool has_relu) {
+    if (!input.is_evaluated() || !weights.is_evaluated() || !bias.is_evaluated()) {
+        throw std::runtime_error("Fused MLP requires materialized input tensors");
+    }
+    if (input.size(0) != 1) {
+        throw std::runtime_error("Fused MLP gemv kernel requires a batch of one row");
+    }
+    size_t input_features = input.size(1);
+    size_t output_features = weights.size(1);
+    if (weights.size(0) != input_features) {
+        throw std::runtime_error("Incompatible shapes for MLP: input features don't match weight rows");
+    }
+    if (bias.size(1) != output_features) {
+        throw std::runtime_error("Incompatible shapes for MLP: bias features don't match weight columns");
+    }
+    check_output(out, {1, static_cast<uint32_t>(output_features)}, "FusedMLP");
 
-            // Apply ReLU if requested
-            if (has_relu) {
-                sum = std::max(0.0f, sum);
-            }
+    gemv(output_features, input_features, input.const_data_ptr(), weights.const_data_ptr(), output_features, false,
+         out.data_ptr(), bias.const_data_ptr(), has_relu);
+}
 
-            // Store result
-            size_t result_idx = batch * output_features + out_feat;
-            result_data[result_idx] = sum;
-        }
+void fused_mlp_small(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out, bool has_relu) {
+    if (!input.is_evaluated() || !weights.is_evaluated() || !bias.is_evaluated()) {
+        throw std::runtime_error("Fused MLP requires materialized input tensors");
     }
+    size_t input_features = input.size(1);
+    size_t output_features = weights.size(1);
+    if (weights.size(0) != input_features) {
+        throw std::runtime_error("Incompatible shapes for MLP: input features don't match weight rows");
+    }
+    if (bias.size(1) != output_features) {
+        throw std::runtime_error("Incompatible shapes for MLP: bias features don't match weight columns");
+    }
+    check_output(out, {input.size(0), static_cast<uint32_t>(output_features)}, "FusedMLP");
 
-    return result;
+    SmallGemmKernel kernel = find_small_gemm(input.size(0), output_features, input_features);
+    if (kernel == nullptr) {
+        throw std::runtime_error("Fused MLP small kernel has no specialization for this shape");
+    }
+    kernel(input.const_data_ptr(), weights.const_data_ptr(), bias.const_data_ptr(), has_relu, out.data_ptr());
 }
 
 }  // namespace math
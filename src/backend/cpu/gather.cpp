@@ -0,0 +1,224 @@
+#include "Tensor.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace math {
+
+namespace {
+
+// Table rows are looked up this many indices ahead of their use and prefetched, so the
+// cache (or page) miss of a random row overlaps with copying the current ones
+constexpr size_t PREFETCH_DISTANCE = 8;
+constexpr size_t CACHE_LINE_BYTES = 64;
+
+// Smallest amount of output worth handing to another thread
+constexpr size_t MIN_FLOATS_PER_THREAD = size_t{1} << 14U;
+
+void prefetch_row(const float* row, size_t floats) {
+    const auto* bytes = reinterpret_cast<const char*>(row);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    for (size_t offset = 0; offset < floats * sizeof(float); offset += CACHE_LINE_BYTES) {
+        __builtin_prefetch(bytes + offset, 0, 1);
+    }
+}
+
+// Kept separate so the loop vectorizes without runtime alias checks
+void accumulate_row(float* __restrict acc, const float* __restrict row, size_t dim) {
+    for (size_t d = 0; d < dim; ++d) {
+        acc[d] += row[d];
+    }
+}
+
+// Call fn with the index data typed as stored (int32_t, int64_t or float)
+template <typename Fn>
+void visit_indices(const Tensor& indices, Fn&& fn) {
+    switch (indices.dtype()) {
+        case DataType::INT32:
+            fn(static_cast<const int32_t*>(indices.raw_data()));
+            break;
+        case DataType::INT64:
+            fn(static_cast<const int64_t*>(indices.raw_data()));
+            break;
+        default:
+            fn(indices.const_data_ptr());
+            break;
+    }
+}
+
+// Position `value` as an index below `limit`, or -1 if it is out of range (or not integral)
+template <typename Index>
+int64_t checked_index(Index value, uint64_t limit) {
+    if constexpr (std::is_floating_point_v<Index>) {
+        auto number = static_cast<double>(value);
+        if (!(number >= 0.0 && number < static_cast<double>(limit)) || std::floor(number) != number) {
+            return -1;
+        }
+        return static_cast<int64_t>(number);
+    } else {
+        auto index = static_cast<int64_t>(value);
+        return index >= 0 && static_cast<uint64_t>(index) < limit ? index : -1;
+    }
+}
+
+// Indices are checked up front so the (possibly threaded) copy loops cannot fail
+template <typename Index>
+void check_indices(const Index* indices, size_t count, uint32_t limit, const char* op_name) {
+    for (size_t i = 0; i < count; ++i) {
+        if (checked_index(indices[i], limit) < 0) {
+            throw std::runtime_error(std::string(op_name) + ": index " + std::to_string(indices[i]) + " at position " +
+                                     std::to_string(i) + " is out of range for size " + std::to_string(limit));
+        }
+    }
+}
+
+void check_index_tensor(const Tensor& tensor, const char* what, const char* op_name) {
+    if (!tensor.is_evaluated()) {
+        throw std::runtime_error(std::string(op_name) + ": " + what + " must be materialized");
+    }
+}
+
+std::vector<uint32_t> gather_output_shape(const Tensor& table, const Tensor& indices, int32_t axis) {
+    int32_t rank = table.rank();
+    if (axis < -rank || axis >= rank) {
+        throw std::runtime_error("Gather: axis " + std::to_string(axis) + " is out of range for rank " +
+                                 std::to_string(rank));
+    }
+    auto dim = static_cast<size_t>(axis < 0 ? axis + rank : axis);
+
+    std::vector<uint32_t> table_shape = shape_of(table);
+    std::vector<uint32_t> shape(table_shape.begin(), table_shape.begin() + static_cast<std::ptrdiff_t>(dim));
+    for (size_t i = 0; i < indices.rank(); ++i) {
+        shape.push_back(indices.size(i));
+    }
+    shape.insert(shape.end(), table_shape.begin() + static_cast<std::ptrdiff_t>(dim) + 1, table_shape.end());
+    return shape;
+}
+
+// Bag boundaries as positions into the index list: bag b spans [positions[b], positions[b + 1])
+std::vector<size_t> bag_positions(const Tensor& offsets, size_t num_indices) {
+    size_t bags = offsets.total_elements();
+    std::vector<size_t> positions(bags + 1, num_indices);
+    visit_indices(offsets, [&](const auto* data) {
+        for (size_t b = 0; b < bags; ++b) {
+            int64_t position = checked_index(data[b], uint64_t{num_indices} + 1);
+            if (position < 0 || (b > 0 && static_cast<size_t>(position) < positions[b - 1])) {
+                throw std::runtime_error("EmbeddingBag: offsets must be increasing positions into the " +
+                                         std::to_string(num_indices) + " indices, got " + std::to_string(data[b]) +
+                                         " for bag " + std::to_string(b));
+            }
+            positions[b] = static_cast<size_t>(position);
+        }
+    });
+    return positions;
+}
+
+}  // namespace
+
+Tensor gather(const Tensor& table, const Tensor& indices, int32_t axis) {
+    Tensor result(gather_output_shape(table, indices, axis));
+    gather(table, indices, result, axis);
+    return result;
+}
+
+void gather(const Tensor& table, const Tensor& indices, Tensor& out, int32_t axis) {
+    check_output(out, gather_output_shape(table, indices, axis), "Gather");
+    check_index_tensor(indices, "indices", "Gather");
+
+    auto dim = static_cast<size_t>(axis < 0 ? axis + table.rank() : axis);
+    size_t outer = 1;
+    size_t inner = 1;
+    for (size_t i = 0; i < table.rank(); ++i) {
+        if (i < dim) {
+            outer *= table.size(i);
+        } else if (i > dim) {
+            inner *= table.size(i);
+        }
+    }
+    uint32_t axis_size = table.size(dim);
+    size_t count = indices.total_elements();
+
+    const float* table_data = table.const_data_ptr();
+    float* result_data = out.data_ptr();
+    visit_indices(indices, [&](const auto* index_data) {
+        check_indices(index_data, count, axis_size, "Gather");
+
+        // One output row of `inner` floats per (outer, index) pair
+        size_t rows = outer * count;
+        size_t grain = std::max<size_t>(1, MIN_FLOATS_PER_THREAD / std::max<size_t>(1, inner));
+        parallel_for(rows, grain, [&](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; ++row) {
+                if (row + PREFETCH_DISTANCE < end) {
+                    size_t ahead = row + PREFETCH_DISTANCE;
+                    auto source = static_cast<size_t>(index_data[ahead % count]);
+                    prefetch_row(table_data + ((ahead / count) * axis_size + source) * inner, inner);
+                }
+                auto source = static_cast<size_t>(index_data[row % count]);
+                std::memcpy(result_data + row * inner, table_data + ((row / count) * axis_size + source) * inner,
+                            inner * sizeof(float));
+            }
+        });
+    });
+}
+
+Tensor embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets, bool mean) {
+    if (table.rank() != 2 || offsets.rank() != 1) {
+        throw std::runtime_error("EmbeddingBag requires a [num_rows, dim] table and 1-D offsets");
+    }
+    Tensor result({offsets.size(0), table.size(1)});
+    embedding_bag(table, indices, offsets, result, mean);
+    return result;
+}
+
+void embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets, Tensor& out, bool mean) {
+    if (table.rank() != 2 || indices.rank() != 1 || offsets.rank() != 1) {
+        throw std::runtime_error("EmbeddingBag requires a [num_rows, dim] table and 1-D indices and offsets");
+    }
+    size_t bags = offsets.size(0);
+    size_t dim = table.size(1);
+    check_output(out, {static_cast<uint32_t>(bags), static_cast<uint32_t>(dim)}, "EmbeddingBag");
+    check_index_tensor(indices, "indices", "EmbeddingBag");
+    check_index_tensor(offsets, "offsets", "EmbeddingBag");
+
+    size_t count = indices.total_elements();
+    std::vector<size_t> positions = bag_positions(offsets, count);
+
+    const float* table_data = table.const_data_ptr();
+    float* result_data = out.data_ptr();
+    visit_indices(indices, [&](const auto* index_data) {
+        check_indices(index_data, count, table.size(0), "EmbeddingBag");
+
+        // Bags are split across threads by their average cost
+        size_t floats_per_bag = std::max<size_t>(1, count * dim / std::max<size_t>(1, bags));
+        size_t grain = std::max<size_t>(1, MIN_FLOATS_PER_THREAD / floats_per_bag);
+        parallel_for(bags, grain, [&](size_t first_bag, size_t last_bag) {
+            size_t chunk_end = positions[last_bag];
+            for (size_t bag = first_bag; bag < last_bag; ++bag) {
+                float* acc = result_data + bag * dim;
+                std::fill(acc, acc + dim, 0.0f);
+                for (size_t i = positions[bag]; i < positions[bag + 1]; ++i) {
+                    if (i + PREFETCH_DISTANCE < chunk_end) {
+                        prefetch_row(table_data + static_cast<size_t>(index_data[i + PREFETCH_DISTANCE]) * dim, dim);
+                    }
+                    accumulate_row(acc, table_data + static_cast<size_t>(index_data[i]) * dim, dim);
+                }
+
+                size_t bag_size = positions[bag + 1] - positions[bag];
+                if (mean && bag_size > 1) {
+                    float scale = 1.0f / static_cast<float>(bag_size);
+                    for (size_t d = 0; d < dim; ++d) {
+                        acc[d] *= scale;
+                    }
+                }
+            }
+        });
+    });
+}
+
+}  // namespace math
@@ -0,0 +1,249 @@
+#include "gemm.hpp"
+
+#include "gemm_tuning.hpp"
+#include "kernel_utils.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace math {
+
+namespace {
+
+// Smallest number of multiply-adds worth handing to another thread
+constexpr size_t MIN_FLOPS_PER_THREAD = size_t{1} << 18U;
+
+// acc[MR x NR] = sum over kc steps of an MR-column times an NR-row. Fixed trip counts let
+// the compiler keep the tile in vector registers.
+void micro_kernel(size_t kc, const float* __restrict a, const float* __restrict b, float* __restrict acc) {
+    float tile[GEMM_MR * GEMM_NR] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < GEMM_MR; ++i) {
+            float a_value = a[p * GEMM_MR + i];
+            for (size_t j = 0; j < GEMM_NR; ++j) {
+                tile[i * GEMM_NR + j] += a_value * b[p * GEMM_NR + j];
+            }
+        }
+    }
+    std::copy(tile, tile + GEMM_MR * GEMM_NR, acc);
+}
+
+// Write the valid rows x cols of a tile, adding to earlier depth blocks and applying the
+// epilogue after the last one
+void store_tile(const float* acc, size_t rows, size_t cols, float* c, const GemmOutput& out, bool accumulate,
+                const float* bias, bool relu) {
+    for (size_t i = 0; i < rows; ++i) {
+        float* row = c + static_cast<std::ptrdiff_t>(i) * out.row_stride;
+        for (size_t j = 0; j < cols; ++j) {
+            float& target = row[static_cast<std::ptrdiff_t>(j) * out.col_stride];
+            float value = acc[i * GEMM_NR + j];
+            if (accumulate) {
+                value += target;
+            }
+            if (bias) {
+                value += bias[j];
+            }
+            if (relu) {
+                value = std::max(0.0f, value);
+            }
+            target = value;
+        }
+    }
+}
+
+// Output of an empty reduction: just the epilogue
+void store_epilogue_only(size_t m, size_t n, const GemmOutput& out) {
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            float value = out.bias ? out.bias[j] : 0.0f;
+            float* target = out.data + static_cast<std::ptrdiff_t>(i) * out.row_stride +
+                            static_cast<std::ptrdiff_t>(j) * out.col_stride;
+            *target = out.relu ? std::max(0.0f, value) : value;
+        }
+    }
+}
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+void gemm_packed(size_t m, size_t n, size_t k, const PackLhs& pack_lhs, const PackRhs& pack_rhs,
+                 const GemmOutput& out, const GemmBlocking& blocking) {
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if (k == 0) {
+        store_epilogue_only(m, n, out);
+        return;
+    }
+
+    size_t mc = std::min(round_up(blocking.mc, GEMM_MR), round_up(m, GEMM_MR));
+    size_t nc = std::min(round_up(blocking.nc, GEMM_NR), round_up(n, GEMM_NR));
+    size_t kc = std::min(std::max<size_t>(1, blocking.kc), k);
+
+    // Reused across calls on the same thread
+    thread_local std::vector<float> lhs_panels;
+    thread_local std::vector<float> rhs_panels;
+    lhs_panels.resize(std::max(lhs_panels.size(), mc * kc));
+    rhs_panels.resize(std::max(rhs_panels.size(), kc * nc));
+    float acc[GEMM_MR * GEMM_NR];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+    for (size_t jc = 0; jc < n; jc += nc) {
+        size_t cols = std::min(nc, n - jc);
+        for (size_t pc = 0; pc < k; pc += kc) {
+            size_t depths = std::min(kc, k - pc);
+            bool first = pc == 0;
+            bool last = pc + depths == k;
+            pack_rhs(pc, depths, jc, cols, rhs_panels.data());
+
+            for (size_t ic = 0; ic < m; ic += mc) {
+                size_t rows = std::min(mc, m - ic);
+                pack_lhs(ic, rows, pc, depths, lhs_panels.data());
+
+                for (size_t jr = 0; jr < cols; jr += GEMM_NR) {
+                    const float* rhs_panel = rhs_panels.data() + (jr / GEMM_NR) * depths * GEMM_NR;
+                    size_t tile_cols = std::min(GEMM_NR, cols - jr);
+                    const float* bias = last && out.bias ? out.bias + jc + jr : nullptr;
+                    for (size_t ir = 0; ir < rows; ir += GEMM_MR) {
+                        micro_kernel(depths, lhs_panels.data() + (ir / GEMM_MR) * depths * GEMM_MR, rhs_panel, acc);
+                        float* c = out.data + static_cast<std::ptrdiff_t>(ic + ir) * out.row_stride +
+                                   static_cast<std::ptrdiff_t>(jc + jr) * out.col_stride;
+                        store_tile(acc, std::min(GEMM_MR, rows - ir), tile_cols, c, out, !first, bias,
+                                   last && out.relu);
+                    }
+                }
+            }
+        }
+    }
+}
+
+PackLhs strided_lhs(const float* a, size_t lda, bool transpose) {
+    return [a, lda, transpose](size_t row, size_t rows, size_t depth, size_t depths, float* dst) noexcept {
+        for (size_t r0 = 0; r0 < rows; r0 += GEMM_MR) {
+            size_t panel_rows = std::min(GEMM_MR, rows - r0);
+            for (size_t p = 0; p < depths; ++p) {
+                for (size_t i = 0; i < GEMM_MR; ++i) {
+                    size_t r = row + r0 + i;
+                    size_t d = depth + p;
+                    dst[i] = i < panel_rows ? (transpose ? a[d * lda + r] : a[r * lda + d]) : 0.0f;
+                }
+                dst += GEMM_MR;
+            }
+        }
+    };
+}
+
+PackRhs strided_rhs(const float* b, size_t ldb, bool transpose) {
+    return [b, ldb, transpose](size_t depth, size_t depths, size_t col, size_t cols, float* dst) noexcept {
+        for (size_t c0 = 0; c0 < cols; c0 += GEMM_NR) {
+            size_t panel_cols = std::min(GEMM_NR, cols - c0);
+            for (size_t p = 0; p < depths; ++p) {
+                size_t d = depth + p;
+                if (!transpose && panel_cols == GEMM_NR) {
+                    std::copy(b + d * ldb + col + c0, b + d * ldb + col + c0 + GEMM_NR, dst);
+                } else {
+                    for (size_t j = 0; j < GEMM_NR; ++j) {
+                        size_t c = col + c0 + j;
+                        dst[j] = j < panel_cols ? (transpose ? b[c * ldb + d] : b[d * ldb + c]) : 0.0f;
+                    }
+                }
+                dst += GEMM_NR;
+            }
+        }
+    };
+}
+
+void gemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b, size_t ldb,
+          bool transpose_b, float* c, size_t ldc, const float* bias, bool relu) {
+    auto tuned = GemmTuningCache::instance().find({m, n, k, transpose_a, transpose_b});
+    gemm(m, n, k, a, lda, transpose_a, b, ldb, transpose_b, c, ldc, bias, relu, tuned.value_or(GemmConfig{}));
+}
+
+void gemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b, size_t ldb,
+          bool transpose_b, float* c, size_t ldc, const float* bias, bool relu, const GemmConfig& config) {
+    // Split the longer output side into whole register tiles; every chunk is an independent
+    // GEMM that packs its own blocks
+    bool split_rows = m >= n;
+    size_t tile = split_rows ? GEMM_MR : GEMM_NR;
+    size_t tiles = ((split_rows ? m : n) + tile - 1) / tile;
+    size_t flops_per_tile = tile * (split_rows ? n : m) * std::max<size_t>(1, k);
+    size_t grain = std::max<size_t>(1, MIN_FLOPS_PER_THREAD / std::max<size_t>(1, flops_per_tile));
+    if (config.threads > 0) {
+        grain = std::max(grain, (tiles + config.threads - 1) / config.threads);
+    }
+
+    parallel_for(tiles, grain, [&](size_t begin, size_t end) {
+        size_t first = begin * tile;
+        size_t count = std::min(end * tile, split_rows ? m : n) - first;
+        GemmOutput out;
+        out.row_stride = static_cast<std::ptrdiff_t>(ldc);
+        out.relu = relu;
+        if (split_rows) {
+            const float* a_block = transpose_a ? a + first : a + first * lda;
+            out.data = c + first * ldc;
+            out.bias = bias;
+            gemm_packed(count, n, k, strided_lhs(a_block, lda, transpose_a), strided_rhs(b, ldb, transpose_b), out,
+                        config.blocking);
+        } else {
+            const float* b_block = transpose_b ? b + first * ldb : b + first;
+            out.data = c + first;
+            out.bias = bias ? bias + first : nullptr;
+            gemm_packed(m, count, k, strided_lhs(a, lda, transpose_a), strided_rhs(b_block, ldb, transpose_b), out,
+                        config.blocking);
+        }
+    });
+}
+
+void gemv(size_t n, size_t k, const float* x, const float* b, size_t ldb, bool transpose_b, float* y,
+          const float* bias, bool relu) {
+    // Columns per chunk: a multiple of the vector width, small enough for y to stay in L1
+    constexpr size_t COLUMN_BLOCK = 256;
+    size_t blocks = (n + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+    size_t grain = std::max<size_t>(1, MIN_FLOPS_PER_THREAD / (COLUMN_BLOCK * std::max<size_t>(1, k)));
+
+    parallel_for(blocks, grain, [&](size_t begin, size_t end) {
+        size_t first = begin * COLUMN_BLOCK;
+        size_t last = std::min(end * COLUMN_BLOCK, n);
+        if (transpose_b) {
+            // Column j of op(b) is row j of b: one dot product each, in independent lanes so
+            // the sum vectorizes without reassociating
+            constexpr size_t LANES = 8;
+            for (size_t j = first; j < last; ++j) {
+                const float* row = b + j * ldb;
+                float lanes[LANES] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+                size_t depth = 0;
+                for (; depth + LANES <= k; depth += LANES) {
+                    for (size_t lane = 0; lane < LANES; ++lane) {
+                        lanes[lane] += x[depth + lane] * row[depth + lane];
+                    }
+                }
+                float sum = 0.0f;
+                for (; depth < k; ++depth) {
+                    sum += x[depth] * row[depth];
+                }
+                for (float lane : lanes) {
+                    sum += lane;
+                }
+                y[j] = sum;
+            }
+        } else {
+            // Row-major b: y accumulates x[depth] times each row, one contiguous stream per step
+            std::fill(y + first, y + last, 0.0f);
+            for (size_t depth = 0; depth < k; ++depth) {
+                const float* row = b + depth * ldb;
+                float scale = x[depth];
+                for (size_t j = first; j < last; ++j) {
+                    y[j] += scale * row[j];
+                }
+            }
+        }
+        for (size_t j = first; j < last; ++j) {
+            float value = y[j] + (bias ? bias[j] : 0.0f);
+            y[j] = relu ? std::max(value, 0.0f) : value;
+        }
+    });
+}
+
+}  // namespace math
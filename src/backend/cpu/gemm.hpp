@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+namespace math {
+
+// Register tile of the micro-kernel: MR rows of the left operand by NR columns of the right
+constexpr size_t GEMM_MR = 4;
+constexpr size_t GEMM_NR = 8;
+
+// Cache blocking of the packed GEMM
+struct GemmBlocking {
+    size_t mc = 96;    // Rows of a packed left block
+    size_t kc = 256;   // Depth of packed blocks
+    size_t nc = 2048;  // Columns of a packed right block
+};
+
+// Cache blocking and thread count of a threaded gemm() call
+struct GemmConfig {
+    GemmBlocking blocking;
+    size_t threads = 0;  // 0: one per hardware thread
+};
+
+// Packs rows [row, row + rows) x depths [depth, depth + depths) of the left operand into
+// `dst` as ceil(rows / MR) panels of `depths` steps of MR values; rows past the end are zero.
+using PackLhs = std::function<void(size_t row, size_t rows, size_t depth, size_t depths, float* dst)>;
+
+// Packs depths [depth, depth + depths) x columns [col, col + cols) of the right operand into
+// `dst` as ceil(cols / NR) panels of `depths` steps of NR values; columns past the end are zero.
+using PackRhs = std::function<void(size_t depth, size_t depths, size_t col, size_t cols, float* dst)>;
+
+// Result (i, j) is stored at data[i * row_stride + j * col_stride], after adding bias[j]
+// (if given) and applying ReLU (if requested)
+struct GemmOutput {
+    float* data = nullptr;
+    std::ptrdiff_t row_stride = 0;
+    std::ptrdiff_t col_stride = 1;
+    const float* bias = nullptr;
+    bool relu = false;
+};
+
+// Single-threaded packed GEMM: out = lhs[m x k] * rhs[k x n]. The operands are only read
+// through their packers, so callers can synthesize them on the fly (implicit GEMM).
+void gemm_packed(size_t m, size_t n, size_t k, const PackLhs& pack_lhs, const PackRhs& pack_rhs,
+                 const GemmOutput& out, const GemmBlocking& blocking = {});
+
+// Packers for row-major matrices with leading dimension `ld`, optionally transposed
+PackLhs strided_lhs(const float* a, size_t lda, bool transpose);
+PackRhs strided_rhs(const float* b, size_t ldb, bool transpose);
+
+// c[m x n] = op(a) * op(b) (+ bias[n]) (ReLU) on row-major matrices, split across threads.
+// Uses the configuration tuned for this shape (see gemm_tuning.hpp) if there is one.
+void gemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b, size_t ldb,
+          bool transpose_b, float* c, size_t ldc, const float* bias = nullptr, bool relu = false);
+void gemm(size_t m, size_t n, size_t k, const float* a, size_t lda, bool transpose_a, const float* b, size_t ldb,
+          bool transpose_b, float* c, size_t ldc, const float* bias, bool relu, const GemmConfig& config);
+
+// y[n] = x[k] * op(b) (+ bias[n]) (ReLU) for a single row x. Streams b once without packing
+// it, which a one-row gemm() would do for a quarter-filled register tile; split across
+// threads by output columns.
+void gemv(size_t n, size_t k, const float* x, const float* b, size_t ldb, bool transpose_b, float* y,
+          const float* bias = nullptr, bool relu = false);
+
+}  // namespace math
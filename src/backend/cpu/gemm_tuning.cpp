@@ -0,0 +1,295 @@
+#include "gemm_tuning.hpp"
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+namespace math {
+
+namespace {
+
+constexpr const char* OP_NAME = "gemm";
+constexpr const char* DTYPE_NAME = "f32";
+
+// Candidates around the defaults; each is clipped to the problem, so small shapes try fewer
+constexpr size_t MC_CANDIDATES[] = {24, 48, 96, 192, 384};     // NOLINT(cppcoreguidelines-avoid-c-arrays)
+constexpr size_t KC_CANDIDATES[] = {64, 128, 256, 512, 1024};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+constexpr size_t NC_CANDIDATES[] = {256, 512, 1024, 2048, 4096};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+std::string key_fields(const GemmKey& key) {
+    return std::to_string(key.m) + " " + std::to_string(key.n) + " " + std::to_string(key.k) + " " +
+           (key.transpose_a ? "1" : "0") + " " + (key.transpose_b ? "1" : "0");
+}
+
+std::string entry_line(const std::string& cpu, const GemmKey& key, const GemmTuningCache::Entry& entry) {
+    const GemmConfig& config = entry.config;
+    std::ostringstream line;
+    line << cpu << '\t' << OP_NAME << '\t' << DTYPE_NAME << '\t' << key_fields(key) << '\t' << config.blocking.mc
+         << ' ' << config.blocking.kc << ' ' << config.blocking.nc << ' ' << config.threads << '\t'
+         << entry.microseconds;
+    return line.str();
+}
+
+// Splits a cache line into its tab-separated fields
+std::vector<std::string> split_fields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, '\t')) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+bool parse_entry(const std::vector<std::string>& fields, GemmKey& key, GemmTuningCache::Entry& entry) {
+    if (fields.size() != 6 || fields[1] != OP_NAME || fields[2] != DTYPE_NAME) {
+        return false;
+    }
+    std::istringstream shape(fields[3]);
+    std::istringstream config(fields[4]);
+    std::istringstream time(fields[5]);
+    GemmConfig& c = entry.config;
+    shape >> key.m >> key.n >> key.k >> key.transpose_a >> key.transpose_b;
+    config >> c.blocking.mc >> c.blocking.kc >> c.blocking.nc >> c.threads;
+    time >> entry.microseconds;
+    return !shape.fail() && !config.fail() && !time.fail() && c.blocking.mc > 0 && c.blocking.kc > 0 &&
+           c.blocking.nc > 0;
+}
+
+// Creates every missing directory on the way to `path`'s parent
+void make_parent_directories(const std::string& path) {
+    for (size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+        mkdir(path.substr(0, slash).c_str(), 0755);  // Existing directories fail harmlessly
+    }
+}
+
+size_t clip(size_t value, size_t extent, size_t multiple) {
+    return std::min(value, (extent + multiple - 1) / multiple * multiple);
+}
+
+// Keeps the candidates that still differ after clipping to the problem
+std::vector<size_t> distinct_candidates(const size_t* begin, const size_t* end, size_t extent, size_t multiple) {
+    std::vector<size_t> values;
+    for (const size_t* it = begin; it != end; ++it) {
+        size_t value = clip(*it, extent, multiple);
+        if (std::find(values.begin(), values.end(), value) == values.end()) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+}  // namespace
+
+size_t GemmKeyHash::operator()(const GemmKey& key) const noexcept {
+    size_t hash = std::hash<size_t>()(key.m);
+    hash = hash * 31 + std::hash<size_t>()(key.n);
+    hash = hash * 31 + std::hash<size_t>()(key.k);
+    return hash * 4 + (key.transpose_a ? 2U : 0U) + (key.transpose_b ? 1U : 0U);
+}
+
+GemmTuningCache::GemmTuningCache() {
+    std::string path = default_path();
+    if (!path.empty()) {
+        load(path);
+    }
+}
+
+GemmTuningCache& GemmTuningCache::instance() {
+    static GemmTuningCache cache;
+    return cache;
+}
+
+std::optional<GemmConfig> GemmTuningCache::find(const GemmKey& key) const {
+    if (empty_.load(std::memory_order_acquire)) {
+        return std::nullopt;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second.config;
+}
+
+void GemmTuningCache::insert(const GemmKey& key, const Entry& entry) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    entries_[key] = entry;
+    empty_.store(false, std::memory_order_release);
+}
+
+std::vector<std::pair<GemmKey, GemmTuningCache::Entry>> GemmTuningCache::entries() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return {entries_.begin(), entries_.end()};
+}
+
+size_t GemmTuningCache::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void GemmTuningCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    entries_.clear();
+    empty_.store(true, std::memory_order_release);
+}
+
+size_t GemmTuningCache::load(const std::string& path) {
+    std::ifstream file(path);
+    size_t loaded = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        auto fields = split_fields(line);
+        GemmKey key;
+        Entry entry;
+        if (!line.empty() && line[0] != '#' && fields[0] == cpu_model() && parse_entry(fields, key, entry)) {
+            insert(key, entry);
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+void GemmTuningCache::save(const std::string& path) const {
+    // Other machines' results stay in the file
+    std::vector<std::string> lines;
+    {
+        std::ifstream existing(path);
+        std::string line;
+        while (std::getline(existing, line)) {
+            if (!line.empty() && line[0] != '#' && split_fields(line)[0] != cpu_model()) {
+                lines.push_back(line);
+            }
+        }
+    }
+    for (const auto& [key, entry] : entries()) {
+        lines.push_back(entry_line(cpu_model(), key, entry));
+    }
+    std::sort(lines.begin(), lines.end());
+
+    // Written next to the target and renamed over it, so readers never see a partial file
+    make_parent_directories(path);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << "# tt_lazy GEMM tuning cache: cpu, op, dtype, m n k transpose_a transpose_b, mc kc nc threads, us\n";
+        for (const auto& line : lines) {
+            file << line << '\n';
+        }
+        if (!file.flush()) {
+            throw std::runtime_error("GEMM tuning cache: cannot write " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("GEMM tuning cache: cannot replace " + path);
+    }
+}
+
+std::string GemmTuningCache::default_path() {
+    // Environment lookups happen before any tuning threads exist
+    if (const char* path = std::getenv("TT_LAZY_TUNING_CACHE")) {  // NOLINT(concurrency-mt-unsafe)
+        return path;
+    }
+    if (const char* cache = std::getenv("XDG_CACHE_HOME")) {  // NOLINT(concurrency-mt-unsafe)
+        return std::string(cache) + "/tt_lazy/gemm_tuning.txt";
+    }
+    if (const char* home = std::getenv("HOME")) {  // NOLINT(concurrency-mt-unsafe)
+        return std::string(home) + "/.cache/tt_lazy/gemm_tuning.txt";
+    }
+    return "";
+}
+
+const std::string& GemmTuningCache::cpu_model() {
+    static const std::string model = [] {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    size_t begin = line.find_first_not_of(" \t", colon + 1);
+                    return begin == std::string::npos ? std::string("unknown") : line.substr(begin);
+                }
+            }
+        }
+        return std::string("unknown");
+    }();
+    return model;
+}
+
+double time_gemm(const GemmKey& key, const GemmConfig& config, size_t repeat) {
+    // Scratch operands stored the way gemm() will read them; the values do not affect timing
+    size_t lda = key.transpose_a ? key.m : key.k;
+    size_t ldb = key.transpose_b ? key.k : key.n;
+    std::vector<float> a(key.m * key.k, 0.5f);
+    std::vector<float> b(key.k * key.n, 0.25f);
+    std::vector<float> c(key.m * key.n);
+
+    auto run = [&] {
+        gemm(key.m, key.n, key.k, a.data(), lda, key.transpose_a, b.data(), ldb, key.transpose_b, c.data(), key.n,
+             nullptr, false, config);
+    };
+    run();  // Warm-up: touches the buffers and sizes the packing scratch
+    double best = 0.0;
+    for (size_t i = 0; i < std::max<size_t>(1, repeat); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        best = i == 0 ? elapsed : std::min(best, elapsed);
+    }
+    return best;
+}
+
+GemmTuningCache::Entry tune_gemm(const GemmKey& key, const GemmTuneOptions& options) {
+    GemmTuningCache::Entry best;
+    best.config.blocking.mc = clip(best.config.blocking.mc, key.m, GEMM_MR);
+    best.config.blocking.kc = std::min(best.config.blocking.kc, std::max<size_t>(1, key.k));
+    best.config.blocking.nc = clip(best.config.blocking.nc, key.n, GEMM_NR);
+    best.microseconds = time_gemm(key, best.config, options.repeat);
+
+    auto try_values = [&](const std::vector<size_t>& values, size_t GemmConfig::*field, size_t GemmBlocking::*block) {
+        for (size_t value : values) {
+            GemmConfig candidate = best.config;
+            (field ? candidate.*field : candidate.blocking.*block) = value;
+            double microseconds = time_gemm(key, candidate, options.repeat);
+            if (microseconds < best.microseconds) {
+                best = {candidate, microseconds};
+            }
+        }
+    };
+
+    // Thread counts first: they decide how much of the problem each core's blocks see
+    size_t budget = thread_budget();
+    size_t max_threads = options.max_threads > 0 ? std::min(options.max_threads, budget) : budget;
+    std::vector<size_t> threads;
+    for (size_t count = 1; count < max_threads; count *= 2) {
+        threads.push_back(count);
+    }
+    threads.push_back(max_threads);
+    best.config.threads = max_threads;
+    try_values(threads, &GemmConfig::threads, nullptr);
+
+    auto end = [](const auto& array) { return std::end(array); };
+    try_values(distinct_candidates(std::begin(MC_CANDIDATES), end(MC_CANDIDATES), key.m, GEMM_MR), nullptr,
+               &GemmBlocking::mc);
+    try_values(distinct_candidates(std::begin(KC_CANDIDATES), end(KC_CANDIDATES), std::max<size_t>(1, key.k), 1),
+               nullptr, &GemmBlocking::kc);
+    try_values(distinct_candidates(std::begin(NC_CANDIDATES), end(NC_CANDIDATES), key.n, GEMM_NR), nullptr,
+               &GemmBlocking::nc);
+
+    GemmTuningCache::instance().insert(key, best);
+    return best;
+}
+
+}  // namespace math
@@ -0,0 +1,94 @@
+#pragma once
+#include "gemm.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace math {
+
+// One GEMM problem as gemm() sees it (float32 only)
+struct GemmKey {
+    size_t m = 0;
+    size_t n = 0;
+    size_t k = 0;
+    bool transpose_a = false;
+    bool transpose_b = false;
+
+    bool operator==(const GemmKey& other) const {
+        return m == other.m && n == other.n && k == other.k && transpose_a == other.transpose_a &&
+               transpose_b == other.transpose_b;
+    }
+};
+
+struct GemmKeyHash {
+    size_t operator()(const GemmKey& key) const noexcept;
+};
+
+// Tuned configurations by problem shape, for the CPU this process runs on.
+//
+// On first use the cache loads the file at default_path(), so tuned settings apply from the
+// first GEMM without tuning at run time. The file is plain text, one entry per line:
+//   cpu-model <TAB> gemm <TAB> f32 <TAB> m n k transpose_a transpose_b <TAB> mc kc nc threads <TAB> microseconds
+// (fields within a group separated by spaces). Entries measured on another CPU model are
+// ignored when loading and kept when saving, so one file can serve a mixed fleet.
+class GemmTuningCache {
+   public:
+    struct Entry {
+        GemmConfig config;
+        double microseconds = 0.0;  // Best time measured while tuning
+    };
+
+    static GemmTuningCache& instance();
+
+    // Non-copyable, non-movable (process-wide)
+    GemmTuningCache(const GemmTuningCache&) = delete;
+    GemmTuningCache& operator=(const GemmTuningCache&) = delete;
+    GemmTuningCache(GemmTuningCache&&) = delete;
+    GemmTuningCache& operator=(GemmTuningCache&&) = delete;
+
+    std::optional<GemmConfig> find(const GemmKey& key) const;
+    void insert(const GemmKey& key, const Entry& entry);
+    std::vector<std::pair<GemmKey, Entry>> entries() const;
+    size_t size() const;
+    void clear();
+
+    // Adds this CPU's entries from `path` (a missing file is empty); returns how many
+    size_t load(const std::string& path);
+    // Writes every entry to `path`, keeping the other CPUs' lines already there
+    void save(const std::string& path) const;
+
+    // $TT_LAZY_TUNING_CACHE, else $XDG_CACHE_HOME/tt_lazy/gemm_tuning.txt, else
+    // $HOME/.cache/tt_lazy/gemm_tuning.txt (empty if none of them is set)
+    static std::string default_path();
+    // "model name" from /proc/cpuinfo, or "unknown"
+    static const std::string& cpu_model();
+
+   private:
+    GemmTuningCache();
+    ~GemmTuningCache() = default;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<GemmKey, Entry, GemmKeyHash> entries_;
+    std::atomic<bool> empty_{true};  // Checked before locking, so untuned runs skip the lookup
+};
+
+struct GemmTuneOptions {
+    size_t repeat = 3;       // Timed runs per candidate; the best one counts
+    size_t max_threads = 0;  // Largest thread count tried (0: the process's thread budget)
+};
+
+// Benchmarks candidate cache blockings and thread counts for `key` on scratch operands,
+// records the fastest in GemmTuningCache and returns it. Starting from the defaults, the
+// thread count, then mc, kc and nc are chosen in turn, each with the others fixed.
+GemmTuningCache::Entry tune_gemm(const GemmKey& key, const GemmTuneOptions& options = {});
+
+// Time of one run with `config` (best of `repeat`), in microseconds
+double time_gemm(const GemmKey& key, const GemmConfig& config, size_t repeat);
+
+}  // namespace math
@@ -0,0 +1,59 @@
+#pragma once
+#include "Tensor.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace math {
+
+// Logical shape of a tensor as a vector
+inline std::vector<uint32_t> shape_of(const Tensor& tensor) {
+    return tensor.dims().to_vector();
+}
+
+inline size_t numel_of(const std::vector<uint32_t>& shape) {
+    size_t numel = 1;
+    for (uint32_t dim : shape) {
+        numel *= dim;
+    }
+    return numel;
+}
+
+// Validate a preallocated output before a kernel writes into it
+inline void check_output(Tensor& out, const Shape& expected_shape, const char* op_name) {
+    if (out.total_elements() != expected_shape.numel()) {
+        throw std::runtime_error(std::string(op_name) + ": output has " + std::to_string(out.total_elements()) +
+                                 " elements, expected " + std::to_string(expected_shape.numel()));
+    }
+    if (!out.is_evaluated() || out.data_ptr() == nullptr) {
+        throw std::runtime_error(std::string(op_name) + ": output tensor has no storage");
+    }
+}
+
+// Split [0, count) into contiguous chunks of at least `min_grain` items and run
+// fn(begin, end) on each, one chunk per thread of the budget, on the shared pool (see
+// thread_pool.hpp). The calling thread takes part; small ranges run inline. If `fn` throws, the
+// first exception is rethrown once every chunk has finished.
+template <typename Fn>
+void parallel_for(size_t count, size_t min_grain, Fn&& fn) {
+    size_t threads = std::min(thread_budget(), count / std::max<size_t>(1, min_grain));
+    if (threads <= 1) {
+        fn(size_t{0}, count);
+        return;
+    }
+
+    size_t chunk = (count + threads - 1) / threads;
+    auto run_chunk = [&fn, chunk, count](size_t index) {
+        size_t begin = index * chunk;
+        fn(begin, std::min(count, begin + chunk));
+    };
+    using RunChunk = decltype(run_chunk);
+    detail::run_parallel(
+        (count + chunk - 1) / chunk,
+        [](const void* context, size_t index) { (*static_cast<const RunChunk*>(context))(index); }, &run_chunk);
+}
+
+}  // namespace math
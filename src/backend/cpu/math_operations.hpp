@@ -1,6 +1,7 @@
 #pragma once
 #include "Tensor.hpp"
 
+#include <utility>
 #include <vector>
 
 namespace math {
@@ -28,4 +29,109 @@ Tensor transpose(const Tensor& input, const std::vector<int32_t>& dims = {});
 // Fused operations for better performance
 Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, bool has_relu = true);
 
+// Indexed lookups. `indices` and `offsets` may be int32, int64 or (integral) float32 tensors.
+// gather takes the slices of `table` at `indices` along `axis`; embedding_bag sums (or
+// averages) the rows of a [num_rows, dim] table over each bag of indices, where bag b spans
+// indices[offsets[b] .. offsets[b + 1]) and the last bag runs to the end. Empty bags are zero.
+Tensor gather(const Tensor& table, const Tensor& indices, int32_t axis = 0);
+Tensor embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets, bool mean = false);
+
+// Selection along `dim`: topk returns the k largest values, best first (ties keep the lower
+// position, NaN above every number), and their positions as whole-number floats; argmax
+// returns the positions of the maxima with `dim` removed. `dim` holds at most 2^24 elements.
+// Rows are filtered against the current k-th best value in vectorized blocks and kept in a
+// k-element heap, not sorted, and run across threads.
+std::pair<Tensor, Tensor> topk(const Tensor& input, uint32_t k, int32_t dim = -1);
+Tensor argmax(const Tensor& input, int32_t dim = -1);
+
+// 2-D convolution settings. Weights are always [C_out, C_in / groups, KH, KW]; the input and
+// output are NCHW, or NHWC when `channels_last` is set.
+struct Conv2dParams {
+    uint32_t stride_h = 1;
+    uint32_t stride_w = 1;
+    uint32_t pad_h = 0;
+    uint32_t pad_w = 0;
+    uint32_t dilation_h = 1;
+    uint32_t dilation_w = 1;
+    uint32_t groups = 1;
+    bool channels_last = false;
+    bool relu = false;
+};
+
+// Convolution as an implicit GEMM: output pixels times output channels over C_in / groups *
+// KH * KW, with input patches gathered while packing instead of materialized by im2col.
+// `bias` (one value per output channel) and ReLU are applied as the tile is stored; pass an
+// empty Tensor() for no bias.
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias, const Conv2dParams& params = {});
+
+// Gradients with no closed form among the operations above. relu_backward passes `grad`
+// through where the forward ReLU output is positive; reduce_sum_backward spreads the gradient
+// of a sum over `dims` (empty: all) back over the summed input's shape.
+Tensor relu_backward(const Tensor& grad, const Tensor& output);
+Tensor reduce_sum_backward(const Tensor& grad, const std::vector<uint32_t>& input_shape,
+                           const std::vector<int32_t>& dims = {});
+
+// Optimizer steps. Each reads the parameter, gradient and state once and writes the
+// parameter and state back in place, in vectorized chunks split across threads; the list
+// overloads update every parameter of a model in one call. State buffers start at zero.
+struct SgdMomentumParams {
+    float lr = 0.01f;
+    float momentum = 0.9f;
+    float dampening = 0.0f;
+    float weight_decay = 0.0f;
+    bool nesterov = false;
+};
+
+struct AdamParams {
+    float lr = 1e-3f;
+    float beta1 = 0.9f;
+    float beta2 = 0.999f;
+    float eps = 1e-8f;
+    float weight_decay = 0.0f;
+    bool decoupled_weight_decay = false;  // AdamW
+    uint64_t step = 1;                    // 1-based step number, for the bias corrections
+};
+
+void sgd_momentum_update(Tensor& param, const Tensor& grad, Tensor& momentum_buffer, const SgdMomentumParams& params);
+void sgd_momentum_update(std::vector<Tensor>& params, const std::vector<Tensor>& grads,
+                         std::vector<Tensor>& momentum_buffers, const SgdMomentumParams& hyper);
+void adam_update(Tensor& param, const Tensor& grad, Tensor& exp_avg, Tensor& exp_avg_sq, const AdamParams& params);
+void adam_update(std::vector<Tensor>& params, const std::vector<Tensor>& grads, std::vector<Tensor>& exp_avgs,
+                 std::vector<Tensor>& exp_avg_sqs, const AdamParams& hyper);
+
+// Out-parameter variants: write the result into preallocated storage, e.g. a caller-owned
+// buffer wrapped in a constant tensor. `out` must hold exactly as many elements as the result.
+void matmul(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a = false, bool transpose_b = false);
+void reduce_sum(const Tensor& input, Tensor& out, const std::vector<int32_t>& dims = {}, bool keepdim = false);
+void relu(const Tensor& input, Tensor& out);
+void relu_backward(const Tensor& grad, const Tensor& output, Tensor& out);
+void reduce_sum_backward(const Tensor& grad, Tensor& out, const std::vector<int32_t>& dims = {});
+void add(const Tensor& a, const Tensor& b, Tensor& out);
+void multiply(const Tensor& a, const Tensor& b, Tensor& out);
+void fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out, bool has_relu = true);
+void gather(const Tensor& table, const Tensor& indices, Tensor& out, int32_t axis = 0);
+void embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets, Tensor& out,
+                   bool mean = false);
+void topk(const Tensor& input, Tensor& values, Tensor& indices, uint32_t k, int32_t dim = -1);
+void argmax(const Tensor& input, Tensor& out, int32_t dim = -1);
+void conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias, Tensor& out,
+            const Conv2dParams& params = {});
+
+// Single-row kernels: matmul / fused_mlp for a left operand of one row, streaming the right
+// operand through gemv (gemm.hpp) instead of packing it. Same results; `out` as above.
+void matmul_gemv(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a = false, bool transpose_b = false);
+void fused_mlp_gemv(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out, bool has_relu = true);
+
+// Tiny-shape kernels: matmul / fused_mlp through the small_gemm specialization for exactly
+// these untransposed 2-D shapes (small_gemm.hpp); throw if there is none. `out` as above.
+void matmul_small(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a = false, bool transpose_b = false);
+void fused_mlp_small(const Tensor& input, const Tensor& weights, const Tensor& bias, Tensor& out,
+                     bool has_relu = true);
+
+// matmul through the external BLAS (sgemm, or sgemv for a single-row left operand); throws
+// unless blas_available() (blas.hpp)
+void matmul_blas(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a = false, bool transpose_b = false);
+void matmul_blas_gemv(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a = false,
+                      bool transpose_b = false);
+
 }  // namespace math
@@ -1,4 +1,9 @@
 #include "Tensor.hpp"
+#include "blas.hpp"
+#include "gemm.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+#include "small_gemm.hpp"
 
 #include <stdexcept>
 
@@ -34,27 +39,13 @@ std::vector<uint32_t> calculate_output_shape(const Tensor& a, const Tensor& b, u
 }
 
 void perform_2d_matrix_multiplication(const Tensor& a, const Tensor& b, Tensor& result, bool transpose_a,
-                                      bool transpose_b, uint32_t a_rows, uint32_t a_cols, uint32_t b_cols,
-                                      uint32_t b_rows) {
-    const float* a_data = a.const_data_ptr();
-    const float* b_data = b.const_data_ptr();
-    float* result_data = result.data_ptr();
-
-    for (uint32_t i = 0; i < a_rows; ++i) {
-        for (uint32_t j = 0; j < b_cols; ++j) {
-            float sum = 0.0f;
-            for (uint32_t k = 0; k < a_cols; ++k) {
-                float a_val = transpose_a ? a_data[k * a_rows + i] : a_data[i * a_cols + k];
-                float b_val = transpose_b ? b_data[j * b_rows + k] : b_data[k * b_cols + j];
-                sum += a_val * b_val;
-            }
-            result_data[i * b_cols + j] = sum;
-        }
-    }
+                                      bool transpose_b, uint32_t a_rows, uint32_t a_cols, uint32_t b_cols) {
+    // Leading dimensions are the stored row lengths, whichever way the operands are read
+    gemm(a_rows, b_cols, a_cols, a.const_data_ptr(), a.size(1), transpose_a, b.const_data_ptr(), b.size(1),
+         transpose_b, result.data_ptr(), b_cols);
 }
-}  // namespace
 
-Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose_b) {
+std::vector<uint32_t> matmul_output_shape(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose_b) {
     // Validate input shapes
     if (a.rank() < 2 || b.rank() < 2) {
         throw std::runtime_error("Matrix multiplication requires at least 2D tensors");
@@ -68,20 +59,72 @@ Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose
         throw std::runtime_error("Matrix dimension mismatch for multiplication");
     }
 
-    // Calculate output shape
-    auto output_shape = calculate_output_shape(a, b, a_dims.rows, b_dims.cols);
-    Tensor result(output_shape);
+    return calculate_output_shape(a, b, a_dims.rows, b_dims.cols);
+}
+}  // namespace
+
+Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose_b) {
+    Tensor result(matmul_output_shape(a, b, transpose_a, transpose_b));
+    matmul(a, b, result, transpose_a, transpose_b);
+    return result;
+}
+
+void matmul(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a, bool transpose_b) {
+    check_output(out, matmul_output_shape(a, b, transpose_a, transpose_b), "MatMul");
+
+    auto a_dims = get_matrix_dimensions(a, transpose_a);
+    auto b_dims = get_matrix_dimensions(b, transpose_b);
 
     // Perform matrix multiplication
     if (a.rank() == 2 && b.rank() == 2) {
-        perform_2d_matrix_multiplication(a, b, result, transpose_a, transpose_b, a_dims.rows, a_dims.cols, b_dims.cols,
-                                         b_dims.rows);
+        perform_2d_matrix_multiplication(a, b, out, transpose_a, transpose_b, a_dims.rows, a_dims.cols, b_dims.cols);
     } else {
         // For higher-dimensional tensors, we'd need more complex implementation
         throw std::runtime_error("Multi-dimensional matrix multiplication not fully implemented");
     }
+}
 
-    return result;
+void matmul_gemv(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a, bool transpose_b) {
+    check_output(out, matmul_output_shape(a, b, transpose_a, transpose_b), "MatMul");
+    if (a.rank() != 2 || b.rank() != 2 || get_matrix_dimensions(a, transpose_a).rows != 1) {
+        throw std::runtime_error("MatMul gemv kernel requires a single-row left operand and 2D tensors");
+    }
+
+    // One row of op(a) is contiguous either way: a [1, k] row or a [k, 1] column
+    auto b_dims = get_matrix_dimensions(b, transpose_b);
+    gemv(b_dims.cols, b_dims.rows, a.const_data_ptr(), b.const_data_ptr(), b.size(1), transpose_b, out.data_ptr());
+}
+
+void matmul_small(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a, bool transpose_b) {
+    check_output(out, matmul_output_shape(a, b, transpose_a, transpose_b), "MatMul");
+    SmallGemmKernel kernel = a.rank() == 2 && b.rank() == 2 && !transpose_a && !transpose_b
+                                 ? find_small_gemm(a.size(0), b.size(1), a.size(1))
+                                 : nullptr;
+    if (kernel == nullptr) {
+        throw std::runtime_error("MatMul small kernel has no specialization for this shape");
+    }
+    kernel(a.const_data_ptr(), b.const_data_ptr(), nullptr, false, out.data_ptr());
+}
+
+void matmul_blas(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a, bool transpose_b) {
+    check_output(out, matmul_output_shape(a, b, transpose_a, transpose_b), "MatMul");
+    if (a.rank() != 2 || b.rank() != 2) {
+        throw std::runtime_error("MatMul BLAS kernel requires 2D tensors");
+    }
+    auto a_dims = get_matrix_dimensions(a, transpose_a);
+    auto b_dims = get_matrix_dimensions(b, transpose_b);
+    blas_sgemm(a_dims.rows, b_dims.cols, a_dims.cols, a.const_data_ptr(), a.size(1), transpose_a, b.const_data_ptr(),
+               b.size(1), transpose_b, out.data_ptr(), b_dims.cols);
+}
+
+void matmul_blas_gemv(const Tensor& a, const Tensor& b, Tensor& out, bool transpose_a, bool transpose_b) {
+    check_output(out, matmul_output_shape(a, b, transpose_a, transpose_b), "MatMul");
+    if (a.rank() != 2 || b.rank() != 2 || get_matrix_dimensions(a, transpose_a).rows != 1) {
+        throw std::runtime_error("MatMul BLAS gemv kernel requires a single-row left operand and 2D tensors");
+    }
+    auto b_dims = get_matrix_dimensions(b, transpose_b);
+    blas_sgemv(b_dims.cols, b_dims.rows, a.const_data_ptr(), b.const_data_ptr(), b.size(1), transpose_b,
+               out.data_ptr());
 }
 
 }  // namespace math
@@ -0,0 +1,177 @@
+#include "Tensor.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace math {
+
+namespace {
+
+// Elements updated per work item; items from every tensor of a step go into one pool
+constexpr size_t CHUNK_FLOATS = size_t{1} << 12U;
+
+// Smallest amount of parameters worth handing to another thread
+constexpr size_t MIN_FLOATS_PER_THREAD = size_t{1} << 15U;
+
+// Raw buffers of one parameter and its optimizer state
+struct ParamBuffers {
+    float* param = nullptr;
+    const float* grad = nullptr;
+    float* first = nullptr;   // Momentum buffer or Adam's first moment
+    float* second = nullptr;  // Adam's second moment
+    size_t size = 0;
+};
+
+struct Chunk {
+    size_t tensor;
+    size_t begin;
+    size_t end;
+};
+
+// All inputs are checked (and lazy gradients evaluated) here, before any thread starts
+ParamBuffers param_buffers(Tensor& param, const Tensor& grad, Tensor& first, Tensor* second, const char* op_name) {
+    auto check = [&](const Tensor& tensor, const char* role) {
+        if (tensor.total_elements() != param.total_elements()) {
+            throw std::runtime_error(std::string(op_name) + ": " + role + " has " +
+                                     std::to_string(tensor.total_elements()) + " elements, parameter has " +
+                                     std::to_string(param.total_elements()));
+        }
+    };
+    // A read-only mapping (MappedWeightFile, SharedWeightStore) would fault on the first write
+    auto check_writable = [&](const Tensor& tensor, const char* role) {
+        if (tensor.is_read_only()) {
+            throw std::runtime_error(std::string(op_name) + ": " + role +
+                                     " is backed by read-only memory; copy it into a writable tensor to train it");
+        }
+    };
+    check(grad, "gradient");
+    check(first, "state");
+    check_writable(param, "parameter");
+    check_writable(first, "state");
+    ParamBuffers buffers;
+    buffers.param = param.data_ptr();
+    buffers.grad = grad.const_data_ptr();
+    buffers.first = first.data_ptr();
+    if (second) {
+        check(*second, "state");
+        check_writable(*second, "state");
+        buffers.second = second->data_ptr();
+    }
+    buffers.size = param.total_elements();
+    bool aliased = buffers.param == buffers.first ||
+                   (second && (buffers.param == buffers.second || buffers.first == buffers.second));
+    if (aliased) {
+        throw std::runtime_error(std::string(op_name) + ": parameter and state buffers must not alias");
+    }
+    return buffers;
+}
+
+template <typename Update>
+void run_chunks(const std::vector<ParamBuffers>& tensors, Update&& update) {
+    std::vector<Chunk> chunks;
+    for (size_t t = 0; t < tensors.size(); ++t) {
+        for (size_t begin = 0; begin < tensors[t].size; begin += CHUNK_FLOATS) {
+            chunks.push_back({t, begin, std::min(tensors[t].size, begin + CHUNK_FLOATS)});
+        }
+    }
+    parallel_for(chunks.size(), MIN_FLOATS_PER_THREAD / CHUNK_FLOATS, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const ParamBuffers& buffers = tensors[chunks[i].tensor];
+            size_t offset = chunks[i].begin;
+            update(buffers.param + offset, buffers.grad + offset, buffers.first + offset,
+                   buffers.second ? buffers.second + offset : nullptr, chunks[i].end - offset);
+        }
+    });
+}
+
+void sgd_momentum_step(const std::vector<ParamBuffers>& tensors, const SgdMomentumParams& params) {
+    float lr = params.lr;
+    float momentum = params.momentum;
+    float damped = 1.0f - params.dampening;
+    float weight_decay = params.weight_decay;
+    bool nesterov = params.nesterov;
+    run_chunks(tensors, [=](float* __restrict p, const float* __restrict g, float* __restrict buf, float*, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            float grad = g[i] + weight_decay * p[i];
+            float velocity = momentum * buf[i] + damped * grad;
+            buf[i] = velocity;
+            p[i] -= lr * (nesterov ? grad + momentum * velocity : velocity);
+        }
+    });
+}
+
+void adam_step(const std::vector<ParamBuffers>& tensors, const AdamParams& params) {
+    if (params.step == 0) {
+        throw std::runtime_error("adam_update: step counts from 1");
+    }
+    auto step = static_cast<double>(params.step);
+    float beta1 = params.beta1;
+    float beta2 = params.beta2;
+    float eps = params.eps;
+    // Bias corrections folded into two scalars: p -= step_size * m / (sqrt(v) * inv_sqrt_bc2 + eps)
+    auto step_size = static_cast<float>(params.lr / (1.0 - std::pow(static_cast<double>(beta1), step)));
+    auto inv_sqrt_bc2 = static_cast<float>(1.0 / std::sqrt(1.0 - std::pow(static_cast<double>(beta2), step)));
+    // AdamW shrinks the parameter directly; Adam adds the decay to the gradient
+    float coupled_decay = params.decoupled_weight_decay ? 0.0f : params.weight_decay;
+    float keep = params.decoupled_weight_decay ? 1.0f - params.lr * params.weight_decay : 1.0f;
+    run_chunks(tensors, [=](float* __restrict p, const float* __restrict g, float* __restrict m, float* __restrict v,
+                            size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            float param = p[i];
+            float grad = g[i] + coupled_decay * param;
+            float first = beta1 * m[i] + (1.0f - beta1) * grad;
+            float second = beta2 * v[i] + (1.0f - beta2) * grad * grad;
+            m[i] = first;
+            v[i] = second;
+            p[i] = keep * param - step_size * first / (std::sqrt(second) * inv_sqrt_bc2 + eps);
+        }
+    });
+}
+
+void check_counts(size_t params, size_t grads, size_t states, const char* op_name) {
+    if (grads != params || states != params) {
+        throw std::runtime_error(std::string(op_name) + ": got " + std::to_string(params) + " parameters, " +
+                                 std::to_string(grads) + " gradients and " + std::to_string(states) +
+                                 " state tensors");
+    }
+}
+
+}  // namespace
+
+void sgd_momentum_update(Tensor& param, const Tensor& grad, Tensor& momentum_buffer, const SgdMomentumParams& params) {
+    sgd_momentum_step({param_buffers(param, grad, momentum_buffer, nullptr, "sgd_momentum_update")}, params);
+}
+
+void sgd_momentum_update(std::vector<Tensor>& params, const std::vector<Tensor>& grads,
+                         std::vector<Tensor>& momentum_buffers, const SgdMomentumParams& hyper) {
+    check_counts(params.size(), grads.size(), momentum_buffers.size(), "sgd_momentum_update");
+    std::vector<ParamBuffers> tensors;
+    tensors.reserve(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        tensors.push_back(param_buffers(params[i], grads[i], momentum_buffers[i], nullptr, "sgd_momentum_update"));
+    }
+    sgd_momentum_step(tensors, hyper);
+}
+
+void adam_update(Tensor& param, const Tensor& grad, Tensor& exp_avg, Tensor& exp_avg_sq, const AdamParams& params) {
+    adam_step({param_buffers(param, grad, exp_avg, &exp_avg_sq, "adam_update")}, params);
+}
+
+void adam_update(std::vector<Tensor>& params, const std::vector<Tensor>& grads, std::vector<Tensor>& exp_avgs,
+                 std::vector<Tensor>& exp_avg_sqs, const AdamParams& hyper) {
+    check_counts(params.size(), grads.size(), exp_avgs.size(), "adam_update");
+    check_counts(params.size(), grads.size(), exp_avg_sqs.size(), "adam_update");
+    std::vector<ParamBuffers> tensors;
+    tensors.reserve(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        tensors.push_back(param_buffers(params[i], grads[i], exp_avgs[i], &exp_avg_sqs[i], "adam_update"));
+    }
+    adam_step(tensors, hyper);
+}
+
+}  // namespace math
@@ -1,17 +1,26 @@
 #include "Tensor.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
 
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace math {
 
-Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim) {
+namespace {
+bool is_reduced_dim(const std::vector<int32_t>& dims, size_t dim) {
+    return dims.empty() || std::find(dims.begin(), dims.end(), static_cast<int32_t>(dim)) != dims.end();
+}
+
+std::vector<uint32_t> reduce_output_shape(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim) {
     std::vector<uint32_t> output_shape;
 
     // Calculate output shape
     for (size_t i = 0; i < input.rank(); ++i) {
-        bool is_reduced = std::find(dims.begin(), dims.end(), static_cast<int32_t>(i)) != dims.end();
+        bool is_reduced = is_reduced_dim(dims, i);
         if (!is_reduced || keepdim) {
             output_shape.push_back(is_reduced ? 1 : input.size(i));
         }
@@ -21,44 +30,112 @@ Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool ke
     if (output_shape.empty()) {
         output_shape.push_back(1);
     }
+    return output_shape;
+}
+
+// Strides into the reduced tensor for each input dimension; reduced dimensions get 0
+std::vector<size_t> reduced_strides(const Tensor& input, const std::vector<int32_t>& dims) {
+    size_t rank = input.rank();
+    std::vector<size_t> strides(rank, 0);
+    size_t stride = 1;
+    for (size_t i = rank; i-- > 0;) {
+        if (!is_reduced_dim(dims, i)) {
+            strides[i] = stride;
+            stride *= input.size(i);
+        }
+    }
+    return strides;
+}
+
+void check_dims(const Tensor& input, const std::vector<int32_t>& dims) {
+    for (int32_t dim : dims) {
+        if (dim < 0 || dim >= static_cast<int32_t>(input.rank())) {
+            throw std::runtime_error("Invalid dimension for reduce operation");
+        }
+    }
+}
+}  // namespace
+
+Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim) {
+    Tensor result(reduce_output_shape(input, dims, keepdim));
+    reduce_sum(input, result, dims, keepdim);
+    return result;
+}
+
+void reduce_sum(const Tensor& input, Tensor& out, const std::vector<int32_t>& dims, bool keepdim) {
+    check_dims(input, dims);
+    check_output(out, reduce_output_shape(input, dims, keepdim), "Reduce");
 
-    Tensor result(output_shape);
+    const float* input_data = input.const_data_ptr();
+    float* output_data = out.data_ptr();
 
-    // Perform reduction
-    if (dims.empty()) {
+    if (dims.empty() || dims.size() == input.rank()) {
         // Sum all elements
-        const float* input_data = input.const_data_ptr();
-        float sum = std::accumulate(input_data, input_data + input.total_elements(), 0.0f);
-        result.data_ptr()[0] = sum;
-    } else {
-        // Sum along specified dimensions
-        // For now, implement a simple case for 2D tensors reducing along dimension 1
-        if (input.rank() == 2 && dims.size() == 1 && dims[0] == 1) {
-            const float* input_data = input.const_data_ptr();
-            float* output_data = result.data_ptr();
-            uint32_t rows = input.size(0);
-            uint32_t cols = input.size(1);
-
-            for (uint32_t i = 0; i < rows; ++i) {
-                float sum = 0.0f;
-                for (uint32_t j = 0; j < cols; ++j) {
-                    sum += input_data[i * cols + j];
-                }
-                output_data[i] = sum;
+        output_data[0] = std::accumulate(input_data, input_data + input.total_elements(), 0.0f);
+        return;
+    }
+
+    // Output strides over the kept dimensions; reduced dimensions contribute stride 0
+    size_t rank = input.rank();
+    std::vector<size_t> out_strides = reduced_strides(input, dims);
+
+    std::fill(output_data, output_data + out.total_elements(), 0.0f);
+
+    // Walk the input in row-major order, accumulating into the matching output element
+    std::vector<uint32_t> index(rank, 0);
+    for (size_t linear = 0; linear < input.total_elements(); ++linear) {
+        size_t out_idx = 0;
+        for (size_t i = 0; i < rank; ++i) {
+            out_idx += index[i] * out_strides[i];
+        }
+        output_data[out_idx] += input_data[linear];
+
+        for (size_t i = rank; i-- > 0;) {
+            if (++index[i] < input.size(i)) {
+                break;
             }
-        } else if (input.rank() == 1 && dims.size() == 1 && dims[0] == 0) {
-            const float* input_data = input.const_data_ptr();
-            float sum = std::accumulate(input_data, input_data + input.total_elements(), 0.0f);
-            result.data_ptr()[0] = sum;
-        } else {
-            // Fallback: sum all elements for any other case
-            const float* input_data = input.const_data_ptr();
-            float sum = std::accumulate(input_data, input_data + input.total_elements(), 0.0f);
-            result.data_ptr()[0] = sum;
+            index[i] = 0;
         }
     }
+}
 
+Tensor reduce_sum_backward(const Tensor& grad, const std::vector<uint32_t>& input_shape,
+                           const std::vector<int32_t>& dims) {
+    Tensor result(input_shape);
+    reduce_sum_backward(grad, result, dims);
     return result;
 }
 
+void reduce_sum_backward(const Tensor& grad, Tensor& out, const std::vector<int32_t>& dims) {
+    check_dims(out, dims);
+    size_t expected = numel_of(reduce_output_shape(out, dims, false));
+    if (grad.total_elements() != expected) {
+        throw std::runtime_error("ReduceBackward: gradient has " + std::to_string(grad.total_elements()) +
+                                 " elements, the reduction produced " + std::to_string(expected));
+    }
+    check_output(out, shape_of(out), "ReduceBackward");
+
+    // The gradient has the same layout with or without kept dimensions; each input element
+    // reads the gradient of the sum it went into
+    const float* grad_data = grad.const_data_ptr();
+    float* output_data = out.data_ptr();
+    size_t rank = out.rank();
+    std::vector<size_t> grad_strides = reduced_strides(out, dims);
+    std::vector<uint32_t> index(rank, 0);
+    for (size_t linear = 0; linear < out.total_elements(); ++linear) {
+        size_t grad_idx = 0;
+        for (size_t i = 0; i < rank; ++i) {
+            grad_idx += index[i] * grad_strides[i];
+        }
+        output_data[linear] = grad_data[grad_idx];
+
+        for (size_t i = rank; i-- > 0;) {
+            if (++index[i] < out.size(i)) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
 }  // namespace math
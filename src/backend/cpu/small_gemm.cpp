@@ -0,0 +1,51 @@
+#include "small_gemm.hpp"
+
+#include <array>
+
+namespace math {
+
+namespace {
+
+constexpr std::array<size_t, 4> ROW_SIZES = {1, 2, 4, 8};
+constexpr std::array<size_t, 5> COLUMN_SIZES = {1, 2, 4, 8, 16};  // N and K
+constexpr size_t SHAPES_PER_ROW_SIZE = COLUMN_SIZES.size() * COLUMN_SIZES.size();
+
+// Kernel `index` of the table, laid out as [m][n][k] over the sizes above
+template <size_t INDEX>
+constexpr SmallGemmKernel table_entry() {
+    constexpr size_t M = ROW_SIZES[INDEX / SHAPES_PER_ROW_SIZE];
+    constexpr size_t N = COLUMN_SIZES[INDEX / COLUMN_SIZES.size() % COLUMN_SIZES.size()];
+    constexpr size_t K = COLUMN_SIZES[INDEX % COLUMN_SIZES.size()];
+    return &small_gemm<M, N, K>;
+}
+
+template <size_t... INDEX>
+constexpr std::array<SmallGemmKernel, sizeof...(INDEX)> make_table(std::index_sequence<INDEX...> /*entries*/) {
+    return {table_entry<INDEX>()...};
+}
+
+constexpr auto KERNELS = make_table(std::make_index_sequence<ROW_SIZES.size() * SHAPES_PER_ROW_SIZE>{});
+
+// Position of `value` in `sizes`, or sizes.size()
+template <size_t COUNT>
+size_t position(const std::array<size_t, COUNT>& sizes, size_t value) {
+    size_t i = 0;
+    while (i < COUNT && sizes[i] != value) {
+        ++i;
+    }
+    return i;
+}
+
+}  // namespace
+
+SmallGemmKernel find_small_gemm(size_t m, size_t n, size_t k) {
+    size_t row = position(ROW_SIZES, m);
+    size_t column = position(COLUMN_SIZES, n);
+    size_t depth = position(COLUMN_SIZES, k);
+    if (row == ROW_SIZES.size() || column == COLUMN_SIZES.size() || depth == COLUMN_SIZES.size()) {
+        return nullptr;
+    }
+    return KERNELS[(row * COLUMN_SIZES.size() + column) * COLUMN_SIZES.size() + depth];
+}
+
+}  // namespace math
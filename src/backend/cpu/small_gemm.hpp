@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+namespace math {
+
+// Shape-specialized kernels for tiny products, where the packed GEMM's packing, tile padding,
+// blocking loops and thread dispatch cost more than the arithmetic. With M, N and K known at
+// compile time, the depth and column loops are expanded into straight-line multiply-adds on
+// a row of accumulators that stays in registers.
+constexpr size_t SMALL_GEMM_MAX_M = 8;
+constexpr size_t SMALL_GEMM_MAX_N = 16;
+constexpr size_t SMALL_GEMM_MAX_K = 16;
+
+namespace detail {
+
+// acc[j] += x * row[j] for every j
+template <size_t... J>
+inline void small_axpy(float* acc, float x, const float* row, std::index_sequence<J...> /*columns*/) {
+    ((acc[J] += x * row[J]), ...);
+}
+
+// acc[0, N) += a_row[0, K) * b[K x N]
+template <size_t N, size_t... P>
+inline void small_row(float* acc, const float* a_row, const float* b, std::index_sequence<P...> /*depths*/) {
+    (small_axpy(acc, a_row[P], b + P * N, std::make_index_sequence<N>{}), ...);
+}
+
+}  // namespace detail
+
+// c[M x N] = a[M x K] * b[K x N] (+ bias[N]) (ReLU) on contiguous row-major matrices
+template <size_t M, size_t N, size_t K>
+void small_gemm(const float* a, const float* b, const float* bias, bool relu, float* c) {
+    for (size_t i = 0; i < M; ++i) {
+        float acc[N] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        detail::small_row<N>(acc, a + i * K, b, std::make_index_sequence<K>{});
+        for (size_t j = 0; j < N; ++j) {
+            float value = bias != nullptr ? acc[j] + bias[j] : acc[j];
+            c[i * N + j] = relu && value < 0.0f ? 0.0f : value;
+        }
+    }
+}
+
+using SmallGemmKernel = void (*)(const float* a, const float* b, const float* bias, bool relu, float* c);
+
+// Precompiled kernel for exactly this shape, or null. Compiled for M in {1, 2, 4, 8} and
+// N, K in {1, 2, 4, 8, 16}; code generated ahead of time instantiates small_gemm directly.
+SmallGemmKernel find_small_gemm(size_t m, size_t n, size_t k);
+
+}  // namespace math
@@ -1,4 +1,5 @@
 #include "Tensor.hpp"
+#include "math_operations.hpp"
 
 #include <algorithm>
 #include <stdexcept>
@@ -20,32 +21,27 @@ std::vector<Tensor> split(const Tensor& input, int64_t split_size, int32_t dim)
     std::vector<Tensor> outputs;
     outputs.reserve(num_outputs);
 
-    // Calculate output shapes
-    std::vector<uint32_t> base_shape(input.shape(), input.shape() + input.rank());
+    // Each output takes a run of `split_size` slabs along `dim` out of every outer block; a slab
+    // is the contiguous stride of `dim`
+    const Shape& shape = input.dims();
+    size_t slab = shape.stride(static_cast<size_t>(dim));
+    size_t block = input_size * slab;
+    size_t outer = block == 0 ? 0 : shape.numel() / block;
+    const float* input_data = input.const_data_ptr();
 
     for (size_t i = 0; i < num_outputs; ++i) {
-        std::vector<uint32_t> output_shape = base_shape;
-        int64_t remaining = static_cast<int64_t>(input_size) - static_cast<int64_t>(i) * split_size;
-        output_shape[static_cast<size_t>(dim)] = static_cast<uint32_t>(std::min(split_size, remaining));
-
-        Tensor output(output_shape);
-
-        // Copy data slice
-        // This is a simplified implementation - in practice you'd need
-        // more sophisticated indexing for multi-dimensional tensors
         size_t start_idx = i * static_cast<size_t>(split_size);
         size_t end_idx = std::min(start_idx + static_cast<size_t>(split_size), input_size);
 
-        // For now, assume 1D tensors or handle the general case
-        if (input.rank() == 1) {
-            const float* input_data = input.const_data_ptr();
-            float* output_data = output.data_ptr();
-            std::copy(input_data + start_idx, input_data + end_idx, output_data);
-        } else {
-            // For multi-dimensional tensors, we'd need more complex indexing
-            // This is a placeholder - full implementation would require
-            // proper multi-dimensional indexing
-            throw std::runtime_error("Multi-dimensional split not fully implemented");
+        Shape output_shape = shape;
+        output_shape.set(static_cast<size_t>(dim), static_cast<uint32_t>(end_idx - start_idx));
+        Tensor output(output_shape);
+
+        float* output_data = output.data_ptr();
+        size_t chunk = (end_idx - start_idx) * slab;
+        for (size_t o = 0; o < outer; ++o) {
+            const float* src = input_data + o * block + start_idx * slab;
+            std::copy(src, src + chunk, output_data + o * chunk);
         }
 
         outputs.push_back(std::move(output));
@@ -0,0 +1,203 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace math {
+
+namespace {
+
+std::atomic<size_t> budget_override{0};
+
+// Set on pool workers, and on a caller while it runs tasks, so nested calls run inline
+thread_local bool in_task = false;
+
+class Pool {
+   public:
+    explicit Pool(size_t workers) : owner_(getpid()) {
+        try {
+            threads_.reserve(workers);
+            for (size_t i = 0; i < workers; ++i) {
+                threads_.emplace_back([this] { worker_loop(); });
+            }
+        } catch (...) {
+            shutdown();  // The destructor does not run for a half-built pool
+            throw;
+        }
+    }
+
+    ~Pool() { shutdown(); }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+    Pool(Pool&&) = delete;
+    Pool& operator=(Pool&&) = delete;
+
+    size_t workers() const { return threads_.size(); }
+    pid_t owner() const { return owner_; }
+
+    // False if another caller is using the pool
+    bool run(size_t count, detail::Task task, const void* context) {
+        std::unique_lock<std::mutex> job(job_mutex_, std::try_to_lock);
+        if (!job.owns_lock()) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = task;
+            context_ = context;
+            count_ = count;
+            next_.store(0, std::memory_order_relaxed);
+            error_ = nullptr;
+            active_ = threads_.size();
+            generation_++;
+        }
+        wake_.notify_all();
+
+        in_task = true;
+        work();
+        in_task = false;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        task_ = nullptr;
+        context_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return true;
+    }
+
+   private:
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void worker_loop() {
+        in_task = true;
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--active_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    // Claims tasks until none are left
+    void work() {
+        for (size_t i = next_.fetch_add(1, std::memory_order_relaxed); i < count_;
+             i = next_.fetch_add(1, std::memory_order_relaxed)) {
+            try {
+                task_(context_, i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    pid_t owner_;
+    std::vector<std::thread> threads_;
+    std::mutex job_mutex_;  // Held by the caller whose tasks the pool runs
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    uint64_t generation_ = 0;
+    size_t active_ = 0;  // Workers not yet done with the current job
+    bool stop_ = false;
+    detail::Task task_ = nullptr;
+    const void* context_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+size_t default_budget() {
+    if (const char* env = std::getenv("TT_LAZY_NUM_THREADS")) {  // NOLINT(concurrency-mt-unsafe)
+        int threads = std::atoi(env);
+        if (threads > 0) {
+            return static_cast<size_t>(threads);
+        }
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// The pool matching the current budget, (re)built on demand. Callers hold a reference, so a
+// pool replaced while in use is joined by its last user.
+std::shared_ptr<Pool> current_pool() {
+    static std::mutex mutex;
+    static std::shared_ptr<Pool> pool;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pool && pool->owner() != getpid()) {
+        // A forked child has the pool's memory but none of its threads: abandon it unjoined
+        new std::shared_ptr<Pool>(std::move(pool));  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    size_t workers = thread_budget() - 1;
+    if (!pool || pool->workers() != workers) {
+        pool.reset();
+        pool = std::make_shared<Pool>(workers);
+    }
+    return pool;
+}
+
+}  // namespace
+
+size_t thread_budget() {
+    size_t threads = budget_override.load(std::memory_order_relaxed);
+    if (threads > 0) {
+        return threads;
+    }
+    static const size_t fallback = default_budget();
+    return fallback;
+}
+
+void set_thread_budget(size_t threads) {
+    budget_override.store(threads, std::memory_order_relaxed);
+}
+
+namespace detail {
+
+void run_parallel(size_t count, Task task, const void* context) {
+    if (count == 0) {
+        return;
+    }
+    if (count > 1 && !in_task && thread_budget() > 1 && current_pool()->run(count, task, context)) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        task(context, i);
+    }
+}
+
+}  // namespace detail
+
+}  // namespace math
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+namespace math {
+
+// Threads the CPU kernels of this process may use, the calling thread included:
+// $TT_LAZY_NUM_THREADS, or else one per hardware thread. Processes sharing a host (e.g. the
+// workers of a sharded runtime) set their share of it. set_thread_budget(0) restores the default.
+size_t thread_budget();
+void set_thread_budget(size_t threads);
+
+namespace detail {
+
+// Runs task(i) for every i in [0, count) on the persistent worker pool and the calling thread,
+// and returns once all have finished, rethrowing the first exception a task threw. Calls made
+// from inside a task, or while another thread is using the pool, run inline on the caller.
+// A plain function pointer rather than std::function, which would probe every kernel lambda
+// for noexcept.
+using Task = void (*)(const void* context, size_t index);
+void run_parallel(size_t count, Task task, const void* context);
+
+}  // namespace detail
+
+}  // namespace math
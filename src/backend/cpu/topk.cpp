@@ -0,0 +1,195 @@
+#include "Tensor.hpp"
+#include "kernel_utils.hpp"
+#include "math_operations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace math {
+
+namespace {
+
+// Elements are compared against the current k-th best value a block at a time; a block
+// with no element above it (the common case once the heap has warmed up) costs one
+// vectorized compare and is skipped
+constexpr size_t FILTER_BLOCK = 16;
+
+// Smallest amount of input worth handing to another thread
+constexpr size_t MIN_FLOATS_PER_THREAD = size_t{1} << 14U;
+
+// Positions are returned as floats, which hold integers exactly up to 2^24
+constexpr size_t MAX_EXACT_INDEX = size_t{1} << 24U;
+
+struct Candidate {
+    float value;
+    uint32_t index;
+};
+
+// Larger values first, ties broken towards the lower position. NaN ranks above every number,
+// as in NumPy and PyTorch, so the order stays a strict weak ordering and a NaN is reported
+// rather than silently dropped.
+bool ranks_before(const Candidate& a, const Candidate& b) {
+    bool a_nan = std::isnan(a.value);
+    bool b_nan = std::isnan(b.value);
+    if (a_nan || b_nan) {
+        return a_nan && (!b_nan || a.index < b.index);
+    }
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+// Row layout of a reduction along `dim`: `outer` blocks of `size` x `inner` elements
+struct RowLayout {
+    size_t outer = 1;
+    size_t size = 1;
+    size_t inner = 1;
+};
+
+RowLayout row_layout(const Tensor& input, int32_t dim, const char* op_name) {
+    int32_t rank = input.rank();
+    if (dim < -rank || dim >= rank) {
+        throw std::runtime_error(std::string(op_name) + ": dim " + std::to_string(dim) + " is out of range for rank " +
+                                 std::to_string(rank));
+    }
+    auto axis = static_cast<size_t>(dim < 0 ? dim + rank : dim);
+
+    const Shape& shape = input.dims();
+    RowLayout layout;
+    layout.size = shape[axis];
+    layout.inner = shape.stride(axis);
+    for (size_t i = 0; i < axis; ++i) {
+        layout.outer *= shape[i];
+    }
+    if (layout.size > MAX_EXACT_INDEX) {
+        throw std::runtime_error(std::string(op_name) + ": dimension of size " + std::to_string(layout.size) +
+                                 " is too large for float32 positions");
+    }
+    return layout;
+}
+
+std::vector<uint32_t> selection_shape(const Tensor& input, int32_t dim, uint32_t k, bool keep_dim) {
+    std::vector<uint32_t> shape = shape_of(input);
+    auto axis = static_cast<size_t>(dim < 0 ? dim + input.rank() : dim);
+    if (keep_dim) {
+        shape[axis] = k;
+    } else {
+        shape.erase(shape.begin() + static_cast<std::ptrdiff_t>(axis));
+        if (shape.empty()) {
+            shape.push_back(1);
+        }
+    }
+    return shape;
+}
+
+// Best k of a contiguous row, best first, using `heap` as scratch
+void select_row(const float* row, size_t n, size_t k, std::vector<Candidate>& heap) {
+    heap.clear();
+    for (size_t i = 0; i < k; ++i) {
+        heap.push_back({row[i], static_cast<uint32_t>(i)});
+    }
+    std::make_heap(heap.begin(), heap.end(), ranks_before);  // Worst kept candidate on top
+    float threshold = heap.front().value;
+
+    // Later positions lose ties, so only strictly larger values (or a NaN over a number) enter
+    // the heap
+    auto offer = [&](size_t i) {
+        if (ranks_before({row[i], static_cast<uint32_t>(i)}, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), ranks_before);
+            heap.back() = {row[i], static_cast<uint32_t>(i)};
+            std::push_heap(heap.begin(), heap.end(), ranks_before);
+            threshold = heap.front().value;
+        }
+    };
+
+    size_t i = k;
+    for (; i + FILTER_BLOCK <= n; i += FILTER_BLOCK) {
+        int hits = 0;
+        for (size_t j = 0; j < FILTER_BLOCK; ++j) {
+            // NaN fails both compares, so `x != x` lets it through to offer()
+            hits |= static_cast<int>(row[i + j] > threshold) | static_cast<int>(row[i + j] != row[i + j]);
+        }
+        if (hits != 0) {
+            for (size_t j = 0; j < FILTER_BLOCK; ++j) {
+                offer(i + j);
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        offer(i);
+    }
+    std::sort_heap(heap.begin(), heap.end(), ranks_before);
+}
+
+// Shared driver: `values` may be null when only positions are wanted
+void select(const Tensor& input, float* values, float* indices, uint32_t k, int32_t dim, const char* op_name) {
+    RowLayout layout = row_layout(input, dim, op_name);
+    if (k == 0 || k > layout.size) {
+        throw std::runtime_error(std::string(op_name) + ": k = " + std::to_string(k) + " must be between 1 and " +
+                                 std::to_string(layout.size));
+    }
+
+    const float* data = input.const_data_ptr();
+    size_t rows = layout.outer * layout.inner;
+    size_t grain = std::max<size_t>(1, MIN_FLOATS_PER_THREAD / layout.size);
+    parallel_for(rows, grain, [&](size_t begin, size_t end) {
+        std::vector<Candidate> heap;
+        heap.reserve(k);
+        std::vector<float> gathered(layout.inner > 1 ? layout.size : 0);
+        for (size_t row = begin; row < end; ++row) {
+            size_t outer = row / layout.inner;
+            size_t inner = row % layout.inner;
+            const float* source = data + outer * layout.size * layout.inner + inner;
+            if (layout.inner > 1) {
+                // Strided row: copy it out once rather than filtering with a stride
+                for (size_t i = 0; i < layout.size; ++i) {
+                    gathered[i] = source[i * layout.inner];
+                }
+                source = gathered.data();
+            }
+            select_row(source, layout.size, k, heap);
+
+            size_t out = outer * k * layout.inner + inner;
+            for (size_t j = 0; j < k; ++j) {
+                if (values) {
+                    values[out + j * layout.inner] = heap[j].value;
+                }
+                indices[out + j * layout.inner] = static_cast<float>(heap[j].index);
+            }
+        }
+    });
+}
+
+}  // namespace
+
+std::pair<Tensor, Tensor> topk(const Tensor& input, uint32_t k, int32_t dim) {
+    row_layout(input, dim, "TopK");
+    Tensor values(selection_shape(input, dim, k, true));
+    Tensor indices(selection_shape(input, dim, k, true));
+    topk(input, values, indices, k, dim);
+    return {std::move(values), std::move(indices)};
+}
+
+void topk(const Tensor& input, Tensor& values, Tensor& indices, uint32_t k, int32_t dim) {
+    row_layout(input, dim, "TopK");
+    check_output(values, selection_shape(input, dim, k, true), "TopK");
+    check_output(indices, selection_shape(input, dim, k, true), "TopK");
+    select(input, values.data_ptr(), indices.data_ptr(), k, dim, "TopK");
+}
+
+Tensor argmax(const Tensor& input, int32_t dim) {
+    row_layout(input, dim, "ArgMax");
+    Tensor result(selection_shape(input, dim, 1, false));
+    argmax(input, result, dim);
+    return result;
+}
+
+void argmax(const Tensor& input, Tensor& out, int32_t dim) {
+    row_layout(input, dim, "ArgMax");
+    check_output(out, selection_shape(input, dim, 1, false), "ArgMax");
+    select(input, nullptr, out.data_ptr(), 1, dim, "ArgMax");
+}
+
+}  // namespace math
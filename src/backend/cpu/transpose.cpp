@@ -1,4 +1,5 @@
 #include "Tensor.hpp"
+#include "math_operations.hpp"
 
 #include <stdexcept>
 
@@ -16,16 +17,19 @@ Tensor transpose(const Tensor& input, const std::vector<int32_t>& dims) {
 
         Tensor result(output_shape);
 
-        // Perform transpose
-        uint32_t rows = input.size(input.rank() - 2);
-        uint32_t cols = input.size(input.rank() - 1);
-
-        const float* input_data = input.const_data_ptr();
-        float* result_data = result.data_ptr();
-
-        for (uint32_t i = 0; i < rows; ++i) {
-            for (uint32_t j = 0; j < cols; ++j) {
-                result_data[j * rows + i] = input_data[i * cols + j];
+        // Transpose every matrix of the leading (batch) dimensions
+        size_t rows = input.size(input.rank() - 2);
+        size_t cols = input.size(input.rank() - 1);
+        size_t matrix = rows * cols;
+        size_t batches = matrix == 0 ? 0 : input.total_elements() / matrix;
+
+        for (size_t batch = 0; batch < batches; ++batch) {
+            const float* input_data = input.const_data_ptr() + batch * matrix;
+            float* result_data = result.data_ptr() + batch * matrix;
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    result_data[j * rows + i] = input_data[i * cols + j];
+                }
             }
         }
 
@@ -1,4 +1,5 @@
 #include "Context.hpp"
+#include "EvaluationManager.hpp"
 #include "Node.hpp"
 #include "Tensor.hpp"
 
@@ -12,24 +13,34 @@ void bind_core_types(py::module& m) {
     // Tensor class
     py::class_<Tensor>(m, "Tensor")
         .def(py::init<>(), "Create a null tensor")
-        .def(py::init<NodeId, uint16_t, std::initializer_list<uint32_t>>(), py::arg("producer"), py::arg("output_idx"),
+        .def(py::init<NodeId, uint16_t, const std::vector<uint32_t>&>(), py::arg("producer"), py::arg("output_idx"),
              py::arg("shape"), "Create a tensor from a node")
         .def("rank", &Tensor::rank, "Get tensor rank")
         .def("size", &Tensor::size, py::arg("dim"), "Get size of dimension")
         .def("is_constant", &Tensor::is_constant, "Check if tensor is constant")
         .def("producer_node", &Tensor::producer_node, "Get producer node ID")
         .def("output_index", &Tensor::output_index, "Get output index")
+        .def("is_lazy", &Tensor::is_lazy, "Check if tensor is still a graph reference")
+        .def("is_evaluated", &Tensor::is_evaluated, "Check if tensor holds data")
+        .def("eval", &Tensor::eval, "Materialize the tensor")
         .def(
-            "shape",
+            "to_numpy",
+            [](Tensor& t) {
+                const float* data = t.const_data_ptr();
+                std::vector<py::ssize_t> shape(t.dims().begin(), t.dims().end());
+                return py::array_t<float>(shape, data);
+            },
+            "Materialize the tensor and copy it into a numpy array")
+        .def(
+            "shape", [](const Tensor& t) { return t.dims().to_vector(); }, "Get tensor shape as list")
+        .def(
+            "strides",
             [](const Tensor& t) {
-                std::vector<uint32_t> shape;
-                shape.reserve(t.rank());  // Pre-allocate capacity
-                for (uint16_t i = 0; i < t.rank(); ++i) {
-                    shape.push_back(t.size(i));
-                }
-                return shape;
+                const Shape& shape = t.dims();
+                return std::vector<size_t>(shape.strides(), shape.strides() + shape.rank());
             },
-            "Get tensor shape as list");
+            "Get the contiguous strides, in elements, as list")
+        .def("numel", &Tensor::total_elements, "Get number of elements");
 
     // Node class
     py::class_<Node>(m, "Node")
@@ -44,23 +55,67 @@ void bind_core_types(py::module& m) {
         .def_static("instance", &Context::instance, py::return_value_policy::reference, "Get global context instance")
         .def("size", &Context::size, "Get number of nodes")
         .def("clear", &Context::clear, "Clear all nodes")
+        .def("stats", &Context::get_stats, "Get graph statistics")
         .def("print_stats", &Context::print_stats, "Print context statistics");
 
     // Utility functions
     m.def(
         "create_constant_tensor",
-        [](py::array_t<float> data, const std::vector<uint32_t>& shape) {
+        [](py::array_t<float, py::array::c_style | py::array::forcecast> data, const std::vector<uint32_t>& shape) {
             if (data.ndim() != static_cast<int>(shape.size())) {
                 throw std::runtime_error("Data dimensions don't match shape");
             }
-            // Convert vector to initializer_list manually
-            uint32_t shape_array[4] = {
-                1, 1, 1, 1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-            for (size_t i = 0; i < shape.size() && i < 4; ++i) {
-                shape_array[i] = shape[i];
+            for (size_t i = 0; i < shape.size(); ++i) {
+                if (data.shape(static_cast<py::ssize_t>(i)) != static_cast<py::ssize_t>(shape[i])) {
+                    throw std::runtime_error("Data dimensions don't match shape");
+                }
+            }
+            // Zero-copy: the tensor holds a reference to the array, released under the GIL
+            // once the last copy of the tensor (graph nodes and caches included) goes away
+            auto* ptr = const_cast<float*>(data.data());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+            bool writeable = data.writeable();
+            auto* keep_alive = new py::object(data);
+            Tensor tensor(ptr, shape, [keep_alive](void*) {
+                py::gil_scoped_acquire gil;
+                delete keep_alive;
+            });
+            // A read-only array (e.g. a memmap opened with mode='r') is still a valid graph input,
+            // but optimizers must refuse to write into it
+            if (!writeable) {
+                tensor.mark_read_only();
             }
-            return Tensor(static_cast<void*>(data.mutable_data()),
-                          {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+            return tensor;
         },
         py::arg("data"), py::arg("shape"), "Create a constant tensor from numpy array");
+
+    m.def(
+        "eval_into",
+        [](const Tensor& tensor, py::array out) {
+            if (!out.dtype().is(py::dtype::of<float>())) {
+                throw std::runtime_error("eval_into: destination must be a float32 array");
+            }
+            if (!out.writeable()) {
+                throw std::runtime_error("eval_into: destination is read-only");
+            }
+            if (out.ndim() != static_cast<py::ssize_t>(tensor.rank())) {
+                throw std::runtime_error("eval_into: destination rank doesn't match tensor");
+            }
+
+            tt_lazy::EvaluationManager::OutputBuffer buffer;
+            buffer.data = static_cast<float*>(out.mutable_data());
+            buffer.size = 1;
+            for (size_t i = 0; i < tensor.rank(); ++i) {
+                auto dim = static_cast<py::ssize_t>(i);
+                if (out.shape(dim) != static_cast<py::ssize_t>(tensor.size(i))) {
+                    throw std::runtime_error("eval_into: destination shape doesn't match tensor");
+                }
+                if (out.strides(dim) % static_cast<py::ssize_t>(sizeof(float)) != 0) {
+                    throw std::runtime_error("eval_into: destination strides are not float-aligned");
+                }
+                buffer.strides.push_back(out.strides(dim) / static_cast<py::ssize_t>(sizeof(float)));
+                buffer.size += static_cast<size_t>(out.shape(dim) - 1) * static_cast<size_t>(buffer.strides.back());
+            }
+            tt_lazy::eval_into({tensor}, {buffer});
+        },
+        py::arg("tensor"), py::arg("out"), "Evaluate a tensor directly into a preallocated float32 array");
 }
@@ -1,8 +1,13 @@
+#include "autodiff.hpp"
 #include "operations.hpp"
+#include "optimizer.hpp"
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <optional>
+#include <utility>
+
 namespace py = pybind11;
 
 void bind_operations(py::module& m) {
@@ -14,8 +19,8 @@ void bind_operations(py::module& m) {
 
     m.def("split", &split, py::arg("input"), py::arg("split_size"), py::arg("dim") = 0, "Split tensor");
 
-    m.def("reduce_sum", &reduce_sum, py::arg("input"), py::arg("dims") = std::vector<int32_t>{},
-          py::arg("keepdim") = false, "Reduce tensor sum");
+    m.def("reduce_sum", py::overload_cast<const Tensor&, const std::vector<int32_t>&, bool>(&reduce_sum),
+          py::arg("input"), py::arg("dims") = std::vector<int32_t>{}, py::arg("keepdim") = false, "Reduce tensor sum");
 
     m.def("add", &add, py::arg("a"), py::arg("b"), "Element-wise addition");
 
@@ -23,4 +28,84 @@ void bind_operations(py::module& m) {
 
     m.def("fused_mlp", &fused_mlp, py::arg("input"), py::arg("weights"), py::arg("bias"), py::arg("has_relu") = true,
           "Fused MLP layer: MatMul + Add + optional ReLU");
+
+    py::enum_<EmbeddingBagArgs::Mode>(m, "EmbeddingBagMode")
+        .value("SUM", EmbeddingBagArgs::Mode::SUM)
+        .value("MEAN", EmbeddingBagArgs::Mode::MEAN);
+
+    m.def("gather", &gather, py::arg("table"), py::arg("indices"), py::arg("axis") = 0,
+          "Take slices of a table at integral indices along an axis");
+
+    m.def("embedding_bag", &embedding_bag, py::arg("table"), py::arg("indices"), py::arg("offsets"),
+          py::arg("mode") = EmbeddingBagArgs::Mode::SUM, "Sum or mean of table rows per bag of indices");
+
+    m.def("topk", &topk, py::arg("input"), py::arg("k"), py::arg("dim") = -1,
+          "Largest k values along a dimension and their positions, as a (values, indices) tuple");
+
+    m.def("argmax", &argmax, py::arg("input"), py::arg("dim") = -1, "Positions of the maxima along a dimension");
+
+    py::enum_<Conv2DArgs::Layout>(m, "Conv2DLayout")
+        .value("NCHW", Conv2DArgs::Layout::NCHW)
+        .value("NHWC", Conv2DArgs::Layout::NHWC);
+
+    m.def(
+        "conv2d",
+        [](const Tensor& input, const Tensor& weight, const std::optional<Tensor>& bias, uint32_t stride,
+           uint32_t padding, uint32_t dilation, uint32_t groups, Conv2DArgs::Layout layout, bool relu) {
+            Conv2DArgs args;
+            args.stride_h = args.stride_w = stride;
+            args.pad_h = args.pad_w = padding;
+            args.dilation_h = args.dilation_w = dilation;
+            args.groups = groups;
+            args.layout = layout;
+            args.has_relu = relu;
+            return conv2d(input, weight, bias.value_or(Tensor()), args);
+        },
+        py::arg("input"), py::arg("weight"), py::arg("bias") = std::nullopt, py::arg("stride") = 1,
+        py::arg("padding") = 0, py::arg("dilation") = 1, py::arg("groups") = 1,
+        py::arg("layout") = Conv2DArgs::Layout::NCHW, py::arg("relu") = false,
+        "2-D convolution with optional fused bias and ReLU");
+
+    m.def("grad", &grad, py::arg("loss"), py::arg("params"),
+          "Gradients of a single-value loss with respect to each parameter, as lazy tensors");
+
+    // Optimizers update the parameters' memory (e.g. the numpy arrays behind
+    // create_constant_tensor) in place
+    py::class_<SgdMomentum>(m, "SgdMomentum")
+        .def(py::init([](std::vector<Tensor> params, float lr, float momentum, float dampening, float weight_decay,
+                         bool nesterov) {
+                 math::SgdMomentumParams hyper;
+                 hyper.lr = lr;
+                 hyper.momentum = momentum;
+                 hyper.dampening = dampening;
+                 hyper.weight_decay = weight_decay;
+                 hyper.nesterov = nesterov;
+                 return SgdMomentum(std::move(params), hyper);
+             }),
+             py::arg("params"), py::arg("lr") = 0.01f, py::arg("momentum") = 0.9f, py::arg("dampening") = 0.0f,
+             py::arg("weight_decay") = 0.0f, py::arg("nesterov") = false)
+        .def("step", &SgdMomentum::step, py::arg("grads"), "Apply one update with the given gradients")
+        .def_property(
+            "lr", [](SgdMomentum& self) { return self.hyper().lr; },
+            [](SgdMomentum& self, float lr) { self.hyper().lr = lr; });
+
+    py::class_<Adam>(m, "Adam")
+        .def(py::init([](std::vector<Tensor> params, float lr, float beta1, float beta2, float eps, float weight_decay,
+                         bool decoupled_weight_decay) {
+                 math::AdamParams hyper;
+                 hyper.lr = lr;
+                 hyper.beta1 = beta1;
+                 hyper.beta2 = beta2;
+                 hyper.eps = eps;
+                 hyper.weight_decay = weight_decay;
+                 hyper.decoupled_weight_decay = decoupled_weight_decay;
+                 return Adam(std::move(params), hyper);
+             }),
+             py::arg("params"), py::arg("lr") = 1e-3f, py::arg("beta1") = 0.9f, py::arg("beta2") = 0.999f,
+             py::arg("eps") = 1e-8f, py::arg("weight_decay") = 0.0f, py::arg("decoupled_weight_decay") = false,
+             "Adam, or AdamW with decoupled_weight_decay=True")
+        .def("step", &Adam::step, py::arg("grads"), "Apply one update with the given gradients")
+        .def_property(
+            "lr", [](Adam& self) { return self.hyper().lr; }, [](Adam& self, float lr) { self.hyper().lr = lr; })
+        .def_property_readonly("steps_taken", [](Adam& self) { return self.hyper().step - 1; });
 }
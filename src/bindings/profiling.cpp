@@ -0,0 +1,168 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "EvaluationMode.hpp"
+#include "MemoryManager.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace py = pybind11;
+
+namespace {
+
+// Context-managed profiler: enables per-op timing on the global evaluation manager
+// for the duration of a `with` block and keeps the timings afterwards.
+class PyProfiler {
+   public:
+    PyProfiler& enter() {
+        auto& manager = tt_lazy::get_evaluation_manager();
+        was_enabled_ = manager.is_profiling_enabled();
+        manager.reset_profile();
+        manager.set_profiling_enabled(true);
+        timings_.clear();
+        return *this;
+    }
+
+    void exit() {
+        auto& manager = tt_lazy::get_evaluation_manager();
+        timings_ = manager.get_profile();
+        manager.set_profiling_enabled(was_enabled_);
+    }
+
+    const std::vector<tt_lazy::EvaluationManager::OpTiming>& timings() const { return timings_; }
+
+    uint64_t total_ns() const {
+        uint64_t total = 0;
+        for (const auto& timing : timings_) {
+            total += timing.duration_ns;
+        }
+        return total;
+    }
+
+    // op name -> {"count": n, "total_ns": t}
+    py::dict summary() const {
+        std::unordered_map<std::string, std::pair<size_t, uint64_t>> totals;
+        for (const auto& timing : timings_) {
+            auto& entry = totals[timing.op_name];
+            entry.first++;
+            entry.second += timing.duration_ns;
+        }
+
+        py::dict result;
+        for (const auto& [op_name, entry] : totals) {
+            py::dict op;
+            op["count"] = entry.first;
+            op["total_ns"] = entry.second;
+            result[py::str(op_name)] = op;
+        }
+        return result;
+    }
+
+   private:
+    std::vector<tt_lazy::EvaluationManager::OpTiming> timings_;
+    bool was_enabled_ = false;
+};
+
+}  // namespace
+
+void bind_profiling(py::module& m) {
+    using EvaluationStats = tt_lazy::EvaluationManager::EvaluationStats;
+    using OpTiming = tt_lazy::EvaluationManager::OpTiming;
+    using SpillStats = tt_lazy::EvaluationManager::SpillStats;
+
+    py::class_<EvaluationStats>(m, "EvaluationStats")
+        .def_readonly("cache_hits", &EvaluationStats::cache_hits)
+        .def_readonly("cache_misses", &EvaluationStats::cache_misses)
+        .def_readonly("operations_executed", &EvaluationStats::operations_executed)
+        .def_readonly("memory_allocated", &EvaluationStats::memory_allocated)
+        .def("__repr__", [](const EvaluationStats& s) {
+            return "EvaluationStats(cache_hits=" + std::to_string(s.cache_hits) +
+                   ", cache_misses=" + std::to_string(s.cache_misses) +
+                   ", operations_executed=" + std::to_string(s.operations_executed) +
+                   ", memory_allocated=" + std::to_string(s.memory_allocated) + ")";
+        });
+
+    py::class_<MemoryManager::Stats>(m, "MemoryStats")
+        .def_readonly("total_allocated", &MemoryManager::Stats::total_allocated)
+        .def_readonly("total_used", &MemoryManager::Stats::total_used)
+        .def_readonly("peak_usage", &MemoryManager::Stats::peak_usage)
+        .def_readonly("active_tensors", &MemoryManager::Stats::active_tensors)
+        .def_readonly("memory_fragmentation", &MemoryManager::Stats::memory_fragmentation)
+        .def("__repr__", [](const MemoryManager::Stats& s) {
+            return "MemoryStats(total_allocated=" + std::to_string(s.total_allocated) +
+                   ", total_used=" + std::to_string(s.total_used) + ", peak_usage=" + std::to_string(s.peak_usage) +
+                   ", active_tensors=" + std::to_string(s.active_tensors) + ")";
+        });
+
+    py::class_<Context::Stats>(m, "GraphStats")
+        .def_readonly("total_nodes", &Context::Stats::total_nodes)
+        .def_readonly("op_counts", &Context::Stats::op_counts)
+        .def("__repr__", [](const Context::Stats& s) {
+            return "GraphStats(total_nodes=" + std::to_string(s.total_nodes) + ")";
+        });
+
+    py::class_<OpTiming>(m, "OpTiming")
+        .def_readonly("node_id", &OpTiming::node_id)
+        .def_readonly("op_name", &OpTiming::op_name)
+        .def_readonly("duration_ns", &OpTiming::duration_ns)
+        .def("__repr__", [](const OpTiming& t) {
+            return "OpTiming(node_id=" + std::to_string(t.node_id) + ", op_name='" + t.op_name +
+                   "', duration_ns=" + std::to_string(t.duration_ns) + ")";
+        });
+
+    py::class_<SpillStats>(m, "SpillStats")
+        .def_readonly("spilled_bytes", &SpillStats::spilled_bytes)
+        .def_readonly("spill_count", &SpillStats::spill_count)
+        .def_readonly("restored_bytes", &SpillStats::restored_bytes)
+        .def_readonly("restore_count", &SpillStats::restore_count)
+        .def_readonly("dropped_bytes", &SpillStats::dropped_bytes)
+        .def_readonly("stall_ns", &SpillStats::stall_ns)
+        .def_readonly("peak_resident_bytes", &SpillStats::peak_resident_bytes)
+        .def("__repr__", [](const SpillStats& s) {
+            return "SpillStats(spilled_bytes=" + std::to_string(s.spilled_bytes) +
+                   ", restored_bytes=" + std::to_string(s.restored_bytes) +
+                   ", dropped_bytes=" + std::to_string(s.dropped_bytes) + ", stall_ns=" + std::to_string(s.stall_ns) +
+                   ", peak_resident_bytes=" + std::to_string(s.peak_resident_bytes) + ")";
+        });
+
+    py::class_<PyProfiler>(m, "Profiler")
+        .def(py::init<>())
+        .def("__enter__", &PyProfiler::enter, py::return_value_policy::reference)
+        .def("__exit__", [](PyProfiler& p, const py::object&, const py::object&, const py::object&) { p.exit(); })
+        .def_property_readonly("timings", &PyProfiler::timings, "Per-op timings in execution order")
+        .def_property_readonly("total_ns", &PyProfiler::total_ns, "Sum of all op timings")
+        .def("summary", &PyProfiler::summary, "Timings aggregated by op name");
+
+    m.def(
+        "get_evaluation_stats", []() { return tt_lazy::get_evaluation_manager().get_stats(); },
+        "Get evaluation manager statistics");
+    m.def(
+        "get_memory_stats", []() { return MemoryManager::instance().get_stats(); }, "Get memory manager statistics");
+    m.def(
+        "clear_cache", []() { tt_lazy::get_evaluation_manager().clear_cache(); },
+        "Clear cached evaluation results and statistics");
+    m.def(
+        "set_memory_budget", [](size_t bytes) { tt_lazy::get_evaluation_manager().set_memory_budget(bytes); },
+        py::arg("bytes"), "Spill intermediate results to disk beyond this many bytes (0 disables)");
+    m.def(
+        "get_spill_stats", []() { return tt_lazy::get_evaluation_manager().get_spill_stats(); },
+        "Get spill-to-disk statistics for the current memory budget");
+    m.def(
+        "set_lazy_window",
+        [](size_t max_nodes, size_t max_bytes) {
+            tt_lazy::get_evaluation_manager().set_lazy_window({max_nodes, max_bytes});
+        },
+        py::arg("max_nodes") = 0, py::arg("max_bytes") = 0,
+        "Evaluate the pending graph once this many nodes or estimated bytes build up (0 disables)");
+    m.def(
+        "set_evaluation_mode",
+        [](const std::string& mode) { tt_lazy::set_evaluation_mode(tt_lazy::parse_evaluation_mode(mode)); },
+        py::arg("mode"), "Evaluate through a new 'tape', 'immediate' or 'adaptive' evaluation manager");
+    m.def(
+        "get_evaluation_mode", []() { return std::string(tt_lazy::evaluation_mode_name(tt_lazy::evaluation_mode())); },
+        "Get the kind of the current evaluation manager");
+}
@@ -5,6 +5,7 @@ namespace py = pybind11;
 // Forward declarations
 void bind_core_types(py::module& m);
 void bind_operations(py::module& m);
+void bind_profiling(py::module& m);
 
 PYBIND11_MODULE(tt_lazy, m) {
     m.doc() = "TT Lazy - High-performance C++ ML framework with lazy evaluation";
@@ -14,4 +15,7 @@ PYBIND11_MODULE(tt_lazy, m) {
 
     // Bind operations (matmul, relu, split, reduce_sum)
     bind_operations(m);
+
+    // Bind statistics and profiling
+    bind_profiling(m);
 }
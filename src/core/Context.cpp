@@ -1,6 +1,7 @@
 #include "Context.hpp"
 
 #include <algorithm>
+#include <cstddef>
 #include <stdexcept>
 
 #include <spdlog/spdlog.h>
@@ -11,17 +12,14 @@ constexpr size_t INITIAL_NODES_CAPACITY = 1024;
 
 Context::Context() {
     nodes_.reserve(INITIAL_NODES_CAPACITY);
-    id_to_index_.reserve(INITIAL_NODES_CAPACITY);
 }
 
 Node* Context::get_node(NodeId id) {
-    auto it = id_to_index_.find(id);
-    return it != id_to_index_.end() ? &nodes_[it->second] : nullptr;
+    return id >= first_id_ && id < next_id_ ? &nodes_[id - first_id_] : nullptr;
 }
 
 const Node* Context::get_node(NodeId id) const {
-    auto it = id_to_index_.find(id);
-    return it != id_to_index_.end() ? &nodes_[it->second] : nullptr;
+    return id >= first_id_ && id < next_id_ ? &nodes_[id - first_id_] : nullptr;
 }
 
 // Get all nodes for inspection
@@ -109,21 +107,40 @@ size_t Context::size() const {
 
 void Context::clear() {
     nodes_.clear();
-    id_to_index_.clear();
+    first_id_ = 1;
     next_id_ = 1;
 }
 
-void Context::print_stats() const {
-    std::unordered_map<OpTypeId, size_t> counts;
+void Context::release_nodes_before(NodeId id) {
+    id = std::min(id, next_id_);
+    if (id <= first_id_) {
+        return;
+    }
+    nodes_.erase(nodes_.begin(), nodes_.begin() + static_cast<std::ptrdiff_t>(id - first_id_));
+    first_id_ = id;
+}
+
+Context::Stats Context::get_stats() const {
+    Stats stats;
+    stats.total_nodes = nodes_.size();
     for (const auto& node : nodes_) {
-        counts[node.type_id()]++;
+        stats.op_counts[std::string(node.op_name())]++;
     }
+    return stats;
+}
+
+void Context::print_stats() const {
+    Stats stats = get_stats();
+
+    // Sort by name so the output is stable between runs
+    std::vector<std::pair<std::string, size_t>> counts(stats.op_counts.begin(), stats.op_counts.end());
+    std::sort(counts.begin(), counts.end());
 
     spdlog::info("Graph statistics:");
-    spdlog::info("  Total nodes: {}", nodes_.size());
+    spdlog::info("  Total nodes: {}", stats.total_nodes);
     spdlog::info("  Operation counts:");
-    for (const auto& [type_id, count] : counts) {
-        spdlog::info("    Type {}: {} nodes", type_id, count);
+    for (const auto& [op_name, count] : counts) {
+        spdlog::info("    {}: {} nodes", op_name, count);
     }
 }
 
@@ -4,8 +4,10 @@
 #include "common.hpp"
 
 #include <functional>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 // Global context for graph building
@@ -26,9 +28,25 @@ class Context {
     // Topological sort for execution
     std::vector<NodeId> topological_sort(const std::unordered_set<NodeId>& node_set) const;
 
-    size_t size() const;
+    size_t size() const;  // Nodes held, which excludes released ones
     void clear();
 
+    // Id of the newest node, or 0 for an empty graph
+    NodeId last_id() const { return next_id_ - 1; }
+
+    // Drops the nodes with ids below `id`, once nothing reads them through the graph any more
+    // (e.g. their consumers were rewritten to read constants). Ids keep counting from where
+    // they were; get_node() returns null for the released ones.
+    void release_nodes_before(NodeId id);
+    bool is_released(NodeId id) const { return id != INVALID_NODE_ID && id < first_id_; }
+
+    // Graph statistics
+    struct Stats {
+        size_t total_nodes = 0;
+        std::unordered_map<std::string, size_t> op_counts;  // Keyed by operation name
+    };
+
+    Stats get_stats() const;
     void print_stats() const;
 
     static Context& instance();
@@ -36,20 +54,11 @@ class Context {
     template <typename ArgsT>
     NodeId create_node(const SmallVector<Tensor, 2>& inputs, ArgsT&& args) {
         NodeId id = next_id_++;
-
-        size_t index = nodes_.size();
         nodes_.emplace_back(id, inputs, std::forward<ArgsT>(args));
-        id_to_index_[id] = index;
-
-        // Update connectivity for input nodes
         for (const auto& input : inputs) {
-            if (!input.is_constant() && input.producer_node() != 0) {
-                if (Node* producer = get_node(input.producer_node())) {
-                    producer->add_output_node(id);
-                }
-            }
+            link_input(id, input);
         }
-
+        notify_dispatch(id);
         return id;
     }
 
@@ -57,23 +66,30 @@ class Context {
     template <typename ArgsT, size_t N>
     NodeId create_node(const SmallVector<Tensor, N>& inputs, ArgsT&& args) {
         NodeId id = next_id_++;
-
-        size_t index = nodes_.size();
         nodes_.emplace_back(id, inputs, std::forward<ArgsT>(args));
-        id_to_index_[id] = index;
-
-        // Update connectivity for input nodes
         for (const auto& input : inputs) {
-            if (!input.is_constant() && input.producer_node() != 0) {
-                if (Node* producer = get_node(input.producer_node())) {
-                    producer->add_output_node(id);
-                }
-            }
+            link_input(id, input);
         }
+        notify_dispatch(id);
+        return id;
+    }
 
+    // Builds the node in place from up to four inputs, so adding a node to a graph makes no
+    // heap allocation beyond growth of the node array and of a producer's consumer list
+    template <typename ArgsT, typename... Inputs>
+    NodeId emplace_node(ArgsT&& args, const Inputs&... inputs) {
+        NodeId id = next_id_++;
+        nodes_.emplace_back(id, std::in_place, std::forward<ArgsT>(args), inputs...);
+        (link_input(id, inputs), ...);
+        notify_dispatch(id);
         return id;
     }
 
+    // Called with the id of every node created from now on, once it is linked into the
+    // graph, e.g. to execute it right away; an empty hook (the default) turns this off
+    using DispatchHook = std::function<void(NodeId)>;
+    void set_dispatch_hook(DispatchHook hook) { dispatch_hook_ = std::move(hook); }
+
     // Find specific operation types
     template <typename ArgsT>
     std::vector<const Node*> find_nodes() const {
@@ -89,7 +105,25 @@ class Context {
     }
 
    private:
+    // Update connectivity for an input's producer
+    void link_input(NodeId id, const Tensor& input) {
+        if (!input.is_constant() && input.producer_node() != 0) {
+            if (Node* producer = get_node(input.producer_node())) {
+                producer->add_output_node(id);
+            }
+        }
+    }
+
+    void notify_dispatch(NodeId id) {
+        if (dispatch_hook_) {
+            dispatch_hook_(id);
+        }
+    }
+
+    // Node ids are handed out in creation order from 1, so node `id` lives at
+    // nodes_[id - first_id_], nodes below first_id_ having been released
     std::vector<Node> nodes_;
-    std::unordered_map<NodeId, size_t> id_to_index_;
+    NodeId first_id_ = 1;
     NodeId next_id_ = 1;
+    DispatchHook dispatch_hook_;
 };
@@ -0,0 +1,168 @@
+#include "EvaluationManager.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace tt_lazy {
+
+namespace {
+
+std::string describe(size_t index) {
+    return "eval_into: output " + std::to_string(index) + ": ";
+}
+
+// Element range [begin, end) covered by a buffer, as addresses
+std::pair<uintptr_t, uintptr_t> address_range(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer) {
+    auto begin = reinterpret_cast<uintptr_t>(buffer.data);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {begin, begin + output_extent(tensor, buffer) * sizeof(float)};
+}
+
+void validate_strides(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer, size_t index) {
+    if (buffer.strides.size() != tensor.rank()) {
+        throw std::runtime_error(describe(index) + "got " + std::to_string(buffer.strides.size()) +
+                                 " strides for a rank " + std::to_string(static_cast<size_t>(tensor.rank())) +
+                                 " tensor");
+    }
+
+    // Dimensions of size 1 are never stepped over, so their stride is irrelevant
+    std::vector<std::pair<int64_t, uint32_t>> steps;  // (stride, extent)
+    for (size_t i = 0; i < tensor.rank(); ++i) {
+        if (tensor.size(i) > 1) {
+            if (buffer.strides[i] <= 0) {
+                throw std::runtime_error(describe(index) + "strides must be positive");
+            }
+            steps.emplace_back(buffer.strides[i], tensor.size(i));
+        }
+    }
+
+    // Elements must not alias: each dimension has to step over the whole span of the inner ones
+    std::sort(steps.begin(), steps.end());
+    for (size_t i = 1; i < steps.size(); ++i) {
+        if (steps[i].first < steps[i - 1].first * static_cast<int64_t>(steps[i - 1].second)) {
+            throw std::runtime_error(describe(index) + "strides make output elements overlap");
+        }
+    }
+}
+
+}  // namespace
+
+size_t output_extent(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer) {
+    if (buffer.strides.empty() || tensor.total_elements() == 0) {
+        return tensor.total_elements();
+    }
+
+    size_t extent = 1;
+    for (size_t i = 0; i < tensor.rank(); ++i) {
+        extent += static_cast<size_t>(tensor.size(i) - 1) * static_cast<size_t>(buffer.strides[i]);
+    }
+    return extent;
+}
+
+bool is_contiguous_output(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer) {
+    if (buffer.strides.empty()) {
+        return true;
+    }
+
+    int64_t expected = 1;
+    for (size_t i = tensor.rank(); i-- > 0;) {
+        if (tensor.size(i) > 1 && buffer.strides[i] != expected) {
+            return false;
+        }
+        expected *= tensor.size(i);
+    }
+    return true;
+}
+
+void validate_output_buffers(const std::vector<Tensor>& tensors,
+                             const std::vector<EvaluationManager::OutputBuffer>& outputs) {
+    if (tensors.size() != outputs.size()) {
+        throw std::runtime_error("eval_into: got " + std::to_string(tensors.size()) + " tensors but " +
+                                 std::to_string(outputs.size()) + " output buffers");
+    }
+
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const auto& tensor = tensors[i];
+        const auto& buffer = outputs[i];
+
+        if (tensor.is_null()) {
+            throw std::runtime_error(describe(i) + "tensor is null");
+        }
+        if (buffer.data == nullptr) {
+            throw std::runtime_error(describe(i) + "destination is null");
+        }
+        auto address = reinterpret_cast<uintptr_t>(buffer.data);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (address % alignof(float) != 0) {
+            throw std::runtime_error(describe(i) + "destination is not aligned to " +
+                                     std::to_string(alignof(float)) + " bytes");
+        }
+        if (!buffer.strides.empty()) {
+            validate_strides(tensor, buffer, i);
+        }
+
+        size_t required = output_extent(tensor, buffer);
+        if (buffer.size < required) {
+            throw std::runtime_error(describe(i) + "destination holds " + std::to_string(buffer.size) +
+                                     " elements, result needs " + std::to_string(required));
+        }
+    }
+
+    // Distinct outputs must not share memory
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        auto range_i = address_range(tensors[i], outputs[i]);
+        for (size_t j = i + 1; j < tensors.size(); ++j) {
+            auto range_j = address_range(tensors[j], outputs[j]);
+            if (range_i.first < range_j.second && range_j.first < range_i.second) {
+                throw std::runtime_error("eval_into: outputs " + std::to_string(i) + " and " + std::to_string(j) +
+                                         " overlap");
+            }
+        }
+    }
+}
+
+void copy_to_output_buffer(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer) {
+    const float* src = tensor.const_data_ptr();
+    size_t numel = tensor.total_elements();
+
+    if (is_contiguous_output(tensor, buffer)) {
+        if (src != buffer.data) {
+            std::memcpy(buffer.data, src, numel * sizeof(float));
+        }
+        return;
+    }
+
+    // Strided scatter in row-major order of the source
+    size_t rank = tensor.rank();
+    std::vector<uint32_t> index(rank, 0);
+    for (size_t linear = 0; linear < numel; ++linear) {
+        int64_t offset = 0;
+        for (size_t i = 0; i < rank; ++i) {
+            offset += static_cast<int64_t>(index[i]) * buffer.strides[i];
+        }
+        buffer.data[offset] = src[linear];
+
+        for (size_t i = rank; i-- > 0;) {
+            if (++index[i] < tensor.size(i)) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
+void eval_into(const Tensor& tensor, float* dst, size_t dst_size, const std::vector<int64_t>& strides) {
+    EvaluationManager::OutputBuffer buffer;
+    buffer.data = dst;
+    buffer.size = dst_size;
+    buffer.strides = strides;
+    get_evaluation_manager().evaluate_into({tensor}, {buffer});
+}
+
+void eval_into(const std::vector<Tensor>& tensors, const std::vector<EvaluationManager::OutputBuffer>& outputs) {
+    get_evaluation_manager().evaluate_into(tensors, outputs);
+}
+
+}  // namespace tt_lazy
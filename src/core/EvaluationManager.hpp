@@ -2,7 +2,10 @@
 
 #include "Tensor.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace tt_lazy {
 
@@ -29,6 +32,27 @@ class EvaluationManager {
      */
     virtual std::shared_ptr<Tensor> evaluate(const Tensor& tensor) = 0;
 
+    /**
+     * Caller-provided destination for an evaluation result.
+     * `size` is the capacity of `data` in elements. `strides` gives the element stride
+     * of each result dimension; empty means contiguous row-major.
+     */
+    struct OutputBuffer {
+        float* data = nullptr;
+        size_t size = 0;
+        std::vector<int64_t> strides;
+    };
+
+    /**
+     * Evaluate tensors straight into caller-provided buffers: the operation producing each
+     * tensor uses its buffer as the output allocation, so no library copy is made. Strided
+     * buffers and results that are already available are filled by a copy instead.
+     * All buffers are validated before anything executes. Results are not cached.
+     * @param tensors The tensors to evaluate
+     * @param outputs One destination per tensor
+     */
+    virtual void evaluate_into(const std::vector<Tensor>& tensors, const std::vector<OutputBuffer>& outputs) = 0;
+
     /**
      * Clear any cached evaluation results.
      */
@@ -49,15 +73,126 @@ class EvaluationManager {
      */
     virtual EvaluationStats get_stats() const = 0;
 
+    /**
+     * Wall-clock timing of a single executed operation.
+     */
+    struct OpTiming {
+        NodeId node_id = 0;
+        std::string op_name;
+        uint64_t duration_ns = 0;
+    };
+
+    /**
+     * Enable or disable per-operation profiling. Timings accumulate
+     * until reset_profile() is called.
+     */
+    virtual void set_profiling_enabled(bool enabled) = 0;
+    virtual bool is_profiling_enabled() const = 0;
+
+    /**
+     * Get per-operation timings recorded since the last reset, in execution order.
+     */
+    virtual std::vector<OpTiming> get_profile() const = 0;
+    virtual void reset_profile() = 0;
+
+    /**
+     * Spill-to-disk activity while a memory budget is set.
+     */
+    struct SpillStats {
+        uint64_t spilled_bytes = 0;  // Written to the spill file
+        uint64_t spill_count = 0;
+        uint64_t restored_bytes = 0;  // Brought back for a later consumer
+        uint64_t restore_count = 0;
+        uint64_t dropped_bytes = 0;  // Intermediates released after their last use
+        uint64_t stall_ns = 0;       // Time operations waited for spill I/O
+        uint64_t peak_resident_bytes = 0;
+    };
+
+    /**
+     * Limit the bytes of intermediate results kept in memory during execution; 0 disables
+     * the limit. Over budget, the results needed furthest in the future are written to a
+     * temporary file and read back ahead of their next consumer.
+     */
+    virtual void set_memory_budget(size_t bytes) = 0;
+    virtual size_t memory_budget() const = 0;
+    virtual SpillStats get_spill_stats() const = 0;
+
+    /**
+     * Bound on the graph that builds up between evaluations; 0 disables a limit.
+     * Once `max_pending_nodes` unevaluated nodes, or an estimated `max_pending_bytes` of
+     * their results, have built up, the pending roots (nodes nothing consumes yet) are
+     * evaluated. Nodes built on them afterwards start from the materialized results instead
+     * of the graph behind them, so loops that never read a result keep compile time and
+     * memory bounded.
+     */
+    struct LazyWindow {
+        size_t max_pending_nodes = 0;
+        size_t max_pending_bytes = 0;  // Estimated from input sizes, see the implementation
+    };
+    virtual void set_lazy_window(const LazyWindow& window) = 0;
+    virtual LazyWindow lazy_window() const = 0;
+
+    /**
+     * Called by set_evaluation_manager() when this manager becomes, or stops being, the one
+     * get_evaluation_manager() returns, e.g. to start or stop observing graph building.
+     */
+    virtual void on_activate() {}
+    virtual void on_deactivate() {}
+
    protected:
     EvaluationManager() = default;
 };
 
 /**
- * Get the global evaluation manager instance.
- * This will automatically initialize with the tape-based implementation
- * when the tape library is linked.
+ * Get the global evaluation manager instance: the one selected with set_evaluation_manager(),
+ * or else the default one. Both are provided by the linked implementation (the tape library).
  */
 EvaluationManager& get_evaluation_manager();
 
+/**
+ * Get the default evaluation manager, created on first use (tape-based unless the tape
+ * library is told otherwise, see EvaluationMode.hpp).
+ */
+EvaluationManager& default_evaluation_manager();
+
+/**
+ * Select the evaluation manager used from now on; nullptr goes back to the default one.
+ * Cached results of the previous manager are not carried over.
+ */
+void set_evaluation_manager(std::shared_ptr<EvaluationManager> manager);
+
+/**
+ * Evaluate a tensor into `dst`, which holds `dst_size` floats laid out with the given
+ * element strides (contiguous row-major when empty).
+ * Throws std::runtime_error on size, alignment or stride mismatches before any work is done.
+ */
+void eval_into(const Tensor& tensor, float* dst, size_t dst_size, const std::vector<int64_t>& strides = {});
+
+/**
+ * Evaluate several tensors into their buffers with a single tape.
+ */
+void eval_into(const std::vector<Tensor>& tensors, const std::vector<EvaluationManager::OutputBuffer>& outputs);
+
+/**
+ * Check that every buffer can receive its tensor: non-null, float-aligned, large enough for
+ * the strided extent, non-self-overlapping strides, and no overlap between buffers.
+ */
+void validate_output_buffers(const std::vector<Tensor>& tensors,
+                             const std::vector<EvaluationManager::OutputBuffer>& outputs);
+
+/**
+ * Whether `buffer` is laid out exactly like a contiguous tensor of the given shape.
+ */
+bool is_contiguous_output(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer);
+
+/**
+ * Number of elements spanned by `buffer` when it receives `tensor`.
+ */
+size_t output_extent(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer);
+
+/**
+ * Copy a materialized tensor into a (possibly strided) buffer.
+ */
+void copy_to_output_buffer(const Tensor& tensor, const EvaluationManager::OutputBuffer& buffer);
+
 }  // namespace tt_lazy
@@ -184,8 +184,11 @@ MemoryManager::Stats MemoryManager::get_stats() const {
 }
 
 void MemoryManager::reset_stats() {
-    std::scoped_lock<std::mutex> lock(stats_mutex_);
-    stats_ = Stats{};
+    {
+        std::scoped_lock<std::mutex> lock(stats_mutex_);
+        stats_ = Stats{};
+    }
+    // update_stats() takes the lock itself
     update_stats();
 }
 
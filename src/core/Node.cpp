@@ -1,5 +1,50 @@
 #include "Node.hpp"
 
+#include <utility>
+
+Node::Node(const Node& other)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - args_storage_ constructed in body
+    : id_(other.id_),
+      type_id_(other.type_id_),
+      inputs_(other.inputs_),
+      output_nodes_(other.output_nodes_),
+      manage_args_(other.manage_args_) {
+    manage_args_(ArgsAction::COPY, args_storage_,
+                 const_cast<char*>(other.args_storage_));  // NOLINT(cppcoreguidelines-pro-type-const-cast) - Only read
+}
+
+Node::Node(Node&& other) noexcept  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - args_storage_ constructed in body
+    : id_(other.id_),
+      type_id_(other.type_id_),
+      inputs_(std::move(other.inputs_)),
+      output_nodes_(std::move(other.output_nodes_)),
+      manage_args_(other.manage_args_) {
+    manage_args_(ArgsAction::MOVE, args_storage_, other.args_storage_);
+}
+
+Node& Node::operator=(const Node& other) {
+    if (this != &other) {
+        *this = Node(other);
+    }
+    return *this;
+}
+
+Node& Node::operator=(Node&& other) noexcept {
+    if (this != &other) {
+        manage_args_(ArgsAction::DESTROY, args_storage_, nullptr);
+        id_ = other.id_;
+        type_id_ = other.type_id_;
+        inputs_ = std::move(other.inputs_);
+        output_nodes_ = std::move(other.output_nodes_);
+        manage_args_ = other.manage_args_;
+        manage_args_(ArgsAction::MOVE, args_storage_, other.args_storage_);
+    }
+    return *this;
+}
+
+Node::~Node() {
+    manage_args_(ArgsAction::DESTROY, args_storage_, nullptr);
+}
+
 NodeId Node::id() const {
     return id_;
 }
@@ -33,3 +78,7 @@ const SmallVector<NodeId, 2>& Node::output_nodes() const {
 void Node::add_output_node(NodeId node_id) {
     output_nodes_.push_back(node_id);
 }
+
+void Node::replace_input(size_t index, const Tensor& input) {
+    inputs_.at(index) = input;
+}
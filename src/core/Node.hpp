@@ -3,6 +3,9 @@
 #include "Tensor.hpp"
 #include "common.hpp"
 
+#include <cstdint>
+#include <utility>
+
 // Graph node with intrusive storage
 class Node {
    public:
@@ -17,6 +20,7 @@ class Node {
         }
 
         new (args_storage_) std::decay_t<ArgsT>(std::forward<ArgsT>(args));
+        manage_args_ = &manage_args<std::decay_t<ArgsT>>;
     }
 
     // Constructor for variable number of inputs
@@ -31,8 +35,31 @@ class Node {
         }
 
         new (args_storage_) std::decay_t<ArgsT>(std::forward<ArgsT>(args));
+        manage_args_ = &manage_args<std::decay_t<ArgsT>>;
+    }
+
+    // Constructor taking the inputs directly, copying each one once into inline storage
+    template <typename ArgsT, typename... Inputs>
+    Node(NodeId id, std::in_place_t /*tag*/, ArgsT&& args,
+         const Inputs&... inputs)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - args_storage_ constructed in body
+        : id_(id), type_id_(detail::get_op_id<std::decay_t<ArgsT>>()), output_nodes_() {
+        static_assert(sizeof(ArgsT) <= sizeof(args_storage_), "Args too large for inline storage");
+        static_assert(sizeof...(Inputs) <= 4, "Too many inputs for inline storage");
+
+        (inputs_.push_back(inputs), ...);
+
+        new (args_storage_) std::decay_t<ArgsT>(std::forward<ArgsT>(args));
+        manage_args_ = &manage_args<std::decay_t<ArgsT>>;
     }
 
+    // The args are copied, moved and destroyed through their own type: a byte copy would leave
+    // args with inline containers (e.g. ReduceArgs::dims) pointing into the old node
+    Node(const Node& other);
+    Node(Node&& other) noexcept;
+    Node& operator=(const Node& other);
+    Node& operator=(Node&& other) noexcept;
+    ~Node();
+
     NodeId id() const;
     OpTypeId type_id() const;
 
@@ -79,12 +106,38 @@ class Node {
 
     void add_output_node(NodeId node_id);
 
+    // Swaps input `index` for another tensor of the same shape, e.g. a constant over the
+    // value the original input computed, so the graph behind it can be released
+    void replace_input(size_t index, const Tensor& input);
+
    private:
+    enum class ArgsAction : uint8_t { COPY, MOVE, DESTROY };
+    using ArgsManager = void (*)(ArgsAction action, void* destination, void* source);
+
+    // `source` is unused for DESTROY, which acts on `destination`
+    template <typename T>
+    static void manage_args(ArgsAction action, void* destination, void* source) {
+        switch (action) {
+            case ArgsAction::COPY:
+                new (destination) T(*static_cast<const T*>(source));
+                break;
+            case ArgsAction::MOVE:
+                new (destination) T(std::move(*static_cast<T*>(source)));
+                break;
+            case ArgsAction::DESTROY:
+                static_cast<T*>(destination)->~T();
+                break;
+            default:
+                break;
+        }
+    }
+
     NodeId id_;
     OpTypeId type_id_;
     SmallVector<Tensor, 4> inputs_;
     SmallVector<NodeId, 2> output_nodes_;
-    static constexpr size_t ARGS_STORAGE_SIZE = 256;
+    static constexpr size_t ARGS_STORAGE_SIZE = 128;
     alignas(std::max_align_t) char args_storage_
         [ARGS_STORAGE_SIZE];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Type erasure storage requires C-style array
+    ArgsManager manage_args_;
 };
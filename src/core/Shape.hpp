@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Tensor dimensions with their contiguous (row-major) strides and element count, computed
+// once whenever the dimensions change. Up to INLINE_RANK dimensions live inside the object, so
+// computing an output shape while building a graph never allocates; higher ranks spill the
+// dimensions and strides to the heap.
+class Shape {
+   public:
+    static constexpr size_t INLINE_RANK = 6;
+
+    Shape() = default;
+    Shape(std::initializer_list<uint32_t> dims) : Shape(dims.begin(), dims.size()) {}
+    Shape(const uint32_t* dims, size_t rank) {
+        reset(rank);
+        std::copy(dims, dims + rank, mutable_data());
+        update_strides();
+    }
+    Shape(const std::vector<uint32_t>& dims) : Shape(dims.data(), dims.size()) {}
+
+    Shape(const Shape& other)
+        : rank_(other.rank_), numel_(other.numel_), inline_dims_(other.inline_dims_),
+          inline_strides_(other.inline_strides_) {
+        if (other.spilled()) {
+            copy_spilled(other);
+        }
+    }
+
+    Shape(Shape&& other) noexcept
+        : rank_(other.rank_), numel_(other.numel_), inline_dims_(other.inline_dims_),
+          inline_strides_(other.inline_strides_), heap_dims_(std::move(other.heap_dims_)),
+          heap_strides_(std::move(other.heap_strides_)) {
+        other.rank_ = 0;
+        other.numel_ = 1;
+    }
+
+    Shape& operator=(const Shape& other) {
+        if (this != &other) {
+            rank_ = other.rank_;
+            numel_ = other.numel_;
+            inline_dims_ = other.inline_dims_;
+            inline_strides_ = other.inline_strides_;
+            if (other.spilled()) {
+                copy_spilled(other);
+            } else {
+                heap_dims_.reset();
+                heap_strides_.reset();
+            }
+        }
+        return *this;
+    }
+
+    Shape& operator=(Shape&& other) noexcept {
+        if (this != &other) {
+            rank_ = other.rank_;
+            numel_ = other.numel_;
+            inline_dims_ = other.inline_dims_;
+            inline_strides_ = other.inline_strides_;
+            heap_dims_ = std::move(other.heap_dims_);
+            heap_strides_ = std::move(other.heap_strides_);
+            other.rank_ = 0;
+            other.numel_ = 1;
+        }
+        return *this;
+    }
+
+    ~Shape() = default;
+
+    size_t rank() const { return rank_; }
+    bool empty() const { return rank_ == 0; }
+    bool spilled() const { return rank_ > INLINE_RANK; }  // Dimensions live on the heap
+    const uint32_t* data() const { return spilled() ? heap_dims_.get() : inline_dims_.data(); }
+    const uint32_t* begin() const { return data(); }
+    const uint32_t* end() const { return data() + rank_; }
+
+    uint32_t operator[](size_t dim) const { return data()[dim]; }  // NOLINT
+
+    // Element count and contiguous strides, in elements; the stride of the last dimension is 1
+    size_t numel() const { return numel_; }
+    const size_t* strides() const { return spilled() ? heap_strides_.get() : inline_strides_.data(); }
+    size_t stride(size_t dim) const { return strides()[dim]; }  // NOLINT
+
+    void set(size_t dim, uint32_t size) {
+        assert(dim < rank_);
+        mutable_data()[dim] = size;
+        update_strides();
+    }
+
+    void push_back(uint32_t dim) {
+        if (rank_ < INLINE_RANK) {
+            inline_dims_[rank_++] = dim;
+        } else {
+            std::vector<uint32_t> dims(begin(), end());
+            dims.push_back(dim);
+            reset(dims.size());
+            std::copy(dims.begin(), dims.end(), mutable_data());
+        }
+        update_strides();
+    }
+
+    // Removes dimension `dim`, shifting the later ones down
+    void erase(size_t dim) {
+        assert(dim < rank_);
+        uint32_t* dims = mutable_data();
+        std::copy(dims + dim + 1, dims + rank_, dims + dim);
+        if (rank_-- == INLINE_RANK + 1) {
+            std::copy(dims, dims + rank_, inline_dims_.begin());
+            heap_dims_.reset();
+            heap_strides_.reset();
+        }
+        update_strides();
+    }
+
+    std::vector<uint32_t> to_vector() const { return {begin(), end()}; }
+
+    bool operator==(const Shape& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+    bool operator!=(const Shape& other) const { return !(*this == other); }
+
+    // NumPy-style broadcast of two shapes, aligned at their last dimension
+    static Shape broadcast(const Shape& a, const Shape& b) {
+        Shape result;
+        result.reset(std::max(a.rank_, b.rank_));
+        uint32_t* dims = result.mutable_data();
+        for (size_t i = 0; i < result.rank_; ++i) {
+            uint32_t dim_a = i < a.rank_ ? a[a.rank_ - 1 - i] : 1;
+            uint32_t dim_b = i < b.rank_ ? b[b.rank_ - 1 - i] : 1;
+            if (dim_a != dim_b && dim_a != 1 && dim_b != 1) {
+                throw std::runtime_error("Incompatible shapes for broadcasting");
+            }
+            dims[result.rank_ - 1 - i] = std::max(dim_a, dim_b);
+        }
+        result.update_strides();
+        return result;
+    }
+
+   private:
+    size_t rank_ = 0;
+    size_t numel_ = 1;
+    std::array<uint32_t, INLINE_RANK> inline_dims_{};
+    std::array<size_t, INLINE_RANK> inline_strides_{};
+    std::unique_ptr<uint32_t[]> heap_dims_;   // NOLINT(cppcoreguidelines-avoid-c-arrays) - Only above INLINE_RANK
+    std::unique_ptr<size_t[]> heap_strides_;  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Only above INLINE_RANK
+
+    uint32_t* mutable_data() { return spilled() ? heap_dims_.get() : inline_dims_.data(); }
+
+    // Sets the rank, moving to heap storage above INLINE_RANK; the dimensions are left unset
+    void reset(size_t rank) {
+        rank_ = rank;
+        if (spilled()) {
+            heap_dims_ = std::make_unique<uint32_t[]>(rank);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+            heap_strides_ = std::make_unique<size_t[]>(rank);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        } else {
+            heap_dims_.reset();
+            heap_strides_.reset();
+        }
+    }
+
+    void copy_spilled(const Shape& other) {
+        heap_dims_ = std::make_unique<uint32_t[]>(rank_);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        heap_strides_ = std::make_unique<size_t[]>(rank_);  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        std::copy(other.heap_dims_.get(), other.heap_dims_.get() + rank_, heap_dims_.get());
+        std::copy(other.heap_strides_.get(), other.heap_strides_.get() + rank_, heap_strides_.get());
+    }
+
+    void update_strides() {
+        const uint32_t* dims = data();
+        size_t* strides = spilled() ? heap_strides_.get() : inline_strides_.data();
+        size_t stride = 1;
+        for (size_t i = rank_; i-- > 0;) {
+            strides[i] = stride;
+            stride *= dims[i];
+        }
+        numel_ = stride;
+    }
+};
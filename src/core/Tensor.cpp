@@ -8,6 +8,7 @@
 #include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include <spdlog/spdlog.h>
@@ -17,170 +18,169 @@ Tensor::Tensor()
     : state_(State::LAZY),
       producer_node_(0),
       output_index_(0),
-      rank_(0),
-      shape_{},
-      data_(nullptr),
-      numel_(0),
       is_constant_(false),
-      constant_data_(nullptr),
-      evaluation_in_progress_(false) {
+      evaluation_in_progress_(false),
+      numel_(0) {
 }
 
 // Create lazy tensor from node output
 Tensor::Tensor(
     NodeId producer_node_id, uint16_t output_index,
     std::initializer_list<uint32_t>
-        shape)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init,bugprone-easily-swappable-parameters) - shape_ initialized in body, parameters semantically different
+        shape)  // NOLINT(bugprone-easily-swappable-parameters) - Semantically different parameters
     : state_(State::LAZY),
       producer_node_(producer_node_id),
       output_index_(output_index),
-      rank_(static_cast<uint16_t>(shape.size())),
-      data_(nullptr),
-      numel_(0),
       is_constant_(false),
-      constant_data_(nullptr),
-      evaluation_in_progress_(false) {
-    assert(rank_ <= 4);
-    std::copy(
-        shape.begin(), shape.end(),
-        shape_);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    std::fill(shape_ + rank_, shape_ + 4,
-              1);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    numel_ = compute_numel();
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
 }
 
-// Create materialized tensor with shape only
 Tensor::Tensor(
-    std::initializer_list<uint32_t>
-        shape)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+    NodeId producer_node_id, uint16_t output_index,
+    const std::vector<uint32_t>&
+        shape)  // NOLINT(bugprone-easily-swappable-parameters) - Semantically different parameters
+    : state_(State::LAZY),
+      producer_node_(producer_node_id),
+      output_index_(output_index),
+      is_constant_(false),
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
+}
+
+Tensor::Tensor(NodeId producer_node_id, uint16_t output_index,
+               const Shape& shape)  // NOLINT(bugprone-easily-swappable-parameters) - Semantically different parameters
+    : state_(State::LAZY),
+      producer_node_(producer_node_id),
+      output_index_(output_index),
+      is_constant_(false),
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
+}
+
+// Create materialized tensor with shape only
+Tensor::Tensor(std::initializer_list<uint32_t> shape)
     : state_(State::MATERIALIZED),
       producer_node_(0),
       output_index_(0),
-      rank_(static_cast<uint16_t>(shape.size())),
       is_constant_(false),
-      constant_data_(nullptr),
-      evaluation_in_progress_(false) {
-    assert(rank_ <= 4);
-    std::copy(
-        shape.begin(), shape.end(),
-        shape_);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    std::fill(shape_ + rank_, shape_ + 4,
-              1);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    numel_ = compute_numel();
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
     allocate_data();
 }
 
-Tensor::Tensor(
-    const std::vector<uint32_t>&
-        shape)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+Tensor::Tensor(const std::vector<uint32_t>& shape)
     : state_(State::MATERIALIZED),
       producer_node_(0),
       output_index_(0),
-      rank_(static_cast<uint16_t>(shape.size())),
       is_constant_(false),
-      constant_data_(nullptr),
-      evaluation_in_progress_(false) {
-    assert(rank_ <= 4);
-    std::copy(
-        shape.begin(), shape.end(),
-        shape_);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    std::fill(shape_ + rank_, shape_ + 4,
-              1);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    numel_ = compute_numel();
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
     allocate_data();
 }
 
-Tensor::Tensor(
-    const std::vector<uint32_t>& shape,
-    const std::vector<float>&
-        data)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+Tensor::Tensor(const Shape& shape)
     : state_(State::MATERIALIZED),
       producer_node_(0),
       output_index_(0),
-      rank_(static_cast<uint16_t>(shape.size())),
       is_constant_(false),
-      constant_data_(nullptr),
-      evaluation_in_progress_(false) {
-    assert(rank_ <= 4);
-    std::copy(
-        shape.begin(), shape.end(),
-        shape_);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    std::fill(shape_ + rank_, shape_ + 4,
-              1);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    numel_ = compute_numel();
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
     allocate_data();
+}
 
+Tensor::Tensor(const std::vector<uint32_t>& shape, const std::vector<float>& data) : Tensor(shape) {
     // Copy data
-    std::copy(data.begin(), data.end(), data_.get());
+    std::copy(data.begin(), data.end(), owned_data());
 }
 
 // Create constant tensor
-Tensor::Tensor(
-    void* data,
-    std::initializer_list<uint32_t>
-        shape)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+Tensor::Tensor(void* data, std::initializer_list<uint32_t> shape)
+    : state_(State::MATERIALIZED),
+      producer_node_(0),
+      output_index_(0),
+      is_constant_(true),
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
+    storage_.constant = data;
+}
+
+Tensor::Tensor(void* data, const std::vector<uint32_t>& shape)
     : state_(State::MATERIALIZED),
       producer_node_(0),
       output_index_(0),
-      rank_(static_cast<uint16_t>(shape.size())),
-      data_(nullptr),
-      numel_(0),
       is_constant_(true),
-      constant_data_(data),
-      evaluation_in_progress_(false) {
-    assert(rank_ <= 4);
-    std::copy(
-        shape.begin(), shape.end(),
-        shape_);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    std::fill(shape_ + rank_, shape_ + 4,
-              1);  // NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay) - Safe array access with known bounds
-    numel_ = compute_numel();
+      evaluation_in_progress_(false),
+      shape_(shape),
+      numel_(shape_.numel()) {
+    storage_.constant = data;
+}
+
+// Create constant tensor owning external memory through a deleter
+Tensor::Tensor(void* data, std::initializer_list<uint32_t> shape, Deleter deleter)
+    : Tensor(data, std::vector<uint32_t>(shape), std::move(deleter)) {
+}
+
+Tensor::Tensor(void* data, const std::vector<uint32_t>& shape, Deleter deleter) : Tensor(data, shape) {
+    if (deleter) {
+        external_owner_ = std::shared_ptr<void>(data, std::move(deleter));
+    }
+}
+
+// Create constant view into memory kept alive by a shared owner
+Tensor::Tensor(std::shared_ptr<void> owner, void* data, const std::vector<uint32_t>& shape) : Tensor(data, shape) {
+    external_owner_ = std::move(owner);
+}
+
+// Create typed constant tensors
+Tensor::Tensor(void* data, const std::vector<uint32_t>& shape, DataType dtype) : Tensor(data, shape) {
+    dtype_ = dtype;
+}
+
+Tensor::Tensor(std::shared_ptr<void> owner, void* data, const std::vector<uint32_t>& shape, DataType dtype)
+    : Tensor(std::move(owner), data, shape) {
+    dtype_ = dtype;
 }
 
 // Copy constructor
-Tensor::Tensor(
-    const Tensor&
-        other)  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+Tensor::Tensor(const Tensor& other)
     : state_(other.state_),
       producer_node_(other.producer_node_),
       output_index_(other.output_index_),
-      rank_(other.rank_),
-      numel_(other.numel_),
       is_constant_(other.is_constant_),
-      constant_data_(other.constant_data_),
-      evaluation_in_progress_(false) {
-    std::copy(other.shape_, other.shape_ + 4, shape_);
+      dtype_(other.dtype_),
+      read_only_(other.read_only_),
+      evaluation_in_progress_(false),
+      shape_(other.shape_),
+      numel_(other.numel_),
+      external_owner_(other.external_owner_) {
     copy_from_other(other);
 }
 
 // Move constructor
-Tensor::Tensor(
-    Tensor&&
-        other) noexcept  // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) - shape_ initialized in body
+Tensor::Tensor(Tensor&& other) noexcept
     : state_(other.state_),
       producer_node_(other.producer_node_),
       output_index_(other.output_index_),
-      rank_(other.rank_),
-      numel_(other.numel_),
       is_constant_(other.is_constant_),
-      constant_data_(other.constant_data_),
-      evaluation_in_progress_(false) {
-    std::copy(other.shape_, other.shape_ + 4, shape_);
+      dtype_(other.dtype_),
+      read_only_(other.read_only_),
+      evaluation_in_progress_(false),
+      numel_(other.numel_) {
     move_from_other(std::move(other));
 }
 
-// Copy assignment
+// Copy assignment: copy first, so a failed allocation leaves this tensor as it was
 Tensor& Tensor::operator=(const Tensor& other) {
     if (this != &other) {
-        state_ = other.state_;
-        producer_node_ = other.producer_node_;
-        output_index_ = other.output_index_;
-        rank_ = other.rank_;
-        numel_ = other.numel_;
-        is_constant_ = other.is_constant_;
-        constant_data_ = other.constant_data_;
-        std::copy(other.shape_, other.shape_ + 4, shape_);
-        copy_from_other(other);
+        *this = Tensor(other);
     }
     return *this;
 }
@@ -188,21 +188,18 @@ Tensor& Tensor::operator=(const Tensor& other) {
 // Move assignment
 Tensor& Tensor::operator=(Tensor&& other) noexcept {
     if (this != &other) {
-        state_ = other.state_;
-        producer_node_ = other.producer_node_;
-        output_index_ = other.output_index_;
-        rank_ = other.rank_;
-        numel_ = other.numel_;
-        is_constant_ = other.is_constant_;
-        constant_data_ = other.constant_data_;
-        std::copy(other.shape_, other.shape_ + 4, shape_);
+        release_storage();
+        dtype_ = other.dtype_;
+        read_only_ = other.read_only_;
         move_from_other(std::move(other));
     }
     return *this;
 }
 
 // Destructor
-Tensor::~Tensor() = default;
+Tensor::~Tensor() {
+    release_storage();
+}
 
 // State information
 bool Tensor::is_null() const {
@@ -224,17 +221,15 @@ uint16_t Tensor::output_index() const {
 
 // Shape information
 const uint32_t* Tensor::shape() const {
-    return shape_;
+    return shape_.data();
 }
 
 uint16_t Tensor::rank() const {
-    return rank_;
+    return static_cast<uint16_t>(shape_.rank());
 }
 
 uint32_t Tensor::size(size_t dim) const {
-    return dim < rank_
-               ? shape_[dim]
-               : 1;  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+    return dim < shape_.rank() ? shape_[dim] : 1;
 }
 
 size_t Tensor::total_elements() const {
@@ -245,30 +240,47 @@ bool Tensor::is_scalar() const {
     return total_elements() == 1;
 }
 
+bool Tensor::uses_inline_storage() const {
+    return state_ == State::MATERIALIZED && !is_constant_ && numel_ > 0 && numel_ <= INLINE_CAPACITY;
+}
+
 // Data access
 float* Tensor::data_ptr() {
+    if (dtype_ != DataType::FLOAT32) {
+        throw std::runtime_error(std::string("Tensor holds ") + data_type_name(dtype_) + " data, not float32");
+    }
     if (state_ == State::LAZY) {
         eval();
     }
 
     if (is_constant_) {
-        return static_cast<float*>(constant_data_);
+        return static_cast<float*>(storage_.constant);
     }
 
-    return data_.get();
+    return owned_data();
 }
 
 const float* Tensor::const_data_ptr() const {
+    if (dtype_ != DataType::FLOAT32) {
+        throw std::runtime_error(std::string("Tensor holds ") + data_type_name(dtype_) + " data, not float32");
+    }
     if (state_ == State::LAZY) {
         const_cast<Tensor*>(this)
             ->eval();  // NOLINT(cppcoreguidelines-pro-type-const-cast) - Lazy evaluation requires mutable access
     }
 
     if (is_constant_) {
-        return static_cast<const float*>(constant_data_);
+        return static_cast<const float*>(storage_.constant);
     }
 
-    return data_.get();
+    return owned_data();
+}
+
+const void* Tensor::raw_data() const {
+    if (is_constant_) {
+        return storage_.constant;
+    }
+    return const_data_ptr();
 }
 
 std::vector<float> Tensor::to_vector() const {
@@ -301,11 +313,10 @@ Tensor::GraphNode Tensor::build_graph_node(int max_depth) const {
         node.op_name = "CONSTANT";
         std::ostringstream shape_str;
         shape_str << "shape=[";
-        for (int i = 0; i < rank_; ++i) {
+        for (size_t i = 0; i < shape_.rank(); ++i) {
             if (i > 0)
                 shape_str << ", ";
-            shape_str << shape_
-                    [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+            shape_str << shape_[i];
         }
         shape_str << "]";
         node.args.push_back(shape_str.str());
@@ -323,11 +334,10 @@ Tensor::GraphNode Tensor::build_graph_node(int max_depth) const {
         node.op_name = "MATERIALIZED";
         std::ostringstream shape_str;
         shape_str << "shape=[";
-        for (int i = 0; i < rank_; ++i) {
+        for (size_t i = 0; i < shape_.rank(); ++i) {
             if (i > 0)
                 shape_str << ", ";
-            shape_str << shape_
-                    [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+            shape_str << shape_[i];
         }
         shape_str << "]";
         node.args.push_back(shape_str.str());
@@ -350,11 +360,10 @@ Tensor::GraphNode Tensor::build_graph_node(int max_depth) const {
     // Add shape information
     std::ostringstream shape_str;
     shape_str << "shape=[";
-    for (int i = 0; i < rank_; ++i) {
+    for (size_t i = 0; i < shape_.rank(); ++i) {
         if (i > 0)
             shape_str << ", ";
-        shape_str << shape_
-                [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+        shape_str << shape_[i];
     }
     shape_str << "]";
     node.args.push_back(shape_str.str());
@@ -445,11 +454,10 @@ void Tensor::print() const {
     // Build shape string
     std::ostringstream shape_stream;
     shape_stream << "Tensor shape: [";
-    for (int i = 0; i < rank_; ++i) {
+    for (size_t i = 0; i < shape_.rank(); ++i) {
         if (i > 0)
             shape_stream << ", ";
-        shape_stream << shape_
-                [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+        shape_stream << shape_[i];
     }
     shape_stream << "]";
     spdlog::info(shape_stream.str());
@@ -483,10 +491,7 @@ Tensor Tensor::reshape(const std::vector<uint32_t>& new_shape) const {
     }
 
     Tensor result = *this;
-    result.rank_ = static_cast<uint16_t>(new_shape.size());
-    assert(result.rank_ <= 4);
-    std::copy(new_shape.begin(), new_shape.end(), result.shape_);
-    std::fill(result.shape_ + result.rank_, result.shape_ + 4, 1);
+    result.shape_ = Shape(new_shape);
 
     return result;
 }
@@ -494,24 +499,7 @@ Tensor Tensor::reshape(const std::vector<uint32_t>& new_shape) const {
 // Broadcasting helpers
 std::vector<uint32_t> Tensor::broadcast_shapes(const std::vector<uint32_t>& shape1,
                                                const std::vector<uint32_t>& shape2) {
-    size_t max_rank = std::max(shape1.size(), shape2.size());
-    std::vector<uint32_t> result(max_rank);
-
-    for (size_t i = 0; i < max_rank; ++i) {
-        size_t idx1 = shape1.size() - 1 - i;
-        size_t idx2 = shape2.size() - 1 - i;
-
-        uint32_t dim1 = (idx1 < shape1.size()) ? shape1[idx1] : 1;
-        uint32_t dim2 = (idx2 < shape2.size()) ? shape2[idx2] : 1;
-
-        if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
-            throw std::runtime_error("Incompatible shapes for broadcasting");
-        }
-
-        result[max_rank - 1 - i] = std::max(dim1, dim2);
-    }
-
-    return result;
+    return Shape::broadcast(Shape(shape1), Shape(shape2)).to_vector();
 }
 
 bool Tensor::can_broadcast(const std::vector<uint32_t>& shape1, const std::vector<uint32_t>& shape2) {
@@ -524,20 +512,38 @@ bool Tensor::can_broadcast(const std::vector<uint32_t>& shape1, const std::vecto
 }
 
 // Helper methods
+bool Tensor::owns_heap_data() const {
+    return state_ == State::MATERIALIZED && !is_constant_ && numel_ > INLINE_CAPACITY;
+}
+
+void Tensor::release_storage() {
+    if (owns_heap_data()) {
+        delete[] storage_.heap;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+    storage_.constant = nullptr;
+}
+
+// Zero-filled storage for a non-constant tensor that holds none yet
 void Tensor::allocate_data() {
-    if (numel_ > 0) {
-        data_ = std::make_unique<float[]>(
-            numel_);  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Dynamic array for tensor data
+    if (numel_ > INLINE_CAPACITY) {
+        storage_.heap = new float[numel_]();  // NOLINT(cppcoreguidelines-owning-memory)
+    } else {
+        std::fill(storage_.inline_floats, storage_.inline_floats + numel_, 0.0f);
     }
 }
 
-size_t Tensor::compute_numel() const {
-    size_t total = 1;
-    for (size_t i = 0; i < rank_; ++i) {
-        total *= shape_
-            [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+float* Tensor::owned_data() {
+    if (numel_ == 0) {
+        return nullptr;
     }
-    return total;
+    return numel_ <= INLINE_CAPACITY ? storage_.inline_floats : storage_.heap;
+}
+
+const float* Tensor::owned_data() const {
+    if (numel_ == 0) {
+        return nullptr;
+    }
+    return numel_ <= INLINE_CAPACITY ? storage_.inline_floats : storage_.heap;
 }
 
 void Tensor::eval_impl() const {
@@ -586,58 +592,61 @@ void Tensor::eval_impl() const {
 void Tensor::copy_from_other(const Tensor& other) {
     if (other.state_ == State::MATERIALIZED) {
         if (other.is_constant_) {
-            constant_data_ = other.constant_data_;
+            storage_.constant = other.storage_.constant;
+        } else if (numel_ <= INLINE_CAPACITY) {
+            std::copy(other.storage_.inline_floats, other.storage_.inline_floats + numel_, storage_.inline_floats);
         } else {
-            data_ = std::make_unique<float[]>(
-                numel_);  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Dynamic array for tensor data
-            if (other.data_) {
-                std::copy(other.data_.get(), other.data_.get() + numel_, data_.get());
-            }
+            storage_.heap = new float[numel_];  // NOLINT(cppcoreguidelines-owning-memory)
+            std::copy(other.storage_.heap, other.storage_.heap + numel_, storage_.heap);
         }
     } else {
-        data_ = nullptr;
-        constant_data_ = nullptr;
+        storage_.constant = nullptr;
+        external_owner_ = nullptr;
     }
 }
 
+// Takes over `other`'s data; this tensor must hold no storage of its own
 void Tensor::move_from_other(
     Tensor&&
         other) {  // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved) - Function resets moved-from object to valid state
     // Move all members from other
-    state_ = std::move(other.state_);
-    producer_node_ = std::move(other.producer_node_);
-    output_index_ = std::move(other.output_index_);
-    rank_ = std::move(other.rank_);
-    numel_ = std::move(other.numel_);
-    is_constant_ = std::move(other.is_constant_);
-    evaluation_in_progress_ = other.evaluation_in_progress_.load();
-
-    // Move array data
-    std::copy(other.shape_, other.shape_ + 4, shape_);
+    state_ = other.state_;
+    producer_node_ = other.producer_node_;
+    output_index_ = other.output_index_;
+    shape_ = std::move(other.shape_);
+    numel_ = other.numel_;
+    is_constant_ = other.is_constant_;
+    evaluation_in_progress_.store(other.evaluation_in_progress_.load(std::memory_order_relaxed),
+                                  std::memory_order_relaxed);
 
     if (other.state_ == State::MATERIALIZED) {
         if (other.is_constant_) {
-            constant_data_ = other.constant_data_;
-            data_ = nullptr;
+            storage_.constant = other.storage_.constant;
+            external_owner_ = std::move(other.external_owner_);
         } else {
-            data_ = std::move(other.data_);
-            constant_data_ = nullptr;
+            if (numel_ <= INLINE_CAPACITY) {
+                std::copy(other.storage_.inline_floats, other.storage_.inline_floats + numel_,
+                          storage_.inline_floats);
+            } else {
+                storage_.heap = other.storage_.heap;
+            }
+            external_owner_ = nullptr;
         }
     } else {
-        data_ = nullptr;
-        constant_data_ = nullptr;
+        storage_.constant = nullptr;
+        external_owner_ = nullptr;
     }
 
-    // Reset other tensor to valid state
+    // Reset other tensor to valid state; the heap data, if any, now belongs to this tensor
+    other.storage_.constant = nullptr;
     other.state_ = State::LAZY;
     other.producer_node_ = 0;
     other.output_index_ = 0;
-    other.rank_ = 0;
     other.numel_ = 0;
     other.is_constant_ = false;
-    other.constant_data_ = nullptr;
-    other.evaluation_in_progress_ = false;
-    std::fill(other.shape_, other.shape_ + 4, 1);
+    other.external_owner_ = nullptr;
+    other.read_only_ = false;
+    other.evaluation_in_progress_.store(false, std::memory_order_relaxed);
 }
 
 // Stream operator implementation
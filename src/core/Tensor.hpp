@@ -1,8 +1,10 @@
 #pragma once
 #include "OpArgs.hpp"
+#include "Shape.hpp"
 #include "common.hpp"
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -29,12 +31,35 @@ class Tensor {
     Tensor(NodeId producer_node_id, uint16_t output_index,
            std::initializer_list<uint32_t>
                shape);  // NOLINT(bugprone-easily-swappable-parameters) - Semantically different parameters
+    Tensor(NodeId producer_node_id, uint16_t output_index, const std::vector<uint32_t>& shape);
+    Tensor(NodeId producer_node_id, uint16_t output_index, const Shape& shape);
 
     // Create materialized tensor with data
     Tensor(std::initializer_list<uint32_t> shape);
     Tensor(const std::vector<uint32_t>& shape);
+    explicit Tensor(const Shape& shape);
     Tensor(const std::vector<uint32_t>& shape, const std::vector<float>& data);
-    Tensor(void* data, std::initializer_list<uint32_t> shape);  // For constants
+
+    // Constant tensors over external memory. Without a deleter the memory is borrowed
+    // and the caller must keep it alive for as long as any copy of the tensor exists.
+    Tensor(void* data, std::initializer_list<uint32_t> shape);
+    Tensor(void* data, const std::vector<uint32_t>& shape);
+
+    // Zero-copy ingestion of external memory (mmap regions, numpy arrays, shared memory, ...).
+    // The deleter runs once the last copy of the tensor - including copies held by graph
+    // nodes, tape operations and evaluation caches - is destroyed.
+    using Deleter = std::function<void(void*)>;
+    Tensor(void* data, std::initializer_list<uint32_t> shape, Deleter deleter);
+    Tensor(void* data, const std::vector<uint32_t>& shape, Deleter deleter);
+
+    // View into memory kept alive by an existing owner, e.g. one tensor per weight
+    // inside a single mapped file. `data` must stay valid while `owner` is alive.
+    Tensor(std::shared_ptr<void> owner, void* data, const std::vector<uint32_t>& shape);
+
+    // Typed constants over external memory, e.g. int32/int64 indices for gather and
+    // embedding_bag. The float accessors (data_ptr, const_data_ptr, ...) reject other types.
+    Tensor(void* data, const std::vector<uint32_t>& shape, DataType dtype);
+    Tensor(std::shared_ptr<void> owner, void* data, const std::vector<uint32_t>& shape, DataType dtype);
 
     // Copy/move constructors
     Tensor(const Tensor& other);
@@ -50,6 +75,13 @@ class Tensor {
     bool is_lazy() const { return state_ == State::LAZY; }
     bool is_evaluated() const { return state_ == State::MATERIALIZED; }
     bool is_constant() const { return is_constant_; }
+    bool owns_external_memory() const { return external_owner_ != nullptr; }
+    const std::shared_ptr<void>& external_owner() const { return external_owner_; }
+
+    // Constants over memory that must not be written, such as read-only mappings. In-place
+    // updates (the optimizer steps) reject them instead of faulting.
+    bool is_read_only() const { return read_only_; }
+    void mark_read_only() { read_only_ = true; }
     bool is_null() const;
     explicit operator bool() const;
 
@@ -60,13 +92,24 @@ class Tensor {
     // Shape information (works for both states)
     const uint32_t* shape() const;
     uint16_t rank() const;
+    const Shape& dims() const { return shape_; }  // Also gives the contiguous strides
     uint32_t size(size_t dim) const;
     size_t total_elements() const;
     bool is_scalar() const;
+    DataType dtype() const { return dtype_; }
+    size_t nbytes() const { return numel_ * data_type_size(dtype_); }
+
+    // Materialized tensors of up to INLINE_CAPACITY floats keep their data inside the Tensor
+    // object instead of on the heap, so scalars, biases and per-row statistics are created and
+    // copied without touching the allocator. Their data pointer moves with the object: take it
+    // again after the tensor is moved.
+    static constexpr size_t INLINE_CAPACITY = 16;
+    bool uses_inline_storage() const;
 
     // Data access (requires materialization for lazy tensors)
     float* data_ptr();
     const float* const_data_ptr() const;
+    const void* raw_data() const;  // Untyped view of the data, valid for every dtype
     std::vector<float> to_vector() const;
 
     void eval();
@@ -100,31 +143,41 @@ class Tensor {
     static bool can_broadcast(const std::vector<uint32_t>& shape1, const std::vector<uint32_t>& shape2);
 
    private:
+    // Small fields first, so they share one word ahead of the shape
     State state_;
 
     // Lazy state data
     NodeId producer_node_;
     uint16_t output_index_;
 
-    // Shape information (common to both states)
-    uint16_t rank_;
-    uint32_t shape_[4];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Fixed-size tensor shape storage
-
-    // Materialized state data
-    std::unique_ptr<float[]> data_;  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Dynamic array for tensor data
-    size_t numel_;
-
     // Constant flag
     bool is_constant_;
-    void* constant_data_;  // For constants only
+    DataType dtype_ = DataType::FLOAT32;  // Non-float types only occur on constants
+    bool read_only_ = false;              // Constant memory that must not be written
 
-    // Evaluation cache
-    mutable std::shared_ptr<Tensor> evaluation_cache_;
+    // Evaluation guard
     mutable std::atomic<bool> evaluation_in_progress_;
 
+    // Shape information (common to both states)
+    Shape shape_;
+    size_t numel_;
+
+    // Materialized data. One member is live, chosen by state and size: `constant` for
+    // constants, `inline_floats` for other tensors of up to INLINE_CAPACITY elements, `heap`
+    // (owned, from new[]) for larger ones. Lazy tensors hold none.
+    union Storage {
+        void* constant = nullptr;
+        float* heap;
+        alignas(16) float inline_floats[INLINE_CAPACITY];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    } storage_;
+    std::shared_ptr<void> external_owner_;  // Keeps external constant memory alive (null when borrowed)
+
     // Helper methods
+    bool owns_heap_data() const;
+    void release_storage();  // Frees owned heap data; the tensor must be re-initialized after
     void allocate_data();
-    size_t compute_numel() const;
+    float* owned_data();
+    const float* owned_data() const;
     void eval_impl() const;
     void copy_from_other(const Tensor& other);
     void move_from_other(Tensor&& other);
@@ -26,6 +26,25 @@ using NodeId = uint32_t;
 // Constants
 constexpr NodeId INVALID_NODE_ID = 0;
 
+// Element types. Computation is float32; the integer types describe index tensors
+// (gather, embedding_bag), which are constants over external memory.
+enum class DataType : uint8_t { FLOAT32, INT32, INT64 };
+
+inline size_t data_type_size(DataType dtype) {
+    return dtype == DataType::INT64 ? sizeof(int64_t) : sizeof(int32_t);
+}
+
+inline const char* data_type_name(DataType dtype) {
+    switch (dtype) {
+        case DataType::INT32:
+            return "int32";
+        case DataType::INT64:
+            return "int64";
+        default:
+            return "float32";
+    }
+}
+
 // Use Boost's small_vector for efficient small collections
 template <typename T, size_t N = 4>
 using SmallVector = boost::container::small_vector<T, N>;
@@ -0,0 +1,231 @@
+#include "autodiff.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Constant filled with `value`, owning its memory
+Tensor filled_constant(const std::vector<uint32_t>& shape, float value) {
+    size_t numel = 1;
+    for (uint32_t dim : shape) {
+        numel *= dim;
+    }
+    std::shared_ptr<float> data(new float[numel], std::default_delete<float[]>());
+    std::fill(data.get(), data.get() + numel, value);
+    return Tensor(std::static_pointer_cast<void>(data), data.get(), shape);
+}
+
+std::vector<uint32_t> shape_of(const Tensor& tensor) {
+    return std::vector<uint32_t>(tensor.shape(), tensor.shape() + tensor.rank());
+}
+
+// Sums a gradient of `grad`'s shape down to the shape of an operand that was broadcast into it
+Tensor reduce_to_shape(const Tensor& grad, const Tensor& operand) {
+    if (shape_of(grad) == shape_of(operand)) {
+        return grad;
+    }
+    if (grad.rank() != operand.rank()) {
+        throw std::runtime_error("grad: broadcasting across ranks is not differentiable");
+    }
+    std::vector<int32_t> dims;
+    for (size_t i = 0; i < grad.rank(); ++i) {
+        if (operand.size(i) == 1 && grad.size(i) != 1) {
+            dims.push_back(static_cast<int32_t>(i));
+        }
+    }
+    return reduce_sum(grad, dims, true);
+}
+
+class GradientBuilder {
+   public:
+    GradientBuilder(const Tensor& loss, const std::vector<Tensor>& params) {
+        for (const Tensor& param : params) {
+            if (param.is_lazy()) {
+                if (param.output_index() != 0) {
+                    throw std::runtime_error("grad: parameters must be the first output of their operation");
+                }
+                param_nodes_.insert(param.producer_node());
+            } else if (param.is_constant()) {
+                param_data_.insert(param.raw_data());
+            } else {
+                throw std::runtime_error("grad: parameters must be constant or lazy tensors");
+            }
+        }
+
+        // Forward order of everything the loss depends on, and the tensor each node produces
+        auto& ctx = Context::instance();
+        order_ = ctx.topological_sort(ctx.get_dependencies({loss}));
+        outputs_.emplace(loss.producer_node(), loss);
+        for (NodeId node_id : order_) {
+            const Node* node = ctx.get_node(node_id);
+            bool needed = param_nodes_.count(node_id) > 0;
+            for (const Tensor& input : node->inputs()) {
+                if (input.is_lazy()) {
+                    outputs_.emplace(input.producer_node(), input);
+                }
+                needed = needed || depends_on_params(input);
+            }
+            if (needed) {
+                needed_.insert(node_id);
+            }
+        }
+    }
+
+    // Walks the graph from the loss back to the parameters
+    void backpropagate(const Tensor& loss) {
+        node_grads_.emplace(loss.producer_node(), filled_constant(shape_of(loss), 1.0f));
+        for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+            auto g = node_grads_.find(*it);
+            if (g != node_grads_.end() && needed_.count(*it) > 0) {
+                apply_rule(*it, Tensor(g->second));
+            }
+        }
+    }
+
+    Tensor gradient(const Tensor& param) const {
+        if (param.is_lazy()) {
+            auto it = node_grads_.find(param.producer_node());
+            if (it != node_grads_.end()) {
+                return it->second;
+            }
+        } else {
+            auto it = constant_grads_.find(param.raw_data());
+            if (it != constant_grads_.end()) {
+                return it->second;
+            }
+        }
+        return filled_constant(shape_of(param), 0.0f);
+    }
+
+   private:
+    bool depends_on_params(const Tensor& tensor) const {
+        if (tensor.is_lazy()) {
+            return needed_.count(tensor.producer_node()) > 0;
+        }
+        return tensor.is_constant() && param_data_.count(tensor.raw_data()) > 0;
+    }
+
+    // Adds a contribution to a tensor's gradient; repeated contributions accumulate through
+    // Add nodes, which the memory planner runs in place
+    void accumulate(const Tensor& tensor, const Tensor& contribution) {
+        if (!depends_on_params(tensor)) {
+            return;
+        }
+        auto emplace = [&](auto& grads, const auto& key) {
+            auto [it, inserted] = grads.emplace(key, contribution);
+            if (!inserted) {
+                it->second = add(it->second, contribution);
+            }
+        };
+        if (tensor.is_lazy()) {
+            emplace(node_grads_, tensor.producer_node());
+        } else {
+            emplace(constant_grads_, tensor.raw_data());
+        }
+    }
+
+    // Vector-Jacobian product of one node: turns the gradient of its output into
+    // contributions to the gradients of its inputs
+    void apply_rule(NodeId node_id, const Tensor& g) {
+        // Creating gradient nodes may move the graph's node storage, so nothing is read from
+        // `node` after the first one is made
+        const Node& node = *Context::instance().get_node(node_id);
+        SmallVector<Tensor, 4> inputs = node.inputs();
+        bool has_inputs_to_reach = false;
+        for (const Tensor& input : inputs) {
+            has_inputs_to_reach = has_inputs_to_reach || depends_on_params(input);
+        }
+        if (!has_inputs_to_reach) {
+            return;  // A parameter itself, with nothing to differentiate below it
+        }
+
+        if (const auto* matmul_args = node.try_as<MatMulArgs>()) {
+            const Tensor& a = inputs[0];
+            const Tensor& b = inputs[1];
+            bool ta = matmul_args->transpose_a;
+            bool tb = matmul_args->transpose_b;
+            if (depends_on_params(a)) {
+                accumulate(a, ta ? matmul(b, g, tb, true) : matmul(g, b, false, !tb));
+            }
+            if (depends_on_params(b)) {
+                accumulate(b, tb ? matmul(g, a, true, ta) : matmul(a, g, !ta, false));
+            }
+        } else if (node.is<AddArgs>()) {
+            for (const Tensor& input : inputs) {
+                if (depends_on_params(input)) {
+                    accumulate(input, reduce_to_shape(g, input));
+                }
+            }
+        } else if (node.is<MultiplyArgs>()) {
+            for (size_t i = 0; i < 2; ++i) {
+                if (depends_on_params(inputs[i])) {
+                    accumulate(inputs[i], reduce_to_shape(multiply(g, inputs[1 - i]), inputs[i]));
+                }
+            }
+        } else if (node.is<ReLUArgs>()) {
+            accumulate(inputs[0], relu_backward(g, outputs_.at(node_id)));
+        } else if (const auto* reduce_args = node.try_as<ReduceArgs>()) {
+            if (reduce_args->type != ReduceArgs::Type::SUM) {
+                throw std::runtime_error("grad: only sum reductions are differentiable");
+            }
+            std::vector<int32_t> dims(reduce_args->dims.begin(), reduce_args->dims.end());
+            accumulate(inputs[0], reduce_sum_backward(g, shape_of(inputs[0]), dims));
+        } else if (const auto* mlp_args = node.try_as<FusedMLPArgs>()) {
+            // output = act(input @ weights + bias)
+            bool has_relu = mlp_args->has_relu;
+            const Tensor& input = inputs[0];
+            const Tensor& weights = inputs[1];
+            const Tensor& bias = inputs[2];
+            Tensor pre = has_relu ? relu_backward(g, outputs_.at(node_id)) : g;
+            if (depends_on_params(input)) {
+                accumulate(input, matmul(pre, weights, false, true));
+            }
+            if (depends_on_params(weights)) {
+                accumulate(weights, matmul(input, pre, true, false));
+            }
+            if (depends_on_params(bias)) {
+                accumulate(bias, reduce_sum(pre, {0}, bias.rank() == 2));
+            }
+        } else {
+            throw std::runtime_error("grad: no gradient rule for " + std::string(node.op_name()));
+        }
+    }
+
+    std::unordered_set<NodeId> param_nodes_;
+    std::unordered_set<const void*> param_data_;
+    std::vector<NodeId> order_;
+    std::unordered_map<NodeId, Tensor> outputs_;
+    std::unordered_set<NodeId> needed_;  // Nodes with a parameter at or below them
+    std::unordered_map<NodeId, Tensor> node_grads_;
+    std::unordered_map<const void*, Tensor> constant_grads_;
+};
+
+}  // namespace
+
+std::vector<Tensor> grad(const Tensor& loss, const std::vector<Tensor>& params) {
+    if (!loss.is_lazy()) {
+        throw std::runtime_error("grad: loss must be computed by the graph");
+    }
+    if (loss.total_elements() != 1) {
+        throw std::runtime_error("grad: loss must hold a single value, got " + std::to_string(loss.total_elements()));
+    }
+
+    GradientBuilder builder(loss, params);
+    builder.backpropagate(loss);
+
+    std::vector<Tensor> grads;
+    grads.reserve(params.size());
+    for (const Tensor& param : params) {
+        grads.push_back(builder.gradient(param));
+    }
+    return grads;
+}
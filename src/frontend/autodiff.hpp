@@ -0,0 +1,18 @@
+#pragma once
+#include "Tensor.hpp"
+
+#include <vector>
+
+// Reverse-mode differentiation of the lazy graph.
+//
+// grad(loss, params) returns d(loss)/d(param) for each parameter, as lazy tensors of the
+// parameters' shapes. The gradients are ordinary graph nodes built from vector-Jacobian
+// products of the operations between the parameters and the loss (MatMul, Add, Multiply,
+// ReLU, sum reductions and FusedMLP), walked in reverse; a tensor read by several operations
+// gets the sum of their contributions. Evaluating the gradients runs the forward operations
+// they need and the backward ones as a single tape.
+//
+// Parameters are constant tensors (matched by the memory they wrap) or lazy tensors of the
+// graph. `loss` must hold a single value. A parameter the loss does not depend on gets a zero
+// gradient; an operation without a rule on the way to a parameter throws std::runtime_error.
+std::vector<Tensor> grad(const Tensor& loss, const std::vector<Tensor>& params);
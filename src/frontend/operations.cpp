@@ -1,6 +1,8 @@
 #include "operations.hpp"
 
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 
 // Helper to create tensors from node with multiple outputs
 std::vector<Tensor> make_output_tensors(
@@ -16,17 +18,7 @@ std::vector<Tensor> make_output_tensors(
                 ? shapes[i]
                 : std::vector<uint32_t>{
                       1};  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
-        // Convert vector to initializer_list format
-        assert(shape.size() <= 4);
-        uint32_t shape_array[4] = {
-            1, 1, 1,
-            1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-        for (size_t j = 0; j < shape.size(); ++j) {
-            shape_array[j] = shape
-                [j];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
-        }
-        Tensor tensor(producer_node_id, static_cast<uint16_t>(i),
-                      {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+        Tensor tensor(producer_node_id, static_cast<uint16_t>(i), shape);
         outputs.push_back(tensor);
     }
 
@@ -40,11 +32,8 @@ std::vector<Tensor> split(const Tensor& input, int64_t split_size, int32_t dim)
     args.split_size = split_size;
     args.dim = dim;
 
-    // Create input list
-    SmallVector<Tensor, 2> inputs{input};
-
     // Create node in global context
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input);
 
     // Calculate output shapes (simplified - you'd compute real shapes based on input)
     size_t input_size = static_cast<size_t>(input.size(static_cast<size_t>(dim)));
@@ -70,9 +59,7 @@ Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose
     args.transpose_a = transpose_a;
     args.transpose_b = transpose_b;
 
-    SmallVector<Tensor, 2> inputs{a, b};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+    NodeId node_id = Context::instance().emplace_node(std::move(args), a, b);
 
     // Calculate output shape (simplified)
     uint32_t rows = transpose_a ? a.size(1) : a.size(0);
@@ -81,7 +68,10 @@ Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a, bool transpose
     return Tensor(node_id, 0, {rows, cols});
 }
 
-Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim) {
+namespace {
+
+template <typename Dims>
+Tensor reduce_sum_node(const Tensor& input, const Dims& dims, bool keepdim) {
     ReduceArgs args;
     for (int32_t dim : dims) {
         args.dims.push_back(dim);
@@ -89,107 +79,70 @@ Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool ke
     args.keepdim = keepdim;
     args.type = ReduceArgs::Type::SUM;
 
-    SmallVector<Tensor, 2> inputs{input};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input);
 
     // Calculate output shape (simplified)
-    std::vector<uint32_t> output_shape;
+    Shape output_shape;
     for (size_t i = 0; i < input.rank(); ++i) {
-        bool is_reduced = std::find(dims.begin(), dims.end(), i) != dims.end();
+        // No dims means reduce over everything
+        bool is_reduced = dims.size() == 0 ||
+                          std::find(dims.begin(), dims.end(), static_cast<int32_t>(i)) != dims.end();
         if (!is_reduced || keepdim) {
             output_shape.push_back(is_reduced ? 1 : input.size(i));
         }
     }
-
-    // Convert vector to initializer_list format
-    assert(output_shape.size() <= 4);
-    uint32_t shape_array[4] = {1, 1, 1,
-                               1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-    for (size_t i = 0; i < output_shape.size(); ++i) {
-        shape_array[i] = output_shape
-            [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
+    if (output_shape.empty()) {
+        output_shape.push_back(1);
     }
-    return Tensor(node_id, 0, {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+
+    return Tensor(node_id, 0, output_shape);
+}
+
+}  // namespace
+
+Tensor reduce_sum(const Tensor& input, std::initializer_list<int32_t> dims, bool keepdim) {
+    return reduce_sum_node(input, dims, keepdim);
+}
+
+Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim) {
+    return reduce_sum_node(input, dims, keepdim);
 }
 
 Tensor relu(const Tensor& input) {
     ReLUArgs args;
     args.inplace = false;
 
-    SmallVector<Tensor, 2> inputs{input};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input);
 
     // Output has same shape as input
-    std::vector<uint32_t> shape(input.shape(), input.shape() + input.rank());
-
-    // Convert vector to initializer_list format
-    assert(shape.size() <= 4);
-    uint32_t shape_array[4] = {1, 1, 1,
-                               1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-    for (size_t i = 0; i < shape.size(); ++i) {
-        shape_array[i] = shape
-            [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
-    }
-    return Tensor(node_id, 0, {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+    return Tensor(node_id, 0, input.dims());
 }
 
 Tensor add(const Tensor& a, const Tensor& b) {
-    AddArgs args;
-
-    SmallVector<Tensor, 2> inputs{a, b};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
-
     // Output shape is broadcasted shape of inputs
-    std::vector<uint32_t> a_shape(a.shape(), a.shape() + a.rank());
-    std::vector<uint32_t> b_shape(b.shape(), b.shape() + b.rank());
-    auto output_shape = Tensor::broadcast_shapes(a_shape, b_shape);
+    Shape output_shape = Shape::broadcast(a.dims(), b.dims());
 
-    // Convert vector to initializer_list format
-    assert(output_shape.size() <= 4);
-    uint32_t shape_array[4] = {1, 1, 1,
-                               1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-    for (size_t i = 0; i < output_shape.size(); ++i) {
-        shape_array[i] = output_shape
-            [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
-    }
-    return Tensor(node_id, 0, {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+    NodeId node_id = Context::instance().emplace_node(AddArgs{}, a, b);
+
+    return Tensor(node_id, 0, output_shape);
 }
 
 Tensor multiply(const Tensor& a, const Tensor& b) {
-    MultiplyArgs args;
-
-    SmallVector<Tensor, 2> inputs{a, b};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
-
     // Output shape is broadcasted shape of inputs
-    std::vector<uint32_t> a_shape(a.shape(), a.shape() + a.rank());
-    std::vector<uint32_t> b_shape(b.shape(), b.shape() + b.rank());
-    auto output_shape = Tensor::broadcast_shapes(a_shape, b_shape);
+    Shape output_shape = Shape::broadcast(a.dims(), b.dims());
 
-    // Convert vector to initializer_list format
-    assert(output_shape.size() <= 4);
-    uint32_t shape_array[4] = {1, 1, 1,
-                               1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Temporary array for shape conversion
-    for (size_t i = 0; i < output_shape.size(); ++i) {
-        shape_array[i] = output_shape
-            [i];  // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) - Safe array access with bounds checking
-    }
-    return Tensor(node_id, 0, {shape_array[0], shape_array[1], shape_array[2], shape_array[3]});
+    NodeId node_id = Context::instance().emplace_node(MultiplyArgs{}, a, b);
+
+    return Tensor(node_id, 0, output_shape);
 }
 
 Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, bool has_relu) {
     FusedMLPArgs args;
     args.has_relu = has_relu;
-    args.fusion_info = std::string("MatMul + Add") + (has_relu ? " + ReLU" : "");
+    args.fusion_info = has_relu ? "MatMul + Add + ReLU" : "MatMul + Add";
 
     // Use 3 inputs: input, weights, and bias - much cleaner!
-    SmallVector<Tensor, 3> inputs{input, weights, bias};
-
-    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input, weights, bias);
 
     // Store bias as additional data - the tape generator will handle this
     // For now, we assume the operation handler will get bias from the context
@@ -205,3 +158,175 @@ Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias,
 
     return Tensor(node_id, 0, {batch_size, output_features});
 }
+
+Tensor gather(const Tensor& table, const Tensor& indices, int32_t axis) {
+    int32_t rank = table.rank();
+    if (axis < -rank || axis >= rank) {
+        throw std::runtime_error("gather: axis " + std::to_string(axis) + " is out of range for rank " +
+                                 std::to_string(rank));
+    }
+    auto dim = static_cast<size_t>(axis < 0 ? axis + rank : axis);
+
+    // Output shape: table dims before the axis, the index dims, then the table dims after it
+    Shape output_shape(table.shape(), dim);
+    for (size_t i = 0; i < indices.rank(); ++i) {
+        output_shape.push_back(indices.size(i));
+    }
+    for (size_t i = dim + 1; i < table.rank(); ++i) {
+        output_shape.push_back(table.size(i));
+    }
+
+    GatherArgs args;
+    args.axis = static_cast<int32_t>(dim);
+
+    NodeId node_id = Context::instance().emplace_node(std::move(args), table, indices);
+
+    return Tensor(node_id, 0, output_shape);
+}
+
+Tensor embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets, EmbeddingBagArgs::Mode mode) {
+    if (table.rank() != 2 || indices.rank() != 1 || offsets.rank() != 1) {
+        throw std::runtime_error("embedding_bag requires a [num_rows, dim] table and 1-D indices and offsets");
+    }
+
+    EmbeddingBagArgs args;
+    args.mode = mode;
+
+    NodeId node_id = Context::instance().emplace_node(std::move(args), table, indices, offsets);
+
+    return Tensor(node_id, 0, {offsets.size(0), table.size(1)});
+}
+
+namespace {
+
+// Positions are returned as floats, which hold integers exactly up to 2^24
+constexpr size_t MAX_SELECTION_SIZE = size_t{1} << 24U;
+
+// Normalized `dim` of a selection over `input`
+size_t selection_axis(const Tensor& input, int32_t dim, const char* op_name) {
+    int32_t rank = input.rank();
+    if (dim < -rank || dim >= rank) {
+        throw std::runtime_error(std::string(op_name) + ": dim " + std::to_string(dim) + " is out of range for rank " +
+                                 std::to_string(rank));
+    }
+    auto axis = static_cast<size_t>(dim < 0 ? dim + rank : dim);
+    if (input.size(axis) > MAX_SELECTION_SIZE) {
+        throw std::runtime_error(std::string(op_name) + ": dimension of size " + std::to_string(input.size(axis)) +
+                                 " is too large for float32 positions (at most 2^24)");
+    }
+    return axis;
+}
+
+}  // namespace
+
+std::pair<Tensor, Tensor> topk(const Tensor& input, uint32_t k, int32_t dim) {
+    size_t axis = selection_axis(input, dim, "topk");
+    if (k == 0 || k > input.size(axis)) {
+        throw std::runtime_error("topk: k = " + std::to_string(k) + " must be between 1 and " +
+                                 std::to_string(input.size(axis)));
+    }
+
+    TopKArgs args;
+    args.k = k;
+    args.dim = static_cast<int32_t>(axis);
+
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input);
+
+    // Output shape: the input shape with `dim` cut down to k
+    Shape output_shape = input.dims();
+    output_shape.set(axis, k);
+    Tensor values(node_id, 0, output_shape);
+
+    // The positions come out of the same kernel call; a second node hands them to consumers
+    NodeId indices_node_id = Context::instance().emplace_node(TopKIndicesArgs{}, values);
+
+    return {values, Tensor(indices_node_id, 0, output_shape)};
+}
+
+Tensor argmax(const Tensor& input, int32_t dim) {
+    size_t axis = selection_axis(input, dim, "argmax");
+
+    ArgMaxArgs args;
+    args.dim = static_cast<int32_t>(axis);
+
+    NodeId node_id = Context::instance().emplace_node(std::move(args), input);
+
+    // Output shape: the input shape without `dim`
+    Shape output_shape = input.dims();
+    output_shape.erase(axis);
+    if (output_shape.empty()) {
+        output_shape.push_back(1);
+    }
+
+    return Tensor(node_id, 0, output_shape);
+}
+
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias, Conv2DArgs args) {
+    if (input.rank() != 4 || weight.rank() != 4) {
+        throw std::runtime_error("conv2d requires a 4-D input and [C_out, C_in / groups, KH, KW] weights");
+    }
+    if (args.stride_h == 0 || args.stride_w == 0 || args.dilation_h == 0 || args.dilation_w == 0 ||
+        args.groups == 0) {
+        throw std::runtime_error("conv2d: stride, dilation and groups must be positive");
+    }
+    bool channels_last = args.layout == Conv2DArgs::Layout::NHWC;
+    uint32_t channels = input.size(channels_last ? 3 : 1);
+    uint32_t height = input.size(channels_last ? 1 : 2);
+    uint32_t width = input.size(channels_last ? 2 : 3);
+    uint32_t out_channels = weight.size(0);
+    if (channels % args.groups != 0 || out_channels % args.groups != 0 ||
+        weight.size(1) * args.groups != channels) {
+        throw std::runtime_error("conv2d: weights of shape [" + std::to_string(out_channels) + ", " +
+                                 std::to_string(weight.size(1)) + ", ...] do not match " +
+                                 std::to_string(channels) + " input channels in " + std::to_string(args.groups) +
+                                 " groups");
+    }
+    if (bias && bias.total_elements() != out_channels) {
+        throw std::runtime_error("conv2d: bias needs one value per output channel");
+    }
+
+    // Output extent of one spatial dimension, or 0 if the dilated kernel does not fit
+    auto extent = [](uint32_t size, uint32_t pad, uint32_t kernel, uint32_t stride, uint32_t dilation) -> uint32_t {
+        uint64_t padded = uint64_t{size} + 2 * uint64_t{pad};
+        uint64_t span = uint64_t{dilation} * (kernel - 1) + 1;
+        return kernel == 0 || padded < span ? 0 : static_cast<uint32_t>((padded - span) / stride + 1);
+    };
+    uint32_t out_h = extent(height, args.pad_h, weight.size(2), args.stride_h, args.dilation_h);
+    uint32_t out_w = extent(width, args.pad_w, weight.size(3), args.stride_w, args.dilation_w);
+    if (out_h == 0 || out_w == 0) {
+        throw std::runtime_error("conv2d: kernel does not fit the padded input");
+    }
+
+    SmallVector<Tensor, 3> inputs{input, weight};
+    if (bias) {
+        inputs.push_back(bias);
+    }
+
+    NodeId node_id = Context::instance().create_node(inputs, std::move(args));
+
+    if (channels_last) {
+        return Tensor(node_id, 0, {input.size(0), out_h, out_w, out_channels});
+    }
+    return Tensor(node_id, 0, {input.size(0), out_channels, out_h, out_w});
+}
+
+Tensor relu_backward(const Tensor& grad, const Tensor& output) {
+    NodeId node_id = Context::instance().emplace_node(ReLUBackwardArgs{}, grad, output);
+
+    return Tensor(node_id, 0, output.dims());
+}
+
+Tensor reduce_sum_backward(const Tensor& grad, const std::vector<uint32_t>& input_shape,
+                           const std::vector<int32_t>& dims) {
+    ReduceBackwardArgs args;
+    for (int32_t dim : dims) {
+        args.dims.push_back(dim);
+    }
+    for (uint32_t size : input_shape) {
+        args.input_shape.push_back(size);
+    }
+
+    NodeId node_id = Context::instance().emplace_node(std::move(args), grad);
+
+    return Tensor(node_id, 0, input_shape);
+}
@@ -3,6 +3,9 @@
 #include "Tensor.hpp"
 #include "common.hpp"
 
+#include <initializer_list>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 // Operation argument definitions
@@ -26,18 +29,76 @@ DEFINE_OP_ARGS(Multiply,
 DEFINE_OP_ARGS(FusedMLP,
                // Store the fused MLP parameters
                bool has_relu = true;          // Whether to apply ReLU activation
-               std::string fusion_info = "";  // Debug info about what was fused
+               std::string_view fusion_info;  // Debug info about what was fused (a string literal)
 );
 
+DEFINE_OP_ARGS(Gather, int32_t axis = 0;);
+
+DEFINE_OP_ARGS(EmbeddingBag, enum class Mode : uint8_t{SUM, MEAN} mode = Mode::SUM;);
+
+DEFINE_OP_ARGS(TopK, uint32_t k = 1; int32_t dim = -1;);
+
+// Second output of a TopK node (the positions); its single input is the TopK values tensor
+DEFINE_OP_ARGS(TopKIndices,
+               // No additional arguments needed
+);
+
+DEFINE_OP_ARGS(ArgMax, int32_t dim = -1;);
+
+DEFINE_OP_ARGS(Conv2D, uint32_t stride_h = 1; uint32_t stride_w = 1; uint32_t pad_h = 0; uint32_t pad_w = 0;
+               uint32_t dilation_h = 1; uint32_t dilation_w = 1; uint32_t groups = 1;
+               enum class Layout
+               : uint8_t{NCHW, NHWC} layout = Layout::NCHW;
+               bool has_relu = false;  // ReLU applied in the kernel epilogue
+);
+
+// Gradient operations created by grad() (see autodiff.hpp). ReLUBackward's inputs are the
+// incoming gradient and the forward ReLU output; ReduceBackward spreads the gradient of a sum
+// over `dims` back to `input_shape`.
+DEFINE_OP_ARGS(ReLUBackward,
+               // No additional arguments needed
+);
+
+DEFINE_OP_ARGS(ReduceBackward, SmallVector<int32_t, 4> dims; SmallVector<uint32_t, 4> input_shape;);
+
 // Helper functions
 std::vector<Tensor> make_output_tensors(NodeId node_id, size_t num_outputs,
                                         const std::vector<std::vector<uint32_t>>& shapes);
 
-// Operation implementations
+// Operation implementations. Except for split, which returns a vector, building a node makes no
+// heap allocation: inputs are copied straight into the node and output shapes are held inline.
 std::vector<Tensor> split(const Tensor& input, int64_t split_size, int32_t dim = 0);
 Tensor matmul(const Tensor& a, const Tensor& b, bool transpose_a = false, bool transpose_b = false);
-Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims = {}, bool keepdim = false);
+Tensor reduce_sum(const Tensor& input, std::initializer_list<int32_t> dims = {}, bool keepdim = false);
+Tensor reduce_sum(const Tensor& input, const std::vector<int32_t>& dims, bool keepdim = false);
 Tensor relu(const Tensor& input);
 Tensor add(const Tensor& a, const Tensor& b);
 Tensor multiply(const Tensor& a, const Tensor& b);
 Tensor fused_mlp(const Tensor& input, const Tensor& weights, const Tensor& bias, bool has_relu = true);
+
+// Indexed lookups; indices and offsets are int32, int64 or integral float32 tensors.
+// gather: slices of `table` at `indices` along `axis` (numpy.take).
+// embedding_bag: [num_bags, dim] sums or means of table rows; bag b holds
+// indices[offsets[b] .. offsets[b + 1]), the last bag runs to the end of `indices`.
+Tensor gather(const Tensor& table, const Tensor& indices, int32_t axis = 0);
+Tensor embedding_bag(const Tensor& table, const Tensor& indices, const Tensor& offsets,
+                     EmbeddingBagArgs::Mode mode = EmbeddingBagArgs::Mode::SUM);
+
+// Selection along `dim`. topk returns {values, indices}: the k largest values, best first
+// (ties keep the lower position), and their positions as whole-number floats, which gather
+// accepts directly. argmax returns the positions of the maxima with `dim` removed. NaN ranks
+// above every number. `dim` may hold at most 2^24 elements, the largest count float32
+// positions represent exactly.
+std::pair<Tensor, Tensor> topk(const Tensor& input, uint32_t k, int32_t dim = -1);
+Tensor argmax(const Tensor& input, int32_t dim = -1);
+
+// 2-D convolution of an NCHW (or NHWC, per args.layout) input with [C_out, C_in / groups,
+// KH, KW] weights. `bias` is optional (one value per output channel); it and args.has_relu
+// are fused into the kernel.
+Tensor conv2d(const Tensor& input, const Tensor& weight, const Tensor& bias = Tensor(), Conv2DArgs args = {});
+
+// Vector-Jacobian products used by grad(): the gradient of relu through its `output`, and the
+// gradient of reduce_sum(input, dims) broadcast back over `input_shape`.
+Tensor relu_backward(const Tensor& grad, const Tensor& output);
+Tensor reduce_sum_backward(const Tensor& grad, const std::vector<uint32_t>& input_shape,
+                           const std::vector<int32_t>& dims = {});
@@ -0,0 +1,54 @@
+#include "optimizer.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+void check_params(const std::vector<Tensor>& params, const char* optimizer) {
+    for (size_t i = 0; i < params.size(); ++i) {
+        const Tensor& param = params[i];
+        if (!param.is_constant() || param.dtype() != DataType::FLOAT32) {
+            throw std::runtime_error(std::string(optimizer) + ": parameter " + std::to_string(i) +
+                                     " must be a float32 constant tensor over the memory to train");
+        }
+        if (param.is_read_only()) {
+            throw std::runtime_error(std::string(optimizer) + ": parameter " + std::to_string(i) +
+                                     " is backed by read-only memory; copy it into a writable tensor to train it");
+        }
+    }
+}
+
+// State buffers shaped like the parameters; new tensors start at zero
+std::vector<Tensor> zeros_like(const std::vector<Tensor>& params) {
+    std::vector<Tensor> state;
+    state.reserve(params.size());
+    for (const Tensor& param : params) {
+        state.emplace_back(param.dims());
+    }
+    return state;
+}
+
+}  // namespace
+
+SgdMomentum::SgdMomentum(std::vector<Tensor> params, const math::SgdMomentumParams& hyper)
+    : params_(std::move(params)), hyper_(hyper) {
+    check_params(params_, "SgdMomentum");
+    momentum_buffers_ = zeros_like(params_);
+}
+
+void SgdMomentum::step(const std::vector<Tensor>& grads) {
+    math::sgd_momentum_update(params_, grads, momentum_buffers_, hyper_);
+}
+
+Adam::Adam(std::vector<Tensor> params, const math::AdamParams& hyper) : params_(std::move(params)), hyper_(hyper) {
+    check_params(params_, "Adam");
+    exp_avgs_ = zeros_like(params_);
+    exp_avg_sqs_ = zeros_like(params_);
+}
+
+void Adam::step(const std::vector<Tensor>& grads) {
+    math::adam_update(params_, grads, exp_avgs_, exp_avg_sqs_, hyper_);
+    hyper_.step++;
+}
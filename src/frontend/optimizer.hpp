@@ -0,0 +1,47 @@
+#pragma once
+#include "Tensor.hpp"
+#include "math_operations.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Training loops over a fixed list of parameters, on top of the fused in-place kernels
+// math::sgd_momentum_update and math::adam_update.
+//
+// Parameters are constant tensors over writable memory (as grad() takes them): step() writes
+// the new values into that memory, so every copy of the parameter sees them. Lazy or owned
+// tensors, whose copies do not share memory, and read-only mappings (MappedWeightFile,
+// SharedWeightStore) are rejected with std::runtime_error. The optimizer owns the state
+// buffers, zero at the start. Gradients may be lazy; they are evaluated before the update.
+class SgdMomentum {
+   public:
+    explicit SgdMomentum(std::vector<Tensor> params, const math::SgdMomentumParams& hyper = {});
+
+    void step(const std::vector<Tensor>& grads);
+
+    math::SgdMomentumParams& hyper() { return hyper_; }  // E.g. for a learning rate schedule
+    const std::vector<Tensor>& params() const { return params_; }
+
+   private:
+    std::vector<Tensor> params_;
+    std::vector<Tensor> momentum_buffers_;
+    math::SgdMomentumParams hyper_;
+};
+
+// Adam, or AdamW with hyper.decoupled_weight_decay. hyper.step is the number of the next step
+// (1 for a fresh optimizer) and advances after each one.
+class Adam {
+   public:
+    explicit Adam(std::vector<Tensor> params, const math::AdamParams& hyper = {});
+
+    void step(const std::vector<Tensor>& grads);
+
+    math::AdamParams& hyper() { return hyper_; }
+    const std::vector<Tensor>& params() const { return params_; }
+
+   private:
+    std::vector<Tensor> params_;
+    std::vector<Tensor> exp_avgs_;
+    std::vector<Tensor> exp_avg_sqs_;
+    math::AdamParams hyper_;
+};
@@ -0,0 +1,217 @@
+#include "DatasetReader.hpp"
+
+#include "MemoryManager.hpp"
+#include "NpyFormat.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool has_npy_magic(int fd) {
+    char magic[6] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    return pread(fd, magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+           std::memcmp(magic, "\x93NUMPY", sizeof(magic)) == 0;
+}
+
+}  // namespace
+
+DatasetReader::DatasetReader(const std::string& path, Options options) : path_(path), options_(options) {
+    if (options_.batch_rows == 0) {
+        throw std::runtime_error("DatasetReader: batch_rows must be positive");
+    }
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open dataset '" + path + "': " + std::strerror(errno));
+    }
+    try {
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) {
+            throw std::runtime_error("Failed to stat dataset '" + path + "': " + std::strerror(errno));
+        }
+        file_size_ = static_cast<size_t>(st.st_size);
+
+        if (has_npy_magic(fd_)) {
+            npy::Header header = npy::read_header(fd_, path);
+            if (options_.row_width != 0 && options_.row_width != header.width) {
+                throw std::runtime_error("Dataset '" + path + "' has rows of " + std::to_string(header.width) +
+                                         " values, expected " + std::to_string(options_.row_width));
+            }
+            row_width_ = header.width;
+            num_rows_ = header.rows;
+            data_offset_ = header.data_offset;
+            if (data_offset_ + num_rows_ * row_width_ * sizeof(float) > file_size_) {
+                throw std::runtime_error("Dataset '" + path + "' is shorter than its .npy header says");
+            }
+        } else {
+            if (options_.row_width == 0) {
+                throw std::runtime_error("Raw dataset '" + path + "' needs a row width");
+            }
+            row_width_ = options_.row_width;
+            size_t row_bytes = static_cast<size_t>(row_width_) * sizeof(float);
+            if (file_size_ % row_bytes != 0) {
+                throw std::runtime_error("Raw dataset '" + path + "' is not a whole number of " +
+                                         std::to_string(row_width_) + "-value rows");
+            }
+            num_rows_ = file_size_ / row_bytes;
+        }
+
+        if (options_.io_mode == IoMode::MMAP && file_size_ > 0) {
+            mapping_ = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (mapping_ == MAP_FAILED) {
+                mapping_ = nullptr;
+                throw std::runtime_error("Failed to map dataset '" + path + "': " + std::strerror(errno));
+            }
+            madvise(mapping_, file_size_, MADV_SEQUENTIAL);
+        } else {
+            posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+    } catch (...) {
+        close(fd_);
+        throw;
+    }
+
+    start_prefetch();
+}
+
+DatasetReader::~DatasetReader() {
+    stop_prefetch();
+    if (mapping_) {
+        munmap(mapping_, file_size_);
+    }
+    close(fd_);
+}
+
+Tensor DatasetReader::next() {
+    auto start = std::chrono::steady_clock::now();
+    Tensor batch;
+    if (options_.prefetch_batches == 0) {
+        if (next_row_ < num_rows_) {
+            batch = read_batch(next_row_);
+            next_row_ += batch.shape()[0];
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_cv_.wait(lock, [this]() { return !ready_.empty() || finished_ || error_; });
+        if (!ready_.empty()) {
+            batch = std::move(ready_.front());
+            ready_.pop_front();
+            space_cv_.notify_one();
+        } else if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.wait_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    if (batch) {
+        stats_.batches++;
+        stats_.rows += batch.shape()[0];
+    }
+    return batch;
+}
+
+void DatasetReader::rewind() {
+    stop_prefetch();
+    next_row_ = 0;
+    start_prefetch();
+}
+
+DatasetReader::Stats DatasetReader::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+Tensor DatasetReader::read_batch(uint64_t first_row) {
+    auto rows = static_cast<uint32_t>(std::min<uint64_t>(options_.batch_rows, num_rows_ - first_row));
+    size_t bytes = static_cast<size_t>(rows) * row_width_ * sizeof(float);
+    auto buffer = MemoryManager::instance().allocate_tensor(bytes);
+
+    size_t offset = data_offset_ + first_row * row_width_ * sizeof(float);
+    if (mapping_) {
+        std::memcpy(buffer->data(), static_cast<const char*>(mapping_) + offset, bytes);
+    } else {
+        auto* ptr = static_cast<char*>(buffer->data());
+        for (size_t done = 0; done < bytes;) {
+            ssize_t count = pread(fd_, ptr + done, bytes - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                throw std::runtime_error("Failed to read dataset '" + path_ + "': " +
+                                         (count == 0 ? std::string("unexpected end of file") : std::strerror(errno)));
+            }
+            done += static_cast<size_t>(count);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.bytes_read += bytes;
+    }
+    void* data = buffer->data();
+    return Tensor(std::static_pointer_cast<void>(buffer), data, {rows, row_width_});
+}
+
+void DatasetReader::start_prefetch() {
+    if (options_.prefetch_batches == 0) {
+        return;
+    }
+    ready_.clear();
+    finished_ = false;
+    stopping_ = false;
+    error_ = nullptr;
+    prefetch_thread_ = std::thread([this]() { prefetch_loop(); });
+}
+
+void DatasetReader::stop_prefetch() {
+    if (!prefetch_thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    space_cv_.notify_all();
+    prefetch_thread_.join();
+    ready_.clear();
+}
+
+void DatasetReader::prefetch_loop() {
+    for (uint64_t row = 0; row < num_rows_; row += options_.batch_rows) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_cv_.wait(lock, [this]() { return stopping_ || ready_.size() < options_.prefetch_batches; });
+            if (stopping_) {
+                return;
+            }
+        }
+
+        Tensor batch;
+        try {
+            batch = read_batch(row);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            ready_cv_.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(std::move(batch));
+        ready_cv_.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    ready_cv_.notify_all();
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Tensor.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Streams a float32 row file in fixed-size batches for offline scoring.
+//
+// Supported files are .npy (float32, C order; detected by the magic bytes) and raw
+// headerless float32 rows, whose width must be given. Each batch is a constant
+// [rows, width] tensor in a buffer from the MemoryManager pool; the buffer returns to the
+// pool once the batch and every copy of it (graph nodes, caches) are gone.
+//
+// With `prefetch_batches` > 0 a background thread reads ahead while the caller computes on
+// the current batch, so file I/O overlaps with compute (1 = double buffering).
+class DatasetReader {
+   public:
+    enum class IoMode {
+        PREAD,  // Read straight into the batch buffers
+        MMAP    // Map the file and copy from the mapping (page faults taken by the reader)
+    };
+
+    struct Options {
+        uint32_t batch_rows = 256;
+        uint32_t row_width = 0;  // Required for raw files, checked against .npy headers
+        IoMode io_mode = IoMode::PREAD;
+        size_t prefetch_batches = 1;  // 0 reads synchronously in next()
+    };
+
+    struct Stats {
+        uint64_t batches = 0;
+        uint64_t rows = 0;
+        uint64_t bytes_read = 0;
+        uint64_t wait_ns = 0;  // Time next() blocked waiting for data
+    };
+
+    DatasetReader(const std::string& path, Options options);
+    ~DatasetReader();
+
+    // Non-copyable, non-movable (owns the file and the prefetch thread)
+    DatasetReader(const DatasetReader&) = delete;
+    DatasetReader& operator=(const DatasetReader&) = delete;
+    DatasetReader(DatasetReader&&) = delete;
+    DatasetReader& operator=(DatasetReader&&) = delete;
+
+    // Next batch, or a null tensor at the end of the file. The last batch may be short.
+    Tensor next();
+
+    // Start over from the first row
+    void rewind();
+
+    uint64_t num_rows() const { return num_rows_; }
+    uint32_t row_width() const { return row_width_; }
+    Stats stats() const;
+
+   private:
+    Tensor read_batch(uint64_t first_row);
+    void start_prefetch();
+    void stop_prefetch();
+    void prefetch_loop();
+
+    std::string path_;
+    Options options_;
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t file_size_ = 0;
+    size_t data_offset_ = 0;
+    uint64_t num_rows_ = 0;
+    uint32_t row_width_ = 0;
+    uint64_t next_row_ = 0;  // First row of the next batch handed out (synchronous mode)
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_cv_;  // A batch was queued (or reading finished)
+    std::condition_variable space_cv_;  // The caller took a batch
+    std::deque<Tensor> ready_;
+    bool finished_ = false;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    Stats stats_;
+    std::thread prefetch_thread_;
+};
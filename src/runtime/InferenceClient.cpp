@@ -0,0 +1,108 @@
+#include "InferenceClient.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+InferenceClient::InferenceClient(const std::string& socket_path, uint32_t num_slots) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("InferenceClient: invalid socket path '" + socket_path + "'");
+    }
+    std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        throw std::runtime_error(std::string("InferenceClient: socket failed: ") + std::strerror(errno));
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::string error = std::strerror(errno);
+        close(fd_);
+        throw std::runtime_error("InferenceClient: cannot connect to " + socket_path + ": " + error);
+    }
+
+    try {
+        inference::Message hello;
+        hello.type = inference::MessageType::HELLO;
+        auto reply = exchange(hello);
+        max_rows_ = reply.max_rows;
+        input_row_elements_ = reply.input_row_elements;
+        output_row_elements_ = reply.output_row_elements;
+
+        ring_ = SharedTensorRing::create(num_slots, max_rows_ * input_row_elements_, max_rows_ * output_row_elements_);
+        inference::Message attach;
+        attach.type = inference::MessageType::ATTACH_RING;
+        if (exchange(attach, ring_->fd()).status != inference::Status::OK) {
+            throw std::runtime_error("InferenceClient: server rejected the shared ring");
+        }
+    } catch (...) {
+        close(fd_);
+        throw;
+    }
+}
+
+InferenceClient::~InferenceClient() {
+    close(fd_);
+}
+
+inference::Message InferenceClient::exchange(const inference::Message& request, int pass_fd, std::string* payload) {
+    inference::send_message(fd_, request, pass_fd);
+    inference::Message reply;
+    if (!inference::receive_message(fd_, reply, nullptr, payload)) {
+        throw std::runtime_error("InferenceClient: server closed the connection");
+    }
+    return reply;
+}
+
+void InferenceClient::submit(uint64_t request_id, uint32_t slot, uint32_t rows, std::chrono::microseconds timeout) {
+    inference::Message message;
+    message.type = inference::MessageType::INFER;
+    message.request_id = request_id;
+    message.slot = slot;
+    message.rows = rows;
+    message.timeout_us = static_cast<uint64_t>(timeout.count());
+    inference::send_message(fd_, message);
+}
+
+InferenceClient::Result InferenceClient::wait() {
+    inference::Message reply;
+    if (!inference::receive_message(fd_, reply)) {
+        throw std::runtime_error("InferenceClient: server closed the connection");
+    }
+    Result result;
+    result.request_id = reply.request_id;
+    result.slot = reply.slot;
+    result.status = reply.status;
+    result.queue_us = reply.queue_us;
+    result.compute_us = reply.compute_us;
+    result.batch_rows = reply.batch_rows;
+    return result;
+}
+
+InferenceClient::Result InferenceClient::infer(const float* input, uint32_t rows, float* output,
+                                               std::chrono::microseconds timeout) {
+    if (rows == 0 || rows > max_rows_) {
+        throw std::runtime_error("InferenceClient: row count must be between 1 and " + std::to_string(max_rows_));
+    }
+    std::memcpy(ring_->input(0), input, rows * input_row_elements_ * sizeof(float));
+    submit(0, 0, rows, timeout);
+    Result result = wait();
+    if (result.status == inference::Status::OK) {
+        std::memcpy(output, ring_->output(0), rows * output_row_elements_ * sizeof(float));
+    }
+    return result;
+}
+
+std::string InferenceClient::stats_json() {
+    inference::Message request;
+    request.type = inference::MessageType::STATS;
+    std::string payload;
+    exchange(request, -1, &payload);
+    return payload;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "InferenceProtocol.hpp"
+#include "SharedTensorRing.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Client side of the InferenceServer protocol. Connects to the server socket, learns the
+// model's row sizes, and creates a SharedTensorRing with `num_slots` request slots that it
+// shares with the server. Up to `num_slots` requests may be in flight at once.
+//
+// Not thread-safe: use one client per thread.
+class InferenceClient {
+   public:
+    struct Result {
+        uint64_t request_id = 0;
+        uint32_t slot = 0;
+        inference::Status status = inference::Status::OK;
+        uint64_t queue_us = 0;
+        uint64_t compute_us = 0;
+        uint32_t batch_rows = 0;
+    };
+
+    explicit InferenceClient(const std::string& socket_path, uint32_t num_slots = 4);
+    ~InferenceClient();
+
+    // Non-copyable, non-movable (owns the socket)
+    InferenceClient(const InferenceClient&) = delete;
+    InferenceClient& operator=(const InferenceClient&) = delete;
+    InferenceClient(InferenceClient&&) = delete;
+    InferenceClient& operator=(InferenceClient&&) = delete;
+
+    // Write the request's rows into input(slot), submit, then read output(slot) after wait()
+    float* input(uint32_t slot) const { return ring_->input(slot); }
+    const float* output(uint32_t slot) const { return ring_->output(slot); }
+
+    // Queue `rows` rows from `slot`. A zero timeout means no deadline.
+    void submit(uint64_t request_id, uint32_t slot, uint32_t rows,
+                std::chrono::microseconds timeout = std::chrono::microseconds(0));
+
+    // Block for the next response
+    Result wait();
+
+    // Synchronous helper: copy `rows` rows in, run them through slot 0, copy the result out
+    Result infer(const float* input, uint32_t rows, float* output,
+                 std::chrono::microseconds timeout = std::chrono::microseconds(0));
+
+    // Server statistics as a JSON object. Call with no requests in flight.
+    std::string stats_json();
+
+    uint32_t num_slots() const { return ring_->num_slots(); }
+    uint32_t max_rows() const { return max_rows_; }
+    size_t input_row_elements() const { return input_row_elements_; }
+    size_t output_row_elements() const { return output_row_elements_; }
+
+   private:
+    inference::Message exchange(const inference::Message& request, int pass_fd = -1, std::string* payload = nullptr);
+
+    int fd_ = -1;
+    std::shared_ptr<SharedTensorRing> ring_;
+    uint32_t max_rows_ = 0;
+    size_t input_row_elements_ = 0;
+    size_t output_row_elements_ = 0;
+};
@@ -0,0 +1,110 @@
+#include "InferenceProtocol.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace inference {
+
+const char* status_name(Status status) {
+    switch (status) {
+        case Status::OK:
+            return "OK";
+        case Status::DEADLINE_EXCEEDED:
+            return "DEADLINE_EXCEEDED";
+        case Status::INVALID_REQUEST:
+            return "INVALID_REQUEST";
+        case Status::ERROR:
+            return "ERROR";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+void send_message(int socket_fd, const Message& message, int pass_fd, const std::string& payload) {
+    if (payload.size() > MAX_PAYLOAD_SIZE) {
+        throw std::runtime_error("Inference message payload too large");
+    }
+    // sendmsg never writes through the iovecs
+    auto* header = const_cast<Message*>(&message);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    auto* body = const_cast<char*>(payload.data());  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    iovec iov[2] = {{header, sizeof(Message)}, {body, payload.size()}};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = payload.empty() ? 1 : 2;
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    if (pass_fd >= 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &pass_fd, sizeof(int));
+    }
+
+    ssize_t sent = 0;
+    do {
+        sent = sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != static_cast<ssize_t>(sizeof(Message) + payload.size())) {
+        throw std::runtime_error(std::string("Failed to send inference message: ") + std::strerror(errno));
+    }
+}
+
+bool receive_message(int socket_fd, Message& message, int* received_fd, std::string* payload) {
+    // Only callers that expect a payload pay for the payload buffer; otherwise any
+    // trailing bytes are discarded by the datagram socket
+    std::vector<char> payload_buffer(payload != nullptr ? MAX_PAYLOAD_SIZE : 0);
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+    iovec iov[2] = {{&message, sizeof(Message)}, {payload_buffer.data(), payload_buffer.size()}};
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = payload != nullptr ? 2 : 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received = 0;
+    do {
+        received = recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC);
+    } while (received < 0 && errno == EINTR);
+    if (received == 0 || (received < 0 && errno == ECONNRESET)) {
+        return false;
+    }
+    if (received < 0) {
+        throw std::runtime_error(std::string("Failed to receive inference message: ") + std::strerror(errno));
+    }
+
+    int fd = -1;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    if (fd >= 0 && received_fd == nullptr) {
+        close(fd);
+    } else if (received_fd != nullptr) {
+        *received_fd = fd;
+    }
+
+    bool truncated = payload != nullptr && (msg.msg_flags & MSG_TRUNC) != 0;
+    if (static_cast<size_t>(received) < sizeof(Message) || truncated) {
+        if (received_fd != nullptr && fd >= 0) {
+            close(fd);
+            *received_fd = -1;
+        }
+        throw std::runtime_error("Malformed inference message");
+    }
+    if (payload != nullptr) {
+        payload->assign(payload_buffer.data(), static_cast<size_t>(received) - sizeof(Message));
+    }
+    return true;
+}
+
+}  // namespace inference
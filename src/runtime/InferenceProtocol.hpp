@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Wire protocol between InferenceClient and InferenceServer.
+//
+// Every message is one SOCK_SEQPACKET datagram on a Unix domain socket: a fixed-size
+// Message, optionally followed by a text payload (stats JSON). Tensor data never goes
+// through the socket; it lives in the client's SharedTensorRing, whose descriptor is
+// passed once with SCM_RIGHTS.
+namespace inference {
+
+enum class MessageType : uint32_t {
+    HELLO = 1,        // Client -> server; reply carries the model's row sizes and limits
+    ATTACH_RING = 2,  // Client -> server with a ring descriptor attached; reply acknowledges
+    INFER = 3,        // Client -> server: run `rows` rows from ring slot `slot`
+    RESPONSE = 4,     // Server -> client: result of an INFER (or of HELLO/ATTACH_RING)
+    STATS = 5,        // Client -> server; reply payload is a JSON object
+};
+
+enum class Status : uint32_t {
+    OK = 0,
+    DEADLINE_EXCEEDED = 1,  // The request's deadline passed before it was scheduled
+    INVALID_REQUEST = 2,    // Bad slot, row count, or no ring attached
+    ERROR = 3,              // Evaluation failed
+};
+
+struct Message {
+    MessageType type = MessageType::HELLO;
+    Status status = Status::OK;
+    uint64_t request_id = 0;
+    uint32_t slot = 0;
+    uint32_t rows = 0;
+    uint64_t timeout_us = 0;  // INFER: relative deadline, 0 = none
+    uint64_t queue_us = 0;    // RESPONSE: time between arrival and batch start
+    uint64_t compute_us = 0;  // RESPONSE: time spent evaluating the batch
+    uint32_t batch_rows = 0;  // RESPONSE: rows in the batch that served the request
+    uint32_t max_rows = 0;    // HELLO reply: largest request the server accepts
+    uint64_t input_row_elements = 0;   // HELLO reply
+    uint64_t output_row_elements = 0;  // HELLO reply
+};
+
+constexpr size_t MAX_PAYLOAD_SIZE = 64 * 1024;
+
+const char* status_name(Status status);
+
+// Send one message, optionally passing `pass_fd` with SCM_RIGHTS. Throws on failure.
+void send_message(int socket_fd, const Message& message, int pass_fd = -1, const std::string& payload = "");
+
+// Receive one message. Returns false when the peer closed the connection. A passed
+// descriptor is stored in `received_fd` (or closed when that is null); the payload, if
+// any, in `payload`.
+bool receive_message(int socket_fd, Message& message, int* received_fd = nullptr, std::string* payload = nullptr);
+
+}  // namespace inference
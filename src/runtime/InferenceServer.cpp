@@ -0,0 +1,445 @@
+#include "InferenceServer.hpp"
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t LATENCY_WINDOW = 4096;
+
+std::runtime_error system_error(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+uint64_t elapsed_us(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+double percentile(std::vector<double> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+// Closes a descriptor received with a message unless ownership is handed on
+class ReceivedFd {
+   public:
+    ReceivedFd() = default;
+    ~ReceivedFd() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    ReceivedFd(const ReceivedFd&) = delete;
+    ReceivedFd& operator=(const ReceivedFd&) = delete;
+    ReceivedFd(ReceivedFd&&) = delete;
+    ReceivedFd& operator=(ReceivedFd&&) = delete;
+
+    int* out() { return &fd_; }
+    int get() const { return fd_; }
+    void release() { fd_ = -1; }
+
+   private:
+    int fd_ = -1;
+};
+
+}  // namespace
+
+InferenceServer::InferenceServer(Model model, Options options)
+    : model_(std::move(model)), options_(std::move(options)) {
+    if (model_.inputs().size() != 1) {
+        throw std::runtime_error("InferenceServer: model must have exactly one input");
+    }
+    if (options_.max_rows_per_request == 0 || options_.max_batch_rows == 0) {
+        throw std::runtime_error("InferenceServer: row limits must be non-zero");
+    }
+    input_row_shape_ = model_.inputs()[0].row_shape;
+    input_row_elements_ = model_.input_row_elements(0);
+    output_row_elements_ = model_.output_row_elements();
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options_.socket_path.empty() || options_.socket_path.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("InferenceServer: invalid socket path '" + options_.socket_path + "'");
+    }
+    std::memcpy(addr.sun_path, options_.socket_path.c_str(), options_.socket_path.size() + 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        throw system_error("InferenceServer: socket failed");
+    }
+    ::unlink(options_.socket_path.c_str());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 64) != 0) {
+        auto error = system_error("InferenceServer: cannot listen on " + options_.socket_path);
+        close(listen_fd_);
+        throw error;
+    }
+    if (pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        auto error = system_error("InferenceServer: pipe failed");
+        close(listen_fd_);
+        ::unlink(options_.socket_path.c_str());
+        throw error;
+    }
+    latency_samples_us_.reserve(LATENCY_WINDOW);
+    spdlog::info("Inference server listening on {}", options_.socket_path);
+}
+
+InferenceServer::~InferenceServer() {
+    for (const auto& [fd, connection] : connections_) {
+        close(fd);
+    }
+    close(listen_fd_);
+    close(wake_pipe_[0]);
+    close(wake_pipe_[1]);
+    ::unlink(options_.socket_path.c_str());
+}
+
+void InferenceServer::stop() {
+    char byte = 1;
+    // Only async-signal-safe calls here; a full pipe already means a stop is pending
+    [[maybe_unused]] ssize_t written = write(wake_pipe_[1], &byte, 1);
+}
+
+void InferenceServer::run() {
+    std::vector<pollfd> fds;
+    while (true) {
+        fds.clear();
+        fds.push_back({wake_pipe_[0], POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (const auto& [fd, connection] : connections_) {
+            fds.push_back({fd, POLLIN, 0});
+        }
+
+        int ready = poll(fds.data(), fds.size(), poll_timeout_ms(Clock::now()));
+        if (ready < 0 && errno != EINTR) {
+            throw system_error("InferenceServer: poll failed");
+        }
+
+        if (ready > 0) {
+            if (fds[0].revents != 0) {
+                char drain[16];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+                while (read(wake_pipe_[0], drain, sizeof(drain)) > 0) {
+                }
+                break;
+            }
+            if ((fds[1].revents & POLLIN) != 0) {
+                accept_connection();
+            }
+            for (size_t i = 2; i < fds.size(); ++i) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+                auto it = connections_.find(fds[i].fd);
+                bool keep = (fds[i].revents & POLLIN) != 0 && it != connections_.end() && handle_message(it->second);
+                if (!keep) {
+                    close_connection(fds[i].fd);
+                }
+            }
+        }
+
+        auto now = Clock::now();
+        expire_deadlines(now);
+        while (batch_ready(now)) {
+            run_batch();
+            now = Clock::now();
+            expire_deadlines(now);
+        }
+    }
+    spdlog::info("Inference server stopped");
+}
+
+void InferenceServer::accept_connection() {
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+        spdlog::warn("InferenceServer: accept failed: {}", std::strerror(errno));
+        return;
+    }
+    connections_[fd] = Connection{fd, nullptr};
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.connections++;
+}
+
+bool InferenceServer::handle_message(Connection& connection) {
+    using inference::MessageType;
+    using inference::Status;
+
+    inference::Message message;
+    ReceivedFd received_fd;  // Only ATTACH_RING keeps it
+    try {
+        if (!inference::receive_message(connection.fd, message, received_fd.out())) {
+            return false;
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("InferenceServer: dropping connection: {}", e.what());
+        return false;
+    }
+
+    inference::Message reply;
+    reply.type = MessageType::RESPONSE;
+    reply.request_id = message.request_id;
+
+    try {
+        switch (message.type) {
+            case MessageType::HELLO:
+                reply.max_rows = options_.max_rows_per_request;
+                reply.input_row_elements = input_row_elements_;
+                reply.output_row_elements = output_row_elements_;
+                inference::send_message(connection.fd, reply);
+                return true;
+
+            case MessageType::ATTACH_RING:
+                if (received_fd.get() < 0) {
+                    reply.status = Status::INVALID_REQUEST;
+                } else {
+                    connection.ring = SharedTensorRing::attach(received_fd.get());
+                    received_fd.release();
+                }
+                inference::send_message(connection.fd, reply);
+                return true;
+
+            case MessageType::STATS:
+                inference::send_message(connection.fd, reply, -1, stats_json());
+                return true;
+
+            case MessageType::INFER: {
+                Request request;
+                request.connection_fd = connection.fd;
+                request.ring = connection.ring;
+                request.request_id = message.request_id;
+                request.slot = message.slot;
+                request.rows = message.rows;
+                request.arrival = Clock::now();
+                request.deadline = message.timeout_us == 0
+                                       ? Clock::time_point::max()
+                                       : request.arrival + std::chrono::microseconds(message.timeout_us);
+                {
+                    std::lock_guard<std::mutex> lock(stats_mutex_);
+                    stats_.requests++;
+                }
+
+                bool valid = request.ring && request.slot < request.ring->num_slots() && request.rows > 0 &&
+                             request.rows <= options_.max_rows_per_request &&
+                             request.rows * input_row_elements_ <= request.ring->input_floats() &&
+                             request.rows * output_row_elements_ <= request.ring->output_floats();
+                if (!valid) {
+                    respond(request, Status::INVALID_REQUEST, 0, 0, 0);
+                    return true;
+                }
+                pending_rows_ += request.rows;
+                pending_.push_back(std::move(request));
+                return true;
+            }
+
+            case MessageType::RESPONSE:
+            default:
+                reply.status = Status::INVALID_REQUEST;
+                inference::send_message(connection.fd, reply);
+                return true;
+        }
+    } catch (const std::exception& e) {
+        spdlog::warn("InferenceServer: dropping connection: {}", e.what());
+        return false;
+    }
+}
+
+void InferenceServer::close_connection(int fd) {
+    // Pending requests from this client can no longer be answered
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->connection_fd == fd) {
+            pending_rows_ -= it->rows;
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    connections_.erase(fd);
+    close(fd);
+}
+
+bool InferenceServer::batch_ready(Clock::time_point now) const {
+    if (pending_.empty()) {
+        return false;
+    }
+    return pending_rows_ >= options_.max_batch_rows ||
+           now >= pending_.front().arrival + std::chrono::microseconds(options_.batch_window_us);
+}
+
+int InferenceServer::poll_timeout_ms(Clock::time_point now) const {
+    if (pending_.empty()) {
+        return -1;
+    }
+    auto wake = pending_.front().arrival + std::chrono::microseconds(options_.batch_window_us);
+    for (const auto& request : pending_) {
+        wake = std::min(wake, request.deadline);
+    }
+    if (wake <= now) {
+        return 0;
+    }
+    // Round up so we never wake just before the window closes
+    auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(wake - now).count();
+    return static_cast<int>((wait_us + 999) / 1000);
+}
+
+void InferenceServer::expire_deadlines(Clock::time_point now) {
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->deadline <= now) {
+            respond(*it, inference::Status::DEADLINE_EXCEEDED, elapsed_us(it->arrival, now), 0, 0);
+            pending_rows_ -= it->rows;
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void InferenceServer::run_batch() {
+    // Take requests in arrival order up to the row budget (always at least one)
+    std::vector<Request> batch;
+    uint32_t rows = 0;
+    while (!pending_.empty() && (batch.empty() || rows + pending_.front().rows <= options_.max_batch_rows)) {
+        rows += pending_.front().rows;
+        pending_rows_ -= pending_.front().rows;
+        batch.push_back(std::move(pending_.front()));
+        pending_.pop_front();
+    }
+
+    auto start = Clock::now();
+    inference::Status status = inference::Status::OK;
+    try {
+        std::vector<uint32_t> input_shape = {rows};
+        input_shape.insert(input_shape.end(), input_row_shape_.begin(), input_row_shape_.end());
+
+        if (batch.size() == 1) {
+            // Zero-copy: read the input from and write the result to the client's slot
+            const auto& request = batch.front();
+            Tensor input(request.ring->input(request.slot), input_shape);
+            Tensor output = model_.build({input});
+            tt_lazy::eval_into(output, request.ring->output(request.slot), rows * output_row_elements_);
+        } else {
+            batch_input_.resize(rows * input_row_elements_);
+            batch_output_.resize(rows * output_row_elements_);
+            float* dst = batch_input_.data();
+            for (const auto& request : batch) {
+                size_t count = request.rows * input_row_elements_;
+                std::memcpy(dst, request.ring->input(request.slot), count * sizeof(float));
+                dst += count;
+            }
+
+            Tensor input(batch_input_.data(), input_shape);
+            Tensor output = model_.build({input});
+            tt_lazy::eval_into(output, batch_output_.data(), batch_output_.size());
+
+            const float* src = batch_output_.data();
+            for (const auto& request : batch) {
+                size_t count = request.rows * output_row_elements_;
+                std::memcpy(request.ring->output(request.slot), src, count * sizeof(float));
+                src += count;
+            }
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("InferenceServer: batch of {} rows failed: {}", rows, e.what());
+        status = inference::Status::ERROR;
+    }
+    auto end = Clock::now();
+
+    // Each batch builds a fresh graph; drop it and any cached results
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.batches++;
+        stats_.batched_rows += rows;
+        stats_.max_batch_requests = std::max<uint64_t>(stats_.max_batch_requests, batch.size());
+    }
+    for (const auto& request : batch) {
+        respond(request, status, elapsed_us(request.arrival, start), elapsed_us(start, end), rows);
+    }
+}
+
+void InferenceServer::respond(const Request& request, inference::Status status, uint64_t queue_us,
+                              uint64_t compute_us, uint32_t batch_rows) {
+    inference::Message reply;
+    reply.type = inference::MessageType::RESPONSE;
+    reply.status = status;
+    reply.request_id = request.request_id;
+    reply.slot = request.slot;
+    reply.rows = request.rows;
+    reply.queue_us = queue_us;
+    reply.compute_us = compute_us;
+    reply.batch_rows = batch_rows;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        switch (status) {
+            case inference::Status::OK:
+                stats_.completed++;
+                break;
+            case inference::Status::DEADLINE_EXCEEDED:
+                stats_.deadline_exceeded++;
+                break;
+            case inference::Status::INVALID_REQUEST:
+                stats_.rejected++;
+                break;
+            case inference::Status::ERROR:
+            default:
+                stats_.errors++;
+                break;
+        }
+        if (status == inference::Status::OK) {
+            auto latency = static_cast<double>(elapsed_us(request.arrival, Clock::now()));
+            if (latency_samples_us_.size() < LATENCY_WINDOW) {
+                latency_samples_us_.push_back(latency);
+            } else {
+                latency_samples_us_[next_latency_sample_] = latency;
+            }
+            next_latency_sample_ = (next_latency_sample_ + 1) % LATENCY_WINDOW;
+        }
+    }
+
+    try {
+        inference::send_message(request.connection_fd, reply);
+    } catch (const std::exception& e) {
+        // The client went away; its connection is closed on the next poll
+        spdlog::debug("InferenceServer: {}", e.what());
+    }
+}
+
+InferenceServer::Stats InferenceServer::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    Stats stats = stats_;
+    stats.latency_p50_us = percentile(latency_samples_us_, 0.50);
+    stats.latency_p99_us = percentile(latency_samples_us_, 0.99);
+    return stats;
+}
+
+std::string InferenceServer::stats_json() const {
+    Stats s = stats();
+    double avg_batch_rows = s.batches > 0 ? static_cast<double>(s.batched_rows) / static_cast<double>(s.batches) : 0.0;
+    std::ostringstream os;
+    os << "{\"connections\": " << s.connections << ", \"requests\": " << s.requests
+       << ", \"completed\": " << s.completed << ", \"deadline_exceeded\": " << s.deadline_exceeded
+       << ", \"rejected\": " << s.rejected << ", \"errors\": " << s.errors << ", \"batches\": " << s.batches
+       << ", \"batched_rows\": " << s.batched_rows << ", \"avg_batch_rows\": " << avg_batch_rows
+       << ", \"max_batch_requests\": " << s.max_batch_requests << ", \"latency_p50_us\": " << s.latency_p50_us
+       << ", \"latency_p99_us\": " << s.latency_p99_us << "}";
+    return os.str();
+}
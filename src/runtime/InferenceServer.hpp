@@ -0,0 +1,117 @@
+#pragma once
+#include "InferenceProtocol.hpp"
+#include "Model.hpp"
+#include "SharedTensorRing.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Long-running inference daemon serving one Model over a Unix domain socket.
+//
+// Clients hand over inputs through their SharedTensorRing and receive results in the same
+// ring. A single event loop accepts connections, queues requests and dynamically batches
+// them: a batch runs once it holds `max_batch_rows` rows or its oldest request has waited
+// `batch_window_us`. Requests whose deadline passes before they are scheduled are answered
+// with DEADLINE_EXCEEDED instead of being evaluated.
+class InferenceServer {
+   public:
+    struct Options {
+        std::string socket_path;
+        uint32_t max_batch_rows = 64;
+        uint32_t batch_window_us = 200;
+        uint32_t max_rows_per_request = 64;
+    };
+
+    struct Stats {
+        uint64_t connections = 0;
+        uint64_t requests = 0;
+        uint64_t completed = 0;
+        uint64_t deadline_exceeded = 0;
+        uint64_t rejected = 0;
+        uint64_t errors = 0;
+        uint64_t batches = 0;
+        uint64_t batched_rows = 0;
+        uint64_t max_batch_requests = 0;
+        // Server-side latency (arrival to response) over recent requests
+        double latency_p50_us = 0.0;
+        double latency_p99_us = 0.0;
+    };
+
+    // Binds and listens on `options.socket_path` (an existing socket file is replaced).
+    // The model must have exactly one batch-major input.
+    InferenceServer(Model model, Options options);
+    ~InferenceServer();
+
+    // Non-copyable, non-movable (owns sockets and the event loop state)
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+    InferenceServer(InferenceServer&&) = delete;
+    InferenceServer& operator=(InferenceServer&&) = delete;
+
+    // Serve until stop() is called
+    void run();
+
+    // Ask run() to return. Safe to call from other threads and from signal handlers.
+    void stop();
+
+    Stats stats() const;
+    std::string stats_json() const;
+
+    const Options& options() const { return options_; }
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        int fd = -1;
+        std::shared_ptr<SharedTensorRing> ring;
+    };
+
+    struct Request {
+        int connection_fd = -1;
+        std::shared_ptr<SharedTensorRing> ring;
+        uint64_t request_id = 0;
+        uint32_t slot = 0;
+        uint32_t rows = 0;
+        Clock::time_point arrival;
+        Clock::time_point deadline;  // Clock::time_point::max() when there is none
+    };
+
+    void accept_connection();
+    // Returns false when the connection should be closed
+    bool handle_message(Connection& connection);
+    void close_connection(int fd);
+    bool batch_ready(Clock::time_point now) const;
+    int poll_timeout_ms(Clock::time_point now) const;
+    void expire_deadlines(Clock::time_point now);
+    void run_batch();
+    void respond(const Request& request, inference::Status status, uint64_t queue_us, uint64_t compute_us,
+                 uint32_t batch_rows);
+
+    Model model_;
+    Options options_;
+    size_t input_row_elements_ = 0;
+    size_t output_row_elements_ = 0;
+    std::vector<uint32_t> input_row_shape_;
+
+    int listen_fd_ = -1;
+    int wake_pipe_[2] = {-1, -1};  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Self-pipe for stop()
+    std::unordered_map<int, Connection> connections_;
+    std::deque<Request> pending_;
+    uint64_t pending_rows_ = 0;
+
+    // Staging buffers for batches that combine several requests
+    std::vector<float> batch_input_;
+    std::vector<float> batch_output_;
+
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+    std::vector<double> latency_samples_us_;  // Ring of recent latencies
+    size_t next_latency_sample_ = 0;
+};
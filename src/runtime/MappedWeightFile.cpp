@@ -0,0 +1,249 @@
+#include "MappedWeightFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t FILE_MAGIC = 0x5454'4C5A'4D57'4631ULL;  // "TTLZMWF1"
+constexpr uint32_t FILE_VERSION = 2;
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t page_size() {
+    static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+std::runtime_error system_error(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+}  // namespace
+
+// File layout: Header | EntryRecord[num_entries] | padding | weight data (each DATA_ALIGNMENT aligned)
+struct MappedWeightFile::Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t num_entries;
+    uint64_t total_size;
+};
+
+struct MappedWeightFile::EntryRecord {
+    char name[MAX_NAME_LENGTH + 1];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Fixed on-disk layout
+    uint32_t rank;
+    uint32_t shape[MAX_RANK];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Fixed on-disk layout
+    uint64_t offset;
+    uint64_t numel;
+};
+
+void MappedWeightFile::write(const std::string& path, const std::vector<std::pair<std::string, Tensor>>& weights) {
+    std::vector<EntryRecord> records(weights.size());
+    size_t offset = align_up(sizeof(Header) + weights.size() * sizeof(EntryRecord), DATA_ALIGNMENT);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        const auto& [name, tensor] = weights[i];
+        auto& record = records[i];
+        if (name.empty() || name.size() > MAX_NAME_LENGTH) {
+            throw std::runtime_error("Invalid weight name '" + name + "'");
+        }
+        if (!tensor.is_constant()) {
+            throw std::runtime_error("Weight '" + name + "' must be a constant tensor");
+        }
+        if (tensor.rank() == 0 || tensor.rank() > MAX_RANK) {
+            throw std::runtime_error("Weight '" + name + "' has rank " +
+                                     std::to_string(static_cast<size_t>(tensor.rank())) +
+                                     ", the weight file stores rank 1-" + std::to_string(MAX_RANK));
+        }
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.name, name.data(), name.size());
+        record.rank = tensor.rank();
+        std::copy(tensor.shape(), tensor.shape() + tensor.rank(), record.shape);
+        record.numel = tensor.total_elements();
+        record.offset = offset;
+        offset = align_up(offset + record.numel * sizeof(float), DATA_ALIGNMENT);
+    }
+
+    Header header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.num_entries = static_cast<uint32_t>(records.size());
+    header.total_size = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot open weight file '" + path + "' for writing");
+    }
+    auto write_bytes = [&file](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    auto pad_to = [&file](size_t position) {
+        static const char zeros[DATA_ALIGNMENT] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        while (static_cast<size_t>(file.tellp()) < position) {
+            size_t gap = std::min(position - static_cast<size_t>(file.tellp()), sizeof(zeros));
+            file.write(zeros, static_cast<std::streamsize>(gap));
+        }
+    };
+
+    write_bytes(&header, sizeof(header));
+    write_bytes(records.data(), records.size() * sizeof(EntryRecord));
+    for (size_t i = 0; i < weights.size(); ++i) {
+        pad_to(records[i].offset);
+        write_bytes(weights[i].second.const_data_ptr(), records[i].numel * sizeof(float));
+    }
+    pad_to(offset);
+    if (!file) {
+        throw std::runtime_error("Failed writing weight file '" + path + "'");
+    }
+}
+
+std::shared_ptr<MappedWeightFile> MappedWeightFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw system_error("Failed to open weight file", path);
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        auto error = system_error("Failed to stat weight file", path);
+        close(fd);
+        throw error;
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("Weight file '" + path + "' is too small");
+    }
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        auto error = system_error("Failed to map weight file", path);
+        close(fd);
+        throw error;
+    }
+    auto file = std::shared_ptr<MappedWeightFile>(new MappedWeightFile(path, fd, base, size));
+
+    const Header& header = file->header();
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.total_size > size ||
+        sizeof(Header) + header.num_entries * sizeof(EntryRecord) > size) {
+        throw std::runtime_error("'" + path + "' is not a compatible weight file");
+    }
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base) + sizeof(Header));
+    for (uint32_t i = 0; i < header.num_entries; ++i) {
+        const auto& entry = entries[i];
+        if (entry.rank == 0 || entry.rank > MAX_RANK || entry.offset % DATA_ALIGNMENT != 0 ||
+            entry.offset + entry.numel * sizeof(float) > size) {
+            throw std::runtime_error("Weight file '" + path + "' has a corrupt entry table");
+        }
+    }
+
+    spdlog::info("Mapped weight file {} ({} weights, {} bytes)", path, header.num_entries, size);
+    return file;
+}
+
+MappedWeightFile::MappedWeightFile(std::string path, int fd, void* base, size_t mapped_size)
+    : path_(std::move(path)), fd_(fd), base_(base), mapped_size_(mapped_size) {}
+
+MappedWeightFile::~MappedWeightFile() {
+    munmap(base_, mapped_size_);
+    close(fd_);
+}
+
+const MappedWeightFile::Header& MappedWeightFile::header() const {
+    return *static_cast<const Header*>(base_);
+}
+
+const MappedWeightFile::EntryRecord* MappedWeightFile::find_entry(const std::string& name) const {
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base_) + sizeof(Header));
+    for (uint32_t i = 0; i < header().num_entries; ++i) {
+        if (std::strncmp(entries[i].name, name.c_str(), MAX_NAME_LENGTH + 1) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+Tensor MappedWeightFile::get(const std::string& name) const {
+    const EntryRecord* entry = find_entry(name);
+    if (!entry) {
+        throw std::runtime_error("Weight '" + name + "' not found in '" + path_ + "'");
+    }
+
+    // The mapping is read-only: graph operations never write through a constant's data pointer,
+    // and the tensor is marked so in-place updates refuse it
+    auto* data = const_cast<char*>(  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                     static_cast<const char*>(base_)) +
+                 entry->offset;
+    std::vector<uint32_t> shape(entry->shape, entry->shape + entry->rank);
+    auto owner = std::const_pointer_cast<MappedWeightFile>(shared_from_this());
+    Tensor tensor(std::static_pointer_cast<void>(owner), data, shape);
+    tensor.mark_read_only();
+    return tensor;
+}
+
+bool MappedWeightFile::contains(const std::string& name) const {
+    return find_entry(name) != nullptr;
+}
+
+std::vector<std::string> MappedWeightFile::names() const {
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base_) + sizeof(Header));
+    std::vector<std::string> result;
+    result.reserve(header().num_entries);
+    for (uint32_t i = 0; i < header().num_entries; ++i) {
+        result.emplace_back(entries[i].name, strnlen(entries[i].name, MAX_NAME_LENGTH + 1));
+    }
+    return result;
+}
+
+bool MappedWeightFile::contains_address(const void* data) const {
+    const auto* begin = static_cast<const char*>(base_);
+    const auto* ptr = static_cast<const char*>(data);
+    return ptr >= begin && ptr < begin + mapped_size_;
+}
+
+std::pair<size_t, size_t> MappedWeightFile::page_range(const void* data, size_t bytes) const {
+    if (!contains_address(data)) {
+        throw std::runtime_error("Address is not inside weight file '" + path_ + "'");
+    }
+    auto offset = static_cast<size_t>(static_cast<const char*>(data) - static_cast<const char*>(base_));
+    size_t begin = offset / page_size() * page_size();
+    size_t end = std::min(align_up(offset + bytes, page_size()), align_up(mapped_size_, page_size()));
+    return {begin, end};
+}
+
+void MappedWeightFile::will_need(const void* data, size_t bytes) const {
+    auto [begin, end] = page_range(data, bytes);
+    madvise(static_cast<char*>(base_) + begin, end - begin, MADV_WILLNEED);
+}
+
+void MappedWeightFile::dont_need(const void* data, size_t bytes) const {
+    auto [begin, end] = page_range(data, bytes);
+    madvise(static_cast<char*>(base_) + begin, end - begin, MADV_DONTNEED);
+    // Clean file pages are also charged to the memory limit while cached
+    posix_fadvise(fd_, static_cast<off_t>(begin), static_cast<off_t>(end - begin), POSIX_FADV_DONTNEED);
+}
+
+size_t MappedWeightFile::resident_bytes() const {
+    size_t pages = align_up(mapped_size_, page_size()) / page_size();
+    std::vector<unsigned char> residency(pages);
+    if (mincore(base_, mapped_size_, residency.data()) != 0) {
+        throw system_error("mincore failed for weight file", path_);
+    }
+    size_t resident = 0;
+    for (unsigned char page : residency) {
+        resident += (page & 1U) != 0 ? page_size() : 0;
+    }
+    return resident;
+}
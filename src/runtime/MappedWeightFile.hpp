@@ -0,0 +1,71 @@
+#pragma once
+#include "Tensor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Read-only, memory-mapped weight file for models whose weights do not fit in RAM.
+//
+// Weights stay on disk and are paged in on demand; every weight starts on its own page so
+// its residency can be controlled independently (see WeightPrefetcher). Tensors handed out
+// by the file are zero-copy views that keep the mapping alive.
+class MappedWeightFile : public std::enable_shared_from_this<MappedWeightFile> {
+   public:
+    static constexpr size_t MAX_NAME_LENGTH = 63;
+    static constexpr size_t MAX_RANK = 8;  // Dimensions stored per on-disk entry
+    static constexpr size_t DATA_ALIGNMENT = 4096;
+
+    // Write constant tensors to `path` in the mapped weight file format
+    static void write(const std::string& path, const std::vector<std::pair<std::string, Tensor>>& weights);
+
+    // Map an existing weight file read-only
+    static std::shared_ptr<MappedWeightFile> open(const std::string& path);
+
+    ~MappedWeightFile();
+
+    // Non-copyable, non-movable (tensors hold the mapping through shared_from_this)
+    MappedWeightFile(const MappedWeightFile&) = delete;
+    MappedWeightFile& operator=(const MappedWeightFile&) = delete;
+    MappedWeightFile(MappedWeightFile&&) = delete;
+    MappedWeightFile& operator=(MappedWeightFile&&) = delete;
+
+    // Constant tensor viewing the named weight. Throws if the weight does not exist.
+    Tensor get(const std::string& name) const;
+    bool contains(const std::string& name) const;
+    std::vector<std::string> names() const;
+
+    // Whether `data` points into this mapping
+    bool contains_address(const void* data) const;
+
+    // Residency hints for a byte range of the mapping (rounded out to whole pages).
+    // will_need starts asynchronous readahead; dont_need drops the pages from this process
+    // and from the page cache so they no longer count against a memory limit.
+    void will_need(const void* data, size_t bytes) const;
+    void dont_need(const void* data, size_t bytes) const;
+
+    // Bytes of the mapping currently in memory
+    size_t resident_bytes() const;
+
+    const std::string& path() const { return path_; }
+    size_t mapped_bytes() const { return mapped_size_; }
+
+   private:
+    struct Header;
+    struct EntryRecord;
+
+    MappedWeightFile(std::string path, int fd, void* base, size_t mapped_size);
+
+    const Header& header() const;
+    const EntryRecord* find_entry(const std::string& name) const;
+    // Page-aligned [begin, end) covering a range of the mapping, clipped to the mapping
+    std::pair<size_t, size_t> page_range(const void* data, size_t bytes) const;
+
+    std::string path_;
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mapped_size_ = 0;
+};
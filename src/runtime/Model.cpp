@@ -0,0 +1,403 @@
+#include "Model.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "operations.hpp"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr const char* MODEL_MAGIC = "TT_LAZY_MODEL";
+constexpr int MODEL_VERSION = 1;
+constexpr size_t MAX_RANK = 64;  // Bounds a corrupt rank before the shape is allocated
+
+std::vector<uint32_t> shape_of(const Tensor& tensor) {
+    return tensor.dims().to_vector();
+}
+
+void write_shape(std::ostream& os, const std::vector<uint32_t>& shape) {
+    os << shape.size();
+    for (uint32_t dim : shape) {
+        os << ' ' << dim;
+    }
+}
+
+std::vector<uint32_t> read_shape(std::istream& is) {
+    size_t rank = 0;
+    is >> rank;
+    if (rank == 0 || rank > MAX_RANK) {
+        throw std::runtime_error("Model file: invalid rank " + std::to_string(rank));
+    }
+    std::vector<uint32_t> shape(rank);
+    for (auto& dim : shape) {
+        is >> dim;
+    }
+    return shape;
+}
+
+size_t numel_of(const std::vector<uint32_t>& shape) {
+    size_t numel = 1;
+    for (uint32_t dim : shape) {
+        numel *= dim;
+    }
+    return numel;
+}
+
+// Read "<keyword> <count>" and check the keyword
+size_t read_section(std::istream& is, const std::string& keyword) {
+    std::string word;
+    size_t count = 0;
+    is >> word >> count;
+    if (!is || word != keyword) {
+        throw std::runtime_error("Model file: expected '" + keyword + "' section");
+    }
+    return count;
+}
+
+}  // namespace
+
+void Model::save(const std::string& path, const std::vector<std::pair<std::string, Tensor>>& inputs,
+                 const Tensor& output) {
+    if (!output.is_lazy()) {
+        throw std::runtime_error("Model::save: output must be produced by an operation");
+    }
+
+    Model model;
+    std::unordered_map<const float*, size_t> input_index;
+    for (const auto& [name, tensor] : inputs) {
+        if (!tensor.is_constant() || tensor.rank() < 2) {
+            throw std::runtime_error("Model::save: input '" + name + "' must be a batch-major constant tensor");
+        }
+        input_index[tensor.const_data_ptr()] = model.inputs_.size();
+        auto shape = shape_of(tensor);
+        model.inputs_.push_back({name, std::vector<uint32_t>(shape.begin() + 1, shape.end())});
+    }
+
+    std::map<std::pair<const float*, size_t>, size_t> weight_index;  // (data, numel) -> weight
+    std::unordered_map<NodeId, size_t> op_index;
+    auto& context = Context::instance();
+
+    auto constant_ref = [&](const Tensor& tensor) {
+        const float* data = tensor.const_data_ptr();
+        if (auto it = input_index.find(data); it != input_index.end()) {
+            return Ref{Ref::Kind::INPUT, it->second};
+        }
+        auto key = std::make_pair(data, tensor.total_elements());
+        auto [it, inserted] = weight_index.emplace(key, model.weights_.size());
+        if (inserted) {
+            model.weight_names_.push_back("w" + std::to_string(model.weights_.size()));
+            model.weights_.push_back(tensor);
+        }
+        return Ref{Ref::Kind::WEIGHT, it->second};
+    };
+
+    // Post-order walk: every operation is emitted after its producers
+    std::function<size_t(NodeId)> visit = [&](NodeId node_id) -> size_t {
+        if (auto it = op_index.find(node_id); it != op_index.end()) {
+            return it->second;
+        }
+        const Node* node = context.get_node(node_id);
+        if (!node) {
+            throw std::runtime_error("Model::save: node " + std::to_string(node_id) + " not found");
+        }
+
+        Operation op;
+        op.op_name = std::string(node->op_name());
+        for (const auto& input : node->inputs()) {
+            if (input.is_lazy()) {
+                if (input.output_index() != 0) {
+                    throw std::runtime_error("Model::save: multi-output operations are not supported");
+                }
+                op.inputs.push_back(Ref{Ref::Kind::OPERATION, visit(input.producer_node())});
+            } else {
+                op.inputs.push_back(constant_ref(input));
+            }
+        }
+
+        if (const auto* matmul_args = node->try_as<MatMulArgs>()) {
+            op.flag_a = matmul_args->transpose_a;
+            op.flag_b = matmul_args->transpose_b;
+        } else if (const auto* reduce_args = node->try_as<ReduceArgs>()) {
+            if (reduce_args->type != ReduceArgs::Type::SUM) {
+                throw std::runtime_error("Model::save: only sum reductions are supported");
+            }
+            op.flag_a = reduce_args->keepdim;
+            op.dims.assign(reduce_args->dims.begin(), reduce_args->dims.end());
+        } else if (const auto* mlp_args = node->try_as<FusedMLPArgs>()) {
+            op.flag_a = mlp_args->has_relu;
+        } else if (!node->is<AddArgs>() && !node->is<MultiplyArgs>() && !node->is<ReLUArgs>()) {
+            throw std::runtime_error("Model::save: unsupported operation " + op.op_name);
+        }
+
+        op_index[node_id] = model.operations_.size();
+        model.operations_.push_back(std::move(op));
+        return model.operations_.size() - 1;
+    };
+    model.output_ = Ref{Ref::Kind::OPERATION, visit(output.producer_node())};
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Model::save: cannot open " + path);
+    }
+
+    auto write_ref = [&file](const Ref& ref) {
+        static const char kinds[] = {'i', 'w', 'o'};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        file << ' ' << kinds[static_cast<size_t>(ref.kind)] << ref.index;
+    };
+
+    file << MODEL_MAGIC << ' ' << MODEL_VERSION << '\n';
+    file << "inputs " << model.inputs_.size() << '\n';
+    for (const auto& input : model.inputs_) {
+        file << "input " << input.name << ' ';
+        write_shape(file, input.row_shape);
+        file << '\n';
+    }
+
+    size_t offset = 0;
+    file << "weights " << model.weights_.size() << '\n';
+    for (size_t i = 0; i < model.weights_.size(); ++i) {
+        file << "weight " << model.weight_names_[i] << ' ';
+        write_shape(file, shape_of(model.weights_[i]));
+        file << ' ' << offset << '\n';
+        offset += model.weights_[i].total_elements();
+    }
+
+    file << "operations " << model.operations_.size() << '\n';
+    for (const auto& op : model.operations_) {
+        file << "op " << op.op_name << ' ' << op.inputs.size();
+        for (const auto& ref : op.inputs) {
+            write_ref(ref);
+        }
+        file << ' ' << op.flag_a << ' ' << op.flag_b << ' ' << op.dims.size();
+        for (int32_t dim : op.dims) {
+            file << ' ' << dim;
+        }
+        file << '\n';
+    }
+    file << "output";
+    write_ref(model.output_);
+    file << '\n';
+
+    file << "data " << offset << '\n';
+    for (const auto& weight : model.weights_) {
+        const auto* bytes = reinterpret_cast<const char*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            weight.const_data_ptr());
+        file.write(bytes, static_cast<std::streamsize>(weight.total_elements() * sizeof(float)));
+    }
+    if (!file) {
+        throw std::runtime_error("Model::save: failed writing " + path);
+    }
+}
+
+Model Model::load(const std::string& path, const std::string& shared_segment) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Model::load: cannot open " + path);
+    }
+
+    std::string magic;
+    int version = 0;
+    file >> magic >> version;
+    if (magic != MODEL_MAGIC || version != MODEL_VERSION) {
+        throw std::runtime_error("Model::load: " + path + " is not a version " + std::to_string(MODEL_VERSION) +
+                                 " model file");
+    }
+
+    Model model;
+    std::string word;
+
+    size_t num_inputs = read_section(file, "inputs");
+    for (size_t i = 0; i < num_inputs; ++i) {
+        Input input;
+        file >> word >> input.name;
+        input.row_shape = read_shape(file);
+        model.inputs_.push_back(std::move(input));
+    }
+
+    struct WeightRecord {
+        std::vector<uint32_t> shape;
+        size_t offset = 0;
+    };
+    std::vector<WeightRecord> weight_records;
+    size_t num_weights = read_section(file, "weights");
+    for (size_t i = 0; i < num_weights; ++i) {
+        WeightRecord record;
+        std::string name;
+        file >> word >> name;
+        record.shape = read_shape(file);
+        file >> record.offset;
+        model.weight_names_.push_back(name);
+        weight_records.push_back(std::move(record));
+    }
+
+    auto read_ref = [&file, &model, num_weights](size_t num_ops) {
+        std::string token;
+        file >> token;
+        if (token.size() < 2) {
+            throw std::runtime_error("Model::load: malformed reference '" + token + "'");
+        }
+        Ref ref;
+        ref.index = std::stoul(token.substr(1));
+        size_t limit = 0;
+        switch (token[0]) {
+            case 'i':
+                ref.kind = Ref::Kind::INPUT;
+                limit = model.inputs_.size();
+                break;
+            case 'w':
+                ref.kind = Ref::Kind::WEIGHT;
+                limit = num_weights;
+                break;
+            case 'o':
+                ref.kind = Ref::Kind::OPERATION;
+                limit = num_ops;
+                break;
+            default:
+                throw std::runtime_error("Model::load: malformed reference '" + token + "'");
+        }
+        if (ref.index >= limit) {
+            throw std::runtime_error("Model::load: reference '" + token + "' out of range");
+        }
+        return ref;
+    };
+
+    size_t num_ops = read_section(file, "operations");
+    for (size_t i = 0; i < num_ops; ++i) {
+        Operation op;
+        size_t num_op_inputs = 0;
+        file >> word >> op.op_name >> num_op_inputs;
+        for (size_t j = 0; j < num_op_inputs; ++j) {
+            op.inputs.push_back(read_ref(i));  // Operations may only read earlier results
+        }
+        size_t num_dims = 0;
+        file >> op.flag_a >> op.flag_b >> num_dims;
+        op.dims.resize(num_dims);
+        for (auto& dim : op.dims) {
+            file >> dim;
+        }
+        model.operations_.push_back(std::move(op));
+    }
+
+    file >> word;
+    if (word != "output") {
+        throw std::runtime_error("Model::load: expected 'output'");
+    }
+    model.output_ = read_ref(num_ops);
+
+    size_t total_floats = read_section(file, "data");
+    file.get();  // Newline before the binary section
+    if (!file) {
+        throw std::runtime_error("Model::load: truncated header in " + path);
+    }
+    for (const auto& record : weight_records) {
+        if (record.offset + numel_of(record.shape) > total_floats) {
+            throw std::runtime_error("Model::load: weight data out of range in " + path);
+        }
+    }
+    auto data_start = file.tellg();
+
+    auto read_data = [&file, &path, data_start, total_floats]() {
+        auto data = std::make_shared<std::vector<float>>(total_floats);
+        file.seekg(data_start);
+        file.read(reinterpret_cast<char*>(data->data()),  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                  static_cast<std::streamsize>(total_floats * sizeof(float)));
+        if (!file) {
+            throw std::runtime_error("Model::load: truncated weight data in " + path);
+        }
+        return data;
+    };
+
+    if (shared_segment.empty()) {
+        model.weight_storage_ = read_data();
+        for (const auto& record : weight_records) {
+            model.weights_.emplace_back(std::static_pointer_cast<void>(model.weight_storage_),
+                                        model.weight_storage_->data() + record.offset, record.shape);
+        }
+    } else {
+        // Only the process that creates the segment reads the weight data
+        std::shared_ptr<std::vector<float>> staging;
+        model.shared_weights_ = SharedWeightStore::create_or_attach(shared_segment, [&]() {
+            staging = read_data();
+            std::vector<SharedWeightStore::WeightSpec> specs;
+            for (size_t i = 0; i < weight_records.size(); ++i) {
+                specs.push_back({model.weight_names_[i], weight_records[i].shape,
+                                 staging->data() + weight_records[i].offset, SharedWeightStore::Layout::ROW_MAJOR});
+            }
+            return specs;
+        });
+        for (const auto& name : model.weight_names_) {
+            model.weights_.push_back(model.shared_weights_->get(name));
+        }
+    }
+
+    // Build once with a single row to learn the output row size
+    std::vector<std::vector<float>> zeros;
+    std::vector<Tensor> probe_inputs;
+    for (const auto& input : model.inputs_) {
+        zeros.emplace_back(numel_of(input.row_shape), 0.0f);
+        std::vector<uint32_t> shape = {1};
+        shape.insert(shape.end(), input.row_shape.begin(), input.row_shape.end());
+        probe_inputs.emplace_back(zeros.back().data(), shape);
+    }
+    Tensor probe = model.build(probe_inputs);
+    model.output_row_elements_ = probe.total_elements();
+
+    return model;
+}
+
+Tensor Model::build(const std::vector<Tensor>& inputs) const {
+    if (inputs.size() != inputs_.size()) {
+        throw std::runtime_error("Model::build: expected " + std::to_string(inputs_.size()) + " inputs, got " +
+                                 std::to_string(inputs.size()));
+    }
+
+    std::vector<Tensor> results;
+    results.reserve(operations_.size());
+    auto resolve = [&](const Ref& ref) -> const Tensor& {
+        switch (ref.kind) {
+            case Ref::Kind::INPUT:
+                return inputs[ref.index];
+            case Ref::Kind::WEIGHT:
+                return weights_[ref.index];
+            case Ref::Kind::OPERATION:
+            default:
+                return results[ref.index];
+        }
+    };
+
+    for (const auto& op : operations_) {
+        auto arg = [&](size_t i) -> const Tensor& {
+            if (i >= op.inputs.size()) {
+                throw std::runtime_error("Model::build: " + op.op_name + " is missing inputs");
+            }
+            return resolve(op.inputs[i]);
+        };
+
+        if (op.op_name == MatMulArgs::NAME) {
+            results.push_back(matmul(arg(0), arg(1), op.flag_a, op.flag_b));
+        } else if (op.op_name == AddArgs::NAME) {
+            results.push_back(add(arg(0), arg(1)));
+        } else if (op.op_name == MultiplyArgs::NAME) {
+            results.push_back(multiply(arg(0), arg(1)));
+        } else if (op.op_name == ReLUArgs::NAME) {
+            results.push_back(relu(arg(0)));
+        } else if (op.op_name == ReduceArgs::NAME) {
+            results.push_back(reduce_sum(arg(0), op.dims, op.flag_a));
+        } else if (op.op_name == FusedMLPArgs::NAME) {
+            results.push_back(fused_mlp(arg(0), arg(1), arg(2), op.flag_a));
+        } else {
+            throw std::runtime_error("Model::build: unsupported operation " + op.op_name);
+        }
+    }
+
+    return resolve(output_);
+}
+
+size_t Model::input_row_elements(size_t input) const {
+    return numel_of(inputs_.at(input).row_shape);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "SharedWeightStore.hpp"
+#include "Tensor.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Serialized inference model: the operation list ("tape") that computes one output from
+// named, batch-major inputs, plus the constant weights it reads.
+//
+// File layout: a text header describing inputs, weights and operations in execution
+// order, followed by the raw float32 weight data. Loading replays the operations through
+// the frontend for whatever batch size is being served.
+class Model {
+   public:
+    // Input whose first dimension is the batch; `row_shape` is the shape of one row
+    struct Input {
+        std::string name;
+        std::vector<uint32_t> row_shape;
+    };
+
+    // Serialize the graph producing `output`. Constant tensors that appear in `inputs`
+    // become batch-major inputs; every other constant is stored as a weight.
+    static void save(const std::string& path, const std::vector<std::pair<std::string, Tensor>>& inputs,
+                     const Tensor& output);
+
+    // Load a model. With a non-empty `shared_segment`, weights are placed in (or attached
+    // from) a SharedWeightStore so prefork workers share one copy.
+    static Model load(const std::string& path, const std::string& shared_segment = "");
+
+    // Rebuild the lazy graph for the given inputs (one per declared input, same order)
+    Tensor build(const std::vector<Tensor>& inputs) const;
+
+    const std::vector<Input>& inputs() const { return inputs_; }
+    size_t num_weights() const { return weights_.size(); }
+    size_t num_operations() const { return operations_.size(); }
+
+    // Elements in one row of an input / of the output
+    size_t input_row_elements(size_t input) const;
+    size_t output_row_elements() const { return output_row_elements_; }
+
+   private:
+    // Where an operation input comes from
+    struct Ref {
+        enum class Kind : uint8_t { INPUT, WEIGHT, OPERATION } kind = Kind::INPUT;
+        size_t index = 0;
+    };
+
+    struct Operation {
+        std::string op_name;
+        std::vector<Ref> inputs;
+        bool flag_a = false;        // MatMul: transpose_a, Reduce: keepdim, FusedMLP: has_relu
+        bool flag_b = false;        // MatMul: transpose_b
+        std::vector<int32_t> dims;  // Reduce: dims
+    };
+
+    Model() = default;
+
+    std::vector<Input> inputs_;
+    std::vector<std::string> weight_names_;
+    std::vector<Tensor> weights_;
+    std::vector<Operation> operations_;
+    Ref output_;
+    size_t output_row_elements_ = 0;
+    std::shared_ptr<std::vector<float>> weight_storage_;
+    std::shared_ptr<SharedWeightStore> shared_weights_;
+};
@@ -0,0 +1,137 @@
+#include "NpyFormat.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+namespace npy {
+
+namespace {
+
+constexpr char MAGIC[] = "\x93NUMPY";  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+constexpr size_t MAGIC_SIZE = 6;
+
+void read_exact(int fd, void* data, size_t bytes, uint64_t offset, const std::string& path) {
+    auto* ptr = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t count = pread(fd, ptr, bytes, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error("Truncated .npy header in '" + path + "'");
+        }
+        ptr += count;
+        bytes -= static_cast<size_t>(count);
+        offset += static_cast<uint64_t>(count);
+    }
+}
+
+// Value of `key` in the header dictionary, up to the next top-level comma or closing brace
+std::string dict_value(const std::string& dict, const std::string& key, const std::string& path) {
+    auto pos = dict.find("'" + key + "'");
+    if (pos == std::string::npos) {
+        throw std::runtime_error("Missing '" + key + "' in .npy header of '" + path + "'");
+    }
+    pos = dict.find(':', pos);
+    size_t end = pos + 1;
+    int depth = 0;
+    while (end < dict.size() && (depth > 0 || (dict[end] != ',' && dict[end] != '}'))) {
+        depth += dict[end] == '(' ? 1 : dict[end] == ')' ? -1 : 0;
+        ++end;
+    }
+    std::string value = dict.substr(pos + 1, end - pos - 1);
+    value.erase(0, value.find_first_not_of(' '));
+    value.erase(value.find_last_not_of(' ') + 1);
+    return value;
+}
+
+}  // namespace
+
+Header read_header(int fd, const std::string& path) {
+    unsigned char prefix[MAGIC_SIZE + 2];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    read_exact(fd, prefix, sizeof(prefix), 0, path);
+    if (std::memcmp(prefix, MAGIC, MAGIC_SIZE) != 0) {
+        throw std::runtime_error("'" + path + "' is not a .npy file");
+    }
+    uint8_t major = prefix[MAGIC_SIZE];
+
+    size_t header_length = 0;
+    size_t offset = sizeof(prefix);
+    if (major == 1) {
+        uint8_t length[2];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        read_exact(fd, length, sizeof(length), offset, path);
+        header_length = length[0] | (static_cast<size_t>(length[1]) << 8U);
+        offset += sizeof(length);
+    } else if (major == 2 || major == 3) {
+        uint8_t length[4];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        read_exact(fd, length, sizeof(length), offset, path);
+        for (size_t i = 0; i < sizeof(length); ++i) {
+            header_length |= static_cast<size_t>(length[i]) << (8U * i);
+        }
+        offset += sizeof(length);
+    } else {
+        throw std::runtime_error("Unsupported .npy version " + std::to_string(static_cast<unsigned>(major)) + " in '" +
+                                 path + "'");
+    }
+
+    std::string dict(header_length, '\0');
+    read_exact(fd, dict.data(), header_length, offset, path);
+
+    std::string descr = dict_value(dict, "descr", path);
+    if (descr != "'<f4'" && descr != "'=f4'") {
+        throw std::runtime_error("'" + path + "' holds " + descr + " data; only little-endian float32 is supported");
+    }
+    if (dict_value(dict, "fortran_order", path) != "False") {
+        throw std::runtime_error("'" + path + "' is in Fortran order; only C order is supported");
+    }
+
+    std::string shape = dict_value(dict, "shape", path);
+    std::vector<uint64_t> dims;
+    for (size_t pos = 0; pos < shape.size();) {
+        if (shape[pos] >= '0' && shape[pos] <= '9') {
+            size_t end = shape.find_first_not_of("0123456789", pos);
+            dims.push_back(std::stoull(shape.substr(pos, end - pos)));
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+    if (dims.empty() || dims.size() > 2 || (dims.size() == 2 && dims[1] > UINT32_MAX)) {
+        throw std::runtime_error("'" + path + "' must hold a 1-D or 2-D array, got shape " + shape);
+    }
+
+    Header header;
+    header.rows = dims[0];
+    header.width = dims.size() == 2 ? static_cast<uint32_t>(dims[1]) : 1;
+    header.data_offset = offset + header_length;
+    return header;
+}
+
+std::string make_header(uint64_t rows, uint32_t width, size_t alignment) {
+    if (alignment == 0 || alignment % 64 != 0) {
+        throw std::runtime_error("npy header alignment must be a multiple of 64");
+    }
+    std::string dict = "{'descr': '<f4', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " +
+                       std::to_string(width) + "), }";
+    size_t prefix = MAGIC_SIZE + 2 + 2;
+    size_t total = (prefix + dict.size() + 1 + alignment - 1) / alignment * alignment;
+    if (total - prefix > UINT16_MAX) {
+        throw std::runtime_error("npy header alignment is too large");
+    }
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict.push_back('\n');
+
+    std::string header(MAGIC, MAGIC_SIZE);
+    header.push_back('\x01');
+    header.push_back('\x00');
+    auto length = static_cast<uint16_t>(dict.size());
+    header.push_back(static_cast<char>(length & 0xFFU));
+    header.push_back(static_cast<char>(length >> 8U));
+    return header + dict;
+}
+
+}  // namespace npy
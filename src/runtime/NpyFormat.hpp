@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Minimal reader/writer for the NumPy .npy header of a C-ordered, little-endian float32
+// matrix (shape (rows, width), or (rows,) for a single column).
+namespace npy {
+
+struct Header {
+    uint64_t rows = 0;
+    uint32_t width = 0;
+    size_t data_offset = 0;  // Bytes from the start of the file to the first element
+};
+
+// Parse the header at the start of the file open as `fd`. Throws for anything that is not a
+// float32 matrix in C order.
+Header read_header(int fd, const std::string& path);
+
+// Version 1.0 header whose total size (and so the data offset) is a multiple of `alignment`,
+// which must be a multiple of 64
+std::string make_header(uint64_t rows, uint32_t width, size_t alignment = 64);
+
+}  // namespace npy
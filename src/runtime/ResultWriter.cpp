@@ -0,0 +1,261 @@
+#include "ResultWriter.hpp"
+
+#include "EvaluationManager.hpp"
+#include "MemoryManager.hpp"
+#include "NpyFormat.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+constexpr size_t BUFFERED_NPY_HEADER_SIZE = 128;  // Fits any (rows, width) header
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+// Pool buffer wrapped as a constant tensor; the buffer returns to the pool with the tensor
+Tensor pool_tensor(size_t rows, uint32_t width) {
+    auto buffer = MemoryManager::instance().allocate_tensor(rows * width * sizeof(float));
+    void* data = buffer->data();
+    return Tensor(std::static_pointer_cast<void>(buffer), data, {static_cast<uint32_t>(rows), width});
+}
+
+}  // namespace
+
+ResultWriter::ResultWriter(const std::string& path, Options options) : path_(path), options_(options) {
+    if (options_.queue_depth == 0) {
+        throw std::runtime_error("ResultWriter: queue_depth must be positive");
+    }
+    if (options_.direct_io && (options_.block_bytes == 0 || options_.block_bytes % DIRECT_IO_ALIGNMENT != 0)) {
+        throw std::runtime_error("ResultWriter: block_bytes must be a positive multiple of 4096");
+    }
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    bool direct = options_.direct_io;
+    fd_ = ::open(path.c_str(), flags | (direct ? O_DIRECT : 0), 0644);
+    if (fd_ < 0 && direct && errno == EINVAL) {
+        spdlog::warn("O_DIRECT is not supported for '{}', using buffered writes", path);
+        direct = false;
+        fd_ = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open '" + path + "' for writing: " + std::strerror(errno));
+    }
+
+    if (direct) {
+        auto block = MemoryManager::instance().allocate_tensor(options_.block_bytes + DIRECT_IO_ALIGNMENT);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        auto address = reinterpret_cast<uintptr_t>(block->data());
+        staging_ = static_cast<char*>(block->data()) + (align_up(address, DIRECT_IO_ALIGNMENT) - address);
+        staging_owner_ = std::move(block);
+    }
+    if (options_.format == Format::NPY) {
+        header_size_ = direct ? DIRECT_IO_ALIGNMENT : BUFFERED_NPY_HEADER_SIZE;
+    }
+    file_offset_ = header_size_;
+    stats_.direct_io = direct;
+
+    writer_thread_ = std::thread([this]() { writer_loop(); });
+}
+
+ResultWriter::~ResultWriter() {
+    try {
+        close();
+    } catch (const std::exception& e) {
+        spdlog::error("ResultWriter: failed to finish '{}': {}", path_, e.what());
+    }
+}
+
+void ResultWriter::write(const Tensor& tensor) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+    if (closed_) {
+        throw std::runtime_error("ResultWriter: '" + path_ + "' is already closed");
+    }
+    if (!tensor || tensor.rank() == 0 || tensor.total_elements() == 0) {
+        throw std::runtime_error("ResultWriter: cannot write an empty tensor");
+    }
+    uint32_t width = tensor.shape()[tensor.rank() - 1];
+    if (row_width_ != 0 && width != row_width_) {
+        throw std::runtime_error("ResultWriter: rows of " + std::to_string(width) + " values do not match width " +
+                                 std::to_string(row_width_));
+    }
+    row_width_ = width;
+    size_t rows = tensor.total_elements() / width;
+
+    Tensor item;
+    if (tensor.is_lazy()) {
+        item = pool_tensor(rows, width);
+        tt_lazy::eval_into(tensor, item.data_ptr(), item.total_elements());
+    } else if (tensor.owns_external_memory()) {
+        item = tensor;
+    } else {
+        item = pool_tensor(rows, width);
+        std::memcpy(item.data_ptr(), tensor.const_data_ptr(), item.total_elements() * sizeof(float));
+    }
+    rows_ += rows;
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_cv_.wait(lock, [this]() { return queue_.size() < options_.queue_depth || error_; });
+    stats_.producer_wait_ns += elapsed_ns(start);
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    queue_.push_back(std::move(item));
+    stats_.tensors++;
+    stats_.rows += rows;
+    ready_cv_.notify_one();
+}
+
+void ResultWriter::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_cv_.notify_all();
+    writer_thread_.join();
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error = error_;
+    }
+    if (!error) {
+        try {
+            finish_file();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    ::close(fd_);
+    fd_ = -1;
+    staging_owner_.reset();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+ResultWriter::Stats ResultWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ResultWriter::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // Stopping with everything written
+        }
+        Tensor item = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            write_bytes(item.const_data_ptr(), item.total_elements() * sizeof(float));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        item = Tensor();  // Hand the buffer back to the pool
+
+        lock.lock();
+        if (error && !error_) {
+            error_ = error;
+            queue_.clear();
+        }
+        space_cv_.notify_all();
+    }
+}
+
+void ResultWriter::write_bytes(const void* data, size_t bytes) {
+    if (!staging_) {
+        write_at(data, bytes, file_offset_);
+        file_offset_ += bytes;
+        return;
+    }
+
+    // O_DIRECT needs aligned buffers, lengths and offsets: stage into whole blocks
+    const auto* source = static_cast<const char*>(data);
+    while (bytes > 0) {
+        size_t count = std::min(bytes, options_.block_bytes - staging_used_);
+        std::memcpy(staging_ + staging_used_, source, count);
+        staging_used_ += count;
+        source += count;
+        bytes -= count;
+        if (staging_used_ == options_.block_bytes) {
+            write_at(staging_, options_.block_bytes, file_offset_);
+            file_offset_ += options_.block_bytes;
+            staging_used_ = 0;
+        }
+    }
+}
+
+void ResultWriter::write_at(const void* data, size_t bytes, uint64_t offset) {
+    auto start = std::chrono::steady_clock::now();
+    const auto* ptr = static_cast<const char*>(data);
+    for (size_t done = 0; done < bytes;) {
+        ssize_t count = pwrite(fd_, ptr + done, bytes - done, static_cast<off_t>(offset + done));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error("Failed to write '" + path_ + "': " + std::strerror(errno));
+        }
+        done += static_cast<size_t>(count);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.bytes_written += bytes;
+    stats_.io_ns += elapsed_ns(start);
+}
+
+void ResultWriter::finish_file() {
+    if (staging_ && staging_used_ > 0) {
+        // Write the partial block padded to the alignment, then cut the padding off
+        size_t padded = align_up(staging_used_, DIRECT_IO_ALIGNMENT);
+        std::memset(staging_ + staging_used_, 0, padded - staging_used_);
+        write_at(staging_, padded, file_offset_);
+        file_offset_ += staging_used_;
+        staging_used_ = 0;
+        if (ftruncate(fd_, static_cast<off_t>(file_offset_)) != 0) {
+            throw std::runtime_error("Failed to truncate '" + path_ + "': " + std::strerror(errno));
+        }
+    }
+
+    if (options_.format == Format::NPY) {
+        std::string header = npy::make_header(rows_, row_width_, header_size_);
+        if (header.size() != header_size_) {
+            throw std::runtime_error("ResultWriter: .npy header does not fit its reserved space");
+        }
+        if (staging_) {
+            std::memcpy(staging_, header.data(), header.size());
+            write_at(staging_, header.size(), 0);
+        } else {
+            write_at(header.data(), header.size(), 0);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Tensor.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Streams evaluated outputs to a file from a background thread, so offline scoring does
+// not stall on disk writes.
+//
+// Every written tensor contributes rows of its last dimension; all tensors must share that
+// width. Lazy tensors are evaluated straight into a MemoryManager pool buffer, which goes
+// back to the pool once its rows are on disk. Pool-backed and other externally owned
+// tensors are queued without a copy and must not be modified until written; anything else
+// is copied into a pool buffer first.
+//
+// At most `queue_depth` tensors wait for the writer thread; write() blocks beyond that.
+// With `direct_io`, data is staged in page-aligned blocks and written with O_DIRECT,
+// bypassing the page cache (falling back to buffered I/O where O_DIRECT is unsupported).
+// write() and close() are meant to be called from a single producer thread.
+class ResultWriter {
+   public:
+    enum class Format {
+        NPY,  // float32 [rows, width] .npy file
+        RAW   // Headerless float32 rows
+    };
+
+    struct Options {
+        Format format = Format::NPY;
+        size_t queue_depth = 4;
+        bool direct_io = false;
+        size_t block_bytes = 1U << 20U;  // O_DIRECT staging block size, a multiple of 4096
+    };
+
+    struct Stats {
+        uint64_t tensors = 0;
+        uint64_t rows = 0;
+        uint64_t bytes_written = 0;
+        uint64_t producer_wait_ns = 0;  // Time write() blocked on a full queue
+        uint64_t io_ns = 0;             // Time the writer thread spent in write calls
+        bool direct_io = false;         // Whether O_DIRECT is in effect
+    };
+
+    ResultWriter(const std::string& path, Options options);
+    ~ResultWriter();
+
+    // Non-copyable, non-movable (owns the file and the writer thread)
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+    ResultWriter(ResultWriter&&) = delete;
+    ResultWriter& operator=(ResultWriter&&) = delete;
+
+    // Queue a tensor for writing. Rethrows an earlier I/O error from the writer thread.
+    void write(const Tensor& tensor);
+
+    // Write everything queued, finish the file header and close the file. Called by the
+    // destructor if needed (which only logs errors).
+    void close();
+
+    uint32_t row_width() const { return row_width_; }
+    Stats stats() const;
+
+   private:
+    void writer_loop();
+    void write_bytes(const void* data, size_t bytes);
+    void write_at(const void* data, size_t bytes, uint64_t offset);
+    void finish_file();
+
+    std::string path_;
+    Options options_;
+    int fd_ = -1;
+    bool closed_ = false;
+    uint32_t row_width_ = 0;
+    uint64_t rows_ = 0;
+    size_t header_size_ = 0;
+
+    // Writer thread state
+    uint64_t file_offset_ = 0;
+    std::shared_ptr<void> staging_owner_;  // Page-aligned O_DIRECT block from the pool
+    char* staging_ = nullptr;
+    size_t staging_used_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable space_cv_;
+    std::deque<Tensor> queue_;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    Stats stats_;
+    std::thread writer_thread_;
+};
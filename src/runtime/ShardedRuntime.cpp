@@ -0,0 +1,356 @@
+#include "ShardedRuntime.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+#include "passes/ShardingPass.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sched.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+std::runtime_error system_error(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void send_all(int fd, const void* data, size_t size) {
+    ssize_t sent = 0;
+    do {
+        sent = send(fd, data, size, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent != static_cast<ssize_t>(size)) {
+        throw system_error("ShardedRuntime: failed to reach worker");
+    }
+}
+
+// Returns false if the peer has gone away
+bool receive_all(int fd, void* data, size_t size) {
+    ssize_t received = 0;
+    do {
+        received = recv(fd, data, size, 0);
+    } while (received < 0 && errno == EINTR);
+    return received == static_cast<ssize_t>(size);
+}
+
+// Copy columns [begin, end) of a row-major [rows, cols] matrix into a new [rows, end - begin] tensor
+Tensor slice_columns(const Tensor& source, uint32_t begin, uint32_t end) {
+    uint32_t rows = source.size(0);
+    uint32_t cols = source.size(1);
+    Tensor slice(std::vector<uint32_t>{rows, end - begin});
+    const float* src = source.const_data_ptr();
+    float* dst = slice.data_ptr();
+    for (uint32_t r = 0; r < rows; ++r) {
+        std::memcpy(dst + static_cast<size_t>(r) * (end - begin), src + static_cast<size_t>(r) * cols + begin,
+                    (end - begin) * sizeof(float));
+    }
+    return slice;
+}
+
+// Copy rows [begin, end) of a row-major [rows, cols] matrix into a new tensor
+Tensor slice_rows(const Tensor& source, uint32_t begin, uint32_t end) {
+    uint32_t cols = source.size(1);
+    Tensor slice(std::vector<uint32_t>{end - begin, cols});
+    std::memcpy(slice.data_ptr(), source.const_data_ptr() + static_cast<size_t>(begin) * cols,
+                static_cast<size_t>(end - begin) * cols * sizeof(float));
+    return slice;
+}
+
+}  // namespace
+
+struct ShardedRuntime::Command {
+    enum Kind : uint32_t { RUN = 0, SHUTDOWN = 1 };
+    uint32_t kind = RUN;
+    uint32_t operation = 0;
+    uint32_t input_rows = 0;  // Shape of the input published in the arena
+    uint32_t input_cols = 0;
+};
+
+ShardedRuntime::ShardedRuntime(std::unique_ptr<Tape> tape) : ShardedRuntime(std::move(tape), Options{}) {}
+
+ShardedRuntime::ShardedRuntime(std::unique_ptr<Tape> tape, Options options)
+    : tape_(std::move(tape)), options_(options) {
+    if (!tape_) {
+        throw std::runtime_error("ShardedRuntime: tape is null");
+    }
+
+    auto& context = Context::instance();
+    for (const auto& op : tape_->operations()) {
+        if (!op->shard.is_sharded()) {
+            continue;
+        }
+        if (num_shards_ != 0 && op->shard.num_shards != num_shards_) {
+            throw std::runtime_error("ShardedRuntime: all sharded operations must use the same shard count");
+        }
+        num_shards_ = op->shard.num_shards;
+
+        ShardedOperation sharded;
+        sharded.node_id = op->node_id;
+        sharded.columns = ShardingPass::shardable_columns(*op);
+        if (sharded.columns < num_shards_) {
+            throw std::runtime_error("ShardedRuntime: node " + std::to_string(op->node_id) + " cannot be sharded");
+        }
+        const Node* node = context.get_node(op->node_id);
+        if (const auto* args = node->try_as<MatMulArgs>()) {
+            sharded.transpose_a = args->transpose_a;
+            sharded.transpose_b = args->transpose_b;
+        } else {
+            sharded.fused = true;
+            sharded.has_relu = node->as<FusedMLPArgs>().has_relu;
+        }
+        operation_index_[op->node_id] = operations_.size();
+        operations_.push_back(sharded);
+    }
+
+    // Sharded operations are routed to the workers; everything else keeps the local handler
+    register_all_operations(executor_);
+    for (OpTypeId type : {MatMulArgs::type_id(), FusedMLPArgs::type_id()}) {
+        auto local = executor_.get_operation_handler(type);
+        executor_.register_operation(type, [this, local](TapeOperation& op, TapeExecutor& executor) {
+            if (op.shard.is_sharded()) {
+                run_sharded(op, executor);
+            } else {
+                local(op, executor);
+            }
+        });
+    }
+
+    if (num_shards_ > 0) {
+        start_workers();
+    }
+}
+
+ShardedRuntime::~ShardedRuntime() {
+    stop_workers();
+}
+
+void ShardedRuntime::start_workers() {
+    arena_ = mmap(nullptr, options_.arena_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE,
+                  -1, 0);
+    if (arena_ == MAP_FAILED) {
+        arena_ = nullptr;
+        throw system_error("ShardedRuntime: failed to map activation arena");
+    }
+
+    try {
+        for (uint32_t shard = 0; shard < num_shards_; ++shard) {
+            int sockets[2] = {-1, -1};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+            if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+                throw system_error("ShardedRuntime: socketpair failed");
+            }
+            pid_t pid = fork();
+            if (pid < 0) {
+                close(sockets[0]);
+                close(sockets[1]);
+                throw system_error("ShardedRuntime: fork failed");
+            }
+            if (pid == 0) {
+                close(sockets[0]);
+                for (int fd : worker_sockets_) {
+                    close(fd);
+                }
+                worker_main(shard, sockets[1]);
+            }
+            close(sockets[1]);
+            worker_pids_.push_back(pid);
+            worker_sockets_.push_back(sockets[0]);
+        }
+    } catch (...) {
+        stop_workers();
+        throw;
+    }
+    spdlog::info("ShardedRuntime: started {} workers for {} sharded operations", num_shards_, operations_.size());
+}
+
+void ShardedRuntime::worker_main(uint32_t shard, int socket_fd) {
+    int status = 0;
+    try {
+        // The workers run at once, so each gets its share of the coordinator's threads for
+        // the GEMM, its other kernels and BLAS
+        math::set_thread_budget(std::max<size_t>(1, math::thread_budget() / num_shards_));
+
+        if (options_.pin_workers) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            if (cpus > 0) {
+                auto [first, last] = ShardSpec::range(static_cast<uint32_t>(cpus), num_shards_, shard);
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (uint32_t cpu = first; cpu < std::max(last, first + 1); ++cpu) {
+                    CPU_SET(cpu % static_cast<uint32_t>(cpus), &set);
+                }
+                sched_setaffinity(0, sizeof(set), &set);
+            }
+        }
+
+        // Take private copies of this shard's weight slices
+        auto& context = Context::instance();
+        std::vector<WeightSlice> slices;
+        slices.reserve(operations_.size());
+        for (const auto& op : operations_) {
+            const Node* node = context.get_node(op.node_id);
+            const auto& inputs = node->inputs();
+            auto [begin, end] = ShardSpec::range(op.columns, num_shards_, shard);
+            WeightSlice slice;
+            slice.weight = op.transpose_b ? slice_rows(inputs[1], begin, end) : slice_columns(inputs[1], begin, end);
+            if (op.fused) {
+                slice.bias = slice_columns(inputs[2], begin, end);
+            }
+            slices.push_back(std::move(slice));
+        }
+
+        Command command;
+        while (receive_all(socket_fd, &command, sizeof(command)) && command.kind == Command::RUN) {
+            uint8_t ok = 1;
+            try {
+                const auto& op = operations_.at(command.operation);
+                const auto& slice = slices[command.operation];
+                Tensor input(arena_input(), std::vector<uint32_t>{command.input_rows, command.input_cols});
+                Tensor block = op.fused ? math::fused_mlp(input, slice.weight, slice.bias, op.has_relu)
+                                        : math::matmul(input, slice.weight, op.transpose_a, op.transpose_b);
+
+                // Write this shard's columns into the shared [rows, columns] output
+                auto [begin, end] = ShardSpec::range(op.columns, num_shards_, shard);
+                uint32_t width = end - begin;
+                float* out = arena_output();
+                const float* src = block.const_data_ptr();
+                for (uint32_t r = 0; r < block.size(0); ++r) {
+                    std::memcpy(out + static_cast<size_t>(r) * op.columns + begin, src + static_cast<size_t>(r) * width,
+                                width * sizeof(float));
+                }
+            } catch (const std::exception& e) {
+                spdlog::error("ShardedRuntime worker {}: {}", shard, e.what());
+                ok = 0;
+            }
+            send_all(socket_fd, &ok, sizeof(ok));
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("ShardedRuntime worker {}: {}", shard, e.what());
+        status = 1;
+    }
+    // Never return into the parent's stack or run its exit handlers
+    _exit(status);
+}
+
+void ShardedRuntime::stop_workers() {
+    Command shutdown;
+    shutdown.kind = Command::SHUTDOWN;
+    for (int fd : worker_sockets_) {
+        send(fd, &shutdown, sizeof(shutdown), MSG_NOSIGNAL);
+        close(fd);
+    }
+    for (pid_t pid : worker_pids_) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+    }
+    worker_sockets_.clear();
+    worker_pids_.clear();
+    if (arena_) {
+        munmap(arena_, options_.arena_bytes);
+        arena_ = nullptr;
+    }
+}
+
+std::shared_ptr<Tensor> ShardedRuntime::execute(const Tensor& output) {
+    if (!output.is_lazy() || !tape_->find_operation(output.producer_node())) {
+        throw std::runtime_error("ShardedRuntime: output is not produced by this tape");
+    }
+
+    for (const auto& op : tape_->operations()) {
+        op->is_evaluated = false;
+        op->result.reset();
+    }
+    executor_.clear_results();
+    uint64_t sharded_before = stats_.sharded_operations;
+    executor_.execute_tape(*tape_);
+    stats_.local_operations += tape_->size() - (stats_.sharded_operations - sharded_before);
+
+    auto result = executor_.get_result(output.producer_node());
+    if (!result) {
+        throw std::runtime_error("ShardedRuntime: tape did not produce the requested output");
+    }
+    return result;
+}
+
+void ShardedRuntime::run_sharded(TapeOperation& op, TapeExecutor& executor) {
+    auto it = operation_index_.find(op.node_id);
+    if (it == operation_index_.end()) {
+        throw std::runtime_error("ShardedRuntime: node " + std::to_string(op.node_id) + " was not sharded at startup");
+    }
+    const auto& sharded = operations_[it->second];
+
+    const Node* node = Context::instance().get_node(op.node_id);
+    if (!node) {
+        throw std::runtime_error("ShardedRuntime: cannot find node " + std::to_string(op.node_id));
+    }
+    const Tensor& declared = node->inputs()[0];
+    std::shared_ptr<Tensor> input = declared.is_lazy() ? executor.get_result(declared.producer_node())
+                                                       : std::make_shared<Tensor>(declared);
+    if (!input || input->rank() != 2) {
+        throw std::runtime_error("ShardedRuntime: sharded operations need a materialized rank-2 input");
+    }
+
+    uint32_t rows = sharded.transpose_a ? input->size(1) : input->size(0);
+    size_t input_floats = input->total_elements();
+    size_t output_floats = static_cast<size_t>(rows) * sharded.columns;
+    if (input_floats > arena_half_floats() || output_floats > arena_half_floats()) {
+        throw std::runtime_error("ShardedRuntime: activations of node " + std::to_string(op.node_id) +
+                                 " exceed the shared arena; increase Options::arena_bytes");
+    }
+
+    // Publish the input, let every shard fill its columns, then wait for all of them
+    std::memcpy(arena_input(), input->const_data_ptr(), input_floats * sizeof(float));
+    Command command;
+    command.operation = static_cast<uint32_t>(it->second);
+    command.input_rows = input->size(0);
+    command.input_cols = input->size(1);
+    for (int fd : worker_sockets_) {
+        send_all(fd, &command, sizeof(command));
+    }
+    bool failed = false;
+    for (size_t shard = 0; shard < worker_sockets_.size(); ++shard) {
+        uint8_t ok = 0;
+        if (!receive_all(worker_sockets_[shard], &ok, sizeof(ok))) {
+            throw std::runtime_error("ShardedRuntime: worker " + std::to_string(shard) + " exited");
+        }
+        failed = failed || ok == 0;
+    }
+    if (failed) {
+        throw std::runtime_error("ShardedRuntime: a worker failed to execute node " + std::to_string(op.node_id));
+    }
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (!result) {
+        result = std::make_shared<Tensor>(std::vector<uint32_t>{rows, sharded.columns});
+    }
+    std::memcpy(result->data_ptr(), arena_output(), output_floats * sizeof(float));
+    executor.set_result(op.node_id, result);
+    op.result = result;
+
+    stats_.sharded_operations++;
+    stats_.gathered_bytes += output_floats * sizeof(float);
+}
+
+size_t ShardedRuntime::arena_half_floats() const {
+    return options_.arena_bytes / 2 / sizeof(float);
+}
+
+float* ShardedRuntime::arena_input() const {
+    return static_cast<float*>(arena_);
+}
+
+float* ShardedRuntime::arena_output() const {
+    return static_cast<float*>(arena_) + arena_half_floats();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+// Tensor-parallel executor for tapes annotated by ShardingPass, using local worker
+// processes as stand-ins for devices.
+//
+// One worker is forked per shard. At startup each worker copies its column slice of every
+// sharded operation's weights (and bias) into private memory, so a shard only ever reads
+// its own slice. When the tape reaches a sharded operation, the coordinator publishes the
+// operation's input in a shared-memory arena, every worker computes its column block and
+// writes it into the shared output (an all-gather through shared memory), and the
+// coordinator continues with the assembled result. Unsharded operations run locally.
+class ShardedRuntime {
+   public:
+    struct Options {
+        size_t arena_bytes = size_t{64} << 20;  // Shared activation arena, split into input and output halves
+        bool pin_workers = false;               // Pin each worker to its own contiguous block of CPUs
+    };
+
+    struct Stats {
+        uint64_t sharded_operations = 0;  // Sharded operation executions
+        uint64_t local_operations = 0;    // Operations executed by the coordinator
+        uint64_t gathered_bytes = 0;      // Output bytes assembled from worker blocks
+    };
+
+    // All sharded operations in `tape` must use the same shard count; that many workers
+    // are started (none if nothing is sharded). The tape's graph must stay alive while
+    // the runtime is used.
+    explicit ShardedRuntime(std::unique_ptr<Tape> tape);
+    ShardedRuntime(std::unique_ptr<Tape> tape, Options options);
+    ~ShardedRuntime();
+
+    // Non-copyable, non-movable (owns worker processes)
+    ShardedRuntime(const ShardedRuntime&) = delete;
+    ShardedRuntime& operator=(const ShardedRuntime&) = delete;
+    ShardedRuntime(ShardedRuntime&&) = delete;
+    ShardedRuntime& operator=(ShardedRuntime&&) = delete;
+
+    // Run the whole tape and return the result for `output`. Constant inputs are re-read on
+    // every call, so callers may update input buffers in place between runs.
+    std::shared_ptr<Tensor> execute(const Tensor& output);
+
+    const Tape& tape() const { return *tape_; }
+    uint32_t num_shards() const { return num_shards_; }
+    const std::vector<pid_t>& worker_pids() const { return worker_pids_; }
+    Stats stats() const { return stats_; }
+
+   private:
+    struct ShardedOperation {
+        NodeId node_id = 0;
+        bool fused = false;  // FusedMLP (weights + bias) rather than MatMul
+        bool transpose_a = false;
+        bool transpose_b = false;
+        bool has_relu = false;
+        uint32_t columns = 0;
+    };
+
+    // Worker-private weight slices for one sharded operation
+    struct WeightSlice {
+        Tensor weight;
+        Tensor bias;
+    };
+
+    struct Command;
+
+    void start_workers();
+    [[noreturn]] void worker_main(uint32_t shard, int socket_fd);
+    void stop_workers();
+    void run_sharded(TapeOperation& op, TapeExecutor& executor);
+
+    float* arena_input() const;
+    float* arena_output() const;
+    size_t arena_half_floats() const;
+
+    std::unique_ptr<Tape> tape_;
+    Options options_;
+    uint32_t num_shards_ = 0;
+    std::vector<ShardedOperation> operations_;
+    std::unordered_map<NodeId, size_t> operation_index_;
+
+    TapeExecutor executor_;
+    void* arena_ = nullptr;
+    std::vector<pid_t> worker_pids_;
+    std::vector<int> worker_sockets_;
+    Stats stats_;
+};
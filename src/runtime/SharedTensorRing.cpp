@@ -0,0 +1,162 @@
+#include "SharedTensorRing.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t RING_MAGIC = 0x5454'4C5A'5249'4E47ULL;  // "TTLZRING"
+
+// The ring file must not change size while it is mapped, or accesses past a shrunken end fault
+constexpr int REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_GROW;
+
+// False on overflow
+bool align_up(size_t value, size_t alignment, size_t* aligned) {
+    size_t padded = 0;
+    if (__builtin_add_overflow(value, alignment - 1, &padded)) {
+        return false;
+    }
+    *aligned = padded / alignment * alignment;
+    return true;
+}
+
+std::runtime_error system_error(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+// Ring layout: Header | padding | slot[0] input | slot[0] output | slot[1] input | ...
+struct SharedTensorRing::Header {
+    uint64_t magic;
+    uint32_t num_slots;
+    uint32_t reserved;
+    uint64_t input_floats;
+    uint64_t output_floats;
+};
+
+bool SharedTensorRing::compute_layout(uint32_t num_slots, uint64_t input_floats, uint64_t output_floats,
+                                      Layout* layout) {
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    size_t output_size = 0;
+    size_t slots_bytes = 0;
+    size_t header_size = 0;
+    // Both sizes come from another process when attaching, so every step is checked
+    return !__builtin_mul_overflow(input_floats, sizeof(float), &input_bytes) &&
+           !__builtin_mul_overflow(output_floats, sizeof(float), &output_bytes) &&
+           align_up(input_bytes, DATA_ALIGNMENT, &layout->output_offset) &&
+           align_up(output_bytes, DATA_ALIGNMENT, &output_size) &&
+           !__builtin_add_overflow(layout->output_offset, output_size, &layout->slot_stride) &&
+           !__builtin_mul_overflow(layout->slot_stride, static_cast<size_t>(num_slots), &slots_bytes) &&
+           align_up(sizeof(Header), DATA_ALIGNMENT, &header_size) &&
+           !__builtin_add_overflow(header_size, slots_bytes, &layout->total_size);
+}
+
+std::shared_ptr<SharedTensorRing> SharedTensorRing::create(uint32_t num_slots, size_t input_floats,
+                                                           size_t output_floats) {
+    if (num_slots == 0 || input_floats == 0 || output_floats == 0) {
+        throw std::runtime_error("SharedTensorRing: slots, input and output sizes must be non-zero");
+    }
+    Layout layout;
+    if (!compute_layout(num_slots, input_floats, output_floats, &layout)) {
+        throw std::runtime_error("SharedTensorRing: ring size overflows");
+    }
+
+    int fd = memfd_create("tt_lazy_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        throw system_error("SharedTensorRing: memfd_create failed");
+    }
+    if (ftruncate(fd, static_cast<off_t>(layout.total_size)) != 0) {
+        close(fd);
+        throw system_error("SharedTensorRing: failed to size ring");
+    }
+    if (fcntl(fd, F_ADD_SEALS, REQUIRED_SEALS) != 0) {
+        close(fd);
+        throw system_error("SharedTensorRing: failed to seal ring");
+    }
+    void* base = mmap(nullptr, layout.total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        throw system_error("SharedTensorRing: failed to map ring");
+    }
+
+    auto* header = static_cast<Header*>(base);
+    header->magic = RING_MAGIC;
+    header->num_slots = num_slots;
+    header->input_floats = input_floats;
+    header->output_floats = output_floats;
+
+    return std::shared_ptr<SharedTensorRing>(
+        new SharedTensorRing(fd, base, layout.total_size, num_slots, input_floats, output_floats, layout));
+}
+
+std::shared_ptr<SharedTensorRing> SharedTensorRing::attach(int fd) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS) {
+        throw std::runtime_error("SharedTensorRing: ring file must be sealed against resizing");
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        throw system_error("SharedTensorRing: fstat failed");
+    }
+    auto size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(Header)) {
+        throw std::runtime_error("SharedTensorRing: file too small to be a ring");
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        throw system_error("SharedTensorRing: failed to map ring");
+    }
+
+    // The header is read once; the peer may rewrite it later, but only these copies are used
+    Header header = *static_cast<const Header*>(base);
+    Layout layout;
+    if (header.magic != RING_MAGIC || header.num_slots == 0 ||
+        !compute_layout(header.num_slots, header.input_floats, header.output_floats, &layout) ||
+        layout.total_size > size) {
+        munmap(base, size);
+        throw std::runtime_error("SharedTensorRing: invalid ring header");
+    }
+    return std::shared_ptr<SharedTensorRing>(new SharedTensorRing(
+        fd, base, size, header.num_slots, header.input_floats, header.output_floats, layout));
+}
+
+SharedTensorRing::SharedTensorRing(int fd, void* base, size_t mapped_size, uint32_t num_slots, size_t input_floats,
+                                   size_t output_floats, const Layout& layout)
+    : fd_(fd),
+      base_(base),
+      mapped_size_(mapped_size),
+      num_slots_(num_slots),
+      input_floats_(input_floats),
+      output_floats_(output_floats),
+      slot_stride_(layout.slot_stride),
+      output_offset_(layout.output_offset) {}
+
+SharedTensorRing::~SharedTensorRing() {
+    munmap(base_, mapped_size_);
+    close(fd_);
+}
+
+float* SharedTensorRing::input(uint32_t slot) const {
+    if (slot >= num_slots_) {
+        throw std::runtime_error("SharedTensorRing: slot " + std::to_string(slot) + " out of range");
+    }
+    size_t header_size = 0;
+    align_up(sizeof(Header), DATA_ALIGNMENT, &header_size);
+    auto* slots = static_cast<char*>(base_) + header_size;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<float*>(slots + slot * slot_stride_);
+}
+
+float* SharedTensorRing::output(uint32_t slot) const {
+    auto* in = reinterpret_cast<char*>(input(slot));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return reinterpret_cast<float*>(in + output_offset_);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed set of input/output slots in an anonymous shared-memory file (memfd), used to
+// move tensors between an inference client and the server without copying them through
+// the socket. The client creates the ring and passes its file descriptor to the server.
+//
+// Each slot holds one request: `input_floats` of input followed by `output_floats` of
+// output, both DATA_ALIGNMENT aligned. The memfd is sealed against shrinking and growing, so
+// the peer cannot resize it under a mapping.
+class SharedTensorRing {
+   public:
+    static constexpr size_t DATA_ALIGNMENT = 64;
+
+    // Create a new ring backed by a fresh memfd
+    static std::shared_ptr<SharedTensorRing> create(uint32_t num_slots, size_t input_floats, size_t output_floats);
+
+    // Map a ring received from another process. Takes ownership of `fd` on success only.
+    // Rejects files without the resize seals and headers whose sizes overflow or exceed the file.
+    static std::shared_ptr<SharedTensorRing> attach(int fd);
+
+    ~SharedTensorRing();
+
+    // Non-copyable, non-movable (owns the mapping and descriptor)
+    SharedTensorRing(const SharedTensorRing&) = delete;
+    SharedTensorRing& operator=(const SharedTensorRing&) = delete;
+    SharedTensorRing(SharedTensorRing&&) = delete;
+    SharedTensorRing& operator=(SharedTensorRing&&) = delete;
+
+    float* input(uint32_t slot) const;
+    float* output(uint32_t slot) const;
+
+    uint32_t num_slots() const { return num_slots_; }
+    size_t input_floats() const { return input_floats_; }
+    size_t output_floats() const { return output_floats_; }
+    int fd() const { return fd_; }
+
+   private:
+    struct Header;
+
+    struct Layout {
+        size_t output_offset = 0;
+        size_t slot_stride = 0;
+        size_t total_size = 0;
+    };
+    // False if the sizes overflow
+    static bool compute_layout(uint32_t num_slots, uint64_t input_floats, uint64_t output_floats, Layout* layout);
+
+    SharedTensorRing(int fd, void* base, size_t mapped_size, uint32_t num_slots, size_t input_floats,
+                     size_t output_floats, const Layout& layout);
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t mapped_size_ = 0;
+    uint32_t num_slots_ = 0;
+    size_t input_floats_ = 0;
+    size_t output_floats_ = 0;
+    size_t slot_stride_ = 0;   // Bytes between consecutive slots
+    size_t output_offset_ = 0;  // Bytes from a slot's input to its output
+};
@@ -0,0 +1,425 @@
+#include "SharedWeightStore.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <spdlog/spdlog.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint64_t SEGMENT_MAGIC = 0x5454'4C5A'5357'4731ULL;  // "TTLZSWG1"
+constexpr uint32_t SEGMENT_VERSION = 2;
+
+enum SegmentState : uint32_t {
+    STATE_POPULATING = 0,
+    STATE_READY = 1,
+    STATE_FAILED = 2,
+};
+
+size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string normalize_name(const std::string& segment_name) {
+    if (segment_name.empty()) {
+        throw std::runtime_error("Shared weight segment name must not be empty");
+    }
+    return segment_name[0] == '/' ? segment_name : "/" + segment_name;
+}
+
+std::runtime_error system_error(const std::string& what, const std::string& segment_name) {
+    return std::runtime_error(what + " '" + segment_name + "': " + std::strerror(errno));
+}
+
+// The creator holds an exclusive flock on the segment until the weights are published, and
+// the kernel drops it if the creator dies. Errors other than contention count as held, so
+// attaching falls back to the timeout.
+bool creator_holds_lock(int fd) {
+    if (flock(fd, LOCK_SH | LOCK_NB) != 0) {
+        return true;
+    }
+    flock(fd, LOCK_UN);
+    return false;
+}
+
+// Unlink `name` if it still refers to the segment open as `fd`, not one a process that took
+// over in the meantime created
+void unlink_if_same(const std::string& name, int fd) {
+    struct stat ours {};
+    struct stat current {};
+    int current_fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (current_fd < 0) {
+        return;
+    }
+    bool same = fstat(fd, &ours) == 0 && fstat(current_fd, &current) == 0 && ours.st_dev == current.st_dev &&
+                ours.st_ino == current.st_ino;
+    close(current_fd);
+    if (same) {
+        shm_unlink(name.c_str());
+    }
+}
+
+}  // namespace
+
+// Segment layout: Header | EntryRecord[num_entries] | padding | weight data (each DATA_ALIGNMENT aligned)
+struct SharedWeightStore::Header {
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> state;
+    uint64_t total_size;
+    uint32_t num_entries;
+    uint32_t reserved;
+};
+
+struct SharedWeightStore::EntryRecord {
+    char name[MAX_NAME_LENGTH + 1];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Fixed layout shared between processes
+    uint32_t rank;
+    uint32_t shape[MAX_RANK];  // NOLINT(cppcoreguidelines-avoid-c-arrays) - Fixed layout shared between processes
+    uint32_t layout;
+    uint64_t offset;
+    uint64_t numel;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Segment state must be lock-free across processes");
+
+std::shared_ptr<SharedWeightStore> SharedWeightStore::create_or_attach(const std::string& segment_name,
+                                                                       const WeightLoader& loader,
+                                                                       std::chrono::milliseconds timeout) {
+    std::string name = normalize_name(segment_name);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (true) {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd >= 0) {
+            return populate(name, fd, loader);
+        }
+        if (errno != EEXIST) {
+            throw system_error("Failed to create shared weight segment", name);
+        }
+
+        fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            if (errno == ENOENT) {
+                continue;  // Unlinked since, e.g. by a failed creator: try to create it again
+            }
+            throw system_error("Failed to open shared weight segment", name);
+        }
+        std::shared_ptr<SharedWeightStore> store;
+        try {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            store = attach_fd(name, fd, std::max(remaining, std::chrono::milliseconds(0)));
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        if (store) {
+            close(fd);
+            return store;
+        }
+
+        // Left behind by a dead creator or an older layout version: replace it
+        spdlog::warn("Replacing stale shared weight segment {}", name);
+        unlink_if_same(name, fd);
+        close(fd);
+    }
+}
+
+std::shared_ptr<SharedWeightStore> SharedWeightStore::populate(const std::string& segment_name, int fd,
+                                                               const WeightLoader& loader) {
+    // We own the segment: load the weights and publish them, holding the creator lock until
+    // then. Any failure leaves the segment marked as failed and unlinked so attached workers
+    // stop waiting.
+    try {
+        if (flock(fd, LOCK_EX) != 0) {
+            throw system_error("Failed to lock shared weight segment", segment_name);
+        }
+        auto store = create(segment_name, fd, loader());
+        close(fd);
+        return store;
+    } catch (...) {
+        struct stat st {};
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+            void* base = mmap(nullptr, sizeof(Header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (base != MAP_FAILED) {
+                static_cast<Header*>(base)->state.store(STATE_FAILED, std::memory_order_release);
+                munmap(base, sizeof(Header));
+            }
+        }
+        close(fd);
+        shm_unlink(segment_name.c_str());
+        throw;
+    }
+}
+
+std::shared_ptr<SharedWeightStore> SharedWeightStore::attach(const std::string& segment_name,
+                                                             std::chrono::milliseconds timeout) {
+    std::string name = normalize_name(segment_name);
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw system_error("Failed to open shared weight segment", name);
+    }
+
+    std::shared_ptr<SharedWeightStore> store;
+    try {
+        store = attach_fd(name, fd, timeout);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    close(fd);
+    if (!store) {
+        throw std::runtime_error("Shared weight segment '" + name +
+                                 "' is stale: its creator died or it has an older layout version");
+    }
+    return store;
+}
+
+void SharedWeightStore::unlink(const std::string& segment_name) {
+    std::string name = normalize_name(segment_name);
+    if (shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+        throw system_error("Failed to unlink shared weight segment", name);
+    }
+}
+
+std::shared_ptr<SharedWeightStore> SharedWeightStore::create(const std::string& segment_name, int fd,
+                                                             const std::vector<WeightSpec>& weights) {
+    // Plan the layout
+    size_t data_offset = align_up(sizeof(Header) + weights.size() * sizeof(EntryRecord), DATA_ALIGNMENT);
+    std::vector<EntryRecord> records(weights.size());
+    for (size_t i = 0; i < weights.size(); ++i) {
+        const auto& weight = weights[i];
+        auto& record = records[i];
+
+        if (weight.name.empty() || weight.name.size() > MAX_NAME_LENGTH) {
+            throw std::runtime_error("Invalid shared weight name '" + weight.name + "'");
+        }
+        if (weight.shape.empty() || weight.shape.size() > MAX_RANK || weight.data == nullptr) {
+            throw std::runtime_error("Invalid shared weight '" + weight.name + "': needs data and rank 1-" +
+                                     std::to_string(MAX_RANK));
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (weights[j].name == weight.name) {
+                throw std::runtime_error("Duplicate shared weight '" + weight.name + "'");
+            }
+        }
+
+        std::memset(&record, 0, sizeof(record));
+        std::memcpy(record.name, weight.name.data(), weight.name.size());
+        record.rank = static_cast<uint32_t>(weight.shape.size());
+        std::copy(weight.shape.begin(), weight.shape.end(), record.shape);
+        record.layout = static_cast<uint32_t>(weight.layout);
+        if (weight.layout == Layout::MATMUL_RHS_PACKED) {
+            if (weight.shape.size() != 2) {
+                throw std::runtime_error("Packed matmul weight '" + weight.name + "' must be 2D");
+            }
+            std::swap(record.shape[0], record.shape[1]);
+        }
+
+        record.numel = 1;
+        for (uint32_t dim : weight.shape) {
+            record.numel *= dim;
+        }
+        record.offset = data_offset;
+        data_offset = align_up(data_offset + record.numel * sizeof(float), DATA_ALIGNMENT);
+    }
+    size_t total_size = std::max(data_offset, sizeof(Header));
+
+    if (ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+        throw system_error("Failed to size shared weight segment", segment_name);
+    }
+    void* base = mmap(nullptr, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        throw system_error("Failed to map shared weight segment", segment_name);
+    }
+    auto store = std::shared_ptr<SharedWeightStore>(new SharedWeightStore(segment_name, base, total_size, true));
+
+    // Populate: header (still marked as populating), entry table, then weight data
+    auto* bytes = static_cast<char*>(base);
+    auto* header = new (base) Header();
+    header->magic = SEGMENT_MAGIC;
+    header->version = SEGMENT_VERSION;
+    header->total_size = total_size;
+    header->num_entries = static_cast<uint32_t>(records.size());
+    std::memcpy(bytes + sizeof(Header), records.data(), records.size() * sizeof(EntryRecord));
+
+    for (size_t i = 0; i < weights.size(); ++i) {
+        const auto& weight = weights[i];
+        auto* dst = reinterpret_cast<float*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            bytes + records[i].offset);
+
+        if (weight.layout == Layout::MATMUL_RHS_PACKED) {
+            // [K, N] -> [N, K]
+            size_t rows = weight.shape[0];
+            size_t cols = weight.shape[1];
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t c = 0; c < cols; ++c) {
+                    dst[c * rows + r] = weight.data[r * cols + c];
+                }
+            }
+        } else {
+            std::memcpy(dst, weight.data, records[i].numel * sizeof(float));
+        }
+    }
+
+    // Publish, then drop write access so this process sees the same read-only view as the rest
+    header->state.store(STATE_READY, std::memory_order_release);
+    if (mprotect(base, total_size, PROT_READ) != 0) {
+        throw system_error("Failed to make shared weight segment read-only", segment_name);
+    }
+
+    spdlog::info("Created shared weight segment {} ({} weights, {} bytes)", segment_name, records.size(),
+                 total_size);
+    return store;
+}
+
+std::shared_ptr<SharedWeightStore> SharedWeightStore::attach_fd(const std::string& segment_name, int fd,
+                                                                std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto wait_or_throw = [&](const char* what) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            throw std::runtime_error("Timed out waiting for shared weight segment '" + segment_name + "' " + what);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    };
+    // An unpublished segment whose creator lock is free on two probes a poll apart has lost
+    // its creator; the second probe covers a creator between shm_open and taking the lock
+    int free_probes = 0;
+    auto creator_died = [&]() {
+        free_probes = creator_holds_lock(fd) ? 0 : free_probes + 1;
+        return free_probes >= 2;
+    };
+
+    // The creator sizes the segment right after creating it
+    struct stat st {};
+    while (true) {
+        if (fstat(fd, &st) != 0) {
+            throw system_error("Failed to stat shared weight segment", segment_name);
+        }
+        if (static_cast<size_t>(st.st_size) >= sizeof(Header)) {
+            break;
+        }
+        if (creator_died()) {
+            return nullptr;
+        }
+        wait_or_throw("to be sized");
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        throw system_error("Failed to map shared weight segment", segment_name);
+    }
+    auto store = std::shared_ptr<SharedWeightStore>(new SharedWeightStore(segment_name, base, size, false));
+
+    // Wait for the creator to publish the weights
+    const Header& header = store->header();
+    while (true) {
+        uint32_t state = header.state.load(std::memory_order_acquire);
+        if (state == STATE_READY) {
+            break;
+        }
+        if (state == STATE_FAILED) {
+            throw std::runtime_error("Shared weight segment '" + segment_name + "' failed to populate");
+        }
+        if (creator_died()) {
+            return nullptr;
+        }
+        wait_or_throw("to be populated");
+    }
+
+    if (header.magic == SEGMENT_MAGIC && header.version != SEGMENT_VERSION) {
+        return nullptr;
+    }
+    if (header.magic != SEGMENT_MAGIC || header.total_size != size ||
+        sizeof(Header) + header.num_entries * sizeof(EntryRecord) > size) {
+        throw std::runtime_error("Shared weight segment '" + segment_name + "' has an incompatible layout");
+    }
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base) + sizeof(Header));
+    for (uint32_t i = 0; i < header.num_entries; ++i) {
+        const auto& entry = entries[i];
+        if (entry.rank == 0 || entry.rank > MAX_RANK || entry.offset + entry.numel * sizeof(float) > size) {
+            throw std::runtime_error("Shared weight segment '" + segment_name + "' has a corrupt entry table");
+        }
+    }
+    return store;
+}
+
+SharedWeightStore::SharedWeightStore(std::string segment_name, void* base, size_t mapped_size, bool is_creator)
+    : segment_name_(std::move(segment_name)), base_(base), mapped_size_(mapped_size), is_creator_(is_creator) {
+}
+
+SharedWeightStore::~SharedWeightStore() {
+    if (base_ != nullptr) {
+        munmap(base_, mapped_size_);
+    }
+}
+
+const SharedWeightStore::Header& SharedWeightStore::header() const {
+    return *static_cast<const Header*>(base_);
+}
+
+const SharedWeightStore::EntryRecord* SharedWeightStore::find_entry(const std::string& name) const {
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base_) + sizeof(Header));
+    for (uint32_t i = 0; i < header().num_entries; ++i) {
+        if (std::strncmp(entries[i].name, name.c_str(), MAX_NAME_LENGTH + 1) == 0) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+Tensor SharedWeightStore::get(const std::string& name) const {
+    const EntryRecord* entry = find_entry(name);
+    if (!entry) {
+        throw std::runtime_error("Shared weight '" + name + "' not found in segment '" + segment_name_ + "'");
+    }
+
+    // The mapping is read-only: graph operations never write through a constant's data pointer,
+    // and the tensor is marked so in-place updates refuse it
+    auto* data = const_cast<char*>(  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                     static_cast<const char*>(base_)) +
+                 entry->offset;
+    std::vector<uint32_t> shape(entry->shape, entry->shape + entry->rank);
+    auto owner = std::const_pointer_cast<SharedWeightStore>(shared_from_this());
+    Tensor tensor(std::static_pointer_cast<void>(owner), data, shape);
+    tensor.mark_read_only();
+    return tensor;
+}
+
+bool SharedWeightStore::contains(const std::string& name) const {
+    return find_entry(name) != nullptr;
+}
+
+SharedWeightStore::Layout SharedWeightStore::layout(const std::string& name) const {
+    const EntryRecord* entry = find_entry(name);
+    if (!entry) {
+        throw std::runtime_error("Shared weight '" + name + "' not found in segment '" + segment_name_ + "'");
+    }
+    return static_cast<Layout>(entry->layout);
+}
+
+std::vector<std::string> SharedWeightStore::names() const {
+    const auto* entries = reinterpret_cast<const EntryRecord*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        static_cast<const char*>(base_) + sizeof(Header));
+    std::vector<std::string> result;
+    result.reserve(header().num_entries);
+    for (uint32_t i = 0; i < header().num_entries; ++i) {
+        result.emplace_back(entries[i].name, strnlen(entries[i].name, MAX_NAME_LENGTH + 1));
+    }
+    return result;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Tensor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Constant weights placed in a named POSIX shared-memory segment so that every worker
+// process on a host maps the same physical pages.
+//
+// The first process to open a segment name creates it, loads the weights and publishes
+// them; every later process attaches read-only and never touches the weight source.
+// Tensors handed out by the store are zero-copy views that keep the mapping alive.
+class SharedWeightStore : public std::enable_shared_from_this<SharedWeightStore> {
+   public:
+    // How a weight is laid out in the segment
+    enum class Layout : uint32_t {
+        ROW_MAJOR = 0,
+        // Pre-packed for use as the right-hand side of matmul: a [K, N] weight is stored as
+        // its [N, K] transpose so the kernel streams contiguous rows (use transpose_b = true)
+        MATMUL_RHS_PACKED = 1,
+    };
+
+    // Weight description supplied by the creating process
+    struct WeightSpec {
+        std::string name;
+        std::vector<uint32_t> shape;  // Logical shape of `data` (row-major)
+        const float* data = nullptr;
+        Layout layout = Layout::ROW_MAJOR;
+    };
+
+    using WeightLoader = std::function<std::vector<WeightSpec>()>;
+
+    static constexpr size_t MAX_NAME_LENGTH = 63;
+    static constexpr size_t MAX_RANK = 8;  // Dimensions stored per segment entry
+    static constexpr size_t DATA_ALIGNMENT = 64;
+
+    // Create the segment and populate it with the weights returned by `loader`, or attach
+    // read-only if another process already created it. Attaching waits up to `timeout` for
+    // the creator to finish populating. A segment whose creator died before publishing, or
+    // one left by an older layout version, is unlinked and created again.
+    static std::shared_ptr<SharedWeightStore> create_or_attach(
+        const std::string& segment_name, const WeightLoader& loader,
+        std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+    // Attach read-only to an existing, populated segment; throws if it is stale
+    static std::shared_ptr<SharedWeightStore> attach(const std::string& segment_name,
+                                                     std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+    // Remove the segment name; existing mappings stay valid until they are unmapped
+    static void unlink(const std::string& segment_name);
+
+    ~SharedWeightStore();
+
+    // Non-copyable, non-movable (tensors hold the mapping through shared_from_this)
+    SharedWeightStore(const SharedWeightStore&) = delete;
+    SharedWeightStore& operator=(const SharedWeightStore&) = delete;
+    SharedWeightStore(SharedWeightStore&&) = delete;
+    SharedWeightStore& operator=(SharedWeightStore&&) = delete;
+
+    // Constant tensor viewing the named weight. Packed weights report their stored
+    // (transposed) shape. Throws if the weight does not exist.
+    Tensor get(const std::string& name) const;
+    bool contains(const std::string& name) const;
+    Layout layout(const std::string& name) const;
+    std::vector<std::string> names() const;
+
+    const std::string& segment_name() const { return segment_name_; }
+    bool is_creator() const { return is_creator_; }
+    size_t mapped_bytes() const { return mapped_size_; }
+
+   private:
+    struct Header;
+    struct EntryRecord;
+
+    SharedWeightStore(std::string segment_name, void* base, size_t mapped_size, bool is_creator);
+
+    static std::shared_ptr<SharedWeightStore> create(const std::string& segment_name, int fd,
+                                                     const std::vector<WeightSpec>& weights);
+    static std::shared_ptr<SharedWeightStore> populate(const std::string& segment_name, int fd,
+                                                       const WeightLoader& loader);
+    // Null if the segment is stale (see create_or_attach)
+    static std::shared_ptr<SharedWeightStore> attach_fd(const std::string& segment_name, int fd,
+                                                        std::chrono::milliseconds timeout);
+
+    const Header& header() const;
+    const EntryRecord* find_entry(const std::string& name) const;
+
+    std::string segment_name_;
+    void* base_;
+    size_t mapped_size_;
+    bool is_creator_;
+};
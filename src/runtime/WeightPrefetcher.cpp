@@ -0,0 +1,137 @@
+#include "WeightPrefetcher.hpp"
+
+#include "Tape.hpp"
+
+#include <algorithm>
+
+#include <unistd.h>
+
+WeightPrefetcher::WeightPrefetcher(std::shared_ptr<MappedWeightFile> weights)
+    : WeightPrefetcher(std::move(weights), Options{}) {}
+
+WeightPrefetcher::WeightPrefetcher(std::shared_ptr<MappedWeightFile> weights, Options options)
+    : weights_(std::move(weights)), options_(options) {
+    worker_ = std::thread([this]() { worker_loop(); });
+}
+
+WeightPrefetcher::~WeightPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+}
+
+void WeightPrefetcher::on_tape_begin(const Tape& tape) {
+    const auto& operations = tape.operations();
+    position_.clear();
+    reads_.assign(operations.size(), {});
+    releases_.assign(operations.size(), {});
+    prefetched_until_ = 0;
+
+    std::unordered_map<const void*, size_t> last_use;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        position_[operations[i]->node_id] = i;
+        for (const auto& constant : operations[i]->constant_inputs) {
+            const void* data = constant.raw_data();
+            if (weights_->contains_address(data)) {
+                reads_[i].push_back({data, constant.nbytes()});
+                last_use[data] = i;
+            }
+        }
+    }
+    for (size_t i = 0; i < operations.size(); ++i) {
+        for (const auto& range : reads_[i]) {
+            if (last_use[range.data] == i) {
+                releases_[i].push_back(range);
+                last_use[range.data] = operations.size();  // Release each weight once
+            }
+        }
+    }
+
+    // Get the first layers loading before the first operation starts
+    prefetch_through(options_.lookahead);
+}
+
+void WeightPrefetcher::on_tape_end([[maybe_unused]] const Tape& tape) {
+    position_.clear();
+    reads_.clear();
+    releases_.clear();
+}
+
+void WeightPrefetcher::on_operation_begin(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    if (it != position_.end()) {
+        prefetch_through(it->second + options_.lookahead + 1);
+    }
+}
+
+void WeightPrefetcher::on_operation_end(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    if (!options_.release_after_use || it == position_.end()) {
+        return;
+    }
+    for (const auto& range : releases_[it->second]) {
+        weights_->dont_need(range.data, range.bytes);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.released_bytes += range.bytes;
+    }
+}
+
+void WeightPrefetcher::prefetch_through(size_t position) {
+    position = std::min(position, reads_.size());
+    if (prefetched_until_ >= position) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (; prefetched_until_ < position; ++prefetched_until_) {
+            for (const auto& range : reads_[prefetched_until_]) {
+                queue_.push_back(range);
+            }
+        }
+    }
+    cv_.notify_one();
+}
+
+void WeightPrefetcher::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+WeightPrefetcher::Stats WeightPrefetcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void WeightPrefetcher::worker_loop() {
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        Range range = queue_.front();
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        // Start readahead, then fault every page in here so the compute thread does not
+        weights_->will_need(range.data, range.bytes);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* bytes = reinterpret_cast<const volatile char*>(range.data);
+        for (size_t offset = 0; offset < range.bytes; offset += page) {
+            (void)bytes[offset];
+        }
+
+        lock.lock();
+        busy_ = false;
+        stats_.prefetch_requests++;
+        stats_.prefetched_bytes += range.bytes;
+        if (queue_.empty()) {
+            idle_cv_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "ExecutionObserver.hpp"
+#include "MappedWeightFile.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Execution observer that streams weights from a MappedWeightFile layer by layer.
+//
+// When a tape starts, the prefetcher records which mapped weights every operation reads.
+// While operation i runs, a background thread pages in the weights of operations
+// i+1 .. i+lookahead (MADV_WILLNEED plus touching each page), so compute rarely waits on
+// disk. After the last operation that reads a weight finishes, its pages are released
+// with MADV_DONTNEED, keeping the resident set near `lookahead` layers of weights.
+class WeightPrefetcher : public ExecutionObserver {
+   public:
+    struct Options {
+        size_t lookahead = 2;           // Operations ahead of the current one to prefetch
+        bool release_after_use = true;  // Drop weights after their last use in the tape
+    };
+
+    struct Stats {
+        uint64_t prefetch_requests = 0;
+        uint64_t prefetched_bytes = 0;
+        uint64_t released_bytes = 0;
+    };
+
+    explicit WeightPrefetcher(std::shared_ptr<MappedWeightFile> weights);
+    WeightPrefetcher(std::shared_ptr<MappedWeightFile> weights, Options options);
+    ~WeightPrefetcher() override;
+
+    // Non-copyable, non-movable (owns the prefetch thread)
+    WeightPrefetcher(const WeightPrefetcher&) = delete;
+    WeightPrefetcher& operator=(const WeightPrefetcher&) = delete;
+    WeightPrefetcher(WeightPrefetcher&&) = delete;
+    WeightPrefetcher& operator=(WeightPrefetcher&&) = delete;
+
+    void on_tape_begin(const Tape& tape) override;
+    void on_tape_end(const Tape& tape) override;
+    void on_operation_begin(const TapeOperation& op) override;
+    void on_operation_end(const TapeOperation& op) override;
+
+    // Block until every queued prefetch has been issued
+    void wait_idle();
+
+    Stats stats() const;
+
+   private:
+    struct Range {
+        const void* data = nullptr;
+        size_t bytes = 0;
+    };
+
+    void prefetch_through(size_t position);
+    void worker_loop();
+
+    std::shared_ptr<MappedWeightFile> weights_;
+    Options options_;
+
+    // Plan for the tape being executed
+    std::unordered_map<NodeId, size_t> position_;
+    std::vector<std::vector<Range>> reads_;     // Mapped weights read by each operation
+    std::vector<std::vector<Range>> releases_;  // Mapped weights whose last use is each operation
+    size_t prefetched_until_ = 0;               // Operations [0, prefetched_until_) are queued
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_cv_;
+    std::deque<Range> queue_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    Stats stats_;
+    std::thread worker_;
+};
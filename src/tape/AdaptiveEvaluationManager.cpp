@@ -0,0 +1,127 @@
+#include "AdaptiveEvaluationManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace tt_lazy {
+
+AdaptiveEvaluationManager::AdaptiveEvaluationManager(const Options& options) : options_(options) {
+    // The tape manager holds every result; eager runs read it and only keep their root there
+    immediate_.set_result_source([this](NodeId node_id) { return tape_.cached_result(node_id); });
+}
+
+std::shared_ptr<Tensor> AdaptiveEvaluationManager::evaluate(const Tensor& tensor) {
+    if (!tensor.is_lazy() || tensor.is_evaluated()) {
+        return tape_.evaluate(tensor);
+    }
+
+    NodeId node_id = tensor.producer_node();
+    if (tape_.is_cached(node_id)) {
+        return tape_.evaluate(tensor);
+    }
+
+    if (!tape_only()) {
+        // Counts only nodes without a result in either mode, as both read the cached ones
+        size_t nodes = immediate_.pending_nodes(tensor, options_.max_eager_nodes + 1);
+        if (choose_eager(nodes)) {
+            size_t executed = immediate_.get_stats().operations_executed;
+            auto start = std::chrono::steady_clock::now();
+            auto result = immediate_.evaluate(tensor);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            executed = immediate_.get_stats().operations_executed - executed;
+
+            // The root joins the tape manager's results, which later tapes start from; the
+            // intermediates are released, as a tape would
+            tape_.adopt_result(node_id, result);
+            immediate_.release_results();
+
+            update(adaptive_stats_.eager_ns_per_node, std::chrono::duration<double, std::nano>(elapsed).count() /
+                                                          static_cast<double>(std::max<size_t>(executed, 1)));
+            adaptive_stats_.eager_evaluations++;
+            return result;
+        }
+    }
+
+    auto result = tape_.evaluate(tensor);
+    const auto& timing = tape_.last_tape_timing();
+    update(adaptive_stats_.tape_generate_ns, static_cast<double>(timing.generate_ns));
+    if (timing.operations > 0) {
+        update(adaptive_stats_.tape_execute_ns_per_node,
+               static_cast<double>(timing.execute_ns) / static_cast<double>(timing.operations));
+    }
+    adaptive_stats_.tape_evaluations++;
+    return result;
+}
+
+void AdaptiveEvaluationManager::evaluate_into(const std::vector<Tensor>& tensors,
+                                              const std::vector<OutputBuffer>& outputs) {
+    tape_.evaluate_into(tensors, outputs);
+}
+
+void AdaptiveEvaluationManager::clear_cache() {
+    // The cost estimates describe the machine and workload, so they outlive the results
+    tape_.clear_cache();
+    immediate_.clear_cache();
+    adaptive_stats_.eager_evaluations = 0;
+    adaptive_stats_.tape_evaluations = 0;
+}
+
+EvaluationManager::EvaluationStats AdaptiveEvaluationManager::get_stats() const {
+    auto stats = tape_.get_stats();
+    auto eager = immediate_.get_stats();
+    stats.cache_hits += eager.cache_hits;
+    stats.cache_misses += eager.cache_misses;
+    stats.operations_executed += eager.operations_executed;
+    stats.memory_allocated += eager.memory_allocated;
+    return stats;
+}
+
+void AdaptiveEvaluationManager::set_profiling_enabled(bool enabled) {
+    tape_.set_profiling_enabled(enabled);
+    immediate_.set_profiling_enabled(enabled);
+}
+
+std::vector<EvaluationManager::OpTiming> AdaptiveEvaluationManager::get_profile() const {
+    // Eagerly run operations first, then those run from tapes
+    auto timings = immediate_.get_profile();
+    auto tape_timings = tape_.get_profile();
+    timings.insert(timings.end(), tape_timings.begin(), tape_timings.end());
+    return timings;
+}
+
+void AdaptiveEvaluationManager::reset_profile() {
+    tape_.reset_profile();
+    immediate_.reset_profile();
+}
+
+bool AdaptiveEvaluationManager::tape_only() const {
+    LazyWindow window = lazy_window();
+    return memory_budget() > 0 || window.max_pending_nodes > 0 || window.max_pending_bytes > 0;
+}
+
+bool AdaptiveEvaluationManager::choose_eager(size_t nodes) {
+    if (nodes > options_.max_eager_nodes) {
+        return false;
+    }
+    // Each mode is measured once before the estimates are compared
+    if (adaptive_stats_.eager_ns_per_node == 0.0) {
+        return true;
+    }
+    bool probe = options_.probe_interval > 0 && ++small_evaluations_ % options_.probe_interval == 0;
+    if (adaptive_stats_.tape_generate_ns == 0.0) {
+        return !probe;
+    }
+
+    double eager_cost = static_cast<double>(nodes) * adaptive_stats_.eager_ns_per_node;
+    double tape_cost =
+        adaptive_stats_.tape_generate_ns + static_cast<double>(nodes) * adaptive_stats_.tape_execute_ns_per_node;
+    bool eager = eager_cost <= tape_cost;
+    return probe ? !eager : eager;
+}
+
+void AdaptiveEvaluationManager::update(double& estimate, double sample) const {
+    sample = std::max(sample, 1.0);  // 0 marks an estimate without samples
+    estimate = estimate == 0.0 ? sample : estimate + options_.smoothing * (sample - estimate);
+}
+
+}  // namespace tt_lazy
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "EvaluationManager.hpp"
+#include "ImmediateEvaluationManager.hpp"
+#include "TapeEvaluationManager.hpp"
+
+#include <cstdint>
+
+namespace tt_lazy {
+
+/**
+ * Evaluation manager that picks, for each evaluation, between running the pending nodes
+ * eagerly (ImmediateEvaluationManager) and building a tape (TapeEvaluationManager).
+ *
+ * Graphs above `max_eager_nodes` pending nodes always go to a tape, where fusion and memory
+ * planning pay off. Smaller ones go to whichever mode the recent measurements predict to be
+ * cheaper: eager costs `nodes * eager time per node`; a tape costs its generation time plus
+ * `nodes * tape execution time per node`. Every `probe_interval` small evaluations the other
+ * mode runs instead, so both estimates follow the workload. A memory budget or a lazy window
+ * sends everything to the tape.
+ *
+ * The tape manager holds the results of both modes: eager runs read its cache and leave their
+ * root there, and tapes start from those roots, so a graph switching modes is not recomputed.
+ */
+class AdaptiveEvaluationManager : public EvaluationManager {
+   public:
+    struct Options {
+        size_t max_eager_nodes = 64;
+        size_t probe_interval = 16;
+        double smoothing = 0.25;  // Weight of the newest sample in the running estimates
+    };
+
+    // Which mode evaluations went to, and the current cost estimates
+    struct AdaptiveStats {
+        size_t eager_evaluations = 0;
+        size_t tape_evaluations = 0;
+        double eager_ns_per_node = 0.0;     // 0 until measured
+        double tape_generate_ns = 0.0;      // Per tape
+        double tape_execute_ns_per_node = 0.0;
+    };
+
+    AdaptiveEvaluationManager() : AdaptiveEvaluationManager(Options{}) {}
+    explicit AdaptiveEvaluationManager(const Options& options);
+    ~AdaptiveEvaluationManager() override = default;
+
+    // Non-copyable, non-movable (inherits from base class)
+    AdaptiveEvaluationManager(const AdaptiveEvaluationManager&) = delete;
+    AdaptiveEvaluationManager& operator=(const AdaptiveEvaluationManager&) = delete;
+    AdaptiveEvaluationManager(AdaptiveEvaluationManager&&) = delete;
+    AdaptiveEvaluationManager& operator=(AdaptiveEvaluationManager&&) = delete;
+
+    std::shared_ptr<Tensor> evaluate(const Tensor& tensor) override;
+    // A single tape, which can write results straight into the buffers
+    void evaluate_into(const std::vector<Tensor>& tensors, const std::vector<OutputBuffer>& outputs) override;
+    void clear_cache() override;
+    EvaluationManager::EvaluationStats get_stats() const override;
+
+    void set_profiling_enabled(bool enabled) override;
+    bool is_profiling_enabled() const override { return tape_.is_profiling_enabled(); }
+    std::vector<EvaluationManager::OpTiming> get_profile() const override;
+    void reset_profile() override;
+
+    // With a memory budget every evaluation goes to a tape, where spilling is planned
+    void set_memory_budget(size_t bytes) override { tape_.set_memory_budget(bytes); }
+    size_t memory_budget() const override { return tape_.memory_budget(); }
+    EvaluationManager::SpillStats get_spill_stats() const override { return tape_.get_spill_stats(); }
+
+    // So does a lazy window, whose flushes the tape manager runs
+    void set_lazy_window(const LazyWindow& window) override { tape_.set_lazy_window(window); }
+    LazyWindow lazy_window() const override { return tape_.lazy_window(); }
+    void on_activate() override { tape_.on_activate(); }
+    void on_deactivate() override { tape_.on_deactivate(); }
+
+    const AdaptiveStats& adaptive_stats() const { return adaptive_stats_; }
+
+   private:
+    bool tape_only() const;
+    bool choose_eager(size_t nodes);
+    void update(double& estimate, double sample) const;
+
+    Options options_;
+    TapeEvaluationManager tape_;
+    ImmediateEvaluationManager immediate_{false};  // Runs nodes only when asked
+    AdaptiveStats adaptive_stats_;
+    size_t small_evaluations_ = 0;
+};
+
+}  // namespace tt_lazy
@@ -0,0 +1,482 @@
+#include "CodeGenerator.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+constexpr size_t ARENA_ALIGNMENT = 16;  // Floats: every arena buffer starts on a 64-byte boundary
+constexpr size_t WEIGHTS_PER_LINE = 8;
+
+std::vector<uint32_t> shape_of(const Tensor& tensor) {
+    return std::vector<uint32_t>(tensor.shape(), tensor.shape() + tensor.rank());
+}
+
+size_t numel(const std::vector<uint32_t>& shape) {
+    size_t count = 1;
+    for (uint32_t dim : shape) {
+        count *= dim;
+    }
+    return count;
+}
+
+std::string shape_string(const std::vector<uint32_t>& shape) {
+    std::string text = "[";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        text += (i > 0 ? ", " : "") + std::to_string(shape[i]);
+    }
+    return text + "]";
+}
+
+// Where an operand of a generated kernel call comes from
+struct Operand {
+    enum class Kind : uint8_t { INPUT, WEIGHT, NODE } kind = Kind::NODE;
+    size_t index = 0;  // INPUT / WEIGHT: position in `run`'s array
+    NodeId node = 0;   // NODE: operation whose result it is
+    std::vector<uint32_t> shape;
+};
+
+// One kernel call of the generated function
+struct Step {
+    enum class Kind : uint8_t { MATMUL, ADD, ADD_ROW, MULTIPLY, RELU, REDUCE } kind = Kind::MATMUL;
+    NodeId node = 0;                // Node whose result the call produces (the last one fused)
+    std::string description;        // Operations it performs, e.g. "MatMul + Add + ReLU"
+    std::vector<Operand> operands;  // MATMUL: a, b and the bias if there is one
+    std::vector<uint32_t> shape;    // Result shape
+    size_t m = 0, n = 0, k = 0;     // MATMUL: c[m x n] over depth k; REDUCE: outer, reduced, inner
+    bool transpose_a = false;
+    bool transpose_b = false;
+    bool relu = false;
+
+    bool is_elementwise() const { return kind != Kind::MATMUL && kind != Kind::REDUCE; }
+};
+
+class SourceGenerator {
+   public:
+    SourceGenerator(const Tape& tape, const std::vector<Tensor>& inputs, const Tensor& output)
+        : inputs_(inputs), output_(output.producer_node()) {
+        // Readers of every result, so epilogue fusion only folds results nothing else reads
+        for (const auto& op : tape.operations()) {
+            on_tape_.insert(op->node_id);
+            for (const Tensor& input : node(op->node_id).inputs()) {
+                if (input.is_lazy()) {
+                    ++readers_[input.producer_node()];
+                }
+            }
+        }
+        if (on_tape_.count(output_) == 0) {
+            throw std::runtime_error("codegen: the output is not computed by the tape");
+        }
+        for (const auto& op : tape.operations()) {
+            add_operation(*op);
+        }
+        prune();
+    }
+
+    // Assigns arena offsets: a result takes the lowest gap that fits when its step runs and is
+    // released after its last reader; an elementwise step writes over an input dying with it
+    void plan() {
+        std::unordered_map<NodeId, size_t> last_use;
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            for (const Operand& operand : steps_[i].operands) {
+                if (operand.kind == Operand::Kind::NODE) {
+                    last_use[operand.node] = i;
+                }
+            }
+        }
+
+        std::vector<std::pair<size_t, size_t>> live;  // (offset, floats), sorted by offset
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            const Step& step = steps_[i];
+            std::unordered_set<NodeId> dying;
+            for (const Operand& operand : step.operands) {
+                if (operand.kind == Operand::Kind::NODE && last_use[operand.node] == i) {
+                    dying.insert(operand.node);
+                }
+            }
+
+            NodeId reused = 0;
+            bool reuses = false;
+            if (step.node != output_) {
+                unplanned_floats_ += numel(step.shape);
+                if (step.is_elementwise()) {
+                    // Only the first operand of a row addition has the result's shape
+                    size_t candidates = step.kind == Step::Kind::ADD_ROW ? 1 : step.operands.size();
+                    for (size_t j = 0; j < candidates && !reuses; ++j) {
+                        const Operand& operand = step.operands[j];
+                        reuses = operand.kind == Operand::Kind::NODE && dying.count(operand.node) > 0 &&
+                                 numel(operand.shape) == numel(step.shape);
+                        reused = operand.node;
+                    }
+                }
+                if (reuses) {
+                    offsets_[step.node] = offsets_.at(reused);
+                    dying.erase(reused);
+                } else {
+                    offsets_[step.node] = allocate(live, numel(step.shape));
+                }
+            }
+            for (NodeId node_id : dying) {
+                size_t offset = offsets_.at(node_id);
+                live.erase(std::find_if(live.begin(), live.end(), [&](const auto& b) { return b.first == offset; }));
+            }
+        }
+    }
+
+    std::string emit(const CodegenOptions& options) const {
+        const std::string& name = options.namespace_name;
+        std::string guard = "TT_LAZY_GENERATED_";
+        for (char c : name) {
+            guard += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(c)) : '_';
+        }
+
+        std::ostringstream out;
+        out << "// Generated by the tt_lazy tape code generator; do not edit.\n"
+            << "// " << steps_.size() << " kernel calls, " << arena_floats_ << " arena floats (" << unplanned_floats_
+            << " without reuse).\n//\n";
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            out << "// inputs[" << i << "]: " << shape_string(shape_of(inputs_[i])) << "\n";
+        }
+        for (size_t i = 0; i < weights_.size(); ++i) {
+            out << "// " << weight_name(i, options) << ": " << shape_string(shape_of(weights_[i])) << "\n";
+        }
+        out << "// output: " << shape_string(steps_.back().shape) << "\n\n"
+            << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+            << "#include \"aot_kernels.hpp\"\n\n#include <cstddef>\n\n"
+            << "namespace " << name << " {\n\n"
+            << "constexpr std::size_t NUM_INPUTS = " << inputs_.size() << ";\n"
+            << "constexpr std::size_t NUM_WEIGHTS = " << (options.embed_weights ? 0 : weights_.size()) << ";\n"
+            << "constexpr std::size_t ARENA_FLOATS = " << arena_floats_ << ";\n"
+            << "constexpr std::size_t OUTPUT_FLOATS = " << numel(steps_.back().shape) << ";\n\n";
+        if (options.embed_weights) {
+            for (size_t i = 0; i < weights_.size(); ++i) {
+                emit_weight(out, i);
+            }
+        }
+
+        const char* unused = "[[maybe_unused]] ";
+        out << "inline void run(" << (inputs_.empty() ? unused : "") << "const float* const* inputs, ";
+        if (!options.embed_weights) {
+            out << (weights_.empty() ? unused : "") << "const float* const* weights, ";
+        }
+        out << "float* output, " << (arena_floats_ == 0 ? unused : "") << "float* arena) {\n";
+        for (const Step& step : steps_) {
+            out << "    // " << step.description << " -> " << shape_string(step.shape) << "\n    "
+                << call(step, options) << ";\n";
+        }
+        out << "}\n\n}  // namespace " << name << "\n\n#endif  // " << guard << "\n";
+        return out.str();
+    }
+
+    const std::vector<Tensor>& weights() const { return weights_; }
+    size_t arena_floats() const { return arena_floats_; }
+    size_t unplanned_floats() const { return unplanned_floats_; }
+    size_t kernel_calls() const { return steps_.size(); }
+
+   private:
+    static const Node& node(NodeId node_id) {
+        const Node* node = Context::instance().get_node(node_id);
+        if (node == nullptr) {
+            throw std::runtime_error("codegen: node " + std::to_string(node_id) + " not found");
+        }
+        return *node;
+    }
+
+    Operand operand(const Tensor& tensor) {
+        Operand result;
+        result.shape = shape_of(tensor);
+        if (tensor.is_lazy()) {
+            if (tensor.output_index() != 0) {
+                throw std::runtime_error("codegen: operations with several outputs are not supported");
+            }
+            if (producer_.count(tensor.producer_node()) == 0) {
+                throw std::runtime_error("codegen: node " + std::to_string(tensor.producer_node()) +
+                                         " is read but not computed by the tape");
+            }
+            result.node = tensor.producer_node();
+            return result;
+        }
+        if (tensor.dtype() != DataType::FLOAT32) {
+            throw std::runtime_error("codegen: only float32 tensors are supported");
+        }
+        auto same = [&](const Tensor& other) {
+            return other.raw_data() == tensor.raw_data() && shape_of(other) == result.shape;
+        };
+        auto input = std::find_if(inputs_.begin(), inputs_.end(), same);
+        if (input != inputs_.end()) {
+            result.kind = Operand::Kind::INPUT;
+            result.index = static_cast<size_t>(input - inputs_.begin());
+            return result;
+        }
+        auto weight = std::find_if(weights_.begin(), weights_.end(), same);
+        result.kind = Operand::Kind::WEIGHT;
+        result.index = static_cast<size_t>(weight - weights_.begin());
+        if (weight == weights_.end()) {
+            weights_.push_back(tensor);
+        }
+        return result;
+    }
+
+    // The matmul step producing `operand` if it can still take an epilogue
+    Step* fusable_matmul(const Operand& operand, bool for_bias) {
+        if (operand.kind != Operand::Kind::NODE || operand.node == output_ || readers_[operand.node] != 1) {
+            return nullptr;
+        }
+        Step& step = steps_[producer_.at(operand.node)];
+        bool open = step.kind == Step::Kind::MATMUL && !step.relu && (!for_bias || step.operands.size() == 2);
+        return open ? &step : nullptr;
+    }
+
+    void add_operation(const TapeOperation& op) {
+        const Node& graph_node = node(op.node_id);
+        std::vector<Operand> operands;
+        for (const Tensor& input : graph_node.inputs()) {
+            operands.push_back(operand(input));
+        }
+        auto require = [&](bool condition, const char* what) {
+            if (!condition) {
+                throw std::runtime_error("codegen: unsupported " + std::string(graph_node.op_name()) + " (" + what +
+                                         ")");
+            }
+        };
+
+        Step step;
+        step.node = op.node_id;
+        step.description = std::string(graph_node.op_name());
+        if (const auto* product = graph_node.try_as<MatMulArgs>()) {
+            require(operands.size() == 2 && operands[0].shape.size() == 2 && operands[1].shape.size() == 2,
+                    "two 2-D operands");
+            const auto& a = operands[0].shape;
+            const auto& b = operands[1].shape;
+            step.transpose_a = product->transpose_a;
+            step.transpose_b = product->transpose_b;
+            step.m = step.transpose_a ? a[1] : a[0];
+            step.k = step.transpose_a ? a[0] : a[1];
+            step.n = step.transpose_b ? b[0] : b[1];
+            require((step.transpose_b ? b[1] : b[0]) == step.k, "inner dimensions differ");
+        } else if (const auto* mlp = graph_node.try_as<FusedMLPArgs>()) {
+            require(operands.size() == 3 && operands[0].shape.size() == 2 && operands[1].shape.size() == 2,
+                    "2-D input and weights");
+            step.m = operands[0].shape[0];
+            step.k = operands[0].shape[1];
+            step.n = operands[1].shape[1];
+            require(operands[1].shape[0] == step.k && numel(operands[2].shape) == step.n, "mismatched shapes");
+            step.relu = mlp->has_relu;
+        } else if (graph_node.is<AddArgs>() || graph_node.is<MultiplyArgs>()) {
+            require(operands.size() == 2, "two operands");
+            bool add = graph_node.is<AddArgs>();
+            const auto& a = operands[0].shape;
+            const auto& b = operands[1].shape;
+            bool row = a.size() == 2 && b.size() == 2 && b[0] == 1 && a[1] == b[1];
+            require(a == b || (add && row), "broadcast shapes");
+            // A constant row added to a product becomes its GEMM's bias (either side for one row)
+            for (size_t side = 0; add && row && side < (a == b ? 2 : 1); ++side) {
+                Step* matmul = operands[1 - side].kind != Operand::Kind::NODE ? fusable_matmul(operands[side], true)
+                                                                               : nullptr;
+                if (matmul) {
+                    matmul->operands.push_back(operands[1 - side]);
+                    fold(*matmul, op.node_id, graph_node.op_name());
+                    return;
+                }
+            }
+            step.kind = a != b ? Step::Kind::ADD_ROW : (add ? Step::Kind::ADD : Step::Kind::MULTIPLY);
+        } else if (graph_node.is<ReLUArgs>()) {
+            require(operands.size() == 1, "one operand");
+            if (Step* matmul = fusable_matmul(operands[0], false)) {
+                matmul->relu = true;
+                fold(*matmul, op.node_id, graph_node.op_name());
+                return;
+            }
+            step.kind = Step::Kind::RELU;
+        } else if (const auto* reduce = graph_node.try_as<ReduceArgs>()) {
+            require(operands.size() == 1, "one operand");
+            step.kind = Step::Kind::REDUCE;
+            const auto& shape = operands[0].shape;
+            std::vector<int32_t> dims(reduce->dims.begin(), reduce->dims.end());
+            std::sort(dims.begin(), dims.end());
+            if (dims.empty()) {
+                for (size_t d = 0; d < shape.size(); ++d) {
+                    dims.push_back(static_cast<int32_t>(d));
+                }
+            }
+            require(dims.front() >= 0 && dims.back() < static_cast<int32_t>(shape.size()) &&
+                        dims.back() - dims.front() + 1 == static_cast<int32_t>(dims.size()),
+                    "dimensions must be adjacent");
+            step.m = step.n = step.k = 1;  // outer, reduced, inner
+            for (size_t d = 0; d < shape.size(); ++d) {
+                bool reduced = std::find(dims.begin(), dims.end(), static_cast<int32_t>(d)) != dims.end();
+                size_t& extent = reduced ? step.n : (d < static_cast<size_t>(dims.front()) ? step.m : step.k);
+                extent *= shape[d];
+                if (!reduced || reduce->keepdim) {
+                    step.shape.push_back(reduced ? 1 : shape[d]);
+                }
+            }
+            if (step.shape.empty()) {
+                step.shape.push_back(1);
+            }
+        } else {
+            throw std::runtime_error("codegen: unsupported operation " + std::string(graph_node.op_name()));
+        }
+
+        if (step.kind == Step::Kind::MATMUL) {
+            step.shape = {static_cast<uint32_t>(step.m), static_cast<uint32_t>(step.n)};
+        } else if (step.kind != Step::Kind::REDUCE) {
+            step.shape = operands[0].shape;
+        }
+        step.operands = std::move(operands);
+        producer_[op.node_id] = steps_.size();
+        steps_.push_back(std::move(step));
+    }
+
+    // Makes `step` produce `node_id` too, the operation it has just absorbed
+    void fold(Step& step, NodeId node_id, std::string_view op_name) {
+        step.node = node_id;
+        step.description += " + " + std::string(op_name);
+        producer_[node_id] = static_cast<size_t>(&step - steps_.data());
+    }
+
+    // Drops the steps the output does not depend on, which ends the list with the output's
+    void prune() {
+        std::unordered_set<NodeId> needed{output_};
+        std::vector<Step> kept;
+        for (auto it = steps_.rbegin(); it != steps_.rend(); ++it) {
+            if (needed.count(it->node) > 0) {
+                for (const Operand& operand : it->operands) {
+                    if (operand.kind == Operand::Kind::NODE) {
+                        needed.insert(operand.node);
+                    }
+                }
+                kept.push_back(std::move(*it));
+            }
+        }
+        steps_.assign(std::make_move_iterator(kept.rbegin()), std::make_move_iterator(kept.rend()));
+        if (steps_.empty() || steps_.back().node != output_) {
+            throw std::runtime_error("codegen: the output is folded into another operation");
+        }
+    }
+
+    size_t allocate(std::vector<std::pair<size_t, size_t>>& live, size_t floats) {
+        size_t size = (floats + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+        size_t offset = 0;
+        auto it = live.begin();
+        for (; it != live.end() && it->first < offset + size; ++it) {
+            offset = std::max(offset, it->first + it->second);
+        }
+        live.insert(it, {offset, size});
+        arena_floats_ = std::max(arena_floats_, offset + size);
+        return offset;
+    }
+
+    std::string weight_name(size_t index, const CodegenOptions& options) const {
+        return options.embed_weights ? "WEIGHT_" + std::to_string(index) : "weights[" + std::to_string(index) + "]";
+    }
+
+    std::string pointer(const Operand& operand, const CodegenOptions& options) const {
+        switch (operand.kind) {
+            case Operand::Kind::INPUT:
+                return "inputs[" + std::to_string(operand.index) + "]";
+            case Operand::Kind::WEIGHT:
+                return weight_name(operand.index, options);
+            case Operand::Kind::NODE:
+            default:
+                return operand.node == output_ ? "output" : "arena + " + std::to_string(offsets_.at(operand.node));
+        }
+    }
+
+    std::string call(const Step& step, const CodegenOptions& options) const {
+        std::string result = step.node == output_ ? "output" : "arena + " + std::to_string(offsets_.at(step.node));
+        std::vector<std::string> args;
+        for (const Operand& operand : step.operands) {
+            args.push_back(pointer(operand, options));
+        }
+        auto flag = [](bool value) { return value ? "true" : "false"; };
+        std::ostringstream text;
+        switch (step.kind) {
+            case Step::Kind::MATMUL:
+                text << "math::aot::matmul<" << step.m << ", " << step.n << ", " << step.k << ", "
+                     << flag(step.transpose_a) << ", " << flag(step.transpose_b) << ", " << flag(step.relu) << ">("
+                     << args[0] << ", " << args[1] << ", " << (args.size() > 2 ? args[2] : "nullptr") << ", "
+                     << result << ")";
+                break;
+            case Step::Kind::ADD:
+            case Step::Kind::MULTIPLY:
+                text << "math::aot::" << (step.kind == Step::Kind::ADD ? "add" : "multiply") << "<"
+                     << numel(step.shape) << ">(" << args[0] << ", " << args[1] << ", " << result << ")";
+                break;
+            case Step::Kind::ADD_ROW:
+                text << "math::aot::add_row<" << step.shape[0] << ", " << step.shape[1] << ">(" << args[0] << ", "
+                     << args[1] << ", " << result << ")";
+                break;
+            case Step::Kind::RELU:
+                text << "math::aot::relu<" << numel(step.shape) << ">(" << args[0] << ", " << result << ")";
+                break;
+            case Step::Kind::REDUCE:
+            default:
+                text << "math::aot::reduce_sum<" << step.m << ", " << step.n << ", " << step.k << ">(" << args[0]
+                     << ", " << result << ")";
+                break;
+        }
+        return text.str();
+    }
+
+    // Exact hexadecimal literals, so the compiled weights are bit-identical to the tensors'
+    void emit_weight(std::ostream& out, size_t index) const {
+        const Tensor& weight = weights_[index];
+        const float* data = weight.const_data_ptr();
+        size_t count = weight.total_elements();
+        out << "alignas(64) inline const float WEIGHT_" << index << "[" << count << "] = {";
+        char literal[32];  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        for (size_t i = 0; i < count; ++i) {
+            if (!std::isfinite(data[i])) {
+                throw std::runtime_error("codegen: weight " + std::to_string(index) + " is not finite");
+            }
+            std::snprintf(literal, sizeof(literal), "%af", static_cast<double>(data[i]));
+            out << (i % WEIGHTS_PER_LINE == 0 ? "\n    " : " ") << literal << ",";
+        }
+        out << "\n};\n\n";
+    }
+
+    const std::vector<Tensor>& inputs_;
+    NodeId output_;
+    std::unordered_set<NodeId> on_tape_;
+    std::unordered_map<NodeId, size_t> readers_;
+    std::unordered_map<NodeId, size_t> producer_;  // Node -> step producing its result
+    std::vector<Step> steps_;
+    std::vector<Tensor> weights_;
+    std::unordered_map<NodeId, size_t> offsets_;  // Arena offset of each intermediate result
+    size_t arena_floats_ = 0;
+    size_t unplanned_floats_ = 0;
+};
+
+}  // namespace
+
+GeneratedCode generate_cpp(const Tape& tape, const std::vector<Tensor>& inputs, const Tensor& output,
+                           const CodegenOptions& options) {
+    if (!output.is_lazy() || output.output_index() != 0) {
+        throw std::runtime_error("codegen: the output must be the first result of a lazy operation");
+    }
+    SourceGenerator generator(tape, inputs, output);
+    generator.plan();
+
+    GeneratedCode code;
+    code.source = generator.emit(options);
+    if (!options.embed_weights) {
+        code.weights = generator.weights();
+    }
+    code.arena_floats = generator.arena_floats();
+    code.unplanned_floats = generator.unplanned_floats();
+    code.kernel_calls = generator.kernel_calls();
+    return code;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Tape.hpp"
+#include "Tensor.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Ahead-of-time compilation of a tape into C++ source.
+//
+// The generated source holds one function, `run`, that performs the tape's operations as
+// direct calls to the math::aot kernels (aot_kernels.hpp) with every shape as a template
+// parameter, so running it involves no graph, tape, handler lookup or allocation. A MatMul
+// whose only reader adds a row bias, and optionally a ReLU after that, becomes one GEMM with
+// a bias/ReLU epilogue. Intermediate results live in a caller-provided arena at offsets fixed
+// at generation time: buffers are reused once their last reader has run, and elementwise
+// operations write over an input that dies with them.
+//
+// All definitions are inline, so the source can be included in (or compiled as) any
+// translation unit of a binary linking tt_math_lib:
+//
+//   namespace NAME {
+//   constexpr size_t NUM_INPUTS, NUM_WEIGHTS, ARENA_FLOATS, OUTPUT_FLOATS;
+//   void run(const float* const* inputs, const float* const* weights, float* output, float* arena);
+//   }
+//
+// With embedded weights the `weights` parameter is gone and the values are compiled in.
+// Supported operations: 2-D MatMul, Add (same shapes, or a [1, N] row added to [M, N]),
+// Multiply (same shapes), ReLU, FusedMLP and Reduce (sum over adjacent dimensions).
+struct CodegenOptions {
+    std::string namespace_name = "tt_lazy_generated";
+    bool embed_weights = false;
+};
+
+struct GeneratedCode {
+    std::string source;
+    // Constants that are not inputs, in the order `run` expects them (empty if embedded)
+    std::vector<Tensor> weights;
+    size_t arena_floats = 0;       // Arena the planned intermediates need
+    size_t unplanned_floats = 0;   // What the same intermediates take without reuse
+    size_t kernel_calls = 0;       // Calls in `run`, after fusion
+};
+
+// Generates the source computing `output` from `inputs` (constant tensors the graph reads,
+// passed to `run` in this order). Every operation producing `output` must be on `tape`;
+// throws std::runtime_error for operations or shapes the generator does not support.
+GeneratedCode generate_cpp(const Tape& tape, const std::vector<Tensor>& inputs, const Tensor& output,
+                           const CodegenOptions& options = {});
@@ -0,0 +1,98 @@
+#include "EvaluationMode.hpp"
+
+#include "AdaptiveEvaluationManager.hpp"
+#include "ImmediateEvaluationManager.hpp"
+#include "TapeEvaluationManager.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace tt_lazy {
+
+namespace {
+
+std::unique_ptr<EvaluationManager> make_manager(EvaluationMode mode) {
+    switch (mode) {
+        case EvaluationMode::IMMEDIATE:
+            return std::make_unique<ImmediateEvaluationManager>();
+        case EvaluationMode::ADAPTIVE:
+            return std::make_unique<AdaptiveEvaluationManager>();
+        case EvaluationMode::TAPE:
+        default:
+            return std::make_unique<TapeEvaluationManager>();
+    }
+}
+
+// Manager chosen with set_evaluation_manager(), if any
+std::shared_ptr<EvaluationManager>& selected_manager() {
+    static std::shared_ptr<EvaluationManager> manager;
+    return manager;
+}
+
+}  // namespace
+
+// The default manager of the tape library, found by the linker; TT_LAZY_EVAL_MODE picks its kind
+EvaluationManager& default_evaluation_manager() {
+    static std::unique_ptr<EvaluationManager> instance = [] {
+        const char* name = std::getenv("TT_LAZY_EVAL_MODE");  // NOLINT(concurrency-mt-unsafe)
+        auto manager = make_manager(name != nullptr ? parse_evaluation_mode(name) : EvaluationMode::TAPE);
+        manager->on_activate();
+        return manager;
+    }();
+    return *instance;
+}
+
+EvaluationManager& get_evaluation_manager() {
+    const auto& selected = selected_manager();
+    return selected ? *selected : default_evaluation_manager();
+}
+
+void set_evaluation_manager(std::shared_ptr<EvaluationManager> manager) {
+    get_evaluation_manager().on_deactivate();
+    selected_manager() = std::move(manager);
+    get_evaluation_manager().on_activate();
+}
+
+void set_evaluation_mode(EvaluationMode mode) {
+    set_evaluation_manager(make_manager(mode));
+}
+
+EvaluationMode evaluation_mode() {
+    EvaluationManager& manager = get_evaluation_manager();
+    if (dynamic_cast<ImmediateEvaluationManager*>(&manager) != nullptr) {
+        return EvaluationMode::IMMEDIATE;
+    }
+    if (dynamic_cast<AdaptiveEvaluationManager*>(&manager) != nullptr) {
+        return EvaluationMode::ADAPTIVE;
+    }
+    return EvaluationMode::TAPE;
+}
+
+EvaluationMode parse_evaluation_mode(const std::string& name) {
+    if (name == "tape") {
+        return EvaluationMode::TAPE;
+    }
+    if (name == "immediate") {
+        return EvaluationMode::IMMEDIATE;
+    }
+    if (name == "adaptive") {
+        return EvaluationMode::ADAPTIVE;
+    }
+    throw std::invalid_argument("Unknown evaluation mode '" + name + "', expected tape, immediate or adaptive");
+}
+
+const char* evaluation_mode_name(EvaluationMode mode) {
+    switch (mode) {
+        case EvaluationMode::IMMEDIATE:
+            return "immediate";
+        case EvaluationMode::ADAPTIVE:
+            return "adaptive";
+        case EvaluationMode::TAPE:
+        default:
+            return "tape";
+    }
+}
+
+}  // namespace tt_lazy
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "EvaluationManager.hpp"
+
+#include <string>
+
+namespace tt_lazy {
+
+// Evaluation strategies provided by the tape library
+enum class EvaluationMode {
+    TAPE,       // TapeEvaluationManager: one optimized tape per evaluation
+    IMMEDIATE,  // ImmediateEvaluationManager: every node runs when it is created
+    ADAPTIVE,   // AdaptiveEvaluationManager: eager or tape, chosen per evaluation
+};
+
+// Switch get_evaluation_manager() to a new manager of the given kind
+void set_evaluation_mode(EvaluationMode mode);
+
+// Kind of the current manager (TAPE for managers of other types)
+EvaluationMode evaluation_mode();
+
+// "tape", "immediate" or "adaptive"; throws std::invalid_argument for other names
+EvaluationMode parse_evaluation_mode(const std::string& name);
+const char* evaluation_mode_name(EvaluationMode mode);
+
+}  // namespace tt_lazy
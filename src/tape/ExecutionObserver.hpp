@@ -0,0 +1,27 @@
+#pragma once
+#include "TapeOperation.hpp"
+
+// Forward declarations
+class Tape;
+
+// Hook interface for instrumenting tape execution (profiling, prefetching, ...)
+// Observers are not owned by the executor and must outlive their registration.
+class ExecutionObserver {
+   public:
+    virtual ~ExecutionObserver() = default;
+
+    // Called once before and after a whole tape is executed
+    virtual void on_tape_begin([[maybe_unused]] const Tape& tape) {}
+    virtual void on_tape_end([[maybe_unused]] const Tape& tape) {}
+
+    // Called around every executed operation
+    virtual void on_operation_begin([[maybe_unused]] const TapeOperation& op) {}
+    virtual void on_operation_end([[maybe_unused]] const TapeOperation& op) {}
+
+   protected:
+    ExecutionObserver() = default;
+    ExecutionObserver(const ExecutionObserver&) = default;
+    ExecutionObserver& operator=(const ExecutionObserver&) = default;
+    ExecutionObserver(ExecutionObserver&&) = default;
+    ExecutionObserver& operator=(ExecutionObserver&&) = default;
+};
@@ -0,0 +1,81 @@
+#include "GemmAutotuner.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "Tape.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+std::optional<math::GemmKey> gemm_key(const TapeOperation& op) {
+    const Node* node = Context::instance().get_node(op.node_id);
+    if (node == nullptr || node->inputs().size() < 2) {
+        return std::nullopt;
+    }
+    const Tensor& a = node->inputs()[0];
+    const Tensor& b = node->inputs()[1];
+    if (a.rank() != 2 || b.rank() != 2) {
+        return std::nullopt;  // Batched products run other kernels
+    }
+    if (const auto* args = node->try_as<MatMulArgs>()) {
+        bool ta = args->transpose_a;
+        bool tb = args->transpose_b;
+        return math::GemmKey{ta ? a.size(1) : a.size(0), tb ? b.size(0) : b.size(1), ta ? a.size(0) : a.size(1), ta,
+                             tb};
+    }
+    if (node->is<FusedMLPArgs>()) {
+        // input [batch, in] times weights [in, out]
+        return math::GemmKey{a.size(0), b.size(1), a.size(1), false, false};
+    }
+    return std::nullopt;
+}
+
+std::vector<math::GemmKey> tape_gemm_keys(const Tape& tape) {
+    std::vector<math::GemmKey> keys;
+    for (const auto& op : tape.operations()) {
+        auto key = gemm_key(*op);
+        if (key && key->m > 0 && key->n > 0 && key->k > 0 && std::find(keys.begin(), keys.end(), *key) == keys.end()) {
+            keys.push_back(*key);
+        }
+    }
+    return keys;
+}
+
+size_t tune_tape_gemms(const Tape& tape, const math::GemmTuneOptions& options) {
+    size_t tuned = 0;
+    for (const auto& key : tape_gemm_keys(tape)) {
+        if (!math::GemmTuningCache::instance().find(key)) {
+            auto entry = math::tune_gemm(key, options);
+            spdlog::info("Tuned GEMM {}x{}x{}: mc={} kc={} nc={} threads={} ({:.1f} us)", key.m, key.n, key.k,
+                         entry.config.blocking.mc, entry.config.blocking.kc, entry.config.blocking.nc,
+                         entry.config.threads, entry.microseconds);
+            ++tuned;
+        }
+    }
+    return tuned;
+}
+
+GemmAutotuner::GemmAutotuner(std::string cache_path, math::GemmTuneOptions options)
+    : cache_path_(std::move(cache_path)), options_(options) {}
+
+void GemmAutotuner::on_tape_begin(const Tape& tape) {
+    size_t tuned = tune_tape_gemms(tape, options_);
+    pending_ += tuned;
+    tuned_shapes_ += tuned;
+}
+
+void GemmAutotuner::on_tape_end([[maybe_unused]] const Tape& tape) {
+    if (pending_ == 0 || cache_path_.empty()) {
+        return;
+    }
+    try {
+        math::GemmTuningCache::instance().save(cache_path_);
+        pending_ = 0;
+    } catch (const std::exception& e) {
+        // The tuned configurations still apply to this process
+        spdlog::warn("GEMM autotuner: {}", e.what());
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "ExecutionObserver.hpp"
+#include "gemm_tuning.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// GEMM problem of a MatMul or FusedMLP operation on 2-D operands (none for other operations)
+std::optional<math::GemmKey> gemm_key(const TapeOperation& op);
+
+// GEMM problems a tape will run, each once
+std::vector<math::GemmKey> tape_gemm_keys(const Tape& tape);
+
+// Tunes every GEMM of the tape that has no tuned configuration yet; returns how many it tuned
+size_t tune_tape_gemms(const Tape& tape, const math::GemmTuneOptions& options = {});
+
+// Execution observer that tunes the untuned GEMM shapes of each tape before it runs and saves
+// the tuning cache after it, so later runs (and processes) start with tuned blockings.
+//
+// Tuning benchmarks dozens of configurations per shape, so a new shape's first tape is slow;
+// it is meant for warm-up runs (TT_LAZY_AUTOTUNE=1) or the tt_lazy_tune tool, while
+// production processes only load the cache.
+class GemmAutotuner : public ExecutionObserver {
+   public:
+    explicit GemmAutotuner(std::string cache_path = math::GemmTuningCache::default_path(),
+                           math::GemmTuneOptions options = {});
+
+    void on_tape_begin(const Tape& tape) override;
+    void on_tape_end(const Tape& tape) override;
+
+    size_t tuned_shapes() const { return tuned_shapes_; }
+
+   private:
+    std::string cache_path_;  // Empty: tuned configurations are kept in memory only
+    math::GemmTuneOptions options_;
+    size_t pending_ = 0;  // Tuned since the last save
+    size_t tuned_shapes_ = 0;
+};
@@ -0,0 +1,202 @@
+#include "ImmediateEvaluationManager.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+#include "TapeGenerator.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace tt_lazy {
+
+ImmediateEvaluationManager::ImmediateEvaluationManager(bool execute_on_dispatch)
+    : execute_on_dispatch_(execute_on_dispatch) {
+    register_all_operations(executor_);
+}
+
+std::shared_ptr<Tensor> ImmediateEvaluationManager::evaluate(const Tensor& tensor) {
+    if (!tensor.is_lazy() || tensor.is_evaluated()) {
+        stats_.cache_hits++;
+        return std::make_shared<Tensor>(tensor);
+    }
+
+    NodeId node_id = tensor.producer_node();
+    if (auto result = find_result(node_id)) {
+        stats_.cache_hits++;
+        return result;
+    }
+
+    stats_.cache_misses++;
+    execute_pending(node_id);
+    auto result = find_result(node_id);
+    if (!result) {
+        throw std::runtime_error("Immediate evaluation produced no result for node " + std::to_string(node_id));
+    }
+    return result;
+}
+
+void ImmediateEvaluationManager::evaluate_into(const std::vector<Tensor>& tensors,
+                                               const std::vector<OutputBuffer>& outputs) {
+    validate_output_buffers(tensors, outputs);
+
+    // Everything is computed before the first copy, so no output can overwrite an input
+    std::vector<std::shared_ptr<Tensor>> results;
+    results.reserve(tensors.size());
+    for (const Tensor& tensor : tensors) {
+        results.push_back(evaluate(tensor));
+    }
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        copy_to_output_buffer(*results[i], outputs[i]);
+    }
+}
+
+void ImmediateEvaluationManager::clear_cache() {
+    executor_.clear_results();
+    stats_ = EvaluationManager::EvaluationStats{};
+}
+
+EvaluationManager::EvaluationStats ImmediateEvaluationManager::get_stats() const {
+    return stats_;
+}
+
+void ImmediateEvaluationManager::set_profiling_enabled(bool enabled) {
+    if (enabled == profiling_enabled_) {
+        return;
+    }
+
+    if (enabled) {
+        executor_.add_observer(&profiler_);
+    } else {
+        executor_.remove_observer(&profiler_);
+    }
+    profiling_enabled_ = enabled;
+}
+
+std::vector<EvaluationManager::OpTiming> ImmediateEvaluationManager::get_profile() const {
+    return profiler_.timings();
+}
+
+void ImmediateEvaluationManager::reset_profile() {
+    profiler_.clear();
+}
+
+void ImmediateEvaluationManager::set_memory_budget(size_t bytes) {
+    if (bytes > 0) {
+        throw std::runtime_error("Immediate evaluation does not support a memory budget");
+    }
+}
+
+void ImmediateEvaluationManager::set_lazy_window(const LazyWindow& window) {
+    if (!execute_on_dispatch_ && (window.max_pending_nodes > 0 || window.max_pending_bytes > 0)) {
+        throw std::runtime_error("On-demand immediate evaluation does not support a lazy window");
+    }
+    lazy_window_ = window;
+}
+
+void ImmediateEvaluationManager::on_activate() {
+    if (!execute_on_dispatch_) {
+        return;
+    }
+    // A node id may have been used by a graph cleared from the Context since, so the new
+    // node always runs, replacing any result held under its id
+    Context::instance().set_dispatch_hook([this](NodeId node_id) {
+        executor_.erase_result(node_id);
+        execute_pending(node_id);
+    });
+    hook_installed_ = true;
+}
+
+void ImmediateEvaluationManager::on_deactivate() {
+    if (hook_installed_) {
+        Context::instance().set_dispatch_hook(nullptr);
+        hook_installed_ = false;
+    }
+}
+
+size_t ImmediateEvaluationManager::pending_nodes(const Tensor& tensor, size_t limit) const {
+    if (!tensor.is_lazy() || tensor.is_evaluated()) {
+        return 0;
+    }
+
+    const auto& context = Context::instance();
+    std::unordered_set<NodeId> visited;
+    std::vector<NodeId> stack{tensor.producer_node()};
+    while (!stack.empty() && visited.size() < limit) {
+        NodeId node_id = stack.back();
+        stack.pop_back();
+        if (has_result(node_id) || !visited.insert(node_id).second) {
+            continue;
+        }
+        if (const Node* node = context.get_node(node_id)) {
+            for (const auto& input : node->inputs()) {
+                if (input.is_lazy()) {
+                    stack.push_back(input.producer_node());
+                }
+            }
+        }
+    }
+    return visited.size();
+}
+
+std::shared_ptr<Tensor> ImmediateEvaluationManager::find_result(NodeId node_id) const {
+    auto result = executor_.get_result(node_id);
+    if (!result && result_source_) {
+        result = result_source_(node_id);
+    }
+    return result;
+}
+
+void ImmediateEvaluationManager::execute_pending(NodeId node_id) {
+    // Depth-first over the inputs without a result, running each node after its inputs
+    const auto& context = Context::instance();
+    std::vector<std::pair<NodeId, bool>> stack{{node_id, false}};  // (node, inputs done)
+    while (!stack.empty()) {
+        auto [current, inputs_done] = stack.back();
+        stack.pop_back();
+        if (has_result(current)) {
+            continue;
+        }
+        if (inputs_done) {
+            execute_node(current);
+            continue;
+        }
+
+        const Node* node = context.get_node(current);
+        if (!node) {
+            throw std::runtime_error("Immediate evaluation: missing graph node " + std::to_string(current));
+        }
+        stack.emplace_back(current, true);
+        for (const auto& input : node->inputs()) {
+            if (input.is_lazy() && !has_result(input.producer_node())) {
+                stack.emplace_back(input.producer_node(), false);
+            }
+        }
+    }
+}
+
+void ImmediateEvaluationManager::execute_node(NodeId node_id) {
+    const Node* node = Context::instance().get_node(node_id);
+    if (!node) {
+        throw std::runtime_error("Immediate evaluation: missing graph node " + std::to_string(node_id));
+    }
+
+    // Kernels read their inputs from the executor, so results from the source are handed to it
+    for (const auto& input : node->inputs()) {
+        if (input.is_lazy() && !executor_.get_result(input.producer_node())) {
+            if (auto result = find_result(input.producer_node())) {
+                executor_.set_result(input.producer_node(), std::move(result));
+            }
+        }
+    }
+
+    auto op = TapeGenerator::create_tape_operation(*node);
+    executor_.execute_operation(*op);
+    if (auto result = executor_.get_result(node_id)) {
+        stats_.operations_executed++;
+        stats_.memory_allocated += result->total_elements() * sizeof(float);
+    }
+}
+
+}  // namespace tt_lazy
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "EvaluationManager.hpp"
+#include "Profiler.hpp"
+#include "TapeExecutor.hpp"
+
+#include <functional>
+
+namespace tt_lazy {
+
+/**
+ * Eager implementation of the EvaluationManager interface.
+ * Each graph node runs straight through the kernel registry, one operation at a time, with
+ * no tape generation or optimization passes, which is cheaper than building a tape for tiny
+ * graphs. While active with dispatch execution on, every node runs as soon as a frontend
+ * operation creates it; otherwise nodes run when a result is requested.
+ */
+class ImmediateEvaluationManager : public EvaluationManager {
+   public:
+    explicit ImmediateEvaluationManager(bool execute_on_dispatch = true);
+    ~ImmediateEvaluationManager() override = default;
+
+    // Non-copyable, non-movable (inherits from base class)
+    ImmediateEvaluationManager(const ImmediateEvaluationManager&) = delete;
+    ImmediateEvaluationManager& operator=(const ImmediateEvaluationManager&) = delete;
+    ImmediateEvaluationManager(ImmediateEvaluationManager&&) = delete;
+    ImmediateEvaluationManager& operator=(ImmediateEvaluationManager&&) = delete;
+
+    std::shared_ptr<Tensor> evaluate(const Tensor& tensor) override;
+    void evaluate_into(const std::vector<Tensor>& tensors, const std::vector<OutputBuffer>& outputs) override;
+    void clear_cache() override;
+    EvaluationManager::EvaluationStats get_stats() const override;
+
+    void set_profiling_enabled(bool enabled) override;
+    bool is_profiling_enabled() const override { return profiling_enabled_; }
+    std::vector<EvaluationManager::OpTiming> get_profile() const override;
+    void reset_profile() override;
+
+    // Spilling plans around a whole tape, so no memory budget can be set (throws if nonzero)
+    void set_memory_budget(size_t bytes) override;
+    size_t memory_budget() const override { return 0; }
+    EvaluationManager::SpillStats get_spill_stats() const override { return {}; }
+
+    // With dispatch execution nothing stays pending, so every window holds; without it the
+    // window is not supported (throws if set)
+    void set_lazy_window(const LazyWindow& window) override;
+    LazyWindow lazy_window() const override { return lazy_window_; }
+
+    // Install and remove the Context dispatch hook when dispatch execution is on. The hook
+    // refers to this manager, so select it through set_evaluation_manager(), which pairs them.
+    void on_activate() override;
+    void on_deactivate() override;
+
+    // Number of nodes `tensor` still needs executed, counting at most `limit`
+    size_t pending_nodes(const Tensor& tensor, size_t limit) const;
+
+    // Whether the result of `node_id` is already computed, here or by the result source
+    bool has_result(NodeId node_id) const { return find_result(node_id) != nullptr; }
+
+    // Results held elsewhere (e.g. cached by a tape manager), which nodes read instead of
+    // running the graph behind them. Null for none.
+    using ResultSource = std::function<std::shared_ptr<Tensor>(NodeId)>;
+    void set_result_source(ResultSource source) { result_source_ = std::move(source); }
+
+    // Drops every computed result, keeping the stats
+    void release_results() { executor_.clear_results(); }
+
+   private:
+    std::shared_ptr<Tensor> find_result(NodeId node_id) const;
+    void execute_pending(NodeId node_id);
+    void execute_node(NodeId node_id);
+
+    TapeExecutor executor_;  // Holds every computed result, by node
+    ResultSource result_source_;
+    bool execute_on_dispatch_;
+    bool hook_installed_ = false;
+    LazyWindow lazy_window_;
+    EvaluationManager::EvaluationStats stats_;
+    Profiler profiler_;
+    bool profiling_enabled_ = false;
+};
+
+}  // namespace tt_lazy
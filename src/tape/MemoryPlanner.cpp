@@ -0,0 +1,159 @@
+#include "MemoryPlanner.hpp"
+
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Operations whose output element i depends only on element i of each same-shaped input, so
+// the output may overwrite an input while it is being read
+bool is_elementwise(OpTypeId op_type) {
+    return op_type == AddArgs::type_id() || op_type == MultiplyArgs::type_id() || op_type == ReLUArgs::type_id() ||
+           op_type == ReLUBackwardArgs::type_id();
+}
+
+bool same_shape(const Tensor& a, const Tensor& b) {
+    return a.rank() == b.rank() && std::equal(a.shape(), a.shape() + a.rank(), b.shape());
+}
+
+}  // namespace
+
+MemoryPlanner::MemoryPlanner(TapeExecutor& executor) : executor_(executor) {}
+
+void MemoryPlanner::on_tape_begin(const Tape& tape) {
+    // A previous tape may have stopped on an exception before on_tape_end
+    reset();
+
+    const auto& operations = tape.operations();
+    for (size_t i = 0; i < operations.size(); ++i) {
+        position_[operations[i]->node_id] = i;
+        entries_[operations[i]->node_id].op = operations[i].get();
+    }
+    for (size_t i = 0; i < operations.size(); ++i) {
+        for (NodeId input : operations[i]->input_nodes) {
+            auto it = entries_.find(input);
+            if (it != entries_.end()) {
+                it->second.last_use = i;
+                it->second.consumed = true;
+            }
+        }
+    }
+}
+
+void MemoryPlanner::on_tape_end([[maybe_unused]] const Tape& tape) {
+    reset();
+}
+
+void MemoryPlanner::on_operation_begin(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    if (it == position_.end()) {
+        return;
+    }
+    NodeId input = reusable_input(op, it->second);
+    if (input != 0) {
+        executor_.bind_output(op.node_id, executor_.get_result(input));
+        reused_[op.node_id] = input;
+    }
+}
+
+void MemoryPlanner::on_operation_end(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    if (it == position_.end()) {
+        return;
+    }
+    size_t position = it->second;
+
+    Entry& entry = entries_[op.node_id];
+    auto result = executor_.get_result(op.node_id);
+    entry.bytes = result ? result->total_elements() * sizeof(float) : 0;
+    auto reused = reused_.find(op.node_id);
+    if (reused != reused_.end()) {
+        // The buffer changes hands; the bytes are already counted for the input
+        executor_.unbind_output(op.node_id);
+        entries_[reused->second].bytes = 0;
+        owned_.erase(reused->second);
+        owned_.insert(op.node_id);
+        stats_.reused_buffers++;
+    } else {
+        live_bytes_ += entry.bytes;
+        if (is_fresh_result(op, result)) {
+            owned_.insert(op.node_id);
+        }
+    }
+    stats_.peak_live_bytes = std::max(stats_.peak_live_bytes, live_bytes_);
+
+    for (NodeId input : op.input_nodes) {
+        if (!is_releasable(input, position) || !executor_.get_result(input)) {
+            continue;  // Still needed, or already released (an input read twice)
+        }
+        Entry& input_entry = entries_[input];
+        owned_.erase(input);
+        executor_.erase_result(input);
+        input_entry.op->result.reset();
+        live_bytes_ -= input_entry.bytes;
+        stats_.released_bytes += input_entry.bytes;
+        input_entry.bytes = 0;
+    }
+}
+
+bool MemoryPlanner::is_releasable(NodeId node_id, size_t position) const {
+    auto it = entries_.find(node_id);
+    return it != entries_.end() && it->second.consumed && it->second.last_use == position &&
+           kept_.count(node_id) == 0 && !executor_.get_output_binding(node_id);
+}
+
+// A buffer the operation allocated for itself: not caller memory bound to it, not a constant,
+// and not another node's result or output handed on (as TopKIndices does with TopK's positions)
+bool MemoryPlanner::is_fresh_result(const TapeOperation& op, const std::shared_ptr<Tensor>& result) const {
+    if (!result || result->is_constant() || executor_.get_output_binding(op.node_id)) {
+        return false;
+    }
+    for (NodeId input : op.input_nodes) {
+        for (uint16_t index = 0;; ++index) {
+            auto output = executor_.get_result(input, index);
+            if (output == result) {
+                return false;
+            }
+            if (!output && index > 0) {
+                break;  // Past the input's last output
+            }
+        }
+    }
+    return true;
+}
+
+NodeId MemoryPlanner::reusable_input(const TapeOperation& op, size_t position) const {
+    if (!is_elementwise(op.op_type) || executor_.get_output_binding(op.node_id)) {
+        return 0;
+    }
+    for (NodeId candidate : op.input_nodes) {
+        if (!is_releasable(candidate, position)) {
+            continue;
+        }
+        auto buffer = executor_.get_result(candidate);
+        if (!buffer || owned_.count(candidate) == 0) {
+            continue;
+        }
+        bool fits = std::all_of(op.input_nodes.begin(), op.input_nodes.end(), [&](NodeId input) {
+            auto tensor = executor_.get_result(input);
+            return tensor && same_shape(*tensor, *buffer);
+        });
+        fits = fits && std::all_of(op.constant_inputs.begin(), op.constant_inputs.end(),
+                                   [&](const Tensor& constant) { return same_shape(constant, *buffer); });
+        if (fits) {
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+void MemoryPlanner::reset() {
+    entries_.clear();
+    position_.clear();
+    reused_.clear();
+    owned_.clear();
+    live_bytes_ = 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "ExecutionObserver.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class TapeExecutor;
+
+// Execution observer that keeps only the results a tape still needs.
+//
+// A result is released as soon as the last operation reading it has run, unless it is one of
+// the kept nodes or an output of the tape (not consumed within it). An elementwise operation
+// (Add, Multiply, ReLU, ReLUBackward) whose input dies with it writes its result into that
+// input's buffer instead of allocating one, so e.g. a chain of gradient accumulations reuses
+// a single buffer. Only buffers the planner saw an operation of the tape allocate, and that no
+// other node, caller or cache holds, are overwritten that way.
+//
+// Released results are gone from the executor, so a later tape needing them recomputes them;
+// it suits one-shot evaluation such as writing a batch of gradients into caller buffers.
+class MemoryPlanner : public ExecutionObserver {
+   public:
+    struct Stats {
+        size_t peak_live_bytes = 0;  // Most result bytes held at once by the planned tapes
+        size_t released_bytes = 0;   // Results dropped after their last use
+        size_t reused_buffers = 0;   // Results written into a dying input
+    };
+
+    explicit MemoryPlanner(TapeExecutor& executor);
+
+    // Nodes whose results must outlive the tape, e.g. the ones the caller asked for
+    void set_kept_nodes(std::unordered_set<NodeId> nodes) { kept_ = std::move(nodes); }
+
+    void on_tape_begin(const Tape& tape) override;
+    void on_tape_end(const Tape& tape) override;
+    void on_operation_begin(const TapeOperation& op) override;
+    void on_operation_end(const TapeOperation& op) override;
+
+    const Stats& stats() const { return stats_; }
+    void reset_stats() { stats_ = Stats{}; }
+
+   private:
+    struct Entry {
+        TapeOperation* op = nullptr;
+        size_t last_use = 0;
+        bool consumed = false;  // Read by a later operation of the tape
+        size_t bytes = 0;       // Held by the executor, 0 once released or handed over
+    };
+
+    bool is_releasable(NodeId node_id, size_t position) const;
+    bool is_fresh_result(const TapeOperation& op, const std::shared_ptr<Tensor>& result) const;
+    NodeId reusable_input(const TapeOperation& op, size_t position) const;
+    void reset();
+
+    TapeExecutor& executor_;
+    std::unordered_set<NodeId> kept_;
+    std::unordered_map<NodeId, Entry> entries_;
+    std::unordered_map<NodeId, size_t> position_;
+    std::unordered_map<NodeId, NodeId> reused_;  // Operation -> input whose buffer it writes
+    std::unordered_set<NodeId> owned_;           // Operations whose buffer only the executor holds
+    size_t live_bytes_ = 0;
+    Stats stats_;
+};
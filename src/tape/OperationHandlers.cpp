@@ -1,10 +1,40 @@
+#include "GemmAutotuner.hpp"
 #include "TapeExecutor.hpp"
+#include "blas.hpp"
+#include "kernel_utils.hpp"
 #include "math_operations.hpp"
 #include "operations.hpp"
+#include "small_gemm.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 // Operation handler implementations
+
+// Inputs in the order the node declares them. Lazy and constant inputs are kept apart in
+// the tape operation, which loses their relative order when they are mixed.
+static std::vector<std::shared_ptr<Tensor>> collect_node_inputs(const TapeOperation& op, TapeExecutor& executor,
+                                                                const char* op_name) {
+    const Node* node = Context::instance().get_node(op.node_id);
+    if (!node) {
+        throw std::runtime_error(std::string("Missing graph node for ") + op_name + " operation");
+    }
+
+    std::vector<std::shared_ptr<Tensor>> input_tensors;
+    for (const auto& input : node->inputs()) {
+        if (input.is_lazy()) {
+            auto tensor = executor.get_result(input.producer_node());
+            if (!tensor) {
+                throw std::runtime_error(std::string("Missing lazy input tensor for ") + op_name + " operation");
+            }
+            input_tensors.push_back(tensor);
+        } else {
+            input_tensors.push_back(std::make_shared<Tensor>(input));
+        }
+    }
+    return input_tensors;
+}
+
 static void handle_split(TapeOperation& op, TapeExecutor& executor) {
     // Collect all input tensors (both lazy and constant)
     std::vector<std::shared_ptr<Tensor>> input_tensors;
@@ -35,34 +65,69 @@ static void handle_split(TapeOperation& op, TapeExecutor& executor) {
 }
 
 static void handle_matmul(TapeOperation& op, TapeExecutor& executor) {
-    // Collect all input tensors (both lazy and constant)
-    std::vector<std::shared_ptr<Tensor>> input_tensors;
+    // Node order matters here: a constant left operand must stay on the left
+    auto input_tensors = collect_node_inputs(op, executor, "matmul");
+    if (input_tensors.size() != 2) {
+        throw std::runtime_error("MatMul operation requires exactly 2 inputs, got " +
+                                 std::to_string(input_tensors.size()));
+    }
 
-    // Add lazy input tensors
-    for (NodeId node_id : op.input_nodes) {
-        auto tensor = executor.get_result(node_id);
-        if (!tensor) {
-            throw std::runtime_error("Missing lazy input tensor for matmul operation");
-        }
-        input_tensors.push_back(tensor);
+    bool transpose_a = false;
+    bool transpose_b = false;
+    if (const Node* node = Context::instance().get_node(op.node_id)) {
+        const auto& args = node->as<MatMulArgs>();
+        transpose_a = args.transpose_a;
+        transpose_b = args.transpose_b;
     }
 
-    // Add constant input tensors
-    for (const auto& const_tensor : op.constant_inputs) {
-        input_tensors.push_back(std::make_shared<Tensor>(const_tensor));
+    // Call math function, writing straight into a bound output buffer if there is one
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::matmul(*input_tensors[0], *input_tensors[1], *result, transpose_a, transpose_b);
+    } else {
+        result = std::make_shared<Tensor>(math::matmul(*input_tensors[0], *input_tensors[1], transpose_a, transpose_b));
     }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
 
+// Runs one of the math::matmul_* kernels that write into preallocated output
+using MatMulKernel = void (*)(const Tensor&, const Tensor&, Tensor&, bool, bool);
+static void run_matmul_kernel(TapeOperation& op, TapeExecutor& executor, MatMulKernel kernel) {
+    auto input_tensors = collect_node_inputs(op, executor, "matmul");
     if (input_tensors.size() != 2) {
         throw std::runtime_error("MatMul operation requires exactly 2 inputs, got " +
                                  std::to_string(input_tensors.size()));
     }
-
-    // Call math function
-    auto result = std::make_shared<Tensor>(math::matmul(*input_tensors[0], *input_tensors[1]));
+    const auto& args = Context::instance().get_node(op.node_id)->as<MatMulArgs>();
+    const Tensor& a = *input_tensors[0];
+    const Tensor& b = *input_tensors[1];
+    auto result = executor.get_output_binding(op.node_id);
+    if (!result) {
+        result = std::make_shared<Tensor>(
+            std::vector<uint32_t>{a.size(args.transpose_a ? 1 : 0), b.size(args.transpose_b ? 0 : 1)});
+    }
+    kernel(a, b, *result, args.transpose_a, args.transpose_b);
     executor.set_result(op.node_id, result);
     op.result = result;
 }
 
+static void handle_matmul_gemv(TapeOperation& op, TapeExecutor& executor) {
+    run_matmul_kernel(op, executor, math::matmul_gemv);
+}
+
+static void handle_matmul_small(TapeOperation& op, TapeExecutor& executor) {
+    run_matmul_kernel(op, executor, math::matmul_small);
+}
+
+static void handle_matmul_blas(TapeOperation& op, TapeExecutor& executor) {
+    run_matmul_kernel(op, executor, math::matmul_blas);
+}
+
+static void handle_matmul_blas_gemv(TapeOperation& op, TapeExecutor& executor) {
+    run_matmul_kernel(op, executor, math::matmul_blas_gemv);
+}
+
 static void handle_reduce(TapeOperation& op, TapeExecutor& executor) {
     // Collect all input tensors (both lazy and constant)
     std::vector<std::shared_ptr<Tensor>> input_tensors;
@@ -86,9 +151,20 @@ static void handle_reduce(TapeOperation& op, TapeExecutor& executor) {
                                  std::to_string(input_tensors.size()));
     }
 
-    // Call math function (simplified - would need proper parameters)
-    std::vector<int32_t> dims = {0};  // Default: reduce along first dimension
-    auto result = std::make_shared<Tensor>(math::reduce_sum(*input_tensors[0], dims));
+    const Node* node = Context::instance().get_node(op.node_id);
+    if (!node) {
+        throw std::runtime_error("Cannot find node for reduce operation");
+    }
+    const auto& args = node->as<ReduceArgs>();
+    std::vector<int32_t> dims(args.dims.begin(), args.dims.end());
+
+    // Call math function, writing straight into a bound output buffer if there is one
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::reduce_sum(*input_tensors[0], *result, dims, args.keepdim);
+    } else {
+        result = std::make_shared<Tensor>(math::reduce_sum(*input_tensors[0], dims, args.keepdim));
+    }
     executor.set_result(op.node_id, result);
     op.result = result;
 }
@@ -116,8 +192,13 @@ static void handle_relu(TapeOperation& op, TapeExecutor& executor) {
                                  std::to_string(input_tensors.size()));
     }
 
-    // Call math function
-    auto result = std::make_shared<Tensor>(math::relu(*input_tensors[0]));
+    // Call math function, writing straight into a bound output buffer if there is one
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::relu(*input_tensors[0], *result);
+    } else {
+        result = std::make_shared<Tensor>(math::relu(*input_tensors[0]));
+    }
     executor.set_result(op.node_id, result);
     op.result = result;
 }
@@ -145,8 +226,13 @@ static void handle_add(TapeOperation& op, TapeExecutor& executor) {
                                  std::to_string(input_tensors.size()));
     }
 
-    // Call math function
-    auto result = std::make_shared<Tensor>(math::add(*input_tensors[0], *input_tensors[1]));
+    // Call math function, writing straight into a bound output buffer if there is one
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::add(*input_tensors[0], *input_tensors[1], *result);
+    } else {
+        result = std::make_shared<Tensor>(math::add(*input_tensors[0], *input_tensors[1]));
+    }
     executor.set_result(op.node_id, result);
     op.result = result;
 }
@@ -174,8 +260,13 @@ static void handle_multiply(TapeOperation& op, TapeExecutor& executor) {
                                  std::to_string(input_tensors.size()));
     }
 
-    // Call math function
-    auto result = std::make_shared<Tensor>(math::multiply(*input_tensors[0], *input_tensors[1]));
+    // Call math function, writing straight into a bound output buffer if there is one
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::multiply(*input_tensors[0], *input_tensors[1], *result);
+    } else {
+        result = std::make_shared<Tensor>(math::multiply(*input_tensors[0], *input_tensors[1]));
+    }
     executor.set_result(op.node_id, result);
     op.result = result;
 }
@@ -214,19 +305,301 @@ static void handle_fused_mlp(TapeOperation& op, TapeExecutor& executor) {
     bool has_relu = args.has_relu;
 
     // Call fused math function with input, weights, bias
-    auto result =
-        std::make_shared<Tensor>(math::fused_mlp(*input_tensors[0], *input_tensors[1], *input_tensors[2], has_relu));
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::fused_mlp(*input_tensors[0], *input_tensors[1], *input_tensors[2], *result, has_relu);
+    } else {
+        result = std::make_shared<Tensor>(
+            math::fused_mlp(*input_tensors[0], *input_tensors[1], *input_tensors[2], has_relu));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_fused_mlp_gemv(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "fused MLP");
+    if (input_tensors.size() != 3) {
+        throw std::runtime_error("Fused MLP operation requires exactly 3 inputs (input, weights, bias), got " +
+                                 std::to_string(input_tensors.size()));
+    }
+    bool has_relu = Context::instance().get_node(op.node_id)->as<FusedMLPArgs>().has_relu;
+    auto result = executor.get_output_binding(op.node_id);
+    if (!result) {
+        result = std::make_shared<Tensor>(std::vector<uint32_t>{1, input_tensors[1]->size(1)});
+    }
+    math::fused_mlp_gemv(*input_tensors[0], *input_tensors[1], *input_tensors[2], *result, has_relu);
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_fused_mlp_small(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "fused MLP");
+    if (input_tensors.size() != 3) {
+        throw std::runtime_error("Fused MLP operation requires exactly 3 inputs (input, weights, bias), got " +
+                                 std::to_string(input_tensors.size()));
+    }
+    bool has_relu = Context::instance().get_node(op.node_id)->as<FusedMLPArgs>().has_relu;
+    auto result = executor.get_output_binding(op.node_id);
+    if (!result) {
+        result = std::make_shared<Tensor>(std::vector<uint32_t>{input_tensors[0]->size(0), input_tensors[1]->size(1)});
+    }
+    math::fused_mlp_small(*input_tensors[0], *input_tensors[1], *input_tensors[2], *result, has_relu);
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_gather(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "gather");
+    if (input_tensors.size() != 2) {
+        throw std::runtime_error("Gather operation requires exactly 2 inputs, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    int32_t axis = Context::instance().get_node(op.node_id)->as<GatherArgs>().axis;
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::gather(*input_tensors[0], *input_tensors[1], *result, axis);
+    } else {
+        result = std::make_shared<Tensor>(math::gather(*input_tensors[0], *input_tensors[1], axis));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_embedding_bag(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "embedding_bag");
+    if (input_tensors.size() != 3) {
+        throw std::runtime_error("EmbeddingBag operation requires exactly 3 inputs, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    bool mean = Context::instance().get_node(op.node_id)->as<EmbeddingBagArgs>().mode == EmbeddingBagArgs::Mode::MEAN;
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::embedding_bag(*input_tensors[0], *input_tensors[1], *input_tensors[2], *result, mean);
+    } else {
+        result = std::make_shared<Tensor>(
+            math::embedding_bag(*input_tensors[0], *input_tensors[1], *input_tensors[2], mean));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_topk(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "topk");
+    if (input_tensors.size() != 1) {
+        throw std::runtime_error("TopK operation requires exactly 1 input, got " + std::to_string(input_tensors.size()));
+    }
+
+    const auto& args = Context::instance().get_node(op.node_id)->as<TopKArgs>();
+
+    // Values are the node's result; positions go to output 1 for the TopKIndices node
+    auto result = executor.get_output_binding(op.node_id);
+    std::shared_ptr<Tensor> indices;
+    if (result) {
+        indices = std::make_shared<Tensor>(std::vector<uint32_t>(result->shape(), result->shape() + result->rank()));
+        math::topk(*input_tensors[0], *result, *indices, args.k, args.dim);
+    } else {
+        auto [values, positions] = math::topk(*input_tensors[0], args.k, args.dim);
+        result = std::make_shared<Tensor>(std::move(values));
+        indices = std::make_shared<Tensor>(std::move(positions));
+    }
+    executor.set_result(op.node_id, 1, indices);
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_topk_indices(TapeOperation& op, TapeExecutor& executor) {
+    if (op.input_nodes.size() != 1) {
+        throw std::runtime_error("TopKIndices operation requires the lazy TopK values as its input");
+    }
+    auto indices = executor.get_result(op.input_nodes[0], 1);
+    if (!indices) {
+        throw std::runtime_error("Missing TopK positions for TopKIndices operation");
+    }
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::check_output(*result, math::shape_of(*indices), "TopKIndices");
+        std::copy(indices->const_data_ptr(), indices->const_data_ptr() + indices->total_elements(), result->data_ptr());
+    } else {
+        result = indices;
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_argmax(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "argmax");
+    if (input_tensors.size() != 1) {
+        throw std::runtime_error("ArgMax operation requires exactly 1 input, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    int32_t dim = Context::instance().get_node(op.node_id)->as<ArgMaxArgs>().dim;
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::argmax(*input_tensors[0], *result, dim);
+    } else {
+        result = std::make_shared<Tensor>(math::argmax(*input_tensors[0], dim));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_conv2d(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "conv2d");
+    if (input_tensors.size() != 2 && input_tensors.size() != 3) {
+        throw std::runtime_error("Conv2D operation requires 2 or 3 inputs, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    const auto& args = Context::instance().get_node(op.node_id)->as<Conv2DArgs>();
+    math::Conv2dParams params;
+    params.stride_h = args.stride_h;
+    params.stride_w = args.stride_w;
+    params.pad_h = args.pad_h;
+    params.pad_w = args.pad_w;
+    params.dilation_h = args.dilation_h;
+    params.dilation_w = args.dilation_w;
+    params.groups = args.groups;
+    params.channels_last = args.layout == Conv2DArgs::Layout::NHWC;
+    params.relu = args.has_relu;
+    Tensor bias = input_tensors.size() == 3 ? *input_tensors[2] : Tensor();
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::conv2d(*input_tensors[0], *input_tensors[1], bias, *result, params);
+    } else {
+        result = std::make_shared<Tensor>(math::conv2d(*input_tensors[0], *input_tensors[1], bias, params));
+    }
     executor.set_result(op.node_id, result);
     op.result = result;
 }
 
+static void handle_relu_backward(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "relu_backward");
+    if (input_tensors.size() != 2) {
+        throw std::runtime_error("ReLUBackward operation requires exactly 2 inputs, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::relu_backward(*input_tensors[0], *input_tensors[1], *result);
+    } else {
+        result = std::make_shared<Tensor>(math::relu_backward(*input_tensors[0], *input_tensors[1]));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+static void handle_reduce_backward(TapeOperation& op, TapeExecutor& executor) {
+    auto input_tensors = collect_node_inputs(op, executor, "reduce_backward");
+    if (input_tensors.size() != 1) {
+        throw std::runtime_error("ReduceBackward operation requires exactly 1 input, got " +
+                                 std::to_string(input_tensors.size()));
+    }
+
+    const auto& args = Context::instance().get_node(op.node_id)->as<ReduceBackwardArgs>();
+    std::vector<int32_t> dims(args.dims.begin(), args.dims.end());
+
+    auto result = executor.get_output_binding(op.node_id);
+    if (result) {
+        math::reduce_sum_backward(*input_tensors[0], *result, dims);
+    } else {
+        std::vector<uint32_t> input_shape(args.input_shape.begin(), args.input_shape.end());
+        result = std::make_shared<Tensor>(math::reduce_sum_backward(*input_tensors[0], input_shape, dims));
+    }
+    executor.set_result(op.node_id, result);
+    op.result = result;
+}
+
+// Kernel selection for GEMM-shaped operations. Costs are in multiply-adds, counting the
+// padding of the packed GEMM's register tiles and the copies made while packing.
+static double packed_gemm_cost(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    if (!key) {
+        return 0.0;
+    }
+    auto round_up = [](size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; };
+    double tiles = static_cast<double>(round_up(key->m, math::GEMM_MR) * round_up(key->n, math::GEMM_NR) * key->k);
+    return tiles + static_cast<double>(key->m * key->k + key->k * key->n);
+}
+
+// Streams the right operand without register blocking, so each multiply-add also loads it
+static double gemv_cost(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    return key ? 2.0 * static_cast<double>(key->m * key->n * key->k) : 0.0;
+}
+
+static bool is_single_row(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    return key && key->m == 1;
+}
+
+// External BLAS kernels, relative to the ones above as measured with OpenBLAS on x86-64:
+// about 0.6x the packed GEMM's time on its (row-padded) tiles, and 0.9x the gemv
+static double blas_sgemm_cost(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    if (!key) {
+        return 0.0;
+    }
+    size_t padded_rows = (key->m + math::GEMM_MR - 1) / math::GEMM_MR * math::GEMM_MR;
+    return 0.6 * static_cast<double>(padded_rows * key->n * key->k);
+}
+
+static double blas_sgemv_cost(const TapeOperation& op) {
+    return 0.9 * gemv_cost(op);
+}
+
+static bool is_2d_product(const TapeOperation& op) {
+    return gemm_key(op).has_value();
+}
+
+// Shape-specialized kernels do the bare m * n * k multiply-adds: no tile padding, packing or
+// thread dispatch
+static bool has_small_kernel(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    return key && !key->transpose_a && !key->transpose_b && math::find_small_gemm(key->m, key->n, key->k) != nullptr;
+}
+
+static double small_gemm_cost(const TapeOperation& op) {
+    auto key = gemm_key(op);
+    return key ? static_cast<double>(key->m * key->n * key->k) : 0.0;
+}
+
 // Global function to register all operations with any TapeExecutor
 void register_all_operations(TapeExecutor& executor) {
-    executor.register_operation(SplitArgs::type_id(), handle_split);
-    executor.register_operation(MatMulArgs::type_id(), handle_matmul);
-    executor.register_operation(ReduceArgs::type_id(), handle_reduce);
-    executor.register_operation(ReLUArgs::type_id(), handle_relu);
-    executor.register_operation(AddArgs::type_id(), handle_add);
-    executor.register_operation(MultiplyArgs::type_id(), handle_multiply);
-    executor.register_operation(FusedMLPArgs::type_id(), handle_fused_mlp);
+    executor.register_kernel(SplitArgs::type_id(), {"split", {}, {}, handle_split});
+    executor.register_kernel(MatMulArgs::type_id(), {"matmul_gemm", {}, packed_gemm_cost, handle_matmul});
+    executor.register_kernel(MatMulArgs::type_id(), {"matmul_gemv", is_single_row, gemv_cost, handle_matmul_gemv});
+    executor.register_kernel(MatMulArgs::type_id(),
+                             {"matmul_small", has_small_kernel, small_gemm_cost, handle_matmul_small});
+    if (math::blas_available()) {
+        executor.register_kernel(MatMulArgs::type_id(),
+                                 {"matmul_blas_sgemm", is_2d_product, blas_sgemm_cost, handle_matmul_blas});
+        executor.register_kernel(MatMulArgs::type_id(),
+                                 {"matmul_blas_sgemv", is_single_row, blas_sgemv_cost, handle_matmul_blas_gemv});
+    }
+    executor.register_kernel(ReduceArgs::type_id(), {"reduce", {}, {}, handle_reduce});
+    executor.register_kernel(ReLUArgs::type_id(), {"relu", {}, {}, handle_relu});
+    executor.register_kernel(AddArgs::type_id(), {"add", {}, {}, handle_add});
+    executor.register_kernel(MultiplyArgs::type_id(), {"multiply", {}, {}, handle_multiply});
+    executor.register_kernel(FusedMLPArgs::type_id(), {"fused_mlp_gemm", {}, packed_gemm_cost, handle_fused_mlp});
+    executor.register_kernel(FusedMLPArgs::type_id(),
+                             {"fused_mlp_gemv", is_single_row, gemv_cost, handle_fused_mlp_gemv});
+    executor.register_kernel(FusedMLPArgs::type_id(),
+                             {"fused_mlp_small", has_small_kernel, small_gemm_cost, handle_fused_mlp_small});
+    executor.register_kernel(GatherArgs::type_id(), {"gather", {}, {}, handle_gather});
+    executor.register_kernel(EmbeddingBagArgs::type_id(), {"embedding_bag", {}, {}, handle_embedding_bag});
+    executor.register_kernel(TopKArgs::type_id(), {"topk", {}, {}, handle_topk});
+    executor.register_kernel(TopKIndicesArgs::type_id(), {"topk_indices", {}, {}, handle_topk_indices});
+    executor.register_kernel(ArgMaxArgs::type_id(), {"argmax", {}, {}, handle_argmax});
+    executor.register_kernel(Conv2DArgs::type_id(), {"conv2d", {}, {}, handle_conv2d});
+    executor.register_kernel(ReLUBackwardArgs::type_id(), {"relu_backward", {}, {}, handle_relu_backward});
+    executor.register_kernel(ReduceBackwardArgs::type_id(), {"reduce_backward", {}, {}, handle_reduce_backward});
 }
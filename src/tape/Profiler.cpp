@@ -0,0 +1,39 @@
+#include "Profiler.hpp"
+
+#include "Context.hpp"
+#include "Node.hpp"
+
+void Profiler::on_operation_begin([[maybe_unused]] const TapeOperation& op) {
+    start_ = std::chrono::steady_clock::now();
+}
+
+void Profiler::on_operation_end(const TapeOperation& op) {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+
+    OpTiming timing;
+    timing.node_id = op.node_id;
+    timing.duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    // Resolve the name through the graph node; the tape only stores the type id
+    if (const Node* node = Context::instance().get_node(op.node_id)) {
+        timing.op_name = std::string(node->op_name());
+    } else {
+        timing.op_name = "type_" + std::to_string(op.op_type);
+    }
+
+    timings_.push_back(std::move(timing));
+}
+
+std::unordered_map<std::string, Profiler::Summary> Profiler::summary() const {
+    std::unordered_map<std::string, Summary> result;
+    for (const auto& timing : timings_) {
+        auto& entry = result[timing.op_name];
+        entry.count++;
+        entry.total_ns += timing.duration_ns;
+    }
+    return result;
+}
+
+void Profiler::clear() {
+    timings_.clear();
+}
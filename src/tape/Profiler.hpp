@@ -0,0 +1,31 @@
+#pragma once
+#include "EvaluationManager.hpp"
+#include "ExecutionObserver.hpp"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Execution observer that records wall-clock time of every executed operation
+class Profiler : public ExecutionObserver {
+   public:
+    using OpTiming = tt_lazy::EvaluationManager::OpTiming;
+
+    // Aggregated timings for one operation type
+    struct Summary {
+        size_t count = 0;
+        uint64_t total_ns = 0;
+    };
+
+    void on_operation_begin(const TapeOperation& op) override;
+    void on_operation_end(const TapeOperation& op) override;
+
+    const std::vector<OpTiming>& timings() const { return timings_; }
+    std::unordered_map<std::string, Summary> summary() const;
+    void clear();
+
+   private:
+    std::chrono::steady_clock::time_point start_;
+    std::vector<OpTiming> timings_;
+};
@@ -0,0 +1,398 @@
+#include "SpillManager.hpp"
+
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t NO_FURTHER_USE = std::numeric_limits<size_t>::max();
+
+void write_all(int fd, const void* data, size_t bytes, uint64_t offset) {
+    const auto* ptr = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = pwrite(fd, ptr, bytes, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw std::runtime_error(std::string("Spill write failed: ") + std::strerror(errno));
+        }
+        ptr += written;
+        bytes -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+void read_all(int fd, void* data, size_t bytes, uint64_t offset) {
+    auto* ptr = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t count = pread(fd, ptr, bytes, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw std::runtime_error(std::string("Spill read failed: ") + std::strerror(errno));
+        }
+        ptr += count;
+        bytes -= static_cast<size_t>(count);
+        offset += static_cast<uint64_t>(count);
+    }
+}
+
+size_t output_bytes(const TapeOperation& op) {
+    if (op.output_shapes.empty()) {
+        return 0;
+    }
+    size_t numel = 1;
+    for (uint32_t dim : op.output_shapes[0]) {
+        numel *= dim;
+    }
+    return numel * sizeof(float);
+}
+
+}  // namespace
+
+SpillManager::SpillManager(TapeExecutor& executor, Options options)
+    : executor_(executor), options_(std::move(options)) {
+    io_thread_ = std::thread([this]() { io_loop(); });
+}
+
+SpillManager::~SpillManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    io_thread_.join();
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+void SpillManager::on_tape_begin(const Tape& tape) {
+    // A previous tape may have stopped on an exception before on_tape_end
+    reset();
+
+    const auto& operations = tape.operations();
+    for (size_t i = 0; i < operations.size(); ++i) {
+        operations_.push_back(operations[i].get());
+        position_[operations[i]->node_id] = i;
+    }
+    for (size_t i = 0; i < operations.size(); ++i) {
+        for (NodeId input : operations[i]->input_nodes) {
+            if (position_.count(input) > 0) {
+                entries_[input].uses.push_back(i);
+            }
+        }
+    }
+    for (auto* op : operations_) {
+        auto& entry = entries_[op->node_id];
+        entry.op = op;
+        entry.is_output = entry.uses.empty();
+        // Operations evaluated by an earlier run already hold their results
+        if (auto result = executor_.get_result(op->node_id)) {
+            entry.location = Location::RESIDENT;
+            entry.bytes = result->total_elements() * sizeof(float);
+            resident_bytes_ += entry.bytes;
+        }
+    }
+}
+
+void SpillManager::on_tape_end([[maybe_unused]] const Tape& tape) {
+    // Outputs are handed back to the caller in memory
+    for (auto& [node_id, entry] : entries_) {
+        if (entry.is_output) {
+            make_resident(node_id, entry);
+        }
+    }
+    reset();
+}
+
+void SpillManager::on_operation_begin(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    if (it == position_.end()) {
+        return;
+    }
+    size_t position = it->second;
+    rethrow_io_error();
+
+    // Make room for the inputs that come back from disk and for the output, then restore
+    size_t pending_output = output_bytes(op);
+    size_t incoming = pending_output;
+    for (NodeId input : op.input_nodes) {
+        auto entry = entries_.find(input);
+        if (entry != entries_.end() && entry->second.location == Location::SPILLED && !entry->second.read_requested) {
+            incoming += entry->second.bytes;
+        }
+    }
+    make_room(position, incoming, &op);
+    for (NodeId input : op.input_nodes) {
+        auto entry = entries_.find(input);
+        if (entry != entries_.end()) {
+            make_resident(input, entry->second);
+        }
+    }
+
+    // Start reading back what the next operations consume while this one computes, as long as
+    // that does not take the space reserved for this operation's output
+    size_t last = std::min(position + options_.lookahead, operations_.size() - 1);
+    for (size_t next = position + 1; next <= last; ++next) {
+        for (NodeId input : operations_[next]->input_nodes) {
+            auto entry = entries_.find(input);
+            if (entry != entries_.end() && entry->second.location == Location::SPILLED &&
+                !entry->second.read_requested &&
+                resident_bytes_ + pending_output + entry->second.bytes <= options_.budget_bytes) {
+                request_read(entry->second);
+            }
+        }
+    }
+}
+
+void SpillManager::on_operation_end(const TapeOperation& op) {
+    auto it = position_.find(op.node_id);
+    auto result = executor_.get_result(op.node_id);
+    if (it == position_.end() || !result) {
+        return;
+    }
+    auto& entry = entries_[op.node_id];
+    entry.location = Location::RESIDENT;
+    entry.bytes = result->total_elements() * sizeof(float);
+    resident_bytes_ += entry.bytes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.peak_resident_bytes = std::max<uint64_t>(stats_.peak_resident_bytes, resident_bytes_);
+    }
+    make_room(it->second, 0, nullptr);
+}
+
+SpillManager::Stats SpillManager::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SpillManager::reset_stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = Stats{};
+}
+
+size_t SpillManager::next_use(const Entry& entry, size_t position) const {
+    auto it = std::upper_bound(entry.uses.begin(), entry.uses.end(), position);
+    if (it != entry.uses.end()) {
+        return *it;
+    }
+    return entry.is_output ? operations_.size() : NO_FURTHER_USE;
+}
+
+void SpillManager::make_room(size_t position, size_t incoming_bytes, const TapeOperation* running) {
+    if (options_.budget_bytes == 0) {
+        return;
+    }
+    while (resident_bytes_ + incoming_bytes > options_.budget_bytes) {
+        // Belady: evict the result whose next use is furthest away
+        Entry* victim = nullptr;
+        NodeId victim_id = 0;
+        size_t victim_use = 0;
+        for (auto& [node_id, entry] : entries_) {
+            if (entry.location != Location::RESIDENT || executor_.get_output_binding(node_id)) {
+                continue;
+            }
+            if (running && std::find(running->input_nodes.begin(), running->input_nodes.end(), node_id) !=
+                               running->input_nodes.end()) {
+                continue;
+            }
+            size_t use = next_use(entry, position);
+            if (!victim || use > victim_use || (use == victim_use && entry.bytes > victim->bytes)) {
+                victim = &entry;
+                victim_id = node_id;
+                victim_use = use;
+            }
+        }
+        if (!victim) {
+            return;  // Everything left is needed right now
+        }
+
+        if (victim_use == NO_FURTHER_USE) {
+            executor_.erase_result(victim_id);
+            victim->op->result.reset();
+            victim->location = Location::RELEASED;
+            resident_bytes_ -= victim->bytes;
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.dropped_bytes += victim->bytes;
+        } else {
+            spill(victim_id, *victim);
+        }
+    }
+}
+
+void SpillManager::spill(NodeId node_id, Entry& entry) {
+    ensure_spill_file();
+    auto result = executor_.get_result(node_id);
+    entry.shape.assign(result->shape(), result->shape() + result->rank());
+    entry.offset = file_size_;
+    file_size_ += entry.bytes;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.in_flight = result;
+        stats_.spilled_bytes += entry.bytes;
+        stats_.spill_count++;
+    }
+    executor_.erase_result(node_id);
+    entry.op->result.reset();
+    entry.location = Location::SPILLED;
+    entry.read_requested = false;
+    resident_bytes_ -= entry.bytes;
+
+    submit([this, &entry, result, fd = fd_]() {
+        write_all(fd, result->const_data_ptr(), entry.bytes, entry.offset);
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.in_flight.reset();
+    });
+}
+
+void SpillManager::request_read(Entry& entry) {
+    entry.read_requested = true;
+    resident_bytes_ += entry.bytes;
+    submit([this, &entry, fd = fd_]() {
+        auto tensor = std::make_shared<Tensor>(entry.shape);
+        read_all(fd, tensor->data_ptr(), entry.bytes, entry.offset);
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.restored = std::move(tensor);
+        stats_.restored_bytes += entry.bytes;
+        stats_.restore_count++;
+    });
+}
+
+void SpillManager::make_resident(NodeId node_id, Entry& entry) {
+    if (entry.location != Location::SPILLED) {
+        return;
+    }
+
+    std::shared_ptr<Tensor> tensor;
+    {
+        // Needed again before its write finished: the data is still in memory
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!entry.read_requested && entry.in_flight) {
+            tensor = entry.in_flight;
+            resident_bytes_ += entry.bytes;
+            stats_.restored_bytes += entry.bytes;
+            stats_.restore_count++;
+        }
+    }
+    if (!tensor) {
+        if (!entry.read_requested) {
+            request_read(entry);
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this, &entry]() { return entry.restored || io_error_; });
+        stats_.stall_ns += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        if (io_error_) {
+            std::rethrow_exception(io_error_);
+        }
+        tensor = std::move(entry.restored);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.peak_resident_bytes = std::max<uint64_t>(stats_.peak_resident_bytes, resident_bytes_);
+    }
+
+    executor_.set_result(node_id, tensor);
+    entry.op->result = tensor;
+    entry.location = Location::RESIDENT;
+    entry.read_requested = false;
+}
+
+void SpillManager::reset() {
+    wait_idle();
+    entries_.clear();
+    position_.clear();
+    operations_.clear();
+    resident_bytes_ = 0;
+    if (fd_ >= 0 && file_size_ > 0) {
+        if (ftruncate(fd_, 0) != 0) {
+            spdlog::warn("Failed to truncate spill file: {}", std::strerror(errno));
+        }
+    }
+    file_size_ = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    io_error_ = nullptr;
+}
+
+void SpillManager::ensure_spill_file() {
+    if (fd_ >= 0) {
+        return;
+    }
+    std::string directory = options_.spill_directory;
+    if (directory.empty()) {
+        const char* tmpdir = std::getenv("TMPDIR");  // NOLINT(concurrency-mt-unsafe)
+        directory = tmpdir && *tmpdir ? tmpdir : "/tmp";
+    }
+    std::string path = directory + "/tt_lazy_spill_XXXXXX";
+    fd_ = mkstemp(path.data());
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to create spill file in '" + directory + "': " + std::strerror(errno));
+    }
+    // Unlinked right away: the space is reclaimed even if the process is killed
+    unlink(path.c_str());
+    spdlog::debug("Spilling intermediate results to {}", directory);
+}
+
+void SpillManager::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+        pending_tasks_++;
+    }
+    cv_.notify_one();
+}
+
+void SpillManager::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this]() { return pending_tasks_ == 0; });
+}
+
+void SpillManager::rethrow_io_error() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (io_error_) {
+        std::rethrow_exception(io_error_);
+    }
+}
+
+void SpillManager::io_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;  // Stopping with nothing left to do
+        }
+        auto task = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> error_lock(mutex_);
+            if (!io_error_) {
+                io_error_ = std::current_exception();
+            }
+        }
+        task = nullptr;  // Release the data a write was holding
+
+        lock.lock();
+        pending_tasks_--;
+        done_cv_.notify_all();
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "EvaluationManager.hpp"
+#include "ExecutionObserver.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class TapeExecutor;
+
+// Execution observer that keeps the executor's live results under a memory budget.
+//
+// When the results held by the executor exceed the budget, the ones whose next use in the
+// tape is furthest away are written to an unlinked temporary file by a background I/O thread
+// and removed from the executor. Results with no remaining use are released instead, except
+// for the tape's outputs. Spilled results are read back in the background as soon as they are
+// within `lookahead` operations of their next consumer (and fit in the budget), and at the
+// latest right before the consumer runs; time spent waiting there is reported as stall time.
+//
+// Accounting is by result size: results being written still occupy memory until their write
+// completes, so the budget can be exceeded briefly while spill writes are in flight.
+class SpillManager : public ExecutionObserver {
+   public:
+    using Stats = tt_lazy::EvaluationManager::SpillStats;
+
+    struct Options {
+        size_t budget_bytes = 0;
+        size_t lookahead = 2;         // Operations ahead to read spilled inputs back for
+        std::string spill_directory;  // Empty: $TMPDIR or /tmp
+    };
+
+    SpillManager(TapeExecutor& executor, Options options);
+    ~SpillManager() override;
+
+    // Non-copyable, non-movable (owns the I/O thread)
+    SpillManager(const SpillManager&) = delete;
+    SpillManager& operator=(const SpillManager&) = delete;
+    SpillManager(SpillManager&&) = delete;
+    SpillManager& operator=(SpillManager&&) = delete;
+
+    void on_tape_begin(const Tape& tape) override;
+    void on_tape_end(const Tape& tape) override;
+    void on_operation_begin(const TapeOperation& op) override;
+    void on_operation_end(const TapeOperation& op) override;
+
+    size_t budget_bytes() const { return options_.budget_bytes; }
+    size_t resident_bytes() const { return resident_bytes_; }
+
+    Stats stats() const;
+    void reset_stats();
+
+   private:
+    enum class Location {
+        PENDING,   // Not computed yet
+        RESIDENT,  // Held by the executor
+        SPILLED,   // On disk, possibly being written or read back
+        RELEASED   // No longer needed by this tape
+    };
+
+    struct Entry {
+        TapeOperation* op = nullptr;
+        size_t bytes = 0;
+        std::vector<size_t> uses;  // Positions of consuming operations, ascending
+        bool is_output = false;    // Not consumed within the tape
+        Location location = Location::PENDING;
+        std::vector<uint32_t> shape;
+        uint64_t offset = 0;                // Position in the spill file
+        bool read_requested = false;        // Read-back queued
+        std::shared_ptr<Tensor> restored;   // Filled by the I/O thread once the read completes
+        std::shared_ptr<Tensor> in_flight;  // Keeps the data alive until the write completes
+    };
+
+    size_t next_use(const Entry& entry, size_t position) const;
+    void make_room(size_t position, size_t incoming_bytes, const TapeOperation* running);
+    void spill(NodeId node_id, Entry& entry);
+    void request_read(Entry& entry);
+    void make_resident(NodeId node_id, Entry& entry);
+
+    void reset();
+    void ensure_spill_file();
+    void submit(std::function<void()> task);
+    void wait_idle();
+    void io_loop();
+    void rethrow_io_error();
+
+    TapeExecutor& executor_;
+    Options options_;
+
+    // Plan for the tape being executed
+    std::unordered_map<NodeId, Entry> entries_;
+    std::unordered_map<NodeId, size_t> position_;
+    std::vector<TapeOperation*> operations_;
+    size_t resident_bytes_ = 0;
+    uint64_t file_size_ = 0;
+    int fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable done_cv_;
+    std::deque<std::function<void()>> queue_;
+    size_t pending_tasks_ = 0;
+    std::exception_ptr io_error_;
+    bool stopping_ = false;
+    Stats stats_;
+    std::thread io_thread_;
+};
@@ -1,5 +1,7 @@
 #include "Tape.hpp"
 
+#include "TapeExecutor.hpp"
+
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -71,7 +73,14 @@ void Tape::print_tape(std::ostream& os) const {
             outputs_str += std::to_string(output);
         }
 
-        os << "  " << i << ": Node " << op->node_id << " (op_type: " << op->op_type << ")\n";
+        os << "  " << i << ": Node " << op->node_id << " (op_type: " << op->op_type << ")";
+        if (op->kernel) {
+            os << " [kernel: " << op->kernel->name << "]";
+        }
+        if (op->shard.is_sharded()) {
+            os << " [sharded x" << op->shard.num_shards << " by columns]";
+        }
+        os << "\n";
         os << "    Inputs: " << inputs_str << "\n";
         os << "    Outputs: " << outputs_str << "\n";
     }
@@ -6,13 +6,40 @@
 #include "TapeGenerator.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace tt_lazy {
 
+namespace {
+
+// A constant reading `result` in place, which it keeps alive
+Tensor constant_view(const std::shared_ptr<Tensor>& result) {
+    std::vector<uint32_t> shape(result->shape(), result->shape() + result->rank());
+    return Tensor(result,
+                  const_cast<void*>(result->raw_data()),  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+                  shape, result->dtype());
+}
+
+}  // namespace
+
 TapeEvaluationManager::TapeEvaluationManager() {
     // Register all standard operations with the executor
     register_all_operations(executor_);
+
+    // Tuned GEMM blockings load from the cache on first use; tuning new shapes is opt-in
+    const char* autotune = std::getenv("TT_LAZY_AUTOTUNE");  // NOLINT(concurrency-mt-unsafe)
+    if (autotune != nullptr && std::string(autotune) != "0") {
+        autotuner_ = std::make_unique<GemmAutotuner>();
+        executor_.add_observer(autotuner_.get());
+    }
 }
 
 std::shared_ptr<Tensor> TapeEvaluationManager::evaluate(const Tensor& tensor) {
@@ -36,28 +63,388 @@ std::shared_ptr<Tensor> TapeEvaluationManager::evaluate(const Tensor& tensor) {
     return evaluate_impl(tensor);
 }
 
+size_t TapeEvaluationManager::cached_bytes() const {
+    size_t bytes = 0;
+    for (const auto& [node_id, result] : evaluation_cache_) {
+        bytes += result->nbytes();
+    }
+    return bytes;
+}
+
+std::shared_ptr<Tensor> TapeEvaluationManager::cached_result(NodeId node_id) const {
+    auto it = evaluation_cache_.find(node_id);
+    return it != evaluation_cache_.end() ? it->second : nullptr;
+}
+
+void TapeEvaluationManager::adopt_result(NodeId node_id, std::shared_ptr<Tensor> result) {
+    executor_.set_result(node_id, result);
+    evaluation_cache_[node_id] = std::move(result);
+    frontier_.insert(node_id);
+}
+
 void TapeEvaluationManager::clear_cache() {
+    release_frontier();
     evaluation_cache_.clear();
     stats_ = EvaluationManager::EvaluationStats{};
+    planner_.reset_stats();
+    window_stats_ = WindowStats{};
+    reset_window();
 }
 
 EvaluationManager::EvaluationStats TapeEvaluationManager::get_stats() const {
     return stats_;
 }
 
+void TapeEvaluationManager::set_profiling_enabled(bool enabled) {
+    if (enabled == profiling_enabled_) {
+        return;
+    }
+
+    if (enabled) {
+        executor_.add_observer(&profiler_);
+    } else {
+        executor_.remove_observer(&profiler_);
+    }
+    profiling_enabled_ = enabled;
+}
+
+std::vector<EvaluationManager::OpTiming> TapeEvaluationManager::get_profile() const {
+    return profiler_.timings();
+}
+
+void TapeEvaluationManager::reset_profile() {
+    profiler_.clear();
+}
+
+void TapeEvaluationManager::set_memory_budget(size_t bytes) {
+    if (spill_manager_) {
+        executor_.remove_observer(spill_manager_.get());
+        spill_manager_.reset();
+    }
+    if (bytes > 0) {
+        SpillManager::Options options;
+        options.budget_bytes = bytes;
+        spill_manager_ = std::make_unique<SpillManager>(executor_, options);
+        executor_.add_observer(spill_manager_.get());
+    }
+}
+
+size_t TapeEvaluationManager::memory_budget() const {
+    return spill_manager_ ? spill_manager_->budget_bytes() : 0;
+}
+
+EvaluationManager::SpillStats TapeEvaluationManager::get_spill_stats() const {
+    return spill_manager_ ? spill_manager_->stats() : EvaluationManager::SpillStats{};
+}
+
+void TapeEvaluationManager::set_lazy_window(const LazyWindow& window) {
+    lazy_window_ = window;
+    update_dispatch_hook();
+}
+
+void TapeEvaluationManager::on_activate() {
+    active_ = true;
+    update_dispatch_hook();
+}
+
+void TapeEvaluationManager::on_deactivate() {
+    active_ = false;
+    update_dispatch_hook();
+}
+
+void TapeEvaluationManager::update_dispatch_hook() {
+    bool wanted = active_ && (lazy_window_.max_pending_nodes > 0 || lazy_window_.max_pending_bytes > 0);
+    if (wanted == hook_installed_) {
+        return;
+    }
+    if (wanted) {
+        // Only nodes created from now on count towards the window
+        reset_window();
+        Context::instance().set_dispatch_hook([this](NodeId node_id) { on_node_created(node_id); });
+    } else {
+        Context::instance().set_dispatch_hook(nullptr);
+    }
+    hook_installed_ = wanted;
+}
+
+void TapeEvaluationManager::on_node_created(NodeId node_id) {
+    if (node_id <= window_start_) {
+        // The graph was cleared and ids start over, so flushed results belong to old nodes
+        release_frontier();
+        window_start_ = node_id - 1;
+        pending_bytes_ = 0;
+    }
+
+    const Node* node = Context::instance().get_node(node_id);
+    size_t bytes = 0;
+    for (const auto& input : node->inputs()) {
+        bytes = std::max(bytes, input.nbytes());
+    }
+    pending_bytes_ += bytes;
+
+    size_t pending = node_id - window_start_;
+    if ((lazy_window_.max_pending_nodes > 0 && pending >= lazy_window_.max_pending_nodes) ||
+        (lazy_window_.max_pending_bytes > 0 && pending_bytes_ >= lazy_window_.max_pending_bytes)) {
+        flush_window(node_id);
+    }
+}
+
+void TapeEvaluationManager::flush_window(NodeId last) {
+    auto& context = Context::instance();
+
+    // The roots cover every pending node; the ones evaluated already join the frontier as is.
+    // Values the window reads from before it are kept as well, for the rewrite below.
+    std::vector<NodeId> roots;
+    std::vector<Tensor> pending;
+    std::unordered_set<NodeId> kept;
+    for (NodeId node_id = window_start_ + 1; node_id <= last; ++node_id) {
+        const Node* node = context.get_node(node_id);
+        if (node == nullptr) {
+            continue;
+        }
+        for (const auto& input : node->inputs()) {
+            NodeId producer = input.producer_node();
+            if (input.is_lazy() && producer <= window_start_ && kept.insert(producer).second &&
+                evaluation_cache_.count(producer) == 0) {
+                pending.emplace_back(producer, 0, Shape{});
+            }
+        }
+        if (!node->output_nodes().empty()) {
+            continue;
+        }
+        roots.push_back(node_id);
+        kept.insert(node_id);
+        if (evaluation_cache_.count(node_id) == 0) {
+            pending.emplace_back(node_id, 0, Shape{});  // The tape only needs the producer
+        }
+    }
+
+    if (!pending.empty()) {
+        stats_.cache_misses += pending.size();
+        auto start = Clock::now();
+        auto tape = generator_.generate_tape(pending, frontier_);
+        auto generated = Clock::now();
+
+        execute_planned(*tape, std::move(kept));
+        record_timing(*tape, start, generated);
+        cache_tape_results(*tape);
+        window_stats_.largest_tape = std::max(window_stats_.largest_tape, tape->operations().size());
+    }
+
+    // The window reads what came before it as constants over the results, so recomputing one
+    // of its intermediates stops at the window, and the graph behind it can go
+    bool self_contained = true;
+    for (NodeId node_id = window_start_ + 1; node_id <= last; ++node_id) {
+        Node* node = context.get_node(node_id);
+        if (node == nullptr) {
+            continue;
+        }
+        for (size_t i = 0; i < node->inputs().size(); ++i) {
+            const Tensor& input = node->inputs()[i];
+            if (!input.is_lazy() || input.producer_node() > window_start_) {
+                continue;
+            }
+            auto result = executor_.get_result(input.producer_node(), input.output_index());
+            if (!result && input.output_index() == 0) {
+                result = cached_result(input.producer_node());
+            }
+            if (result) {
+                node->replace_input(i, constant_view(result));
+            } else {
+                self_contained = false;
+            }
+        }
+    }
+
+    // Earlier roots consumed by this window are superseded by the new ones. Roots whose node
+    // is released stay, as nothing tells whether they are read again.
+    for (auto it = frontier_.begin(); it != frontier_.end();) {
+        const Node* node = context.get_node(*it);
+        if (node != nullptr && !node->output_nodes().empty()) {
+            evaluation_cache_.erase(*it);
+            executor_.erase_result(*it);
+            it = frontier_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (NodeId node_id : roots) {
+        // Later tapes read frontier results from the executor
+        if (!executor_.get_result(node_id)) {
+            executor_.set_result(node_id, evaluation_cache_[node_id]);
+        }
+        frontier_.insert(node_id);
+    }
+
+    // The previous windows are released along with their results, but for the frontier
+    if (self_contained) {
+        context.release_nodes_before(window_start_ + 1);
+        for (auto it = evaluation_cache_.begin(); it != evaluation_cache_.end();) {
+            if (it->first <= window_start_ && frontier_.count(it->first) == 0) {
+                executor_.erase_result(it->first);
+                it = evaluation_cache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    window_stats_.flushes++;
+    window_stats_.flushed_nodes += last - window_start_;
+    window_start_ = last;
+    pending_bytes_ = 0;
+}
+
+void TapeEvaluationManager::reset_window() {
+    window_start_ = Context::instance().last_id();
+    pending_bytes_ = 0;
+}
+
+void TapeEvaluationManager::release_frontier() {
+    for (NodeId node_id : frontier_) {
+        evaluation_cache_.erase(node_id);
+        executor_.erase_result(node_id);
+    }
+    frontier_.clear();
+}
+
 std::shared_ptr<Tensor> TapeEvaluationManager::evaluate_impl(const Tensor& tensor) {
     if (!needs_evaluation(tensor)) {
         return std::make_shared<Tensor>(tensor);
     }
 
     // Generate tape for this tensor
-    auto tape = generator_.generate_tape(tensor);
+    auto start = Clock::now();
+    auto tape = generator_.generate_tape({tensor}, frontier_);
+    auto generated = Clock::now();
+
+    // Only the requested result needs to survive the tape; intermediates are released at their
+    // last use rather than cached, so reading one later recomputes it
+    execute_planned(*tape, {tensor.producer_node()});
+    record_timing(*tape, start, generated);
+    cache_tape_results(*tape);
+
+    // Get the final result
+    std::shared_ptr<Tensor> result = executor_.get_result(tensor.producer_node());
+
+    return result;
+}
+
+void TapeEvaluationManager::evaluate_into(const std::vector<Tensor>& tensors,
+                                          const std::vector<OutputBuffer>& outputs) {
+    validate_output_buffers(tensors, outputs);
+
+    // Lazy outputs not computed yet go through one tape. Contiguous destinations become the
+    // output allocation of their producing operation; everything else is copied afterwards.
+    std::vector<Tensor> pending;
+    std::unordered_map<NodeId, size_t> direct;  // producer node -> output index
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const Tensor& tensor = tensors[i];
+        if (!needs_evaluation(tensor) || evaluation_cache_.count(tensor.producer_node()) > 0) {
+            continue;
+        }
+        pending.push_back(tensor);
+        if (tensor.output_index() == 0 && is_contiguous_output(tensor, outputs[i]) &&
+            direct.count(tensor.producer_node()) == 0) {
+            direct[tensor.producer_node()] = i;
+        }
+    }
+
+    if (!pending.empty()) {
+        stats_.cache_misses += pending.size();
+        auto start = Clock::now();
+        auto tape = generator_.generate_tape(pending, frontier_);
+        auto generated = Clock::now();
+
+        // Writing into a buffer the graph still reads from would corrupt the inputs
+        for (const auto& op : tape->operations()) {
+            for (const auto& constant : op->constant_inputs) {
+                auto begin = reinterpret_cast<uintptr_t>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                    constant.raw_data());
+                auto end = begin + constant.nbytes();
+                for (size_t i = 0; i < outputs.size(); ++i) {
+                    auto out_begin = reinterpret_cast<uintptr_t>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                        outputs[i].data);
+                    auto out_end = out_begin + output_extent(tensors[i], outputs[i]) * sizeof(float);
+                    if (begin < out_end && out_begin < end) {
+                        throw std::runtime_error("eval_into: output " + std::to_string(i) +
+                                                 " overlaps an input of the graph");
+                    }
+                }
+            }
+        }
 
-    // Execute tape
-    executor_.execute_tape(*tape);
+        for (const auto& [node_id, index] : direct) {
+            if (tape->find_operation(node_id)) {
+                const Tensor& tensor = tensors[index];
+                std::vector<uint32_t> shape(tensor.shape(), tensor.shape() + tensor.rank());
+                executor_.bind_output(node_id, std::make_shared<Tensor>(outputs[index].data, shape));
+            }
+        }
+
+        // Only the requested results need to survive the tape
+        std::unordered_set<NodeId> kept;
+        for (const Tensor& tensor : pending) {
+            kept.insert(tensor.producer_node());
+        }
+        try {
+            execute_planned(*tape, std::move(kept));
+        } catch (...) {
+            executor_.clear_output_bindings();
+            throw;
+        }
+        record_timing(*tape, start, generated);
 
-    // Cache all results from the tape execution
-    for (const auto& op : tape->operations()) {
+        // Outputs whose producer was optimized away or not bound fall back to a copy
+        for (auto it = direct.begin(); it != direct.end();) {
+            auto binding = executor_.get_output_binding(it->first);
+            if (binding && executor_.get_result(it->first) == binding) {
+                stats_.operations_executed++;
+                ++it;
+            } else {
+                it = direct.erase(it);
+            }
+        }
+
+        // Bound results live in caller memory; only library-owned results are cached
+        executor_.clear_output_bindings();
+        cache_tape_results(*tape);
+    }
+
+    // Copy whatever was not written in place
+    for (size_t i = 0; i < tensors.size(); ++i) {
+        const Tensor& tensor = tensors[i];
+        auto it = direct.find(tensor.producer_node());
+        if (needs_evaluation(tensor) && it != direct.end() && it->second == i) {
+            continue;
+        }
+        auto result = evaluate(tensor);
+        if (!result) {
+            throw std::runtime_error("eval_into: failed to evaluate output " + std::to_string(i));
+        }
+        copy_to_output_buffer(*result, outputs[i]);
+    }
+}
+
+void TapeEvaluationManager::execute_planned(Tape& tape, std::unordered_set<NodeId> kept) {
+    // Under a memory budget the spill manager decides what stays resident instead
+    if (spill_manager_) {
+        executor_.execute_tape(tape);
+        return;
+    }
+    planner_.set_kept_nodes(std::move(kept));
+    executor_.add_observer(&planner_);
+    try {
+        executor_.execute_tape(tape);
+    } catch (...) {
+        executor_.remove_observer(&planner_);
+        throw;
+    }
+    executor_.remove_observer(&planner_);
+}
+
+void TapeEvaluationManager::cache_tape_results(const Tape& tape) {
+    for (const auto& op : tape.operations()) {
         auto op_result = executor_.get_result(op->node_id);
         if (op_result) {
             evaluation_cache_[op->node_id] = op_result;
@@ -65,23 +452,19 @@ std::shared_ptr<Tensor> TapeEvaluationManager::evaluate_impl(const Tensor& tenso
             stats_.memory_allocated += op_result->total_elements() * sizeof(float);
         }
     }
+}
 
-    // Get the final result
-    std::shared_ptr<Tensor> result = executor_.get_result(tensor.producer_node());
-
-    return result;
+void TapeEvaluationManager::record_timing(const Tape& tape, Clock::time_point start, Clock::time_point generated) {
+    auto end = Clock::now();
+    last_tape_timing_.operations = tape.operations().size();
+    last_tape_timing_.generate_ns =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(generated - start).count());
+    last_tape_timing_.execute_ns =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - generated).count());
 }
 
 bool TapeEvaluationManager::needs_evaluation(const Tensor& tensor) const {
     return tensor.is_lazy() && !tensor.is_evaluated();
 }
 
-// Implementation of the global evaluation manager function
-// This will be found by the linker when the tape library is linked
-
-EvaluationManager& get_evaluation_manager() {
-    static std::unique_ptr<EvaluationManager> instance = std::make_unique<TapeEvaluationManager>();
-    return *instance;
-}
-
 }  // namespace tt_lazy
@@ -1,10 +1,17 @@
 #pragma once
 
 #include "EvaluationManager.hpp"
+#include "GemmAutotuner.hpp"
+#include "MemoryPlanner.hpp"
+#include "Profiler.hpp"
+#include "SpillManager.hpp"
 #include "TapeExecutor.hpp"
 #include "TapeGenerator.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace tt_lazy {
 
@@ -24,17 +31,96 @@ class TapeEvaluationManager : public EvaluationManager {
     TapeEvaluationManager& operator=(TapeEvaluationManager&&) = delete;
 
     std::shared_ptr<Tensor> evaluate(const Tensor& tensor) override;
+    void evaluate_into(const std::vector<Tensor>& tensors, const std::vector<OutputBuffer>& outputs) override;
     void clear_cache() override;
     EvaluationManager::EvaluationStats get_stats() const override;
 
+    void set_profiling_enabled(bool enabled) override;
+    bool is_profiling_enabled() const override { return profiling_enabled_; }
+    std::vector<EvaluationManager::OpTiming> get_profile() const override;
+    void reset_profile() override;
+
+    void set_memory_budget(size_t bytes) override;
+    size_t memory_budget() const override;
+    EvaluationManager::SpillStats get_spill_stats() const override;
+
+    // Flushes the pending roots whenever the window fills up while this manager is active.
+    // Pending bytes are estimated per node by its largest input, as results are not sized
+    // before they run. The dispatch hook this installs refers to this manager, so select it
+    // through set_evaluation_manager(), which pairs them.
+    void set_lazy_window(const LazyWindow& window) override;
+    LazyWindow lazy_window() const override { return lazy_window_; }
+    void on_activate() override;
+    void on_deactivate() override;
+
+    // Flushes so far, reset by clear_cache(). Results of flushed roots are kept until a later
+    // flush covers their consumers. Each flush rewrites its nodes to read the values from
+    // before it as constants and releases the graph older than the previous flush, so the
+    // Context stays bounded: an intermediate of the latest flush is recomputed from those
+    // constants when read, and reading one released with the graph throws.
+    struct WindowStats {
+        size_t flushes = 0;
+        size_t flushed_nodes = 0;  // Pending nodes the flushes covered
+        size_t largest_tape = 0;   // Operations on the biggest flush tape
+    };
+    const WindowStats& window_stats() const { return window_stats_; }
+
+    // Intermediates of every tape (evaluate, evaluate_into and window flushes) are released at
+    // their last use unless a memory budget hands that job to the spill manager; only the
+    // requested results are cached. Reset by clear_cache().
+    const MemoryPlanner::Stats& memory_plan_stats() const { return planner_.stats(); }
+
+    // Cost of the most recent tape: generating (and optimizing) it, then executing it
+    struct TapeTiming {
+        size_t operations = 0;  // On the tape after optimization
+        uint64_t generate_ns = 0;
+        uint64_t execute_ns = 0;
+    };
+    const TapeTiming& last_tape_timing() const { return last_tape_timing_; }
+
+    // Bytes of the results held between evaluations, the frontier included
+    size_t cached_bytes() const;
+
+    // Whether the result of `node_id` is cached from an earlier tape, or adopted
+    bool is_cached(NodeId node_id) const { return evaluation_cache_.count(node_id) > 0; }
+    std::shared_ptr<Tensor> cached_result(NodeId node_id) const;
+
+    // Caches a result computed outside this manager (e.g. eagerly). Later tapes read it as a
+    // materialized node instead of running the graph behind it; clear_cache() drops it.
+    void adopt_result(NodeId node_id, std::shared_ptr<Tensor> result);
+
    private:
+    using Clock = std::chrono::steady_clock;
+
     std::shared_ptr<Tensor> evaluate_impl(const Tensor& tensor);
     bool needs_evaluation(const Tensor& tensor) const;
+    void record_timing(const Tape& tape, Clock::time_point start, Clock::time_point generated);
+    void execute_planned(Tape& tape, std::unordered_set<NodeId> kept);
+    void cache_tape_results(const Tape& tape);
+    void update_dispatch_hook();
+    void on_node_created(NodeId node_id);
+    void flush_window(NodeId last);
+    void reset_window();
+    void release_frontier();
 
     TapeGenerator generator_;
     TapeExecutor executor_;
+    MemoryPlanner planner_{executor_};
     std::unordered_map<NodeId, std::shared_ptr<Tensor>> evaluation_cache_;
     EvaluationManager::EvaluationStats stats_;
+    Profiler profiler_;
+    bool profiling_enabled_ = false;
+    TapeTiming last_tape_timing_;
+    std::unique_ptr<SpillManager> spill_manager_;  // Only while a memory budget is set
+    std::unique_ptr<GemmAutotuner> autotuner_;     // Only with TT_LAZY_AUTOTUNE set
+
+    LazyWindow lazy_window_;
+    bool active_ = false;
+    bool hook_installed_ = false;
+    NodeId window_start_ = 0;  // Nodes with larger ids are pending
+    size_t pending_bytes_ = 0;
+    std::unordered_set<NodeId> frontier_;  // Flushed roots and adopted results; tapes start from them
+    WindowStats window_stats_;
 };
 
 }  // namespace tt_lazy
@@ -4,11 +4,48 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <string>
+
+namespace {
+
+bool accepts(const Kernel& kernel, const TapeOperation& op) {
+    return !kernel.supports || kernel.supports(op);
+}
+
+// Cheapest kernel of `candidates` that accepts `op`; the first one wins ties
+std::shared_ptr<const Kernel> choose_kernel(const std::vector<std::shared_ptr<const Kernel>>& candidates,
+                                            const TapeOperation& op) {
+    std::shared_ptr<const Kernel> best;
+    double best_cost = 0.0;
+    for (const auto& kernel : candidates) {
+        if (!accepts(*kernel, op)) {
+            continue;
+        }
+        double cost = kernel->cost ? kernel->cost(op) : 0.0;
+        if (!best || cost < best_cost) {
+            best = kernel;
+            best_cost = cost;
+        }
+    }
+    return best;
+}
+
+}  // namespace
 
 void TapeExecutor::execute_tape(Tape& tape) {
+    select_kernels(tape);
+
+    for (auto* observer : observers_) {
+        observer->on_tape_begin(tape);
+    }
+
     for (const auto& op : tape.operations()) {
         execute_operation(*op);
     }
+
+    for (auto* observer : observers_) {
+        observer->on_tape_end(tape);
+    }
 }
 
 void TapeExecutor::execute_operation(TapeOperation& op) {
@@ -17,14 +54,22 @@ void TapeExecutor::execute_operation(TapeOperation& op) {
         return;
     }
 
-    // Check if operation type is registered
-    if (op.op_type >= operation_handlers_.size() || !operation_handlers_[op.op_type]) {
-        throw std::runtime_error("Unknown operation type: " + std::to_string(op.op_type));
+    // Operations run outside execute_tape choose their kernel here
+    if (!is_current(op)) {
+        op.kernel = select_kernel(op);
+    }
+
+    for (auto* observer : observers_) {
+        observer->on_operation_begin(op);
     }
 
-    // Execute the registered handler
-    operation_handlers_[op.op_type](op, *this);
+    // Execute the selected kernel
+    op.kernel->impl(op, *this);
     op.is_evaluated = true;
+
+    for (auto* observer : observers_) {
+        observer->on_operation_end(op);
+    }
 }
 
 std::shared_ptr<Tensor> TapeExecutor::get_result(NodeId node_id) const {
@@ -36,24 +81,141 @@ void TapeExecutor::set_result(NodeId node_id, std::shared_ptr<Tensor> result) {
     results_[node_id] = std::move(result);
 }
 
+void TapeExecutor::erase_result(NodeId node_id) {
+    results_.erase(node_id);
+}
+
+std::shared_ptr<Tensor> TapeExecutor::get_result(NodeId node_id, uint16_t output_index) const {
+    if (output_index == 0) {
+        return get_result(node_id);
+    }
+    auto it = extra_outputs_.find(output_key(node_id, output_index));
+    return it != extra_outputs_.end() ? it->second : nullptr;
+}
+
+void TapeExecutor::set_result(NodeId node_id, uint16_t output_index, std::shared_ptr<Tensor> result) {
+    if (output_index == 0) {
+        set_result(node_id, std::move(result));
+    } else {
+        extra_outputs_[output_key(node_id, output_index)] = std::move(result);
+    }
+}
+
+uint64_t TapeExecutor::output_key(NodeId node_id, uint16_t output_index) {
+    return (uint64_t{node_id} << 16U) | output_index;
+}
+
+void TapeExecutor::bind_output(NodeId node_id, std::shared_ptr<Tensor> destination) {
+    output_bindings_[node_id] = std::move(destination);
+}
+
+std::shared_ptr<Tensor> TapeExecutor::get_output_binding(NodeId node_id) const {
+    auto it = output_bindings_.find(node_id);
+    return it != output_bindings_.end() ? it->second : nullptr;
+}
+
+void TapeExecutor::unbind_output(NodeId node_id) {
+    output_bindings_.erase(node_id);
+}
+
+void TapeExecutor::clear_output_bindings() {
+    // Bound results alias caller memory and must not outlive the call that bound them
+    for (const auto& [node_id, destination] : output_bindings_) {
+        auto it = results_.find(node_id);
+        if (it != results_.end() && it->second == destination) {
+            results_.erase(it);
+        }
+    }
+    output_bindings_.clear();
+}
+
 void TapeExecutor::register_operation(OpTypeId op_type, OperationHandler handler) {
     // Resize vector if needed to accommodate the operation type
-    if (op_type >= operation_handlers_.size()) {
-        operation_handlers_.resize(op_type + 1);
+    if (op_type >= kernels_.size()) {
+        kernels_.resize(op_type + 1);
+    }
+    kernels_[op_type].clear();
+    if (handler) {
+        kernels_[op_type].push_back(std::make_shared<const Kernel>(Kernel{"default", {}, {}, std::move(handler)}));
+    }
+}
+
+void TapeExecutor::register_kernel(OpTypeId op_type, Kernel kernel) {
+    if (!kernel.impl) {
+        throw std::runtime_error("Kernel " + kernel.name + " has no implementation");
+    }
+    if (op_type >= kernels_.size()) {
+        kernels_.resize(op_type + 1);
+    }
+    auto& registered = kernels_[op_type];
+    auto replacement = std::make_shared<const Kernel>(std::move(kernel));
+    auto it = std::find_if(registered.begin(), registered.end(),
+                           [&](const auto& existing) { return existing->name == replacement->name; });
+    if (it != registered.end()) {
+        *it = std::move(replacement);
+    } else {
+        registered.push_back(std::move(replacement));
     }
-    operation_handlers_[op_type] = std::move(handler);
 }
 
 bool TapeExecutor::is_registered(OpTypeId op_type) const {
-    return op_type < operation_handlers_.size() && operation_handlers_[op_type] != nullptr;
+    return op_type < kernels_.size() && !kernels_[op_type].empty();
+}
+
+OperationHandler TapeExecutor::get_operation_handler(OpTypeId op_type) const {
+    if (!is_registered(op_type)) {
+        return OperationHandler{};
+    }
+    // A snapshot, so the result keeps dispatching to these kernels once it replaces them
+    return [candidates = kernels_[op_type]](TapeOperation& op, TapeExecutor& executor) {
+        bool selected = op.kernel && std::find(candidates.begin(), candidates.end(), op.kernel) != candidates.end();
+        auto kernel = selected ? op.kernel : choose_kernel(candidates, op);
+        if (!kernel) {
+            throw std::runtime_error("No kernel accepts operation type " + std::to_string(op.op_type));
+        }
+        kernel->impl(op, executor);
+    };
 }
 
 size_t TapeExecutor::get_num_registered_operations() const {
-    return operation_handlers_.size();
+    return kernels_.size();
+}
+
+const std::vector<std::shared_ptr<const Kernel>>& TapeExecutor::kernels(OpTypeId op_type) const {
+    static const std::vector<std::shared_ptr<const Kernel>> none;
+    return op_type < kernels_.size() ? kernels_[op_type] : none;
+}
+
+std::shared_ptr<const Kernel> TapeExecutor::select_kernel(const TapeOperation& op) const {
+    if (!is_registered(op.op_type)) {
+        throw std::runtime_error("Unknown operation type: " + std::to_string(op.op_type));
+    }
+    auto kernel = choose_kernel(kernels_[op.op_type], op);
+    if (!kernel) {
+        throw std::runtime_error("No kernel accepts operation type " + std::to_string(op.op_type));
+    }
+    return kernel;
+}
+
+void TapeExecutor::select_kernels(Tape& tape) const {
+    for (const auto& op : tape.operations()) {
+        if (!op->is_evaluated && !is_current(*op)) {
+            op->kernel = select_kernel(*op);
+        }
+    }
+}
+
+bool TapeExecutor::is_current(const TapeOperation& op) const {
+    if (!op.kernel || op.op_type >= kernels_.size()) {
+        return false;
+    }
+    const auto& registered = kernels_[op.op_type];
+    return std::find(registered.begin(), registered.end(), op.kernel) != registered.end();
 }
 
 void TapeExecutor::clear_results() {
     results_.clear();
+    extra_outputs_.clear();
 }
 
 size_t TapeExecutor::memory_usage() const {
@@ -63,5 +225,20 @@ size_t TapeExecutor::memory_usage() const {
             total += tensor->total_elements() * sizeof(float);  // Simplified
         }
     }
+    for (const auto& [key, tensor] : extra_outputs_) {
+        if (tensor) {
+            total += tensor->total_elements() * sizeof(float);
+        }
+    }
     return total;
 }
+
+void TapeExecutor::add_observer(ExecutionObserver* observer) {
+    if (observer && std::find(observers_.begin(), observers_.end(), observer) == observers_.end()) {
+        observers_.push_back(observer);
+    }
+}
+
+void TapeExecutor::remove_observer(ExecutionObserver* observer) {
+    observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+}
@@ -1,9 +1,11 @@
 #pragma once
+#include "ExecutionObserver.hpp"
 #include "Tape.hpp"
 #include "TapeOperation.hpp"
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -13,6 +15,16 @@ class Tape;
 // Function signature for operation execution
 using OperationHandler = std::function<void(TapeOperation&, TapeExecutor&)>;
 
+// One implementation of an operation type. Several may be registered per type; for each
+// tape operation the executor picks, among the kernels whose predicate accepts it, the one
+// with the lowest estimated cost (the first registered on ties).
+struct Kernel {
+    std::string name;                                    // Shown by Tape::print_tape
+    std::function<bool(const TapeOperation&)> supports;  // Shapes / flags it handles (empty: all)
+    std::function<double(const TapeOperation&)> cost;    // Relative estimate (empty: 0)
+    OperationHandler impl;
+};
+
 // Tape executor - executes tape using registered operation handlers
 class TapeExecutor {
    public:
@@ -24,22 +36,58 @@ class TapeExecutor {
     // Execute single operation
     void execute_operation(TapeOperation& op);
 
-    // Operation registry methods
+    // Operation registry methods. register_operation makes `handler` the only kernel of the
+    // type (named "default"); register_kernel adds one, replacing a kernel of the same name.
     void register_operation(OpTypeId op_type, OperationHandler handler);
+    void register_kernel(OpTypeId op_type, Kernel kernel);
     bool is_registered(OpTypeId op_type) const;
+    // Runs the kernels currently registered (empty if none), choosing per operation as the
+    // executor does, e.g. to wrap them with a replacement
+    OperationHandler get_operation_handler(OpTypeId op_type) const;
     size_t get_num_registered_operations() const;
+    const std::vector<std::shared_ptr<const Kernel>>& kernels(OpTypeId op_type) const;
+
+    // Kernel selection, done once when a tape is lowered to this executor: records the chosen
+    // kernel in each operation that has none (or one no longer registered). execute_tape
+    // calls it; call it earlier to inspect the choices. Throws if no kernel accepts an operation.
+    void select_kernels(Tape& tape) const;
+    std::shared_ptr<const Kernel> select_kernel(const TapeOperation& op) const;
 
     // Result management
     std::shared_ptr<Tensor> get_result(NodeId node_id) const;
     void set_result(NodeId node_id, std::shared_ptr<Tensor> result);
+    void erase_result(NodeId node_id);
+
+    // Further outputs of multi-output operations (output_index > 0). Consumers read them
+    // through an extraction node, so every graph node still has a single result above.
+    std::shared_ptr<Tensor> get_result(NodeId node_id, uint16_t output_index) const;
+    void set_result(NodeId node_id, uint16_t output_index, std::shared_ptr<Tensor> result);
+
+    // Output bindings: a bound node's handler writes its result into the given
+    // tensor (typically a view of caller-owned memory) instead of allocating one
+    void bind_output(NodeId node_id, std::shared_ptr<Tensor> destination);
+    std::shared_ptr<Tensor> get_output_binding(NodeId node_id) const;
+    void unbind_output(NodeId node_id);  // Drops the binding only; the result stays
+    void clear_output_bindings();
 
     // Memory management
     void clear_results();
     size_t memory_usage() const;
 
+    // Execution observers (not owned)
+    void add_observer(ExecutionObserver* observer);
+    void remove_observer(ExecutionObserver* observer);
+
    private:
+    static uint64_t output_key(NodeId node_id, uint16_t output_index);
+
     std::unordered_map<NodeId, std::shared_ptr<Tensor>> results_;
-    std::vector<OperationHandler> operation_handlers_;
+    std::unordered_map<uint64_t, std::shared_ptr<Tensor>> extra_outputs_;
+    std::unordered_map<NodeId, std::shared_ptr<Tensor>> output_bindings_;
+    bool is_current(const TapeOperation& op) const;
+
+    std::vector<std::vector<std::shared_ptr<const Kernel>>> kernels_;  // By operation type
+    std::vector<ExecutionObserver*> observers_;
 };
 
 // Global function to register all standard operations with a TapeExecutor
@@ -9,6 +9,8 @@
 
 #include <algorithm>
 #include <queue>
+#include <stdexcept>
+#include <string>
 #include <unordered_set>
 
 #include <spdlog/spdlog.h>
@@ -18,10 +20,16 @@ std::vector<std::unique_ptr<TapeOptimizationPass>> TapeGenerator::optimization_p
 bool TapeGenerator::default_passes_registered_ = false;
 
 std::unique_ptr<Tape> TapeGenerator::generate_tape(const std::vector<Tensor>& outputs) {
+    static const std::unordered_set<NodeId> none;
+    return generate_tape(outputs, none);
+}
+
+std::unique_ptr<Tape> TapeGenerator::generate_tape(const std::vector<Tensor>& outputs,
+                                                   const std::unordered_set<NodeId>& materialized) {
     auto tape = std::make_unique<Tape>();
 
     // Collect all dependencies
-    std::vector<NodeId> dependencies = collect_dependencies(outputs);
+    std::vector<NodeId> dependencies = collect_dependencies(outputs, materialized);
 
     // Topologically sort dependencies
     std::vector<NodeId> sorted_nodes = topological_sort(dependencies);
@@ -77,16 +85,21 @@ std::unique_ptr<Tape> TapeGenerator::generate_tape(const Tensor& output) {
     return generate_tape(std::vector<Tensor>{output});
 }
 
-std::vector<NodeId> TapeGenerator::collect_dependencies(const std::vector<Tensor>& outputs) {
+std::vector<NodeId> TapeGenerator::collect_dependencies(const std::vector<Tensor>& outputs,
+                                                        const std::unordered_set<NodeId>& materialized) {
     std::unordered_set<NodeId> visited;
     std::vector<NodeId> dependencies;
 
     std::function<void(NodeId)> collect = [&](NodeId node_id) {
-        if (visited.count(node_id))
+        if (visited.count(node_id) || materialized.count(node_id))
             return;
         visited.insert(node_id);
 
         const Node* node = Context::instance().get_node(node_id);
+        if (!node && Context::instance().is_released(node_id)) {
+            throw std::runtime_error("Node " + std::to_string(node_id) +
+                                     " was released from the graph and its result is no longer held");
+        }
         if (node) {
             // Add dependencies first
             for (const auto& input : node->inputs()) {
@@ -111,13 +124,14 @@ std::vector<NodeId> TapeGenerator::topological_sort(const std::vector<NodeId>& n
     std::unordered_map<NodeId, std::vector<NodeId>> graph;
     std::unordered_map<NodeId, int> in_degree;
 
-    // Build graph and calculate in-degrees
+    // Build graph and calculate in-degrees; inputs outside the set are available already
+    std::unordered_set<NodeId> node_set(nodes.begin(), nodes.end());
     for (NodeId node_id : nodes) {
         const Node* node = Context::instance().get_node(node_id);
         if (node) {
             in_degree[node_id] = 0;
             for (const auto& input : node->inputs()) {
-                if (input.is_lazy()) {
+                if (input.is_lazy() && node_set.count(input.producer_node())) {
                     NodeId input_id = input.producer_node();
                     graph[input_id].push_back(node_id);
                     in_degree[node_id]++;
@@ -3,6 +3,7 @@
 #include "Tensor.hpp"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 // Forward declarations
@@ -20,10 +21,18 @@ class TapeGenerator {
     // Generate tape from single tensor
     std::unique_ptr<Tape> generate_tape(const Tensor& output);
 
+    // Generate a tape that reads the results of the `materialized` nodes, which the executor
+    // must already hold, instead of walking the graph behind them
+    std::unique_ptr<Tape> generate_tape(const std::vector<Tensor>& outputs,
+                                        const std::unordered_set<NodeId>& materialized);
+
     // Control optimization
     void set_optimization_enabled(bool enabled) { optimization_enabled_ = enabled; }
     bool is_optimization_enabled() const { return optimization_enabled_; }
 
+    // Tape operation for a single graph node, as the tape would hold it before optimization
+    static std::unique_ptr<TapeOperation> create_tape_operation(const Node& node);
+
     // Optimization pass registry
     static void register_optimization_pass(std::unique_ptr<TapeOptimizationPass> pass);
     static void register_default_passes();
@@ -31,9 +40,9 @@ class TapeGenerator {
 
    private:
     // Helper methods
-    std::vector<NodeId> collect_dependencies(const std::vector<Tensor>& outputs);
+    std::vector<NodeId> collect_dependencies(const std::vector<Tensor>& outputs,
+                                             const std::unordered_set<NodeId>& materialized);
     std::vector<NodeId> topological_sort(const std::vector<NodeId>& nodes);
-    std::unique_ptr<TapeOperation> create_tape_operation(const Node& node);
 
     // Optimization control
     bool optimization_enabled_ = false;
@@ -2,9 +2,29 @@
 #include "Tensor.hpp"
 #include "common.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
+// Tensor-parallel placement of an operation: the output's last dimension is split into
+// `num_shards` contiguous column blocks, each computed by a separate worker from its own
+// slice of the weights. A single shard means the operation runs unsharded.
+struct ShardSpec {
+    uint32_t num_shards = 1;
+
+    bool is_sharded() const { return num_shards > 1; }
+
+    // Half-open column range [begin, end) owned by `shard` when `extent` columns are split
+    static std::pair<uint32_t, uint32_t> range(uint32_t extent, uint32_t num_shards, uint32_t shard) {
+        auto begin = static_cast<uint32_t>(static_cast<uint64_t>(extent) * shard / num_shards);
+        auto end = static_cast<uint32_t>(static_cast<uint64_t>(extent) * (shard + 1) / num_shards);
+        return {begin, end};
+    }
+};
+
+struct Kernel;  // TapeExecutor.hpp
+
 // Represents a single operation in the execution tape
 struct TapeOperation {
     NodeId node_id;
@@ -14,6 +34,12 @@ struct TapeOperation {
     std::vector<NodeId> output_nodes;     // Produced tensors
     std::vector<std::vector<uint32_t>> output_shapes;
 
+    // Placement set by ShardingPass (unsharded by default)
+    ShardSpec shard;
+
+    // Implementation chosen by TapeExecutor::select_kernels (null until then)
+    std::shared_ptr<const Kernel> kernel;
+
     // Execution metadata
     bool is_constant = false;
     bool is_evaluated = false;
@@ -0,0 +1,56 @@
+#include "ShardingPass.hpp"
+
+#include "Context.hpp"
+#include "Tape.hpp"
+#include "operations.hpp"
+
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+ShardingPass::ShardingPass(uint32_t num_shards, uint32_t min_columns)
+    : num_shards_(num_shards), min_columns_(min_columns) {
+    if (num_shards_ == 0) {
+        throw std::runtime_error("ShardingPass: number of shards must be positive");
+    }
+}
+
+uint32_t ShardingPass::shardable_columns(const TapeOperation& op) {
+    const Node* node = Context::instance().get_node(op.node_id);
+    if (!node) {
+        return 0;
+    }
+    const auto& inputs = node->inputs();
+
+    if (const auto* args = node->try_as<MatMulArgs>()) {
+        if (inputs.size() != 2 || !inputs[1].is_constant() || inputs[0].rank() != 2 || inputs[1].rank() != 2) {
+            return 0;
+        }
+        return args->transpose_b ? inputs[1].size(0) : inputs[1].size(1);
+    }
+    if (node->is<FusedMLPArgs>()) {
+        if (inputs.size() != 3 || !inputs[1].is_constant() || !inputs[2].is_constant() || inputs[0].rank() != 2 ||
+            inputs[1].rank() != 2) {
+            return 0;
+        }
+        return inputs[1].size(1);
+    }
+    return 0;
+}
+
+int ShardingPass::apply(Tape& tape, [[maybe_unused]] const std::vector<Tensor>& outputs) {
+    if (num_shards_ < 2) {
+        return 0;
+    }
+
+    int sharded = 0;
+    for (auto& op : get_operations(tape)) {
+        uint32_t columns = shardable_columns(*op);
+        if (columns >= min_columns_ && columns >= num_shards_) {
+            op->shard.num_shards = num_shards_;
+            sharded++;
+            spdlog::info("    🔀 Sharding node {} ({} columns) across {} workers", op->node_id, columns, num_shards_);
+        }
+    }
+    return sharded;
+}
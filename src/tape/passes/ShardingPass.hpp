@@ -0,0 +1,29 @@
+#pragma once
+#include "TapeOptimizationPass.hpp"
+
+#include <cstdint>
+
+// Sharding pass - annotates weight-bound MatMul and FusedMLP operations with a column-wise
+// ShardSpec so a tensor-parallel runtime can split them across workers. Operations with
+// fewer than `min_columns` output columns stay unsharded.
+//
+// Not registered by default; add it to the TapeGenerator or apply it to a generated tape.
+class ShardingPass : public TapeOptimizationPass {
+   public:
+    static constexpr uint32_t DEFAULT_MIN_COLUMNS = 64;
+
+    explicit ShardingPass(uint32_t num_shards, uint32_t min_columns = DEFAULT_MIN_COLUMNS);
+
+    int apply(Tape& tape, const std::vector<Tensor>& outputs) override;
+    std::string name() const override { return "Sharding"; }
+    static constexpr int SHARDING_PRIORITY = 90;  // After fusion so fused ops are sharded whole
+    int priority() const override { return SHARDING_PRIORITY; }
+
+    // Output columns the operation would be split along, or 0 when it cannot be sharded
+    // (it must be a rank-2 MatMul/FusedMLP whose weights, and bias, are constants)
+    static uint32_t shardable_columns(const TapeOperation& op);
+
+   private:
+    uint32_t num_shards_;
+    uint32_t min_columns_;
+};
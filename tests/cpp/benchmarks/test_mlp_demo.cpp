@@ -13,6 +13,11 @@
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
+// Constant tensors take ownership of their heap buffers
+static void delete_floats(void* data) {
+    delete[] static_cast<float*>(data);
+}
+
 class SimpleMLP {
    public:
     Tensor W1, b1;  // Layer 1: input_size -> hidden_size
@@ -40,10 +45,10 @@ class SimpleMLP {
             b2_data[i] = 0.01f * (1.0f + 0.1f * (i % 10));
 
         // Initialize weights as constant tensors (like the working tests)
-        W1 = Tensor(w1_data, {static_cast<uint32_t>(input_size), static_cast<uint32_t>(hidden_size)});
-        b1 = Tensor(b1_data, {1u, static_cast<uint32_t>(hidden_size)});
-        W2 = Tensor(w2_data, {static_cast<uint32_t>(hidden_size), static_cast<uint32_t>(output_size)});
-        b2 = Tensor(b2_data, {1u, static_cast<uint32_t>(output_size)});
+        W1 = Tensor(w1_data, {static_cast<uint32_t>(input_size), static_cast<uint32_t>(hidden_size)}, delete_floats);
+        b1 = Tensor(b1_data, {1u, static_cast<uint32_t>(hidden_size)}, delete_floats);
+        W2 = Tensor(w2_data, {static_cast<uint32_t>(hidden_size), static_cast<uint32_t>(output_size)}, delete_floats);
+        b2 = Tensor(b2_data, {1u, static_cast<uint32_t>(output_size)}, delete_floats);
     }
 
     // Forward pass - builds computation graph lazily
@@ -75,7 +80,7 @@ Tensor create_test_input() {
     data[6] = 0.3f;
     data[7] = -0.1f;
 
-    return Tensor(data, {2, 4});
+    return Tensor(data, {2, 4}, delete_floats);
 }
 
 class MLPDemoTest : public ::testing::Test {
@@ -207,7 +212,7 @@ TEST_F(MLPDemoTest, GraphStructureValidation) {
     float* input_data = new float[3];
     for (int i = 0; i < 3; ++i)
         input_data[i] = 1.0f;
-    Tensor input(input_data, {1, 3});
+    Tensor input(input_data, {1, 3}, delete_floats);
 
     Tensor output = model.forward(input);
 
@@ -269,8 +274,8 @@ TEST_F(MLPDemoTest, ElementwiseOperations) {
         b_data[i] = 3.0f;
     }
 
-    Tensor a(a_data, {2, 2});
-    Tensor b(b_data, {2, 2});
+    Tensor a(a_data, {2, 2}, delete_floats);
+    Tensor b(b_data, {2, 2}, delete_floats);
 
     Tensor c = add(a, b);
     EXPECT_TRUE(c.is_lazy());
@@ -305,7 +310,7 @@ TEST_F(MLPDemoTest, OptimizationPassRegistry) {
     float* input_data = new float[3];
     for (int i = 0; i < 3; ++i)
         input_data[i] = 1.0f;
-    Tensor input(input_data, {1, 3});
+    Tensor input(input_data, {1, 3}, delete_floats);
 
     // Build the computation graph
     spdlog::info("📊 Building computation graph...");
@@ -346,9 +351,9 @@ TEST_F(MLPDemoTest, FusedMLPOperation) {
     for (int i = 0; i < 4; ++i)
         bias_data[i] = 0.01f * (i + 1.0f);
 
-    Tensor input(input_data, {2, 3});
-    Tensor weights(weight_data, {3, 4});
-    Tensor bias(bias_data, {1, 4});
+    Tensor input(input_data, {2, 3}, delete_floats);
+    Tensor weights(weight_data, {3, 4}, delete_floats);
+    Tensor bias(bias_data, {1, 4}, delete_floats);
 
     spdlog::info("⚡ Testing fused MLP operation...");
 
@@ -408,9 +413,9 @@ TEST_F(MLPDemoTest, NodeCountReduction) {
     for (int i = 0; i < 2; ++i)
         bias_data[i] = 0.01f * (i + 1.0f);
 
-    Tensor input(input_data, {1, 4});
-    Tensor weights(weight_data, {4, 2});
-    Tensor bias(bias_data, {1, 2});
+    Tensor input(input_data, {1, 4}, delete_floats);
+    Tensor weights(weight_data, {4, 2}, delete_floats);
+    Tensor bias(bias_data, {1, 2}, delete_floats);
 
     // Unfused: MatMul -> Add -> ReLU (3 separate operations)
     auto matmul_result = matmul(input, weights);
@@ -442,9 +447,9 @@ TEST_F(MLPDemoTest, NodeCountReduction) {
     for (int i = 0; i < 2; ++i)
         bias_data2[i] = 0.01f * (i + 1.0f);
 
-    Tensor input2(input_data2, {1, 4});
-    Tensor weights2(weight_data2, {4, 2});
-    Tensor bias2(bias_data2, {1, 2});
+    Tensor input2(input_data2, {1, 4}, delete_floats);
+    Tensor weights2(weight_data2, {4, 2}, delete_floats);
+    Tensor bias2(bias_data2, {1, 2}, delete_floats);
 
     // Fused: Single fused_mlp operation
     Tensor fused_result = fused_mlp(input2, weights2, bias2, true);
@@ -483,7 +488,7 @@ TEST_F(MLPDemoTest, TapeSystemIntegratedOptimization) {
     float* input_data = new float[3];
     for (int i = 0; i < 3; ++i)
         input_data[i] = 1.0f;
-    Tensor input(input_data, {1, 3});
+    Tensor input(input_data, {1, 3}, delete_floats);
 
     // Build computation graph
     Tensor output = model.forward(input);
@@ -512,7 +517,7 @@ TEST_F(MLPDemoTest, TapeSystemIntegratedOptimization) {
     float* input_data2 = new float[3];
     for (int i = 0; i < 3; ++i)
         input_data2[i] = 1.0f;
-    Tensor input2(input_data2, {1, 3});
+    Tensor input2(input_data2, {1, 3}, delete_floats);
 
     Tensor output2 = model2.forward(input2);
 
@@ -553,9 +558,9 @@ TEST_F(MLPDemoTest, RealTapeFusion) {
     for (int i = 0; i < 2; ++i)
         bias_data[i] = 0.01f * (i + 1.0f);
 
-    Tensor input(input_data, {1, 4});
-    Tensor weights(weight_data, {4, 2});
-    Tensor bias(bias_data, {1, 2});
+    Tensor input(input_data, {1, 4}, delete_floats);
+    Tensor weights(weight_data, {4, 2}, delete_floats);
+    Tensor bias(bias_data, {1, 2}, delete_floats);
 
     // Build: MatMul -> Add (should be fusible)
     auto matmul_result = matmul(input, weights);
@@ -0,0 +1,294 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "MemoryPlanner.hpp"
+#include "TapeEvaluationManager.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "autodiff.hpp"
+#include "operations.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class AutodiffTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static std::vector<float> values(size_t count, size_t seed) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<float>((i * 7919 + seed * 104729) % 19) * 0.1f - 0.9f;
+        }
+        return data;
+    }
+
+    // Evaluates all gradients through one tape, straight into host vectors
+    static std::vector<std::vector<float>> evaluate(const std::vector<Tensor>& grads) {
+        std::vector<std::vector<float>> results;
+        std::vector<tt_lazy::EvaluationManager::OutputBuffer> buffers;
+        results.reserve(grads.size());
+        for (const Tensor& g : grads) {
+            results.emplace_back(g.total_elements());
+            buffers.push_back({results.back().data(), results.back().size(), {}});
+        }
+        tt_lazy::eval_into(grads, buffers);
+        return results;
+    }
+
+    static void expect_near(const std::vector<float>& actual, const std::vector<double>& expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_NEAR(actual[i], expected[i], 1e-3 * (1.0 + std::fabs(expected[i]))) << "element " << i;
+        }
+    }
+};
+
+TEST_F(AutodiffTest, MlpGradientsMatchManualBackprop) {
+    constexpr uint32_t N = 5, I = 7, H = 9, O = 4;
+    auto x = values(N * I, 1);
+    auto w1 = values(I * H, 2);
+    auto b1 = values(H, 3);
+    auto w2 = values(H * O, 4);
+    auto b2 = values(O, 5);
+
+    // Reference: h = relu(x w1 + b1), out = h w2 + b2, loss = sum(out * out)
+    std::vector<double> h(N * H), out(N * O);
+    for (size_t n = 0; n < N; ++n) {
+        for (size_t j = 0; j < H; ++j) {
+            double sum = b1[j];
+            for (size_t i = 0; i < I; ++i) {
+                sum += static_cast<double>(x[n * I + i]) * w1[i * H + j];
+            }
+            h[n * H + j] = std::max(0.0, sum);
+        }
+        for (size_t k = 0; k < O; ++k) {
+            double sum = b2[k];
+            for (size_t j = 0; j < H; ++j) {
+                sum += h[n * H + j] * w2[j * O + k];
+            }
+            out[n * O + k] = sum;
+        }
+    }
+    std::vector<double> dx(N * I), dw1(I * H), db1(H), dw2(H * O), db2(O);
+    for (size_t n = 0; n < N; ++n) {
+        std::vector<double> dh(H, 0.0);
+        for (size_t k = 0; k < O; ++k) {
+            double g = 2.0 * out[n * O + k];
+            db2[k] += g;
+            for (size_t j = 0; j < H; ++j) {
+                dw2[j * O + k] += h[n * H + j] * g;
+                dh[j] += g * w2[j * O + k];
+            }
+        }
+        for (size_t j = 0; j < H; ++j) {
+            double g = h[n * H + j] > 0.0 ? dh[j] : 0.0;
+            db1[j] += g;
+            for (size_t i = 0; i < I; ++i) {
+                dw1[i * H + j] += x[n * I + i] * g;
+                dx[n * I + i] += g * w1[i * H + j];
+            }
+        }
+    }
+
+    for (bool fused : {false, true}) {
+        SCOPED_TRACE(fused ? "fused first layer" : "matmul + add + relu");
+        Tensor x_t(x.data(), {N, I});
+        Tensor w1_t(w1.data(), {I, H});
+        Tensor b1_t(b1.data(), {1, H});
+        Tensor w2_t(w2.data(), {H, O});
+        Tensor b2_t(b2.data(), {1, O});
+        Tensor hidden = fused ? fused_mlp(x_t, w1_t, b1_t, true) : relu(add(matmul(x_t, w1_t), b1_t));
+        Tensor output = fused_mlp(hidden, w2_t, b2_t, false);
+        Tensor loss = reduce_sum(multiply(output, output));
+
+        auto grads = evaluate(grad(loss, {x_t, w1_t, b1_t, w2_t, b2_t}));
+        expect_near(grads[0], dx);
+        expect_near(grads[1], dw1);
+        expect_near(grads[2], db1);
+        expect_near(grads[3], dw2);
+        expect_near(grads[4], db2);
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+}
+
+TEST_F(AutodiffTest, AccumulatesSharedTensorsThroughTransposesAndReductions) {
+    constexpr uint32_t K = 6, M = 4, N = 3;
+    auto w = values(K * M, 6);
+    auto x = values(K * N, 7);
+    auto unused = values(3, 8);
+
+    // y = w^T x, loss = sum over rows of sum over columns of (y * y + y)
+    Tensor w_t(w.data(), {K, M});
+    Tensor x_t(x.data(), {K, N});
+    Tensor unused_t(unused.data(), {3});
+    Tensor y = matmul(w_t, x_t, true, false);
+    Tensor loss = reduce_sum(reduce_sum(add(multiply(y, y), y), {1}), {});
+    auto grads = evaluate(grad(loss, {w_t, x_t, y, unused_t}));
+
+    std::vector<double> y_ref(M * N), dy(M * N);
+    for (size_t m = 0; m < M; ++m) {
+        for (size_t n = 0; n < N; ++n) {
+            double sum = 0.0;
+            for (size_t k = 0; k < K; ++k) {
+                sum += static_cast<double>(w[k * M + m]) * x[k * N + n];
+            }
+            y_ref[m * N + n] = sum;
+            dy[m * N + n] = 2.0 * sum + 1.0;
+        }
+    }
+    std::vector<double> dw(K * M, 0.0), dx(K * N, 0.0);
+    for (size_t k = 0; k < K; ++k) {
+        for (size_t m = 0; m < M; ++m) {
+            for (size_t n = 0; n < N; ++n) {
+                dw[k * M + m] += x[k * N + n] * dy[m * N + n];
+                dx[k * N + n] += w[k * M + m] * dy[m * N + n];
+            }
+        }
+    }
+    expect_near(grads[0], dw);
+    expect_near(grads[1], dx);
+    expect_near(grads[2], dy);
+    expect_near(grads[3], {0.0, 0.0, 0.0});
+}
+
+TEST_F(AutodiffTest, BroadcastMultiplyReducesToOperandShapes) {
+    std::vector<float> x{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<float> w{0.5f, -1.0f, 2.0f};
+    Tensor x_t(x.data(), {2, 3});
+    Tensor w_t(w.data(), {1, 3});
+
+    // loss = sum(x * w), with w broadcast over the rows of x
+    std::vector<Tensor> grads = grad(reduce_sum(multiply(x_t, w_t)), {x_t, w_t});
+    EXPECT_EQ(grads[0].dims(), (Shape{2, 3}));
+    EXPECT_EQ(grads[1].dims(), (Shape{1, 3}));
+    auto values = evaluate(grads);
+    expect_near(values[0], {0.5, -1.0, 2.0, 0.5, -1.0, 2.0});
+    expect_near(values[1], {5.0, 7.0, 9.0});
+}
+
+TEST_F(AutodiffTest, BackwardTapeReleasesActivationsAndReusesBuffers) {
+    constexpr uint32_t ROWS = 16, WIDTH = 32, LAYERS = 6;
+    auto input = values(ROWS * WIDTH, 9);
+    std::vector<std::vector<float>> weights;
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        weights.push_back(values(WIDTH * WIDTH, 10 + layer));
+        for (float& value : weights.back()) {
+            value *= 0.3f;
+        }
+    }
+
+    std::vector<Tensor> params;
+    Tensor x(input.data(), {ROWS, WIDTH});
+    Tensor first;
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        params.emplace_back(weights[layer].data(), std::vector<uint32_t>{WIDTH, WIDTH});
+        x = relu(matmul(x, params.back()));
+        if (layer == 0) {
+            first = x;
+        }
+    }
+    // A skip connection makes the first activation's gradient a sum of two contributions
+    Tensor loss = reduce_sum(add(x, first));
+    std::vector<Tensor> grads = grad(loss, params);
+
+    // Every result of the same tape, kept until the end
+    TapeGenerator generator;
+    auto tape = generator.generate_tape(grads);
+    TapeExecutor executor;
+    register_all_operations(executor);
+    executor.execute_tape(*tape);
+    size_t unplanned_bytes = executor.memory_usage();
+
+    auto* manager = dynamic_cast<tt_lazy::TapeEvaluationManager*>(&tt_lazy::get_evaluation_manager());
+    ASSERT_NE(manager, nullptr);
+    auto planned = evaluate(grads);
+    const auto& stats = manager->memory_plan_stats();
+    EXPECT_GT(stats.released_bytes, 0u);
+    EXPECT_GT(stats.reused_buffers, 0u);
+    EXPECT_LT(stats.peak_live_bytes, unplanned_bytes / 2);
+
+    // Same values as the unplanned run, and still right when evaluated again
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        auto unplanned = executor.get_result(grads[layer].producer_node());
+        ASSERT_NE(unplanned, nullptr);
+        EXPECT_EQ(planned[layer], unplanned->to_vector()) << "layer " << layer;
+    }
+    EXPECT_EQ(evaluate(grads), planned);
+
+    EXPECT_THROW(grad(x, params), std::runtime_error) << "Loss must be a single value";
+    Tensor positions = argmax(matmul(Tensor(input.data(), {ROWS, WIDTH}), params[0]));
+    EXPECT_THROW(grad(reduce_sum(positions), {params[0]}), std::runtime_error) << "ArgMax has no gradient";
+}
+
+TEST_F(AutodiffTest, GradientsReadThroughEvalArePlannedToo) {
+    constexpr uint32_t ROWS = 16, WIDTH = 32, LAYERS = 4;
+    auto input = values(ROWS * WIDTH, 20);
+    std::vector<std::vector<float>> weights;
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        weights.push_back(values(WIDTH * WIDTH, 21 + layer));
+    }
+    std::vector<Tensor> params;
+    std::vector<Tensor> activations;
+    Tensor x(input.data(), {ROWS, WIDTH});
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        params.emplace_back(weights[layer].data(), std::vector<uint32_t>{WIDTH, WIDTH});
+        x = relu(matmul(x, params.back()));
+        activations.push_back(x);
+    }
+    std::vector<Tensor> grads = grad(reduce_sum(x), params);
+    auto expected = evaluate(grads);
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    auto* manager = dynamic_cast<tt_lazy::TapeEvaluationManager*>(&tt_lazy::get_evaluation_manager());
+    ASSERT_NE(manager, nullptr);
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        Tensor g = grads[layer];
+        g.eval();
+        EXPECT_EQ(g.to_vector(), expected[layer]) << "layer " << layer;
+    }
+
+    // Each read cached its gradient and nothing else: the activations were released
+    const auto& stats = manager->memory_plan_stats();
+    EXPECT_GT(stats.released_bytes, 0u);
+    EXPECT_GT(stats.reused_buffers, 0u);
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        EXPECT_TRUE(manager->is_cached(grads[layer].producer_node()));
+        EXPECT_FALSE(manager->is_cached(activations[layer].producer_node())) << "layer " << layer;
+    }
+}
+
+TEST_F(AutodiffTest, PlannerOnlyOverwritesBuffersItOwns) {
+    // TopKIndices hands on the positions TopK stored as its second output; an elementwise
+    // consumer must not write into that shared buffer
+    std::vector<float> data = {3.0f, 1.0f, 2.0f, 0.5f, 5.0f, 4.0f};
+    std::vector<float> scale = {2.0f, 2.0f, 2.0f, 2.0f};
+    Tensor input(data.data(), {2, 3});
+    auto [top, positions] = topk(input, 2);
+    Tensor doubled = relu(multiply(positions, Tensor(scale.data(), {2, 2})));
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({doubled});
+    TapeExecutor executor;
+    register_all_operations(executor);
+    MemoryPlanner planner(executor);
+    planner.set_kept_nodes({doubled.producer_node()});
+    executor.add_observer(&planner);
+    executor.execute_tape(*tape);
+
+    EXPECT_EQ(executor.get_result(doubled.producer_node())->to_vector(),
+              (std::vector<float>{0.0f, 4.0f, 2.0f, 4.0f}));
+    EXPECT_EQ(executor.get_result(top.producer_node(), 1)->to_vector(), (std::vector<float>{0.0f, 2.0f, 1.0f, 2.0f}));
+    // The multiply allocated its own buffer, which the ReLU then reused
+    EXPECT_EQ(planner.stats().reused_buffers, 1u);
+}
@@ -0,0 +1,127 @@
+#include "CodeGenerator.hpp"
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "TapeGenerator.hpp"
+#include "operations.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class CodegenTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static std::vector<float> values(size_t count, size_t seed) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<float>((i * 7919 + seed * 104729) % 23) * 0.1f - 1.1f;
+        }
+        return data;
+    }
+
+    static GeneratedCode generate(const std::vector<Tensor>& inputs, const Tensor& output,
+                                  const CodegenOptions& options = {}) {
+        TapeGenerator generator;
+        auto tape = generator.generate_tape({output});
+        return generate_cpp(*tape, inputs, output, options);
+    }
+};
+
+TEST_F(CodegenTest, MlpBecomesTwoFusedGemmCalls) {
+    constexpr uint32_t N = 8, I = 4, H = 16, O = 3;
+    auto x = values(N * I, 1);
+    auto w1 = values(I * H, 2);
+    auto b1 = values(H, 3);
+    auto w2 = values(H * O, 4);
+    auto b2 = values(O, 5);
+    Tensor x_t(x.data(), {N, I});
+    Tensor w1_t(w1.data(), {I, H});
+    Tensor b1_t(b1.data(), {1, H});
+    Tensor w2_t(w2.data(), {H, O});
+    Tensor b2_t(b2.data(), {1, O});
+    Tensor output = add(matmul(relu(add(matmul(x_t, w1_t), b1_t)), w2_t), b2_t);
+
+    GeneratedCode code = generate({x_t}, output);
+    EXPECT_EQ(code.kernel_calls, 2u);
+    EXPECT_EQ(code.arena_floats, N * H);
+    ASSERT_EQ(code.weights.size(), 4u);
+    EXPECT_EQ(code.weights[0].raw_data(), w1_t.raw_data());
+    EXPECT_EQ(code.weights[1].raw_data(), b1_t.raw_data());
+    EXPECT_EQ(code.weights[2].raw_data(), w2_t.raw_data());
+    EXPECT_EQ(code.weights[3].raw_data(), b2_t.raw_data());
+
+    const std::string& source = code.source;
+    EXPECT_NE(source.find("namespace tt_lazy_generated {"), std::string::npos);
+    EXPECT_NE(source.find("constexpr std::size_t ARENA_FLOATS = 128;"), std::string::npos);
+    EXPECT_NE(source.find("constexpr std::size_t OUTPUT_FLOATS = 24;"), std::string::npos);
+    EXPECT_NE(source.find("// MatMul + Add + ReLU -> [8, 16]"), std::string::npos);
+    EXPECT_NE(source.find("math::aot::matmul<8, 16, 4, false, false, true>(inputs[0], weights[0], weights[1], "
+                          "arena + 0);"),
+              std::string::npos)
+        << source;
+    EXPECT_NE(source.find("math::aot::matmul<8, 3, 16, false, false, false>(arena + 0, weights[2], weights[3], "
+                          "output);"),
+              std::string::npos)
+        << source;
+
+    // Embedded weights are compiled in as exact literals
+    CodegenOptions options;
+    options.namespace_name = "demo";
+    options.embed_weights = true;
+    GeneratedCode embedded = generate({x_t}, output, options);
+    EXPECT_TRUE(embedded.weights.empty());
+    EXPECT_NE(embedded.source.find("alignas(64) inline const float WEIGHT_0[64] = {"), std::string::npos);
+    EXPECT_NE(embedded.source.find("inline void run(const float* const* inputs, float* output, float* arena)"),
+              std::string::npos);
+    EXPECT_NE(embedded.source.find("(inputs[0], WEIGHT_0, WEIGHT_1, arena + 0);"), std::string::npos);
+}
+
+TEST_F(CodegenTest, ArenaReusesDeadBuffersAndWritesElementwiseResultsInPlace) {
+    constexpr uint32_t N = 8, K = 16;
+    auto x = values(N * K, 6);
+    auto w = values(K * K, 7);
+    Tensor x_t(x.data(), {N, K});
+    Tensor w_t(w.data(), {K, K});
+
+    // h is read twice, so it keeps its own buffer; every later result overwrites a dead one
+    Tensor h = matmul(x_t, w_t);
+    Tensor output = reduce_sum(add(relu(multiply(h, h)), h), {1});
+
+    GeneratedCode code = generate({x_t}, output);
+    EXPECT_EQ(code.kernel_calls, 5u);
+    EXPECT_EQ(code.unplanned_floats, 4u * N * K);
+    EXPECT_EQ(code.arena_floats, 2u * N * K);
+
+    const std::string& source = code.source;
+    EXPECT_NE(source.find("math::aot::matmul<8, 16, 16, false, false, false>(inputs[0], weights[0], nullptr, "
+                          "arena + 0);"),
+              std::string::npos)
+        << source;
+    EXPECT_NE(source.find("math::aot::multiply<128>(arena + 0, arena + 0, arena + 128);"), std::string::npos);
+    EXPECT_NE(source.find("math::aot::relu<128>(arena + 128, arena + 128);"), std::string::npos);
+    EXPECT_NE(source.find("math::aot::add<128>(arena + 128, arena + 0, arena + 128);"), std::string::npos);
+    EXPECT_NE(source.find("math::aot::reduce_sum<8, 16, 1>(arena + 128, output);"), std::string::npos);
+}
+
+TEST_F(CodegenTest, RejectsUnsupportedOperations) {
+    auto x = values(4 * 6, 8);
+    Tensor x_t(x.data(), {4, 6});
+    EXPECT_THROW(generate({x_t}, argmax(relu(x_t))), std::runtime_error);
+
+    Tensor y = relu(x_t);
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({y});
+    EXPECT_THROW(generate_cpp(*tape, {x_t}, x_t), std::runtime_error) << "The output must be computed";
+    EXPECT_THROW(generate_cpp(*tape, {x_t}, relu(y)), std::runtime_error) << "The output must be on the tape";
+}
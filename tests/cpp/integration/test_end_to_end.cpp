@@ -388,3 +388,112 @@ TEST_F(EndToEndTest, MultipleEvaluationPaths) {
 
     spdlog::info("Multiple evaluation paths test successful!");
 }
+
+TEST_F(EndToEndTest, ProfilerRecordsPerOpTimings) {
+    spdlog::info("\n=== Testing Per-Op Profiling ===");
+
+    auto& eval_manager = tt_lazy::get_evaluation_manager();
+    eval_manager.reset_profile();
+    eval_manager.set_profiling_enabled(true);
+
+    float data1[4], data2[4];  // 2x2 matrices
+    fill_test_data(data1, 4, 1.0f);
+    fill_test_data(data2, 4, 2.0f);
+
+    Tensor input1(data1, {2, 2});
+    Tensor input2(data2, {2, 2});
+
+    auto result = relu(matmul(input1, input2));
+    result.eval();
+
+    eval_manager.set_profiling_enabled(false);
+    auto profile = eval_manager.get_profile();
+
+    ASSERT_EQ(profile.size(), 2) << "Expected one timing per executed op";
+    EXPECT_EQ(profile[0].op_name, "MatMul");
+    EXPECT_EQ(profile[1].op_name, "ReLU");
+    EXPECT_EQ(profile[1].node_id, result.producer_node());
+
+    for (const auto& timing : profile) {
+        spdlog::info("  {} (node {}): {} ns", timing.op_name, timing.node_id, timing.duration_ns);
+    }
+
+    // Disabled profiler records nothing new
+    auto more = relu(input1);
+    more.eval();
+    EXPECT_EQ(eval_manager.get_profile().size(), 2);
+
+    eval_manager.reset_profile();
+    EXPECT_TRUE(eval_manager.get_profile().empty());
+}
+
+TEST_F(EndToEndTest, EvalIntoCallerBuffer) {
+    spdlog::info("\n=== Testing Evaluation Into Caller Buffers ===");
+
+    float data1[6] = {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};  // 2x3
+    float data2[6] = {1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};     // 3x2
+    Tensor input1(data1, {2, 3});
+    Tensor input2(data2, {3, 2});
+
+    auto result = relu(matmul(input1, input2));
+
+    // Contiguous: the final op writes straight into dst and nothing is cached for it
+    float dst[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+    tt_lazy::eval_into(result, dst, 4);
+    EXPECT_FLOAT_EQ(dst[0], 4.0f);  // [1,-2,3] @ [[1,0],[0,1],[1,1]] = [4, 1]
+    EXPECT_FLOAT_EQ(dst[1], 1.0f);
+    EXPECT_FLOAT_EQ(dst[2], 0.0f);  // relu([-10, -10])
+    EXPECT_FLOAT_EQ(dst[3], 0.0f);
+    EXPECT_TRUE(result.is_lazy()) << "eval_into must not materialize the handle";
+
+    // Strided: rows padded to 3 floats, filled by a scatter copy
+    float padded[6] = {9.0f, 9.0f, 9.0f, 9.0f, 9.0f, 9.0f};
+    tt_lazy::eval_into(result, padded, 6, {3, 1});
+    EXPECT_FLOAT_EQ(padded[0], 4.0f);
+    EXPECT_FLOAT_EQ(padded[1], 1.0f);
+    EXPECT_FLOAT_EQ(padded[2], 9.0f) << "Padding must be left untouched";
+    EXPECT_FLOAT_EQ(padded[3], 0.0f);
+    EXPECT_FLOAT_EQ(padded[5], 9.0f);
+
+    // Multi-output: intermediate and final result from one tape
+    auto hidden = matmul(input1, input2);
+    auto activated = relu(hidden);
+    float hidden_dst[4];
+    float activated_dst[4];
+    tt_lazy::eval_into({hidden, activated}, {{hidden_dst, 4, {}}, {activated_dst, 4, {}}});
+    EXPECT_FLOAT_EQ(hidden_dst[2], -10.0f);
+    EXPECT_FLOAT_EQ(activated_dst[2], 0.0f);
+    EXPECT_FLOAT_EQ(activated_dst[0], 4.0f);
+}
+
+TEST_F(EndToEndTest, EvalIntoValidatesUpFront) {
+    spdlog::info("\n=== Testing eval_into Validation ===");
+
+    float data[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    Tensor input(data, {2, 2});
+    auto result = relu(input);
+
+    auto& eval_manager = tt_lazy::get_evaluation_manager();
+    size_t executed_before = eval_manager.get_stats().operations_executed;
+
+    alignas(float) unsigned char raw[5 * sizeof(float)];
+    float small[3];
+    float dst[8];
+    EXPECT_THROW(tt_lazy::eval_into(result, small, 3), std::runtime_error) << "Too small";
+    EXPECT_THROW(tt_lazy::eval_into(result, nullptr, 4), std::runtime_error) << "Null";
+    EXPECT_THROW(tt_lazy::eval_into(result, reinterpret_cast<float*>(raw + 1), 4),  // NOLINT
+                 std::runtime_error)
+        << "Misaligned";
+    EXPECT_THROW(tt_lazy::eval_into(result, dst, 8, {1}), std::runtime_error) << "Stride rank";
+    EXPECT_THROW(tt_lazy::eval_into(result, dst, 8, {1, 1}), std::runtime_error) << "Overlapping strides";
+    EXPECT_THROW(tt_lazy::eval_into(result, dst, 4, {4, 1}), std::runtime_error) << "Strided extent too large";
+    EXPECT_THROW(tt_lazy::eval_into({result, relu(input)}, {{dst, 4, {}}, {dst + 2, 4, {}}}), std::runtime_error)
+        << "Overlapping outputs";
+    EXPECT_THROW(tt_lazy::eval_into(result, data, 4), std::runtime_error) << "Aliases a graph input";
+
+    EXPECT_EQ(eval_manager.get_stats().operations_executed, executed_before) << "Nothing may run on bad input";
+
+    // A valid call still works afterwards
+    tt_lazy::eval_into(result, dst, 8);
+    EXPECT_FLOAT_EQ(dst[3], 4.0f);
+}
@@ -0,0 +1,179 @@
+#include "AdaptiveEvaluationManager.hpp"
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "EvaluationMode.hpp"
+#include "ImmediateEvaluationManager.hpp"
+#include "operations.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class EvaluationModeTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    void TearDown() override {
+        tt_lazy::set_evaluation_manager(nullptr);
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    // relu(x @ w + b) over 2x3 inputs, with the values computed by the default (tape) manager
+    Tensor model() { return relu(add(matmul(x_, w_), b_)); }
+
+    std::vector<float> x_data_{1.0f, -2.0f, 0.5f, 3.0f, 0.0f, -1.0f};
+    std::vector<float> w_data_{0.5f, -1.0f, 2.0f, 0.25f, -0.5f, 1.0f};
+    std::vector<float> b_data_{0.1f, -0.2f};
+    Tensor x_{x_data_.data(), {2, 3}};
+    Tensor w_{w_data_.data(), {3, 2}};
+    Tensor b_{b_data_.data(), {1, 2}};
+};
+
+TEST_F(EvaluationModeTest, ImmediateRunsNodesAtDispatch) {
+    std::vector<float> expected = model().to_vector();
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    tt_lazy::set_evaluation_mode(tt_lazy::EvaluationMode::IMMEDIATE);
+    EXPECT_EQ(tt_lazy::evaluation_mode(), tt_lazy::EvaluationMode::IMMEDIATE);
+    auto& manager = tt_lazy::get_evaluation_manager();
+
+    // All three kernels ran while the graph was built; reading the result only copies it
+    Tensor y = model();
+    EXPECT_EQ(manager.get_stats().operations_executed, 3);
+    EXPECT_EQ(y.to_vector(), expected);
+    EXPECT_EQ(manager.get_stats().operations_executed, 3);
+    EXPECT_EQ(manager.get_stats().cache_hits, 1);
+
+    // A cleared graph reuses node ids; the new nodes replace the old results
+    Context::instance().clear();
+    Tensor z = add(x_, x_);
+    EXPECT_EQ(z.to_vector(), (std::vector<float>{2.0f, -4.0f, 1.0f, 6.0f, 0.0f, -2.0f}));
+
+    EXPECT_THROW(manager.set_memory_budget(1024), std::runtime_error);
+}
+
+TEST_F(EvaluationModeTest, ImmediateOnDemandMatchesTape) {
+    std::vector<float> expected = model().to_vector();
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    auto manager = std::make_shared<tt_lazy::ImmediateEvaluationManager>(false);
+    tt_lazy::set_evaluation_manager(manager);
+    Tensor y = model();
+    EXPECT_EQ(manager->get_stats().operations_executed, 0);
+    EXPECT_EQ(manager->pending_nodes(y, 10), 3);
+    EXPECT_EQ(manager->pending_nodes(y, 2), 2);
+
+    EXPECT_EQ(y.to_vector(), expected);
+    EXPECT_EQ(manager->get_stats().operations_executed, 3);
+    EXPECT_EQ(manager->pending_nodes(y, 10), 0);
+
+    std::vector<float> dst(4, -1.0f);
+    tt_lazy::eval_into(y, dst.data(), dst.size());
+    EXPECT_EQ(dst, expected);
+}
+
+TEST_F(EvaluationModeTest, AdaptivePicksModeByGraphSize) {
+    std::vector<float> expected = model().to_vector();
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    tt_lazy::AdaptiveEvaluationManager::Options options;
+    options.max_eager_nodes = 4;
+    options.probe_interval = 0;
+    auto manager = std::make_shared<tt_lazy::AdaptiveEvaluationManager>(options);
+    tt_lazy::set_evaluation_manager(manager);
+    EXPECT_EQ(tt_lazy::evaluation_mode(), tt_lazy::EvaluationMode::ADAPTIVE);
+
+    // Three pending nodes: eager, which is measured first
+    EXPECT_EQ(model().to_vector(), expected);
+    EXPECT_EQ(manager->adaptive_stats().eager_evaluations, 1);
+    EXPECT_GT(manager->adaptive_stats().eager_ns_per_node, 0.0);
+
+    // A chain longer than max_eager_nodes goes to a tape
+    Tensor chain = model();
+    for (int i = 0; i < 4; ++i) {
+        chain = relu(chain);
+    }
+    EXPECT_EQ(chain.to_vector(), expected);
+    EXPECT_EQ(manager->adaptive_stats().tape_evaluations, 1);
+    EXPECT_GT(manager->adaptive_stats().tape_generate_ns, 0.0);
+
+    // With a memory budget everything goes to a tape, where spilling is planned
+    manager->set_memory_budget(1 << 20);
+    EXPECT_EQ(model().to_vector(), expected);
+    EXPECT_EQ(manager->adaptive_stats().tape_evaluations, 2);
+    manager->set_memory_budget(0);
+
+    // Estimates survive clear_cache, counters do not
+    manager->clear_cache();
+    EXPECT_EQ(manager->adaptive_stats().eager_evaluations, 0);
+    EXPECT_GT(manager->adaptive_stats().eager_ns_per_node, 0.0);
+}
+
+TEST_F(EvaluationModeTest, AdaptiveModesShareResults) {
+    std::vector<float> expected = model().to_vector();
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+
+    tt_lazy::AdaptiveEvaluationManager::Options options;
+    options.max_eager_nodes = 4;
+    options.probe_interval = 0;
+    auto manager = std::make_shared<tt_lazy::AdaptiveEvaluationManager>(options);
+    tt_lazy::set_evaluation_manager(manager);
+    manager->set_profiling_enabled(true);
+
+    // Consumers are built first, so they refer to the lazy tensors rather than read copies
+    Tensor hidden = add(matmul(x_, w_), b_);
+    Tensor chain = relu(hidden);
+    for (int i = 0; i < 4; ++i) {
+        chain = relu(chain);
+    }
+    Tensor doubled = add(chain, chain);
+
+    // Two nodes run eagerly; the five on top go to a tape that starts from their result
+    hidden.to_vector();
+    EXPECT_EQ(manager->adaptive_stats().eager_evaluations, 1);
+    EXPECT_EQ(chain.to_vector(), expected);
+    EXPECT_EQ(manager->adaptive_stats().tape_evaluations, 1);
+
+    // One node left, which reads the tape's result
+    std::vector<float> twice;
+    for (float value : expected) {
+        twice.push_back(value + value);
+    }
+    EXPECT_EQ(doubled.to_vector(), twice);
+    EXPECT_EQ(manager->adaptive_stats().eager_evaluations, 2);
+
+    // No node ran twice
+    std::unordered_set<NodeId> ran;
+    for (const auto& timing : manager->get_profile()) {
+        EXPECT_TRUE(ran.insert(timing.node_id).second) << "node " << timing.node_id << " ran again";
+    }
+    EXPECT_EQ(ran.count(hidden.producer_node()), 1);
+    EXPECT_EQ(ran.count(doubled.producer_node()), 1);
+}
+
+TEST_F(EvaluationModeTest, DefaultManagerIsRestored) {
+    tt_lazy::set_evaluation_mode(tt_lazy::EvaluationMode::IMMEDIATE);
+    tt_lazy::set_evaluation_manager(nullptr);
+    EXPECT_EQ(&tt_lazy::get_evaluation_manager(), &tt_lazy::default_evaluation_manager());
+    EXPECT_EQ(tt_lazy::evaluation_mode(), tt_lazy::EvaluationMode::TAPE);
+
+    // The dispatch hook went away with the immediate manager
+    Tensor y = model();
+    EXPECT_TRUE(y.is_lazy());
+    EXPECT_FALSE(y.is_evaluated());
+    EXPECT_EQ(tt_lazy::get_evaluation_manager().get_stats().operations_executed, 0);
+
+    EXPECT_EQ(tt_lazy::parse_evaluation_mode("adaptive"), tt_lazy::EvaluationMode::ADAPTIVE);
+    EXPECT_THROW(tt_lazy::parse_evaluation_mode("eager"), std::invalid_argument);
+}
@@ -0,0 +1,165 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "MappedWeightFile.hpp"
+#include "operations.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+class GatherTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t NUM_ROWS = 1000;
+    static constexpr uint32_t DIM = 48;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        table_.resize(NUM_ROWS * DIM);
+        for (size_t i = 0; i < table_.size(); ++i) {
+            table_[i] = static_cast<float>(i % 97) - 48.0f;
+        }
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    std::vector<float> reference_bags(const std::vector<int32_t>& indices, const std::vector<int32_t>& offsets,
+                                      bool mean) const {
+        std::vector<float> result(offsets.size() * DIM, 0.0f);
+        for (size_t bag = 0; bag < offsets.size(); ++bag) {
+            size_t begin = static_cast<size_t>(offsets[bag]);
+            size_t end = bag + 1 < offsets.size() ? static_cast<size_t>(offsets[bag + 1]) : indices.size();
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t d = 0; d < DIM; ++d) {
+                    result[bag * DIM + d] += table_[static_cast<size_t>(indices[i]) * DIM + d];
+                }
+            }
+            if (mean && end > begin) {
+                for (size_t d = 0; d < DIM; ++d) {
+                    result[bag * DIM + d] /= static_cast<float>(end - begin);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<float> table_;
+};
+
+TEST_F(GatherTest, GathersSlicesAlongAxis) {
+    Tensor table(table_.data(), {NUM_ROWS, DIM});
+
+    // Rows with 2-D int64 indices: [2, 3] + [DIM]
+    std::vector<int64_t> rows = {5, 0, 999, 5, 17, 3};
+    Tensor row_indices(rows.data(), {2, 3}, DataType::INT64);
+    Tensor gathered = gather(table, row_indices);
+    ASSERT_EQ(gathered.rank(), 3);
+    EXPECT_EQ(gathered.size(0), 2u);
+    EXPECT_EQ(gathered.size(1), 3u);
+    EXPECT_EQ(gathered.size(2), DIM);
+    gathered.eval();
+    auto values = gathered.to_vector();
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (size_t d = 0; d < DIM; ++d) {
+            EXPECT_EQ(values[i * DIM + d], table_[static_cast<size_t>(rows[i]) * DIM + d]);
+        }
+    }
+
+    // Columns with int32 indices
+    std::vector<int32_t> columns = {47, 1};
+    Tensor column_indices(columns.data(), {2}, DataType::INT32);
+    Tensor picked = gather(table, column_indices, -1);
+    picked.eval();
+    auto picked_values = picked.to_vector();
+    ASSERT_EQ(picked_values.size(), NUM_ROWS * 2u);
+    for (size_t row = 0; row < NUM_ROWS; ++row) {
+        EXPECT_EQ(picked_values[row * 2], table_[row * DIM + 47]);
+        EXPECT_EQ(picked_values[row * 2 + 1], table_[row * DIM + 1]);
+    }
+}
+
+TEST_F(GatherTest, EmbeddingBagSumAndMean) {
+    // Enough bags to be split across threads, including empty ones
+    constexpr size_t BAGS = 2048;
+    std::vector<int32_t> indices;
+    std::vector<int32_t> offsets;
+    for (size_t bag = 0; bag < BAGS; ++bag) {
+        offsets.push_back(static_cast<int32_t>(indices.size()));
+        for (size_t i = 0; i < bag % 7; ++i) {
+            indices.push_back(static_cast<int32_t>((bag * 131 + i * 37) % NUM_ROWS));
+        }
+    }
+
+    Tensor table(table_.data(), {NUM_ROWS, DIM});
+    Tensor index_tensor(indices.data(), {static_cast<uint32_t>(indices.size())}, DataType::INT32);
+    Tensor offset_tensor(offsets.data(), {static_cast<uint32_t>(offsets.size())}, DataType::INT32);
+
+    for (auto mode : {EmbeddingBagArgs::Mode::SUM, EmbeddingBagArgs::Mode::MEAN}) {
+        Tensor pooled = embedding_bag(table, index_tensor, offset_tensor, mode);
+        EXPECT_EQ(pooled.size(0), BAGS);
+        EXPECT_EQ(pooled.size(1), DIM);
+        pooled.eval();
+        auto expected = reference_bags(indices, offsets, mode == EmbeddingBagArgs::Mode::MEAN);
+        auto values = pooled.to_vector();
+        ASSERT_EQ(values.size(), expected.size());
+        for (size_t i = 0; i < values.size(); ++i) {
+            EXPECT_FLOAT_EQ(values[i], expected[i]) << "at " << i;
+        }
+    }
+}
+
+TEST_F(GatherTest, AcceptsLazyFloatIndicesAndRejectsBadOnes) {
+    // Indices computed by the graph arrive as float32
+    std::vector<float> base = {1.0f, 2.0f, 3.0f};
+    std::vector<float> shift = {10.0f, 10.0f, 10.0f};
+    Tensor indices = add(Tensor(base.data(), {3}), Tensor(shift.data(), {3}));
+    Tensor gathered = gather(Tensor(table_.data(), {NUM_ROWS, DIM}), indices);
+    gathered.eval();
+    auto values = gathered.to_vector();
+    for (size_t i = 0; i < base.size(); ++i) {
+        EXPECT_EQ(values[i * DIM], table_[(static_cast<size_t>(base[i]) + 10) * DIM]);
+    }
+
+    std::vector<int64_t> out_of_range = {3, NUM_ROWS};
+    Tensor bad = gather(Tensor(table_.data(), {NUM_ROWS, DIM}), Tensor(out_of_range.data(), {2}, DataType::INT64));
+    EXPECT_THROW(bad.eval(), std::runtime_error);
+
+    std::vector<float> fractional = {1.5f};
+    Tensor bad_float = gather(Tensor(table_.data(), {NUM_ROWS, DIM}), Tensor(fractional.data(), {1}));
+    EXPECT_THROW(bad_float.eval(), std::runtime_error);
+
+    std::vector<int32_t> index_data = {0, 1};
+    Tensor integer_indices(index_data.data(), {2}, DataType::INT32);
+    EXPECT_THROW(integer_indices.const_data_ptr(), std::runtime_error);
+    EXPECT_EQ(integer_indices.nbytes(), 2 * sizeof(int32_t));
+}
+
+TEST_F(GatherTest, EmbeddingBagOverMappedTable) {
+    std::string path = "/tmp/tt_lazy_embedding_" + std::to_string(getpid()) + ".bin";
+    MappedWeightFile::write(path, {{"embedding", Tensor(table_.data(), {NUM_ROWS, DIM})}});
+    auto file = MappedWeightFile::open(path);
+
+    std::vector<int64_t> indices = {4, 900, 4, 12, 600};
+    std::vector<int64_t> offsets = {0, 2, 2};
+    Tensor pooled = embedding_bag(file->get("embedding"), Tensor(indices.data(), {5}, DataType::INT64),
+                                  Tensor(offsets.data(), {3}, DataType::INT64));
+    pooled.eval();
+    auto values = pooled.to_vector();
+    auto expected = reference_bags({4, 900, 4, 12, 600}, {0, 2, 2}, false);
+    ASSERT_EQ(values.size(), expected.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_FLOAT_EQ(values[i], expected[i]) << "at " << i;
+    }
+
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+    file.reset();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,315 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "InferenceClient.hpp"
+#include "InferenceServer.hpp"
+#include "Model.hpp"
+#include "SharedTensorRing.hpp"
+#include "operations.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+size_t open_descriptors() {
+    size_t count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    while (dirent* entry = readdir(dir)) {
+        count += entry->d_name[0] != '.' ? 1 : 0;
+    }
+    closedir(dir);
+    return count - 1;  // The directory stream itself
+}
+
+// memfd holding a ring header: magic, slots, reserved, input and output floats
+int make_ring_file(uint32_t slots, uint64_t input_floats, uint64_t output_floats, bool sealed) {
+    int fd = memfd_create("test_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0 || ftruncate(fd, 4096) != 0) {
+        return -1;
+    }
+    uint64_t magic = 0x5454'4C5A'5249'4E47ULL;
+    char header[32] = {};
+    std::memcpy(header, &magic, 8);
+    std::memcpy(header + 8, &slots, 4);
+    std::memcpy(header + 16, &input_floats, 8);
+    std::memcpy(header + 24, &output_floats, 8);
+    if (pwrite(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        return -1;
+    }
+    if (sealed && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0) {
+        return -1;
+    }
+    return fd;
+}
+
+}  // namespace
+
+class InferenceServerTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t IN = 4;
+    static constexpr uint32_t HIDDEN = 3;
+    static constexpr uint32_t OUT = 2;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        std::string suffix = std::to_string(getpid());
+        model_path_ = "/tmp/tt_lazy_test_model_" + suffix + ".ttm";
+        socket_path_ = "/tmp/tt_lazy_test_server_" + suffix + ".sock";
+
+        for (size_t i = 0; i < w1_.size(); ++i) {
+            w1_[i] = 0.1f * static_cast<float>(i % 7) - 0.2f;
+        }
+        for (size_t i = 0; i < w2_.size(); ++i) {
+            w2_[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+        }
+    }
+
+    void TearDown() override {
+        stop_server();
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        std::remove(model_path_.c_str());
+    }
+
+    // relu(x @ w1 + b1) @ w2^T + b2
+    Tensor build_reference(const Tensor& x) {
+        Tensor w1(w1_.data(), {IN, HIDDEN});
+        Tensor b1(b1_.data(), {1, HIDDEN});
+        Tensor w2(w2_.data(), {OUT, HIDDEN});
+        Tensor b2(b2_.data(), {1, OUT});
+        return add(matmul(fused_mlp(x, w1, b1, true), w2, false, true), b2);
+    }
+
+    std::vector<float> reference(const std::vector<float>& input, uint32_t rows) {
+        std::vector<float> data = input;
+        Tensor x(data.data(), {rows, IN});
+        Tensor y = build_reference(x);
+        std::vector<float> result(rows * OUT);
+        tt_lazy::eval_into(y, result.data(), result.size());
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        return result;
+    }
+
+    std::vector<float> make_input(uint32_t rows, float seed) {
+        std::vector<float> input(rows * IN);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = seed + 0.125f * static_cast<float>(i);
+        }
+        return input;
+    }
+
+    void save_model() {
+        std::vector<float> example(IN, 0.0f);
+        Tensor x(example.data(), {1, IN});
+        Model::save(model_path_, {{"x", x}}, build_reference(x));
+        Context::instance().clear();
+    }
+
+    void start_server(InferenceServer::Options options) {
+        save_model();
+        options.socket_path = socket_path_;
+        server_ = std::make_unique<InferenceServer>(Model::load(model_path_), options);
+        server_thread_ = std::thread([this]() { server_->run(); });
+    }
+
+    void stop_server() {
+        if (server_) {
+            server_->stop();
+            server_thread_.join();
+            server_.reset();
+        }
+    }
+
+    std::string model_path_;
+    std::string socket_path_;
+    std::vector<float> w1_ = std::vector<float>(IN * HIDDEN);
+    std::vector<float> b1_ = {0.1f, -0.3f, 0.2f};
+    std::vector<float> w2_ = std::vector<float>(OUT * HIDDEN);
+    std::vector<float> b2_ = {0.5f, -0.5f};
+    std::unique_ptr<InferenceServer> server_;
+    std::thread server_thread_;
+};
+
+TEST_F(InferenceServerTest, ModelRoundTripsThroughFile) {
+    auto input = make_input(3, -1.0f);
+    auto expected = reference(input, 3);
+
+    save_model();
+    Model model = Model::load(model_path_);
+    ASSERT_EQ(model.inputs().size(), 1u);
+    EXPECT_EQ(model.inputs()[0].name, "x");
+    EXPECT_EQ(model.input_row_elements(0), IN);
+    EXPECT_EQ(model.output_row_elements(), OUT);
+    EXPECT_EQ(model.num_weights(), 4u);
+    EXPECT_EQ(model.num_operations(), 3u);
+
+    // The loaded model serves any batch size
+    Tensor x(input.data(), {3, IN});
+    std::vector<float> result(3 * OUT);
+    tt_lazy::eval_into(model.build({x}), result.data(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result[i], expected[i], 1e-5f) << "at " << i;
+    }
+}
+
+TEST_F(InferenceServerTest, ModelLoadRejectsGarbage) {
+    FILE* file = std::fopen(model_path_.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a model\n", file);
+    std::fclose(file);
+    EXPECT_THROW(Model::load(model_path_), std::runtime_error);
+}
+
+TEST_F(InferenceServerTest, ServesRequestsThroughSharedRing) {
+    auto input = make_input(2, 0.5f);
+    auto expected = reference(input, 2);
+
+    InferenceServer::Options options;
+    options.batch_window_us = 0;
+    start_server(options);
+
+    InferenceClient client(socket_path_);
+    EXPECT_EQ(client.input_row_elements(), IN);
+    EXPECT_EQ(client.output_row_elements(), OUT);
+
+    std::vector<float> result(2 * OUT);
+    auto status = client.infer(input.data(), 2, result.data());
+    ASSERT_EQ(status.status, inference::Status::OK);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result[i], expected[i], 1e-5f) << "at " << i;
+    }
+
+    // Oversized and out-of-range requests are rejected without evaluation
+    client.submit(7, 0, client.max_rows() + 1);
+    EXPECT_EQ(client.wait().status, inference::Status::INVALID_REQUEST);
+    client.submit(8, client.num_slots(), 1);
+    EXPECT_EQ(client.wait().status, inference::Status::INVALID_REQUEST);
+}
+
+TEST_F(InferenceServerTest, BatchesConcurrentRequests) {
+    InferenceServer::Options options;
+    options.max_batch_rows = 4;
+    options.batch_window_us = 5'000'000;  // Only the row budget closes the batch
+    start_server(options);
+
+    InferenceClient client(socket_path_, 4);
+    std::vector<std::vector<float>> inputs;
+    for (uint32_t slot = 0; slot < 4; ++slot) {
+        inputs.push_back(make_input(1, static_cast<float>(slot)));
+        std::copy(inputs.back().begin(), inputs.back().end(), client.input(slot));
+        client.submit(100 + slot, slot, 1);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        auto result = client.wait();
+        ASSERT_EQ(result.status, inference::Status::OK);
+        EXPECT_EQ(result.batch_rows, 4u);
+        EXPECT_EQ(result.request_id, 100 + result.slot);
+    }
+
+    auto stats = server_->stats();
+    EXPECT_EQ(stats.batches, 1u);
+    EXPECT_EQ(stats.completed, 4u);
+    EXPECT_EQ(stats.max_batch_requests, 4u);
+
+    // Each request's result lands in its own slot
+    stop_server();
+    for (uint32_t slot = 0; slot < 4; ++slot) {
+        auto expected = reference(inputs[slot], 1);
+        for (uint32_t j = 0; j < OUT; ++j) {
+            EXPECT_NEAR(client.output(slot)[j], expected[j], 1e-5f) << "slot " << slot;
+        }
+    }
+}
+
+TEST_F(InferenceServerTest, ExpiredDeadlinesAreNotEvaluated) {
+    InferenceServer::Options options;
+    options.batch_window_us = 200'000;
+    start_server(options);
+
+    InferenceClient client(socket_path_);
+    std::fill(client.input(0), client.input(0) + IN, 1.0f);
+    client.submit(1, 0, 1, std::chrono::microseconds(1000));
+    auto result = client.wait();
+    EXPECT_EQ(result.status, inference::Status::DEADLINE_EXCEEDED);
+
+    std::string stats = client.stats_json();
+    EXPECT_NE(stats.find("\"deadline_exceeded\": 1"), std::string::npos) << stats;
+    EXPECT_NE(stats.find("\"batches\": 0"), std::string::npos) << stats;
+}
+
+TEST_F(InferenceServerTest, RingAttachRejectsUntrustedFiles) {
+    // Resizable files, and headers whose sizes wrap around, are rejected; the caller keeps the fd
+    int unsealed = make_ring_file(1, 4, 4, false);
+    ASSERT_GE(unsealed, 0);
+    EXPECT_THROW(SharedTensorRing::attach(unsealed), std::runtime_error);
+    EXPECT_GE(fcntl(unsealed, F_GETFD), 0);
+    close(unsealed);
+
+    int wrapping = make_ring_file(4, (1ULL << 62) + 1, 1, true);
+    ASSERT_GE(wrapping, 0);
+    EXPECT_THROW(SharedTensorRing::attach(wrapping), std::runtime_error);
+    close(wrapping);
+
+    int valid = make_ring_file(2, 4, 4, true);
+    ASSERT_GE(valid, 0);
+    auto ring = SharedTensorRing::attach(valid);
+    EXPECT_EQ(ring->num_slots(), 2u);
+    EXPECT_EQ(ring->fd(), valid);
+}
+
+TEST_F(InferenceServerTest, ServerClosesUnusedDescriptors) {
+    start_server(InferenceServer::Options{});
+
+    int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    ASSERT_GE(sock, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    inference::Message hello;
+    hello.type = inference::MessageType::HELLO;
+    inference::Message reply;
+    inference::send_message(sock, hello);
+    ASSERT_TRUE(inference::receive_message(sock, reply));
+    size_t baseline = open_descriptors();
+
+    // The server shares this process, so a descriptor it kept would show up here
+    int passed = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    ASSERT_GE(passed, 0);
+    for (int i = 0; i < 8; ++i) {
+        inference::send_message(sock, hello, passed);
+        ASSERT_TRUE(inference::receive_message(sock, reply));
+    }
+    close(passed);
+    EXPECT_EQ(open_descriptors(), baseline);
+
+    // A rejected ring drops the connection and is closed exactly once
+    int unsealed = make_ring_file(1, 4, 4, false);
+    ASSERT_GE(unsealed, 0);
+    inference::Message attach;
+    attach.type = inference::MessageType::ATTACH_RING;
+    inference::send_message(sock, attach, unsealed);
+    close(unsealed);
+    EXPECT_FALSE(inference::receive_message(sock, reply));
+    close(sock);
+    stop_server();
+    EXPECT_LE(open_descriptors(), baseline - 1);
+}
@@ -0,0 +1,255 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "blas.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+#include "small_gemm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class KernelRegistryTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        register_all_operations(executor_);
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static std::vector<float> values(size_t count, size_t seed) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<float>((i * 7919 + seed * 104729) % 29) * 0.1f - 1.4f;
+        }
+        return data;
+    }
+
+    std::string kernel_of(const Tape& tape, const Tensor& tensor) const {
+        const TapeOperation* op = tape.find_operation(tensor.producer_node());
+        return op && op->kernel ? op->kernel->name : "";
+    }
+
+    TapeExecutor executor_;
+};
+
+TEST_F(KernelRegistryTest, SingleRowProductsSelectGemvAndMatchGemm) {
+    constexpr uint32_t K = 300, N = 70;
+    auto x = values(2 * K, 1);
+    auto w = values(K * N, 2);
+    auto wt = values(N * K, 3);
+    auto bias = values(N, 4);
+    Tensor weights(w.data(), {K, N});
+    Tensor weights_t(wt.data(), {N, K});
+    Tensor bias_t(bias.data(), {1, N});
+
+    // The first row alone, and as the first of two rows
+    std::vector<Tensor> outputs;
+    for (uint32_t rows : {1u, 2u}) {
+        Tensor input(x.data(), {rows, K});
+        outputs.push_back(matmul(input, weights));
+        outputs.push_back(matmul(input, weights_t, false, true));
+        outputs.push_back(fused_mlp(input, weights, bias_t, true));
+    }
+    Tensor column(x.data(), {K, 1});
+    outputs.push_back(matmul(column, weights, true, false));
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape(outputs);
+    executor_.select_kernels(*tape);
+    // MatMul prefers the BLAS kernels when they are linked
+    std::string matmul_gemv = math::blas_available() ? "matmul_blas_sgemv" : "matmul_gemv";
+    std::string matmul_gemm = math::blas_available() ? "matmul_blas_sgemm" : "matmul_gemm";
+    for (size_t i = 0; i < 3; ++i) {
+        bool fused = i == 2;
+        EXPECT_EQ(kernel_of(*tape, outputs[i]), fused ? "fused_mlp_gemv" : matmul_gemv) << i;
+        EXPECT_EQ(kernel_of(*tape, outputs[i + 3]), fused ? "fused_mlp_gemm" : matmul_gemm) << i;
+    }
+    EXPECT_EQ(kernel_of(*tape, outputs[6]), matmul_gemv);
+
+    std::ostringstream os;
+    tape->print_tape(os);
+    EXPECT_NE(os.str().find("[kernel: fused_mlp_gemv]"), std::string::npos) << os.str();
+    EXPECT_NE(os.str().find("[kernel: fused_mlp_gemm]"), std::string::npos) << os.str();
+
+    executor_.execute_tape(*tape);
+    for (size_t i = 0; i < 3; ++i) {
+        auto row = executor_.get_result(outputs[i].producer_node())->to_vector();
+        auto both = executor_.get_result(outputs[i + 3].producer_node())->to_vector();
+        ASSERT_EQ(row.size(), N);
+        for (size_t j = 0; j < N; ++j) {
+            ASSERT_NEAR(row[j], both[j], 1e-4f * (1.0f + std::fabs(both[j]))) << "output " << i << ", column " << j;
+        }
+    }
+    EXPECT_EQ(executor_.get_result(outputs[6].producer_node())->to_vector(),
+              executor_.get_result(outputs[0].producer_node())->to_vector());
+}
+
+TEST_F(KernelRegistryTest, CheapestAcceptingKernelWinsAndReplacementsReselect) {
+    auto a = values(4 * 4, 5);
+    Tensor sum = add(Tensor(a.data(), {4, 4}), Tensor(a.data(), {4, 4}));
+    TapeGenerator generator;
+    auto tape = generator.generate_tape(sum);
+
+    std::vector<std::string> ran;
+    auto recording = [&ran](const std::string& name) {
+        return [&ran, name](TapeOperation&, TapeExecutor&) { ran.push_back(name); };
+    };
+    auto accepts_sum = [node = sum.producer_node()](const TapeOperation& op) noexcept { return op.node_id == node; };
+    executor_.register_kernel(AddArgs::type_id(),
+                              {"cheap_elsewhere", [](const TapeOperation&) noexcept { return false; },
+                               [](const TapeOperation&) noexcept { return 0.0; }, recording("never")});
+    executor_.register_kernel(AddArgs::type_id(),
+                              {"cheaper", accepts_sum, [](const TapeOperation&) noexcept { return 1.0; },
+                               recording("cheaper")});
+    executor_.register_kernel(AddArgs::type_id(),
+                              {"pricey", {}, [](const TapeOperation&) noexcept { return 5.0; }, recording("pricey")});
+    EXPECT_EQ(executor_.kernels(AddArgs::type_id()).size(), 4u);
+
+    // The built-in add has no cost estimate (0), so it wins until it is priced out
+    executor_.select_kernels(*tape);
+    EXPECT_EQ(kernel_of(*tape, sum), "add");
+    executor_.register_kernel(AddArgs::type_id(), {"add", {}, [](const TapeOperation&) noexcept { return 3.0; },
+                                                   executor_.kernels(AddArgs::type_id())[0]->impl});
+    executor_.execute_tape(*tape);
+    EXPECT_EQ(kernel_of(*tape, sum), "cheaper") << "A replaced kernel is selected again";
+    EXPECT_EQ(ran, std::vector<std::string>{"cheaper"});
+
+    // A wrapper keeps dispatching to the kernels it replaced
+    auto wrapped = executor_.get_operation_handler(AddArgs::type_id());
+    executor_.register_operation(AddArgs::type_id(), [&](TapeOperation& op, TapeExecutor& executor) {
+        ran.push_back("wrapper");
+        wrapped(op, executor);
+    });
+    tape->find_operation(sum.producer_node())->is_evaluated = false;
+    executor_.execute_tape(*tape);
+    EXPECT_EQ(kernel_of(*tape, sum), "default");
+    EXPECT_EQ(ran, (std::vector<std::string>{"cheaper", "wrapper", "cheaper"}));
+
+    executor_.register_kernel(MultiplyArgs::type_id(),
+                              {"multiply", [](const TapeOperation&) noexcept { return false; }, {},
+                               recording("never")});
+    auto product = generator.generate_tape(multiply(Tensor(a.data(), {4, 4}), Tensor(a.data(), {4, 4})));
+    EXPECT_THROW(executor_.execute_tape(*product), std::runtime_error) << "No kernel accepts the operation";
+}
+
+TEST_F(KernelRegistryTest, BlasKernelsAreRegisteredOnlyWhenLinked) {
+    constexpr uint32_t M = 5, K = 40, N = 24;
+    auto a = values(M * K, 6);
+    auto b = values(N * K, 7);
+    Tensor lhs(a.data(), {M, K});
+    Tensor rhs_t(b.data(), {N, K});
+    Tensor rows = matmul(lhs, rhs_t, false, true);
+    Tensor row = matmul(Tensor(a.data(), {1, K}), rhs_t, false, true);
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({rows, row});
+    executor_.select_kernels(*tape);
+
+    size_t blas_kernels = 0;
+    for (const auto& kernel : executor_.kernels(MatMulArgs::type_id())) {
+        blas_kernels += kernel->name.rfind("matmul_blas", 0) == 0 ? 1U : 0U;
+    }
+    if (!math::blas_available()) {
+        EXPECT_EQ(blas_kernels, 0u);
+        EXPECT_EQ(kernel_of(*tape, rows), "matmul_gemm");
+        EXPECT_STREQ(math::blas_name(), "none");
+        float c = 0.0f;
+        EXPECT_THROW(math::blas_sgemm(1, 1, 1, &c, 1, false, &c, 1, false, &c, 1), std::runtime_error);
+        return;
+    }
+
+    // With BLAS linked its kernels win on cost, and agree with the built-in ones
+    EXPECT_EQ(blas_kernels, 2u);
+    EXPECT_EQ(kernel_of(*tape, rows), "matmul_blas_sgemm");
+    EXPECT_EQ(kernel_of(*tape, row), "matmul_blas_sgemv");
+    executor_.execute_tape(*tape);
+    Tensor expected({M, N});
+    math::matmul(lhs, rhs_t, expected, false, true);
+    auto actual = executor_.get_result(rows.producer_node())->to_vector();
+    auto first_row = executor_.get_result(row.producer_node())->to_vector();
+    for (size_t i = 0; i < actual.size(); ++i) {
+        float reference = expected.const_data_ptr()[i];
+        ASSERT_NEAR(actual[i], reference, 1e-4f * (1.0f + std::fabs(reference))) << "element " << i;
+        if (i < N) {
+            ASSERT_NEAR(first_row[i], reference, 1e-4f * (1.0f + std::fabs(reference))) << "element " << i;
+        }
+    }
+}
+
+TEST_F(KernelRegistryTest, TinyProductsSelectShapeSpecializedKernels) {
+    // Every specialization against a plain triple loop, with and without the epilogue
+    for (size_t m : {1u, 2u, 4u, 8u}) {
+        for (size_t n : {1u, 2u, 4u, 8u, 16u}) {
+            for (size_t k : {1u, 2u, 4u, 8u, 16u}) {
+                auto kernel = math::find_small_gemm(m, n, k);
+                ASSERT_NE(kernel, nullptr) << m << "x" << n << "x" << k;
+                auto a = values(m * k, 8);
+                auto b = values(k * n, 9);
+                auto bias = values(n, 10);
+                std::vector<float> plain(m * n), fused(m * n);
+                kernel(a.data(), b.data(), nullptr, false, plain.data());
+                kernel(a.data(), b.data(), bias.data(), true, fused.data());
+                for (size_t i = 0; i < m; ++i) {
+                    for (size_t j = 0; j < n; ++j) {
+                        float sum = 0.0f;
+                        for (size_t p = 0; p < k; ++p) {
+                            sum += a[i * k + p] * b[p * n + j];
+                        }
+                        ASSERT_NEAR(plain[i * n + j], sum, 1e-5f * (1.0f + std::fabs(sum)));
+                        ASSERT_NEAR(fused[i * n + j], std::max(0.0f, sum + bias[j]), 1e-5f * (1.0f + std::fabs(sum)));
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_EQ(math::find_small_gemm(3, 8, 4), nullptr);
+    EXPECT_EQ(math::find_small_gemm(2, 32, 4), nullptr);
+
+    // The demo MLP's shapes: 2x4 @ 4x8, then 2x8 @ 8x1
+    auto x = values(2 * 4, 11);
+    auto w1 = values(4 * 8, 12);
+    auto b1 = values(8, 13);
+    auto w2 = values(8 * 1, 14);
+    Tensor input(x.data(), {2, 4});
+    Tensor w1_t(w1.data(), {4, 8});
+    Tensor b1_t(b1.data(), {1, 8});
+    Tensor w2_t(w2.data(), {8, 1});
+    Tensor hidden = fused_mlp(input, w1_t, b1_t, true);
+    Tensor output = matmul(hidden, w2_t);
+    Tensor transposed = matmul(Tensor(x.data(), {4, 2}), w1_t, true, false);
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({output, transposed});
+    executor_.execute_tape(*tape);
+    EXPECT_EQ(kernel_of(*tape, hidden), "fused_mlp_small");
+    EXPECT_EQ(kernel_of(*tape, output), "matmul_small");
+    EXPECT_NE(kernel_of(*tape, transposed), "matmul_small") << "Transposed operands use the general kernels";
+
+    Tensor expected_hidden({2, 8});
+    Tensor expected_output({2, 1});
+    math::fused_mlp(input, w1_t, b1_t, expected_hidden, true);
+    math::matmul(expected_hidden, w2_t, expected_output);
+    auto actual_hidden = executor_.get_result(hidden.producer_node())->to_vector();
+    auto actual_output = executor_.get_result(output.producer_node())->to_vector();
+    for (size_t i = 0; i < actual_hidden.size(); ++i) {
+        ASSERT_NEAR(actual_hidden[i], expected_hidden.const_data_ptr()[i], 1e-5f) << "hidden " << i;
+    }
+    for (size_t i = 0; i < actual_output.size(); ++i) {
+        ASSERT_NEAR(actual_output[i], expected_output.const_data_ptr()[i], 1e-5f) << "output " << i;
+    }
+    auto rows = values(3 * 4, 15);
+    Tensor three_rows({3, 8});
+    EXPECT_THROW(math::matmul_small(Tensor(rows.data(), {3, 4}), w1_t, three_rows), std::runtime_error)
+        << "No specialization for 3 rows";
+}
@@ -0,0 +1,171 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "TapeEvaluationManager.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class LazyWindowTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        manager_ = std::make_shared<tt_lazy::TapeEvaluationManager>();
+        tt_lazy::set_evaluation_manager(manager_);
+    }
+
+    void TearDown() override {
+        tt_lazy::set_evaluation_manager(nullptr);
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    // `steps` iterations of x = relu(x + b), two nodes each, and the same loop on plain floats
+    Tensor stream(size_t steps) {
+        Tensor x(x_data_.data(), {2, 3});
+        for (size_t i = 0; i < steps; ++i) {
+            x = relu(add(x, b_));
+        }
+        return x;
+    }
+
+    std::vector<float> expected(size_t steps) const {
+        std::vector<float> x = x_data_;
+        for (size_t i = 0; i < steps; ++i) {
+            for (size_t j = 0; j < x.size(); ++j) {
+                x[j] = std::max(x[j] + b_data_[j % 3], 0.0f);
+            }
+        }
+        return x;
+    }
+
+    std::shared_ptr<tt_lazy::TapeEvaluationManager> manager_;
+    std::vector<float> x_data_{1.0f, -2.0f, 0.5f, 3.0f, 0.0f, 40.0f};
+    std::vector<float> b_data_{0.25f, 0.5f, -0.125f};
+    Tensor b_{b_data_.data(), {1, 3}};
+};
+
+TEST_F(LazyWindowTest, StreamingLoopStaysBounded) {
+    manager_->set_lazy_window({8, 0});
+
+    // 200 nodes built without reading anything: every eighth one flushes the window
+    Tensor x = stream(100);
+    const auto& window = manager_->window_stats();
+    EXPECT_EQ(window.flushes, 25);
+    EXPECT_EQ(window.flushed_nodes, 200);
+    EXPECT_EQ(window.largest_tape, 8);
+
+    // The result is the last flushed root
+    auto before = manager_->get_stats().operations_executed;
+    EXPECT_EQ(x.to_vector(), expected(100));
+    EXPECT_EQ(manager_->get_stats().operations_executed, before);
+
+    // A read past the last flush only runs the nodes since then
+    x = stream(3);
+    EXPECT_EQ(x.to_vector(), expected(3));
+    EXPECT_LE(manager_->last_tape_timing().operations, 8);
+}
+
+TEST_F(LazyWindowTest, ByteThresholdAndReleasedIntermediates) {
+    // 24-byte inputs: the window holds five nodes
+    manager_->set_lazy_window({0, 5 * 24});
+    Tensor x(x_data_.data(), {2, 3});
+    Tensor a = relu(add(x, b_));
+    Tensor c = add(a, a);
+    Tensor d = multiply(a, b_);
+    Tensor e = relu(d);
+    EXPECT_EQ(manager_->window_stats().flushes, 1);
+
+    // Both roots are materialized; the intermediate `a` was released and is recomputed
+    std::vector<float> a_values = expected(1);
+    std::vector<float> c_values;
+    std::vector<float> e_values;
+    for (size_t j = 0; j < a_values.size(); ++j) {
+        c_values.push_back(a_values[j] + a_values[j]);
+        e_values.push_back(std::max(a_values[j] * b_data_[j % 3], 0.0f));
+    }
+    EXPECT_EQ(c.to_vector(), c_values);
+    EXPECT_EQ(e.to_vector(), e_values);
+    EXPECT_EQ(a.to_vector(), a_values);
+}
+
+TEST_F(LazyWindowTest, LongStreamKeepsGraphAndResultsBounded) {
+    manager_->set_lazy_window({8, 0});
+
+    Tensor x(x_data_.data(), {2, 3});
+    Tensor early_intermediate = add(x, b_);
+    x = relu(early_intermediate);
+    x = relu(add(x, b_));
+    x = relu(add(x, b_));
+    x = relu(add(x, b_));
+    std::weak_ptr<Tensor> early_root = manager_->cached_result(x.producer_node());
+    ASSERT_FALSE(early_root.expired());
+
+    // 4000 nodes, 500 flushes: the graph and the results held stay within two windows
+    size_t largest_graph = 0;
+    size_t largest_cached = 0;
+    for (size_t i = 4; i < 2000; ++i) {
+        x = relu(add(x, b_));
+        largest_graph = std::max(largest_graph, Context::instance().size());
+        largest_cached = std::max(largest_cached, manager_->cached_bytes());
+    }
+    EXPECT_EQ(manager_->window_stats().flushes, 500);
+    EXPECT_LE(largest_graph, 16);
+    EXPECT_LE(largest_cached, 2 * x.nbytes());
+    EXPECT_TRUE(early_root.expired());
+    EXPECT_EQ(x.to_vector(), expected(2000));
+
+    // The graph behind the last flushes is gone, so its intermediates can no longer be read
+    EXPECT_THROW(early_intermediate.to_vector(), std::runtime_error);
+}
+
+TEST_F(LazyWindowTest, ReleasingNodesKeepsArgsOfTheRest) {
+    // Reduce dims live in an inline container, which must follow its node when the nodes
+    // before it are released
+    auto build = [this]() {
+        std::vector<Tensor> sums;
+        Tensor x(x_data_.data(), {2, 3});
+        for (int32_t i = 0; i < 4; ++i) {
+            sums.push_back(reduce_sum(x, {i % 2}, true));
+            x = relu(add(x, sums.back()));
+        }
+        sums.push_back(reduce_sum(x, {0}, true));
+        return sums;
+    };
+    std::vector<Tensor> plain = build();
+    std::vector<float> last_flushed = plain[3].to_vector();
+    std::vector<float> pending = plain[4].to_vector();
+    Context::instance().clear();
+    manager_->clear_cache();
+
+    // Four flushes: the last one covers plain[3], and the graph before it is released
+    manager_->set_lazy_window({3, 0});
+    std::vector<Tensor> windowed = build();
+    EXPECT_EQ(manager_->window_stats().flushes, 4);
+    EXPECT_EQ(windowed[3].to_vector(), last_flushed);
+    EXPECT_EQ(windowed[4].to_vector(), pending);
+}
+
+TEST_F(LazyWindowTest, ClearedGraphAndDeactivation) {
+    manager_->set_lazy_window({4, 0});
+    stream(10);
+    EXPECT_EQ(manager_->window_stats().flushes, 5);
+
+    // Node ids start over after a clear, so the old results must not be read
+    Context::instance().clear();
+    Tensor x = stream(5);
+    EXPECT_EQ(x.to_vector(), expected(5));
+
+    // Deselected, the manager no longer sees graph building
+    tt_lazy::set_evaluation_manager(nullptr);
+    manager_->clear_cache();
+    Tensor y = stream(10);
+    EXPECT_EQ(manager_->window_stats().flushes, 0);
+    EXPECT_FALSE(y.is_evaluated());
+    EXPECT_EQ(y.to_vector(), expected(10));
+}
@@ -0,0 +1,162 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "ShardedRuntime.hpp"
+#include "TapeGenerator.hpp"
+#include "operations.hpp"
+#include "passes/ShardingPass.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <signal.h>
+
+class ShardedRuntimeTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t BATCH = 3;
+    static constexpr uint32_t IN = 8;
+    static constexpr uint32_t HIDDEN = 10;  // Not divisible by 3 or 4: shards are uneven
+    static constexpr uint32_t OUT = 6;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        fill(x_, 0.1f);
+        fill(w1_, -0.05f);
+        fill(b1_, 0.2f);
+        fill(w2_, 0.03f);
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static void fill(std::vector<float>& data, float scale) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = scale * static_cast<float>(static_cast<int>(i % 11) - 5);
+        }
+    }
+
+    // relu(x @ w1 + b1) @ w2^T, then a small unsharded reduction
+    Tensor build() {
+        Tensor x(x_.data(), {BATCH, IN});
+        Tensor w1(w1_.data(), {IN, HIDDEN});
+        Tensor b1(b1_.data(), {1, HIDDEN});
+        Tensor w2(w2_.data(), {OUT, HIDDEN});
+        hidden_ = fused_mlp(x, w1, b1, true);
+        projected_ = matmul(hidden_, w2, false, true);
+        return reduce_sum(projected_, {1}, true);
+    }
+
+    std::vector<float> evaluate_locally(const Tensor& output) {
+        std::vector<float> result(output.total_elements());
+        tt_lazy::eval_into(output, result.data(), result.size());
+        return result;
+    }
+
+    std::unique_ptr<Tape> sharded_tape(const Tensor& output, uint32_t num_shards, uint32_t min_columns = 1) {
+        TapeGenerator generator;
+        auto tape = generator.generate_tape(output);
+        ShardingPass pass(num_shards, min_columns);
+        pass.apply(*tape, {output});
+        return tape;
+    }
+
+    std::vector<float> x_ = std::vector<float>(BATCH * IN);
+    std::vector<float> w1_ = std::vector<float>(IN * HIDDEN);
+    std::vector<float> b1_ = std::vector<float>(HIDDEN);
+    std::vector<float> w2_ = std::vector<float>(OUT * HIDDEN);
+    Tensor hidden_;
+    Tensor projected_;
+};
+
+TEST_F(ShardedRuntimeTest, ShardRangesCoverColumnsExactly) {
+    uint32_t next = 0;
+    for (uint32_t shard = 0; shard < 4; ++shard) {
+        auto [begin, end] = ShardSpec::range(10, 4, shard);
+        EXPECT_EQ(begin, next);
+        EXPECT_GE(end - begin, 2u);
+        EXPECT_LE(end - begin, 3u);
+        next = end;
+    }
+    EXPECT_EQ(next, 10u);
+}
+
+TEST_F(ShardedRuntimeTest, PassAnnotatesWeightBoundOperations) {
+    Tensor output = build();
+    auto tape = sharded_tape(output, 4, HIDDEN);
+
+    // Only the FusedMLP has enough columns; the reduction can never be sharded
+    EXPECT_EQ(tape->find_operation(hidden_.producer_node())->shard.num_shards, 4u);
+    EXPECT_FALSE(tape->find_operation(projected_.producer_node())->shard.is_sharded());
+    EXPECT_FALSE(tape->find_operation(output.producer_node())->shard.is_sharded());
+
+    std::ostringstream os;
+    tape->print_tape(os);
+    EXPECT_NE(os.str().find("sharded x4"), std::string::npos) << os.str();
+}
+
+TEST_F(ShardedRuntimeTest, ShardedExecutionMatchesLocal) {
+    Tensor output = build();
+    std::vector<float> expected_projection = evaluate_locally(projected_);
+    std::vector<float> expected = evaluate_locally(output);
+
+    ShardedRuntime runtime(sharded_tape(output, 3));
+    EXPECT_EQ(runtime.num_shards(), 3u);
+    ASSERT_EQ(runtime.worker_pids().size(), 3u);
+
+    auto result = runtime.execute(output);
+    ASSERT_EQ(result->total_elements(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result->const_data_ptr()[i], expected[i], 1e-4f) << "at " << i;
+    }
+
+    auto projection = runtime.execute(projected_);
+    for (size_t i = 0; i < expected_projection.size(); ++i) {
+        EXPECT_NEAR(projection->const_data_ptr()[i], expected_projection[i], 1e-4f) << "at " << i;
+    }
+
+    auto stats = runtime.stats();
+    EXPECT_EQ(stats.sharded_operations, 4u);  // Two sharded ops, two runs
+    EXPECT_EQ(stats.local_operations, 2u);
+    EXPECT_EQ(stats.gathered_bytes, 2 * (BATCH * HIDDEN + BATCH * OUT) * sizeof(float));
+}
+
+TEST_F(ShardedRuntimeTest, RerunsWithUpdatedInputs) {
+    Tensor output = build();
+    ShardedRuntime runtime(sharded_tape(output, 2));
+    runtime.execute(output);
+
+    // Workers keep their weight slices; new activations are published on every run
+    fill(x_, -0.2f);
+    auto result = runtime.execute(output);
+    std::vector<float> updated(result->const_data_ptr(), result->const_data_ptr() + result->total_elements());
+
+    tt_lazy::get_evaluation_manager().clear_cache();
+    std::vector<float> expected = evaluate_locally(output);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(updated[i], expected[i], 1e-4f) << "at " << i;
+    }
+}
+
+TEST_F(ShardedRuntimeTest, ReportsLostWorkers) {
+    Tensor output = build();
+    ShardedRuntime runtime(sharded_tape(output, 2));
+    kill(runtime.worker_pids()[1], SIGKILL);
+    EXPECT_THROW(runtime.execute(output), std::runtime_error);
+}
+
+TEST_F(ShardedRuntimeTest, UnshardedTapeRunsWithoutWorkers) {
+    Tensor output = build();
+    std::vector<float> expected = evaluate_locally(output);
+
+    TapeGenerator generator;
+    ShardedRuntime runtime(generator.generate_tape(output));
+    EXPECT_EQ(runtime.num_shards(), 0u);
+    EXPECT_TRUE(runtime.worker_pids().empty());
+    auto result = runtime.execute(output);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result->const_data_ptr()[i], expected[i], 1e-4f);
+    }
+}
@@ -0,0 +1,102 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "operations.hpp"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class SpillTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t ROWS = 16;
+    static constexpr uint32_t WIDTH = 32;
+    static constexpr size_t LAYERS = 6;
+    static constexpr size_t RESULT_BYTES = ROWS * WIDTH * sizeof(float);
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        input_.resize(ROWS * WIDTH);
+        for (size_t i = 0; i < input_.size(); ++i) {
+            input_[i] = 0.05f * static_cast<float>(static_cast<int>(i % 17) - 8);
+        }
+        weights_.resize(LAYERS, std::vector<float>(WIDTH * WIDTH));
+        for (size_t layer = 0; layer < LAYERS; ++layer) {
+            for (size_t i = 0; i < weights_[layer].size(); ++i) {
+                weights_[layer][i] = 0.02f * static_cast<float>(static_cast<int>((i + 3 * layer) % 11) - 5);
+            }
+        }
+    }
+
+    void TearDown() override {
+        tt_lazy::get_evaluation_manager().set_memory_budget(0);
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    // A deep chain whose first activations are consumed again at the very end (skip
+    // connections), so they stay live while every later layer is computed
+    std::vector<float> run() {
+        Tensor x(input_.data(), {ROWS, WIDTH});
+        std::vector<Tensor> activations;
+        for (size_t layer = 0; layer < LAYERS; ++layer) {
+            x = relu(matmul(x, Tensor(weights_[layer].data(), {WIDTH, WIDTH})));
+            activations.push_back(x);
+        }
+        for (size_t skip = 0; skip < 3; ++skip) {
+            x = add(x, activations[skip]);
+        }
+        x.eval();
+        std::vector<float> result = x.to_vector();
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        return result;
+    }
+
+    std::vector<float> input_;
+    std::vector<std::vector<float>> weights_;
+};
+
+TEST_F(SpillTest, DisabledByDefault) {
+    auto& manager = tt_lazy::get_evaluation_manager();
+    EXPECT_EQ(manager.memory_budget(), 0u);
+    run();
+    auto stats = manager.get_spill_stats();
+    EXPECT_EQ(stats.spilled_bytes, 0u);
+    EXPECT_EQ(stats.peak_resident_bytes, 0u);
+}
+
+TEST_F(SpillTest, SpilledRunMatchesUnlimitedRun) {
+    std::vector<float> expected = run();
+
+    auto& manager = tt_lazy::get_evaluation_manager();
+    manager.set_memory_budget(4 * RESULT_BYTES);
+    EXPECT_EQ(manager.memory_budget(), 4 * RESULT_BYTES);
+    std::vector<float> result = run();
+
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(result[i], expected[i]) << "at " << i;
+    }
+
+    auto stats = manager.get_spill_stats();
+    EXPECT_GT(stats.spill_count, 0u);
+    EXPECT_EQ(stats.spilled_bytes, stats.spill_count * RESULT_BYTES);
+    EXPECT_GT(stats.restore_count, 0u);
+    EXPECT_LE(stats.restored_bytes, stats.spilled_bytes);
+    EXPECT_GT(stats.dropped_bytes, 0u);  // Layer outputs consumed once are released, not written
+}
+
+TEST_F(SpillTest, ResidentResultsStayWithinBudget) {
+    auto& manager = tt_lazy::get_evaluation_manager();
+    manager.set_memory_budget(4 * RESULT_BYTES);
+    run();
+    auto stats = manager.get_spill_stats();
+    EXPECT_GT(stats.peak_resident_bytes, 0u);
+    EXPECT_LE(stats.peak_resident_bytes, 4 * RESULT_BYTES);
+
+    // Budgets too small for a single operation still complete; they just spill everything
+    manager.set_memory_budget(1);
+    EXPECT_EQ(run().size(), ROWS * WIDTH);
+    EXPECT_GT(manager.get_spill_stats().spill_count, 0u);
+}
@@ -0,0 +1,148 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class TopKTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t ROWS = 64;
+    static constexpr uint32_t CLASSES = 1000;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        // Few distinct values, so rows are full of ties
+        logits_.resize(ROWS * CLASSES);
+        for (size_t i = 0; i < logits_.size(); ++i) {
+            logits_[i] = static_cast<float>((i * 7919) % 211) * 0.25f - 20.0f;
+        }
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    // Positions of the k largest values of a row: larger first, then lower position first
+    std::vector<size_t> reference(const float* row, size_t n, size_t stride, size_t k) const {
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return row[a * stride] > row[b * stride]; });
+        order.resize(k);
+        return order;
+    }
+
+    std::vector<float> logits_;
+};
+
+TEST_F(TopKTest, MatchesStableSortAlongLastDim) {
+    constexpr uint32_t K = 5;
+    Tensor logits(logits_.data(), {ROWS, CLASSES});
+    auto [values, indices] = topk(logits, K);
+    EXPECT_EQ(values.size(0), ROWS);
+    EXPECT_EQ(values.size(1), K);
+    EXPECT_EQ(indices.size(1), K);
+
+    indices.eval();
+    values.eval();
+    auto value_data = values.to_vector();
+    auto index_data = indices.to_vector();
+    for (size_t row = 0; row < ROWS; ++row) {
+        auto expected = reference(logits_.data() + row * CLASSES, CLASSES, 1, K);
+        for (size_t j = 0; j < K; ++j) {
+            EXPECT_EQ(index_data[row * K + j], static_cast<float>(expected[j])) << "row " << row;
+            EXPECT_EQ(value_data[row * K + j], logits_[row * CLASSES + expected[j]]) << "row " << row;
+        }
+    }
+}
+
+TEST_F(TopKTest, LeadingDimAndArgMax) {
+    Tensor logits(logits_.data(), {ROWS, CLASSES});
+
+    // Along dim 0 every column is a strided row
+    auto [values, indices] = topk(logits, 3, 0);
+    EXPECT_EQ(indices.size(0), 3u);
+    EXPECT_EQ(indices.size(1), CLASSES);
+    auto index_data = indices.to_vector();
+    for (size_t column = 0; column < CLASSES; column += 97) {
+        auto expected = reference(logits_.data() + column, ROWS, CLASSES, 3);
+        for (size_t j = 0; j < 3; ++j) {
+            EXPECT_EQ(index_data[j * CLASSES + column], static_cast<float>(expected[j])) << "column " << column;
+        }
+    }
+
+    Tensor best = argmax(logits, 1);
+    ASSERT_EQ(best.rank(), 1);
+    EXPECT_EQ(best.size(0), ROWS);
+    auto best_data = best.to_vector();
+    for (size_t row = 0; row < ROWS; ++row) {
+        EXPECT_EQ(best_data[row], static_cast<float>(reference(logits_.data() + row * CLASSES, CLASSES, 1, 1)[0]));
+    }
+
+    std::vector<float> single = {1.0f, 9.0f, 9.0f, -3.0f};
+    Tensor single_best = argmax(Tensor(single.data(), {4}));
+    EXPECT_EQ(single_best.size(0), 1u);
+    EXPECT_EQ(single_best.to_vector()[0], 1.0f);
+}
+
+TEST_F(TopKTest, IndicesFeedGatherAndBadArgumentsThrow) {
+    // Label lookup on the predicted classes stays inside the graph
+    std::vector<float> labels(CLASSES * 2);
+    for (size_t i = 0; i < labels.size(); ++i) {
+        labels[i] = static_cast<float>(i);
+    }
+    Tensor predicted = gather(Tensor(labels.data(), {CLASSES, 2}), argmax(Tensor(logits_.data(), {ROWS, CLASSES})));
+    EXPECT_EQ(predicted.size(0), ROWS);
+    EXPECT_EQ(predicted.size(1), 2u);
+    auto predicted_data = predicted.to_vector();
+    for (size_t row = 0; row < ROWS; ++row) {
+        size_t expected = reference(logits_.data() + row * CLASSES, CLASSES, 1, 1)[0];
+        EXPECT_EQ(predicted_data[row * 2], static_cast<float>(expected * 2));
+    }
+
+    Tensor logits(logits_.data(), {ROWS, CLASSES});
+    EXPECT_THROW(topk(logits, 0), std::runtime_error);
+    EXPECT_THROW(topk(logits, CLASSES + 1), std::runtime_error);
+    EXPECT_THROW(argmax(logits, 2), std::runtime_error);
+}
+
+TEST_F(TopKTest, NaNRanksFirst) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    // Wherever the NaN sits, including the seed position, it wins
+    std::vector<float> leading = {nan, 1.0f, 5.0f, 9.0f};
+    std::vector<float> middle = {1.0f, 5.0f, nan, 9.0f};
+    EXPECT_EQ(argmax(Tensor(leading.data(), {4})).to_vector()[0], 0.0f);
+    EXPECT_EQ(argmax(Tensor(middle.data(), {4})).to_vector()[0], 2.0f);
+
+    // A long row goes through the block filter; NaNs rank first, in position order
+    std::vector<float> row(100);
+    for (size_t i = 0; i < row.size(); ++i) {
+        row[i] = static_cast<float>(i % 37);
+    }
+    row[70] = nan;
+    row[40] = nan;
+    auto [values, indices] = topk(Tensor(row.data(), {100}), 4);
+    auto value_data = values.to_vector();
+    EXPECT_EQ(indices.to_vector(), (std::vector<float>{40.0f, 70.0f, 36.0f, 73.0f}));
+    EXPECT_TRUE(std::isnan(value_data[0]));
+    EXPECT_TRUE(std::isnan(value_data[1]));
+    EXPECT_EQ(value_data[2], 36.0f);
+    EXPECT_EQ(value_data[3], 36.0f);
+}
+
+TEST_F(TopKTest, RejectsDimsPastExactFloatPositions) {
+    // Borrowed and never read: the check happens while building the graph
+    std::vector<float> wide((size_t{1} << 24U) + 1);
+    Tensor input(wide.data(), {static_cast<uint32_t>(wide.size())});
+    EXPECT_THROW(argmax(input), std::runtime_error);
+    EXPECT_THROW(topk(input, 1), std::runtime_error);
+}
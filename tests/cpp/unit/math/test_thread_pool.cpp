@@ -0,0 +1,77 @@
+#include "kernel_utils.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+class ThreadPoolTest : public ::testing::Test {
+   protected:
+    void SetUp() override { math::set_thread_budget(4); }
+    void TearDown() override { math::set_thread_budget(0); }
+};
+
+TEST_F(ThreadPoolTest, CoversEveryIndexOnce) {
+    std::vector<int> hits(10000, 0);
+    for (int round = 0; round < 20; ++round) {
+        math::parallel_for(hits.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                hits[i]++;
+            }
+        });
+    }
+    EXPECT_EQ(std::accumulate(hits.begin(), hits.end(), 0), 20 * 10000);
+    EXPECT_EQ(*std::min_element(hits.begin(), hits.end()), 20);
+}
+
+TEST_F(ThreadPoolTest, ForwardsExceptionsAfterAllChunks) {
+    std::atomic<size_t> done{0};
+    auto run = [&] {
+        math::parallel_for(64, 1, [&](size_t begin, size_t end) {
+            if (begin == 0) {
+                throw std::runtime_error("chunk failed");
+            }
+            done += end - begin;
+        });
+    };
+    EXPECT_THROW(run(), std::runtime_error);
+    EXPECT_EQ(done.load(), 48);  // The three other chunks of 16 still ran
+
+    // The pool stays usable
+    std::atomic<size_t> total{0};
+    math::parallel_for(64, 1, [&](size_t begin, size_t end) { total += end - begin; });
+    EXPECT_EQ(total.load(), 64);
+}
+
+TEST_F(ThreadPoolTest, NestedCallsRunInline) {
+    std::atomic<size_t> total{0};
+    math::parallel_for(8, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            math::parallel_for(100, 1, [&](size_t b, size_t e) { total += e - b; });
+        }
+    });
+    EXPECT_EQ(total.load(), 800);
+}
+
+TEST_F(ThreadPoolTest, ForkedChildBuildsItsOwnPool) {
+    std::atomic<size_t> total{0};
+    math::parallel_for(64, 1, [&](size_t begin, size_t end) { total += end - begin; });
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::atomic<size_t> child_total{0};
+        math::parallel_for(64, 1, [&](size_t begin, size_t end) { child_total += end - begin; });
+        _exit(child_total.load() == 64 ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
@@ -143,3 +143,47 @@ TEST_F(ContextTest, Clear) {
     ctx.clear();
     EXPECT_EQ(ctx.size(), 0);
 }
+
+TEST_F(ContextTest, EmplaceNodeCopiesInputsAndLinksProducers) {
+    auto& ctx = Context::instance();
+
+    float data[100];
+    Tensor input(data, {10, 10});
+    Tensor hidden = relu(input);
+
+    NodeId id = ctx.emplace_node(MatMulArgs{}, hidden, input);
+    const Node* node = ctx.get_node(id);
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(node->op_name(), "MatMul");
+    ASSERT_EQ(node->inputs().size(), 2);
+    EXPECT_EQ(node->inputs()[0].producer_node(), hidden.producer_node());
+    EXPECT_TRUE(node->inputs()[1].is_constant());
+
+    const Node* producer = ctx.get_node(hidden.producer_node());
+    ASSERT_EQ(producer->output_nodes().size(), 1);
+    EXPECT_EQ(producer->output_nodes()[0], id);
+
+    // Ids index the node array directly; unknown ids find nothing
+    EXPECT_EQ(ctx.get_node(INVALID_NODE_ID), nullptr);
+    EXPECT_EQ(ctx.get_node(id + 1), nullptr);
+    ctx.clear();
+    EXPECT_EQ(ctx.get_node(id), nullptr);
+}
+
+TEST_F(ContextTest, StatsByOpName) {
+    auto& ctx = Context::instance();
+
+    float data[100];
+    Tensor input(data, {10, 10});
+
+    auto matmul_result = matmul(input, input);
+    auto relu1 = relu(matmul_result);
+    auto relu2 = relu(relu1);
+
+    auto stats = ctx.get_stats();
+    EXPECT_EQ(stats.total_nodes, 3);
+    EXPECT_EQ(stats.op_counts["MatMul"], 1);
+    EXPECT_EQ(stats.op_counts["ReLU"], 2);
+
+    ctx.print_stats();
+}
@@ -0,0 +1,131 @@
+#include "DatasetReader.hpp"
+#include "MemoryManager.hpp"
+#include "NpyFormat.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+class DatasetReaderTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t ROWS = 23;
+    static constexpr uint32_t WIDTH = 5;
+
+    void SetUp() override {
+        base_ = "/tmp/tt_lazy_dataset_" + std::to_string(getpid());
+        values_.resize(ROWS * WIDTH);
+        for (size_t i = 0; i < values_.size(); ++i) {
+            values_[i] = static_cast<float>(i) * 0.5f;
+        }
+    }
+
+    void TearDown() override {
+        std::remove((base_ + ".npy").c_str());
+        std::remove((base_ + ".f32").c_str());
+    }
+
+    std::string write_file(bool npy_format, const std::string& header_override = "") {
+        std::string path = base_ + (npy_format ? ".npy" : ".f32");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!header_override.empty()) {
+            file << header_override;
+        } else if (npy_format) {
+            file << npy::make_header(ROWS, WIDTH);
+        }
+        file.write(reinterpret_cast<const char*>(values_.data()),
+                   static_cast<std::streamsize>(values_.size() * sizeof(float)));
+        return path;
+    }
+
+    // Read every batch and check it against the source rows
+    void expect_all_rows(DatasetReader& reader, uint32_t batch_rows) {
+        uint64_t row = 0;
+        while (Tensor batch = reader.next()) {
+            ASSERT_EQ(batch.rank(), 2);
+            ASSERT_EQ(batch.shape()[1], WIDTH);
+            EXPECT_EQ(batch.shape()[0], std::min<uint64_t>(batch_rows, ROWS - row));
+            EXPECT_TRUE(batch.is_constant());
+            for (size_t i = 0; i < batch.total_elements(); ++i) {
+                ASSERT_EQ(batch.const_data_ptr()[i], values_[row * WIDTH + i]) << "row " << row;
+            }
+            row += batch.shape()[0];
+        }
+        EXPECT_EQ(row, ROWS);
+    }
+
+    std::string base_;
+    std::vector<float> values_;
+};
+
+TEST_F(DatasetReaderTest, ReadsNpyInBatchesWithEveryIoMode) {
+    std::string path = write_file(true);
+    for (auto mode : {DatasetReader::IoMode::PREAD, DatasetReader::IoMode::MMAP}) {
+        for (size_t prefetch : {size_t{0}, size_t{1}, size_t{3}}) {
+            DatasetReader::Options options;
+            options.batch_rows = 4;
+            options.io_mode = mode;
+            options.prefetch_batches = prefetch;
+            DatasetReader reader(path, options);
+            EXPECT_EQ(reader.num_rows(), ROWS);
+            EXPECT_EQ(reader.row_width(), WIDTH);
+            expect_all_rows(reader, 4);
+
+            auto stats = reader.stats();
+            EXPECT_EQ(stats.batches, 6u);
+            EXPECT_EQ(stats.rows, ROWS);
+            EXPECT_EQ(stats.bytes_read, ROWS * WIDTH * sizeof(float));
+        }
+    }
+}
+
+TEST_F(DatasetReaderTest, ReadsRawRowsAndRewinds) {
+    std::string path = write_file(false);
+    DatasetReader::Options options;
+    options.batch_rows = 10;
+    EXPECT_THROW(DatasetReader(path, options), std::runtime_error);  // Raw files need a width
+
+    options.row_width = WIDTH;
+    DatasetReader reader(path, options);
+    expect_all_rows(reader, 10);
+    EXPECT_FALSE(reader.next());
+    reader.rewind();
+    expect_all_rows(reader, 10);
+
+    options.row_width = 4;  // 23 * 5 values are not whole 4-value rows
+    EXPECT_THROW(DatasetReader(path, options), std::runtime_error);
+}
+
+TEST_F(DatasetReaderTest, BatchesComeFromTheMemoryPool) {
+    std::string path = write_file(true);
+    DatasetReader::Options options;
+    options.batch_rows = 8;
+    DatasetReader reader(path, options);
+
+    size_t before = MemoryManager::instance().get_stats().active_tensors;
+    {
+        Tensor batch = reader.next();
+        EXPECT_TRUE(batch.owns_external_memory());
+        EXPECT_GT(MemoryManager::instance().get_stats().active_tensors, before);
+    }
+    while (reader.next()) {
+    }
+    EXPECT_EQ(MemoryManager::instance().get_stats().active_tensors, before);
+}
+
+TEST_F(DatasetReaderTest, RejectsUnsupportedNpyFiles) {
+    std::string header = npy::make_header(ROWS, WIDTH);
+    header.replace(header.find("<f4"), 3, "<f8");
+    std::string path = write_file(true, header);
+    EXPECT_THROW(DatasetReader(path, DatasetReader::Options{}), std::runtime_error);
+
+    DatasetReader::Options options;
+    options.row_width = WIDTH + 1;
+    path = write_file(true);
+    EXPECT_THROW(DatasetReader(path, options), std::runtime_error);
+
+    EXPECT_EQ(npy::make_header(1, 1, 4096).size(), 4096u);
+}
@@ -0,0 +1,138 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "GemmAutotuner.hpp"
+#include "TapeGenerator.hpp"
+#include "gemm_tuning.hpp"
+#include "operations.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+class GemmTuningTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        path_ = "/tmp/tt_lazy_gemm_tuning_" + std::to_string(getpid()) + "/cache.txt";
+        math::GemmTuningCache::instance().clear();
+        Context::instance().clear();
+    }
+
+    void TearDown() override {
+        math::GemmTuningCache::instance().clear();
+        std::remove(path_.c_str());
+        std::remove(path_.substr(0, path_.rfind('/')).c_str());
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static std::vector<float> values(size_t count, size_t seed) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<float>((i * 7919 + seed * 104729) % 23) * 0.1f - 1.1f;
+        }
+        return data;
+    }
+
+    std::string path_;
+};
+
+TEST_F(GemmTuningTest, TunedConfigurationComputesTheSameProduct) {
+    constexpr size_t M = 37, N = 70, K = 300;
+    auto a = values(K * M, 1);
+    auto b = values(N * K, 2);
+    std::vector<float> expected(M * N), tuned(M * N);
+    math::gemm(M, N, K, a.data(), M, true, b.data(), K, true, expected.data(), N, nullptr, false);
+
+    math::GemmKey key{M, N, K, true, true};
+    math::GemmTuneOptions options;
+    options.repeat = 1;
+    options.max_threads = 2;
+    auto entry = math::tune_gemm(key, options);
+    EXPECT_GT(entry.microseconds, 0.0);
+    EXPECT_LE(entry.config.threads, 2u);
+    ASSERT_TRUE(math::GemmTuningCache::instance().find(key).has_value());
+    EXPECT_FALSE(math::GemmTuningCache::instance().find({M, N, K, false, true}).has_value());
+
+    // gemm() now picks up the tuned blocking; the result must not change beyond rounding
+    math::gemm(M, N, K, a.data(), M, true, b.data(), K, true, tuned.data(), N, nullptr, false);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_NEAR(tuned[i], expected[i], 1e-3f * (1.0f + std::fabs(expected[i]))) << "element " << i;
+    }
+}
+
+TEST_F(GemmTuningTest, CacheRoundTripsAndKeepsOtherCpus) {
+    auto& cache = math::GemmTuningCache::instance();
+    math::GemmTuningCache::Entry entry;
+    entry.config.blocking = {48, 128, 1024};
+    entry.config.threads = 3;
+    entry.microseconds = 12.5;
+    cache.insert({64, 256, 512, false, true}, entry);
+
+    // A missing file loads nothing; saving creates the directory
+    EXPECT_EQ(cache.load(path_), 0u);
+    {
+        std::ofstream file(path_);
+        EXPECT_FALSE(file.is_open()) << "Directory should not exist yet";
+    }
+    cache.save(path_);
+    {
+        std::ofstream file(path_, std::ios::app);
+        file << "Some Other CPU\tgemm\tf32\t1 2 3 0 0\t24 64 256 1\t1.5\n";
+        file << "malformed line\n";
+    }
+
+    cache.clear();
+    EXPECT_FALSE(cache.find({64, 256, 512, false, true}).has_value());
+    EXPECT_EQ(cache.load(path_), 1u);
+    auto loaded = cache.find({64, 256, 512, false, true});
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->blocking.mc, 48u);
+    EXPECT_EQ(loaded->blocking.kc, 128u);
+    EXPECT_EQ(loaded->blocking.nc, 1024u);
+    EXPECT_EQ(loaded->threads, 3u);
+    EXPECT_FALSE(cache.find({1, 2, 3, false, false}).has_value()) << "Measured on another CPU";
+
+    // Saving again keeps the other CPU's entry in the file
+    cache.save(path_);
+    std::ifstream file(path_);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(contents.find("Some Other CPU\tgemm\tf32\t1 2 3 0 0"), std::string::npos);
+    EXPECT_NE(contents.find(math::GemmTuningCache::cpu_model() + "\tgemm\tf32\t64 256 512 0 1\t48 128 1024 3"),
+              std::string::npos);
+}
+
+TEST_F(GemmTuningTest, AutotunerTunesTheShapesOfATape) {
+    constexpr uint32_t N = 8, I = 24, H = 40, O = 6;
+    auto x = values(N * I, 3);
+    auto w1 = values(I * H, 4);
+    auto b1 = values(H, 5);
+    auto w2 = values(O * H, 6);
+    Tensor hidden = fused_mlp(Tensor(x.data(), {N, I}), Tensor(w1.data(), {I, H}), Tensor(b1.data(), {1, H}), true);
+    Tensor output = matmul(hidden, Tensor(w2.data(), {O, H}), false, true);
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({output});
+    auto keys = tape_gemm_keys(*tape);
+    ASSERT_EQ(keys.size(), 2u);
+    EXPECT_TRUE((keys[0] == math::GemmKey{N, H, I, false, false}));
+    EXPECT_TRUE((keys[1] == math::GemmKey{N, O, H, false, true}));
+
+    math::GemmTuneOptions options;
+    options.repeat = 1;
+    options.max_threads = 1;
+    GemmAutotuner autotuner(path_, options);
+    autotuner.on_tape_begin(*tape);
+    autotuner.on_tape_end(*tape);
+    EXPECT_EQ(autotuner.tuned_shapes(), 2u);
+    autotuner.on_tape_begin(*tape);
+    EXPECT_EQ(autotuner.tuned_shapes(), 2u) << "Tuned shapes are not tuned again";
+
+    math::GemmTuningCache::instance().clear();
+    EXPECT_EQ(math::GemmTuningCache::instance().load(path_), 2u);
+}
@@ -0,0 +1,134 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "MappedWeightFile.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "WeightPrefetcher.hpp"
+#include "operations.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+class MappedWeightsTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t WIDTH = 40;
+    static constexpr size_t LAYERS = 4;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        path_ = "/tmp/tt_lazy_weights_" + std::to_string(getpid()) + ".bin";
+        for (size_t layer = 0; layer < LAYERS; ++layer) {
+            storage_.emplace_back(WIDTH * WIDTH);
+            for (size_t i = 0; i < storage_.back().size(); ++i) {
+                storage_.back()[i] = 0.01f * static_cast<float>(static_cast<int>((i + layer) % 13) - 6);
+            }
+        }
+        input_.assign(2 * WIDTH, 0.5f);
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        std::remove(path_.c_str());
+    }
+
+    std::vector<std::pair<std::string, Tensor>> in_memory_weights() {
+        std::vector<std::pair<std::string, Tensor>> weights;
+        for (size_t layer = 0; layer < LAYERS; ++layer) {
+            weights.emplace_back("layer" + std::to_string(layer), Tensor(storage_[layer].data(), {WIDTH, WIDTH}));
+        }
+        return weights;
+    }
+
+    // relu(... relu(x @ w0) ... @ wN)
+    template <typename GetWeight>
+    Tensor build(GetWeight get_weight) {
+        Tensor x(input_.data(), {2, WIDTH});
+        for (size_t layer = 0; layer < LAYERS; ++layer) {
+            x = relu(matmul(x, get_weight("layer" + std::to_string(layer))));
+        }
+        return x;
+    }
+
+    std::string path_;
+    std::vector<std::vector<float>> storage_;
+    std::vector<float> input_;
+};
+
+TEST_F(MappedWeightsTest, RoundTripsPageAlignedWeights) {
+    MappedWeightFile::write(path_, in_memory_weights());
+    auto file = MappedWeightFile::open(path_);
+    EXPECT_EQ(file->names().size(), LAYERS);
+    EXPECT_TRUE(file->contains("layer2"));
+    EXPECT_FALSE(file->contains("missing"));
+    EXPECT_THROW(file->get("missing"), std::runtime_error);
+
+    for (size_t layer = 0; layer < LAYERS; ++layer) {
+        Tensor weight = file->get("layer" + std::to_string(layer));
+        ASSERT_EQ(weight.total_elements(), WIDTH * WIDTH);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(weight.const_data_ptr()) % MappedWeightFile::DATA_ALIGNMENT, 0u);
+        EXPECT_TRUE(file->contains_address(weight.const_data_ptr()));
+        for (size_t i = 0; i < storage_[layer].size(); ++i) {
+            ASSERT_EQ(weight.const_data_ptr()[i], storage_[layer][i]);
+        }
+    }
+    EXPECT_LE(file->resident_bytes(), file->mapped_bytes() + MappedWeightFile::DATA_ALIGNMENT);
+}
+
+TEST_F(MappedWeightsTest, TensorsKeepTheMappingAlive) {
+    MappedWeightFile::write(path_, in_memory_weights());
+    Tensor weight = MappedWeightFile::open(path_)->get("layer1");
+    EXPECT_EQ(weight.const_data_ptr()[5], storage_[1][5]);
+}
+
+TEST_F(MappedWeightsTest, RejectsInvalidFiles) {
+    EXPECT_THROW(MappedWeightFile::open(path_), std::runtime_error);
+    FILE* file = std::fopen(path_.c_str(), "wb");
+    std::fputs("definitely not a weight file, but long enough for a header", file);
+    std::fclose(file);
+    EXPECT_THROW(MappedWeightFile::open(path_), std::runtime_error);
+}
+
+TEST_F(MappedWeightsTest, PrefetcherStreamsEveryWeightOnce) {
+    std::vector<float> expected(2 * WIDTH);
+    auto weights = in_memory_weights();
+    Tensor reference = build([&](const std::string& name) {
+        for (const auto& [weight_name, tensor] : weights) {
+            if (weight_name == name) {
+                return tensor;
+            }
+        }
+        return Tensor();
+    });
+    tt_lazy::eval_into(reference, expected.data(), expected.size());
+
+    MappedWeightFile::write(path_, weights);
+    auto file = MappedWeightFile::open(path_);
+    Tensor output = build([&](const std::string& name) { return file->get(name); });
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape(output);
+    TapeExecutor executor;
+    register_all_operations(executor);
+    WeightPrefetcher prefetcher(file, {1, true});
+    executor.add_observer(&prefetcher);
+    executor.execute_tape(*tape);
+    prefetcher.wait_idle();
+
+    auto result = executor.get_result(output.producer_node());
+    ASSERT_NE(result, nullptr);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result->const_data_ptr()[i], expected[i], 1e-5f) << "at " << i;
+    }
+
+    auto stats = prefetcher.stats();
+    EXPECT_EQ(stats.prefetch_requests, LAYERS);
+    EXPECT_EQ(stats.prefetched_bytes, LAYERS * WIDTH * WIDTH * sizeof(float));
+    EXPECT_EQ(stats.released_bytes, stats.prefetched_bytes);
+}
@@ -0,0 +1,257 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "MappedWeightFile.hpp"
+#include "autodiff.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+#include "optimizer.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+class OptimizerTest : public ::testing::Test {
+   protected:
+    // Spans several chunks, with a partial one at the end
+    static constexpr uint32_t SIZE = 3 * 4096 + 77;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+
+    static std::vector<float> values(size_t count, size_t seed) {
+        std::vector<float> data(count);
+        for (size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<float>((i * 7919 + seed * 104729) % 41) * 0.05f - 1.0f;
+        }
+        return data;
+    }
+};
+
+TEST_F(OptimizerTest, AdamMatchesReferenceOverSeveralSteps) {
+    for (bool decoupled : {false, true}) {
+        auto param = values(SIZE, 1);
+        std::vector<float> m(SIZE, 0.0f);
+        std::vector<float> v(SIZE, 0.0f);
+        std::vector<double> ref_p(param.begin(), param.end());
+        std::vector<double> ref_m(SIZE, 0.0);
+        std::vector<double> ref_v(SIZE, 0.0);
+
+        math::AdamParams hyper;
+        hyper.lr = 0.01f;
+        hyper.weight_decay = 0.1f;
+        hyper.decoupled_weight_decay = decoupled;
+
+        Tensor param_tensor(param.data(), {SIZE});
+        Tensor m_tensor(m.data(), {SIZE});
+        Tensor v_tensor(v.data(), {SIZE});
+        for (uint64_t step = 1; step <= 3; ++step) {
+            auto grad = values(SIZE, step + 1);
+            hyper.step = step;
+            math::adam_update(param_tensor, Tensor(grad.data(), {SIZE}), m_tensor, v_tensor, hyper);
+
+            double bc1 = 1.0 - std::pow(0.9, static_cast<double>(step));
+            double bc2 = 1.0 - std::pow(0.999, static_cast<double>(step));
+            for (size_t i = 0; i < SIZE; ++i) {
+                double g = grad[i];
+                if (decoupled) {
+                    ref_p[i] *= 1.0 - 0.01 * 0.1;
+                } else {
+                    g += 0.1 * ref_p[i];
+                }
+                ref_m[i] = 0.9 * ref_m[i] + 0.1 * g;
+                ref_v[i] = 0.999 * ref_v[i] + 0.001 * g * g;
+                ref_p[i] -= 0.01 * (ref_m[i] / bc1) / (std::sqrt(ref_v[i] / bc2) + 1e-8);
+            }
+        }
+
+        // Updated in place, in the caller's buffers
+        for (size_t i = 0; i < SIZE; ++i) {
+            ASSERT_NEAR(param[i], ref_p[i], 1e-5) << "element " << i << (decoupled ? " (AdamW)" : "");
+            ASSERT_NEAR(m[i], ref_m[i], 1e-5);
+            ASSERT_NEAR(v[i], ref_v[i], 1e-5);
+        }
+    }
+}
+
+TEST_F(OptimizerTest, SgdMomentumMatchesReference) {
+    for (bool nesterov : {false, true}) {
+        auto param = values(SIZE, 2);
+        std::vector<float> buffer(SIZE, 0.0f);
+        std::vector<double> ref_p(param.begin(), param.end());
+        std::vector<double> ref_buf(SIZE, 0.0);
+
+        math::SgdMomentumParams hyper;
+        hyper.lr = 0.1f;
+        hyper.weight_decay = 0.01f;
+        hyper.dampening = 0.1f;
+        hyper.nesterov = nesterov;
+
+        Tensor param_tensor(param.data(), {SIZE});
+        Tensor buffer_tensor(buffer.data(), {SIZE});
+        for (size_t step = 0; step < 3; ++step) {
+            auto grad = values(SIZE, step + 5);
+            math::sgd_momentum_update(param_tensor, Tensor(grad.data(), {SIZE}), buffer_tensor, hyper);
+            for (size_t i = 0; i < SIZE; ++i) {
+                double g = grad[i] + 0.01 * ref_p[i];
+                ref_buf[i] = 0.9 * ref_buf[i] + 0.9 * g;
+                ref_p[i] -= 0.1 * (nesterov ? g + 0.9 * ref_buf[i] : ref_buf[i]);
+            }
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            ASSERT_NEAR(param[i], ref_p[i], 1e-5) << "element " << i << (nesterov ? " (Nesterov)" : "");
+            ASSERT_NEAR(buffer[i], ref_buf[i], 1e-5);
+        }
+    }
+}
+
+TEST_F(OptimizerTest, MultiTensorMatchesPerTensorWithLazyGradients) {
+    std::vector<uint32_t> sizes = {5, SIZE, 1, 4096};
+    std::vector<std::vector<float>> fused_storage;
+    std::vector<std::vector<float>> single_storage;
+    std::vector<std::vector<float>> grad_storage;
+    for (size_t t = 0; t < sizes.size(); ++t) {
+        for (size_t copy = 0; copy < 2; ++copy) {
+            auto& storage = copy == 0 ? fused_storage : single_storage;
+            storage.push_back(values(sizes[t], t));  // Parameter
+            storage.emplace_back(sizes[t], 0.0f);    // First moment
+            storage.emplace_back(sizes[t], 0.0f);    // Second moment
+        }
+        grad_storage.push_back(values(sizes[t], t + 9));
+    }
+
+    math::AdamParams hyper;
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> exp_avgs;
+    std::vector<Tensor> exp_avg_sqs;
+    for (size_t t = 0; t < sizes.size(); ++t) {
+        params.emplace_back(fused_storage[3 * t].data(), std::vector<uint32_t>{sizes[t]});
+        exp_avgs.emplace_back(fused_storage[3 * t + 1].data(), std::vector<uint32_t>{sizes[t]});
+        exp_avg_sqs.emplace_back(fused_storage[3 * t + 2].data(), std::vector<uint32_t>{sizes[t]});
+        // Gradients may come straight from the graph; they are evaluated before the update
+        Tensor grad(grad_storage[t].data(), {sizes[t]});
+        grads.push_back(add(grad, grad));
+    }
+    math::adam_update(params, grads, exp_avgs, exp_avg_sqs, hyper);
+
+    for (size_t t = 0; t < sizes.size(); ++t) {
+        std::vector<float> doubled(grad_storage[t]);
+        for (float& g : doubled) {
+            g *= 2.0f;
+        }
+        Tensor param(single_storage[3 * t].data(), {sizes[t]});
+        Tensor m(single_storage[3 * t + 1].data(), {sizes[t]});
+        Tensor v(single_storage[3 * t + 2].data(), {sizes[t]});
+        math::adam_update(param, Tensor(doubled.data(), {sizes[t]}), m, v, hyper);
+        EXPECT_EQ(fused_storage[3 * t], single_storage[3 * t]) << "tensor " << t;
+        EXPECT_EQ(fused_storage[3 * t + 2], single_storage[3 * t + 2]) << "tensor " << t;
+    }
+
+    std::vector<float> small(4);
+    Tensor p(small.data(), {4});
+    std::vector<float> other(5);
+    Tensor mismatched(other.data(), {5});
+    EXPECT_THROW(math::sgd_momentum_update(p, mismatched, p, {}), std::runtime_error);
+    std::vector<float> grad(4);
+    EXPECT_THROW(math::sgd_momentum_update(p, Tensor(grad.data(), {4}), p, {}), std::runtime_error);
+    params.pop_back();
+    EXPECT_THROW(math::adam_update(params, grads, exp_avgs, exp_avg_sqs, hyper), std::runtime_error);
+}
+
+TEST_F(OptimizerTest, FrontendOptimizersTrainWithLazyGradients) {
+    // loss = sum(x @ w + b); the gradients stay lazy until the step reads them
+    std::vector<float> x_data = values(4 * 8, 3);
+    std::vector<float> w_data = values(8 * 2, 4);
+    std::vector<float> b_data = values(2, 5);
+    auto w_expected = w_data;
+    auto b_expected = b_data;
+    std::vector<float> w_m(w_data.size(), 0.0f);
+    std::vector<float> w_v(w_data.size(), 0.0f);
+    std::vector<float> b_m(b_data.size(), 0.0f);
+    std::vector<float> b_v(b_data.size(), 0.0f);
+
+    Tensor x(x_data.data(), {4, 8});
+    Tensor w(w_data.data(), {8, 2});
+    Tensor b(b_data.data(), {1, 2});
+    math::AdamParams hyper;
+    hyper.lr = 0.05f;
+    Adam adam({w, b}, hyper);
+    for (uint64_t step = 1; step <= 3; ++step) {
+        std::vector<Tensor> grads = grad(reduce_sum(add(matmul(x, w), b)), {w, b});
+        auto w_grad = grads[0].to_vector();
+        auto b_grad = grads[1].to_vector();
+        adam.step(grads);
+
+        // The same step through the math kernel on separate buffers
+        math::AdamParams reference = hyper;
+        reference.step = step;
+        Tensor w_ref(w_expected.data(), {8, 2});
+        Tensor w_m_ref(w_m.data(), {8, 2});
+        Tensor w_v_ref(w_v.data(), {8, 2});
+        Tensor b_ref(b_expected.data(), {1, 2});
+        Tensor b_m_ref(b_m.data(), {1, 2});
+        Tensor b_v_ref(b_v.data(), {1, 2});
+        math::adam_update(w_ref, Tensor(w_grad.data(), {8, 2}), w_m_ref, w_v_ref, reference);
+        math::adam_update(b_ref, Tensor(b_grad.data(), {1, 2}), b_m_ref, b_v_ref, reference);
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+    EXPECT_EQ(adam.hyper().step, 4u);
+    EXPECT_EQ(w_data, w_expected);  // Written into the caller's memory
+    EXPECT_EQ(b_data, b_expected);
+
+    std::vector<float> p_data = values(16, 6);
+    std::vector<float> g_data = values(16, 7);
+    auto p_expected = p_data;
+    std::vector<float> buffer(16, 0.0f);
+    SgdMomentum sgd({Tensor(p_data.data(), {16})});
+    sgd.step({Tensor(g_data.data(), {16})});
+    Tensor p_ref(p_expected.data(), {16});
+    Tensor buffer_ref(buffer.data(), {16});
+    math::sgd_momentum_update(p_ref, Tensor(g_data.data(), {16}), buffer_ref, {});
+    EXPECT_EQ(p_data, p_expected);
+}
+
+TEST_F(OptimizerTest, ReadOnlyAndCopiedParametersAreRejected) {
+    // A mapped weight file is read-only: training it must throw, not fault
+    std::string path = "/tmp/tt_lazy_optimizer_test_" + std::to_string(getpid()) + ".ttw";
+    std::vector<float> weights = values(64, 8);
+    MappedWeightFile::write(path, {{"w", Tensor(weights.data(), {64})}});
+    auto file = MappedWeightFile::open(path);
+    std::remove(path.c_str());
+    Tensor mapped = file->get("w");
+    EXPECT_TRUE(mapped.is_read_only());
+    EXPECT_TRUE(Tensor(mapped).is_read_only());
+
+    std::vector<float> g_data = values(64, 9);
+    std::vector<float> m_data(64);
+    std::vector<float> v_data(64);
+    Tensor m(m_data.data(), {64});
+    Tensor v(v_data.data(), {64});
+    try {
+        math::adam_update(mapped, Tensor(g_data.data(), {64}), m, v, {});
+        FAIL() << "updated a read-only parameter";
+    } catch (const std::runtime_error& error) {
+        EXPECT_NE(std::string(error.what()).find("read-only"), std::string::npos) << error.what();
+    }
+    EXPECT_THROW(math::sgd_momentum_update(m, Tensor(g_data.data(), {64}), mapped, {}), std::runtime_error);
+    EXPECT_THROW(Adam({mapped}), std::runtime_error);
+    EXPECT_THROW(SgdMomentum({mapped}), std::runtime_error);
+
+    // Owned and lazy tensors: the optimizer's copy would not share the caller's memory
+    std::vector<float> x_data = values(4, 10);
+    EXPECT_THROW(Adam({Tensor(std::vector<uint32_t>{4}, x_data)}), std::runtime_error);
+    EXPECT_THROW(Adam({relu(Tensor(x_data.data(), {4}))}), std::runtime_error);
+}
@@ -0,0 +1,137 @@
+#include "Context.hpp"
+#include "DatasetReader.hpp"
+#include "EvaluationManager.hpp"
+#include "MemoryManager.hpp"
+#include "ResultWriter.hpp"
+#include "operations.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class ResultWriterTest : public ::testing::Test {
+   protected:
+    static constexpr uint32_t WIDTH = 6;
+
+    void SetUp() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        path_ = "/tmp/tt_lazy_results_" + std::to_string(getpid());
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        std::remove(path_.c_str());
+    }
+
+    static std::vector<float> batch_values(uint32_t rows, float base) {
+        std::vector<float> values(static_cast<size_t>(rows) * WIDTH);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = base + static_cast<float>(i);
+        }
+        return values;
+    }
+
+    // Lazy, borrowed-constant and materialized batches; returns every row written in order
+    std::vector<float> write_batches(ResultWriter& writer) {
+        std::vector<float> expected;
+        for (uint32_t batch = 0; batch < 5; ++batch) {
+            uint32_t rows = 100 + batch * 37;  // Not a whole number of staging blocks
+            std::vector<float> values = batch_values(rows, static_cast<float>(batch) * 1000.0f);
+            Tensor input(values.data(), {rows, WIDTH});
+            if (batch % 3 == 0) {
+                writer.write(relu(input));
+            } else if (batch % 3 == 1) {
+                writer.write(input);
+            } else {
+                writer.write(Tensor({rows, WIDTH}, values));
+            }
+            expected.insert(expected.end(), values.begin(), values.end());
+            Context::instance().clear();
+            tt_lazy::get_evaluation_manager().clear_cache();
+        }
+        return expected;
+    }
+
+    std::vector<float> read_back() {
+        DatasetReader::Options options;
+        options.batch_rows = 64;
+        options.row_width = WIDTH;
+        DatasetReader reader(path_, options);
+        std::vector<float> values;
+        while (Tensor batch = reader.next()) {
+            values.insert(values.end(), batch.const_data_ptr(), batch.const_data_ptr() + batch.total_elements());
+        }
+        return values;
+    }
+
+    std::string path_;
+};
+
+TEST_F(ResultWriterTest, WritesNpyReadableByDatasetReader) {
+    for (bool direct : {false, true}) {
+        ResultWriter::Options options;
+        options.direct_io = direct;
+        options.block_bytes = 4096;
+        options.queue_depth = 2;
+        ResultWriter writer(path_, options);
+        std::vector<float> expected = write_batches(writer);
+        writer.close();
+
+        EXPECT_EQ(writer.row_width(), WIDTH);
+        auto stats = writer.stats();
+        EXPECT_EQ(stats.tensors, 5u);
+        EXPECT_EQ(stats.rows * WIDTH, expected.size());
+        EXPECT_GE(stats.bytes_written, expected.size() * sizeof(float));
+
+        std::vector<float> values = read_back();
+        ASSERT_EQ(values.size(), expected.size()) << "direct_io=" << direct;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(values[i], expected[i]) << "at " << i << " direct_io=" << direct;
+        }
+    }
+}
+
+TEST_F(ResultWriterTest, RawFilesHoldExactlyTheRows) {
+    ResultWriter::Options options;
+    options.format = ResultWriter::Format::RAW;
+    options.direct_io = true;
+    options.block_bytes = 8192;
+    std::vector<float> expected;
+    {
+        ResultWriter writer(path_, options);
+        expected = write_batches(writer);
+    }  // The destructor finishes the file
+
+    struct stat st {};
+    ASSERT_EQ(stat(path_.c_str(), &st), 0);
+    EXPECT_EQ(static_cast<size_t>(st.st_size), expected.size() * sizeof(float));
+    EXPECT_EQ(read_back(), expected);
+}
+
+TEST_F(ResultWriterTest, PoolBuffersAreRecycled) {
+    size_t before = MemoryManager::instance().get_stats().active_tensors;
+    {
+        ResultWriter::Options options;
+        options.queue_depth = 1;
+        ResultWriter writer(path_, options);
+        write_batches(writer);
+        writer.close();
+        EXPECT_EQ(writer.stats().tensors, 5u);
+    }
+    EXPECT_EQ(MemoryManager::instance().get_stats().active_tensors, before);
+}
+
+TEST_F(ResultWriterTest, RejectsMismatchedRowsAndWritesAfterClose) {
+    ResultWriter writer(path_, ResultWriter::Options{});
+    std::vector<float> values = batch_values(2, 0.0f);
+    writer.write(Tensor(values.data(), {2, WIDTH}));
+    EXPECT_THROW(writer.write(Tensor(values.data(), {3, 4})), std::runtime_error);
+    writer.close();
+    EXPECT_THROW(writer.write(Tensor(values.data(), {2, WIDTH})), std::runtime_error);
+}
@@ -0,0 +1,163 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Shape.hpp"
+#include "Tensor.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class ShapeTest : public ::testing::Test {
+   protected:
+    void SetUp() override { Context::instance().clear(); }
+
+    void TearDown() override { Context::instance().clear(); }
+};
+
+TEST_F(ShapeTest, EditsDimensionsInline) {
+    Shape shape{2, 3, 4};
+    EXPECT_EQ(shape.rank(), 3);
+    EXPECT_EQ(shape.numel(), 24);
+    EXPECT_EQ(shape[1], 3);
+
+    shape.erase(1);
+    EXPECT_EQ(shape, (Shape{2, 4}));
+    shape.push_back(5);
+    EXPECT_EQ(shape.to_vector(), (std::vector<uint32_t>{2, 4, 5}));
+    EXPECT_NE(shape, Shape(std::vector<uint32_t>{2, 4}));
+    EXPECT_TRUE(Shape().empty());
+    EXPECT_EQ(Shape().numel(), 1);
+}
+
+TEST_F(ShapeTest, PrecomputesContiguousStrides) {
+    Shape shape{2, 3, 4};
+    EXPECT_EQ(std::vector<size_t>(shape.strides(), shape.strides() + 3), (std::vector<size_t>{12, 4, 1}));
+
+    // Every edit keeps the strides and element count current
+    shape.set(1, 5);
+    EXPECT_EQ(shape.stride(0), 20);
+    EXPECT_EQ(shape.numel(), 40);
+    shape.push_back(2);
+    EXPECT_EQ(shape.stride(2), 2);
+    EXPECT_EQ(shape.numel(), 80);
+    shape.erase(0);
+    EXPECT_EQ(shape.stride(0), 8);
+    EXPECT_EQ(shape.numel(), 40);
+}
+
+TEST_F(ShapeTest, SpillsToHeapAboveInlineRank) {
+    Shape shape;
+    for (uint32_t dim = 1; dim <= Shape::INLINE_RANK; ++dim) {
+        shape.push_back(dim);
+    }
+    EXPECT_FALSE(shape.spilled());
+    shape.push_back(2);
+    shape.push_back(3);
+    ASSERT_TRUE(shape.spilled());
+    EXPECT_EQ(shape.rank(), Shape::INLINE_RANK + 2);
+    EXPECT_EQ(shape.numel(), 720 * 6);
+    EXPECT_EQ(shape.stride(0), 720 * 6 / 1);
+    EXPECT_EQ(shape.stride(Shape::INLINE_RANK), 3);
+
+    // Copies own their heap storage; moves take it
+    Shape copy = shape;
+    copy.set(0, 2);
+    EXPECT_EQ(shape[0], 1);
+    EXPECT_EQ(copy.numel(), shape.numel() * 2);
+    Shape moved = std::move(copy);
+    EXPECT_EQ(moved.numel(), shape.numel() * 2);
+    EXPECT_TRUE(copy.empty());  // NOLINT(bugprone-use-after-move) - checking moved-from state
+
+    // Erasing back down to the inline rank returns to inline storage
+    shape.erase(0);
+    shape.erase(0);
+    EXPECT_FALSE(shape.spilled());
+    EXPECT_EQ(shape, (Shape{3, 4, 5, 6, 2, 3}));
+    EXPECT_EQ(shape.stride(0), 4 * 5 * 6 * 2 * 3);
+}
+
+TEST_F(ShapeTest, BroadcastAlignsTrailingDimensions) {
+    EXPECT_EQ(Shape::broadcast({4, 8}, {1, 8}), (Shape{4, 8}));
+    EXPECT_EQ(Shape::broadcast({2, 1, 3, 1, 5, 1, 7, 8}, {4, 1, 6, 1, 8}), (Shape{2, 1, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(Shape::broadcast({8}, {2, 3, 1}), (Shape{2, 3, 8}));
+    EXPECT_EQ(Shape::broadcast({}, {5}), (Shape{5}));
+    EXPECT_THROW(Shape::broadcast({4, 8}, {3, 8}), std::runtime_error);
+
+    // The vector form used by the kernels agrees
+    EXPECT_EQ(Tensor::broadcast_shapes({8}, {2, 3, 1}), (std::vector<uint32_t>{2, 3, 8}));
+    EXPECT_FALSE(Tensor::can_broadcast({4, 8}, {3, 8}));
+}
+
+TEST_F(ShapeTest, FrontendOutputShapes) {
+    float data[64] = {};
+    Tensor matrix(data, {4, 8});
+    Tensor row(data, {1, 8});
+    Tensor cube(data, {2, 4, 8});
+    Tensor indices(data, {3});
+
+    EXPECT_EQ(add(matrix, row).dims(), (Shape{4, 8}));
+    EXPECT_EQ(multiply(row, cube).dims(), (Shape{2, 4, 8}));
+    EXPECT_EQ(relu(cube).dims(), (Shape{2, 4, 8}));
+    EXPECT_EQ(reduce_sum(cube, {1}).dims(), (Shape{2, 8}));
+    EXPECT_EQ(reduce_sum(cube, {1}, true).dims(), (Shape{2, 1, 8}));
+    EXPECT_EQ(reduce_sum(cube).dims(), (Shape{1}));
+    EXPECT_EQ(reduce_sum(cube, std::vector<int32_t>{0, 2}).dims(), (Shape{4}));
+    EXPECT_EQ(gather(cube, indices, 1).dims(), (Shape{2, 3, 8}));
+    EXPECT_EQ(argmax(cube, 1).dims(), (Shape{2, 8}));
+    EXPECT_EQ(topk(cube, 2, -1).second.dims(), (Shape{2, 4, 2}));
+
+    // Incompatible operands are rejected before a node is created
+    size_t nodes = Context::instance().size();
+    EXPECT_THROW(add(matrix, Tensor(data, {3, 8})), std::runtime_error);
+    EXPECT_EQ(Context::instance().size(), nodes);
+}
+
+TEST_F(ShapeTest, KernelsHandleHighRanks) {
+    // [2, 1, 3, 1, 2, 1, 2] + [2, 1, 2, 1]: broadcast along both operands at rank 7
+    std::vector<float> a_data(24);
+    std::vector<float> b_data(4);
+    std::iota(a_data.begin(), a_data.end(), 0.0f);
+    std::iota(b_data.begin(), b_data.end(), 100.0f);
+    Tensor a(a_data.data(), {2, 1, 3, 1, 2, 1, 2});
+    Tensor b(b_data.data(), {2, 1, 2, 1});
+
+    Tensor sum = math::add(a, b);
+    ASSERT_EQ(sum.dims(), (Shape{2, 1, 3, 2, 2, 2, 2}));
+    const float* values = sum.const_data_ptr();
+    for (size_t i = 0; i < sum.total_elements(); ++i) {
+        // Output index i0..i6 reads a at (i0, 0, i2, 0, i4, 0, i6) and b at (i3, 0, i5, 0)
+        size_t i6 = i % 2;
+        size_t i5 = i / 2 % 2;
+        size_t i4 = i / 4 % 2;
+        size_t i3 = i / 8 % 2;
+        size_t i2 = i / 16 % 3;
+        size_t i0 = i / 48;
+        float expected = a_data[i0 * 12 + i2 * 4 + i4 * 2 + i6] + b_data[i3 * 2 + i5];
+        ASSERT_FLOAT_EQ(values[i], expected) << "at " << i;
+    }
+
+    // Reductions, splits and batched transposes over every dimension of a 6-D tensor
+    std::vector<float> data(64);
+    std::iota(data.begin(), data.end(), 0.0f);
+    Tensor cube(std::vector<uint32_t>{2, 2, 2, 2, 2, 2}, data);
+    EXPECT_EQ(math::reduce_sum(cube, {0, 1, 2, 3, 4}).to_vector(), (std::vector<float>{992, 1024}));
+    std::vector<Tensor> halves = math::split(cube, 1, 3);
+    ASSERT_EQ(halves.size(), 2);
+    EXPECT_EQ(halves[1].dims(), (Shape{2, 2, 2, 1, 2, 2}));
+    EXPECT_EQ(halves[1].to_vector()[0], 4.0f);
+    EXPECT_EQ(halves[1].to_vector()[4], 12.0f);
+    Tensor transposed = math::transpose(cube, {});
+    EXPECT_EQ(transposed.to_vector()[5], 6.0f);  // Second matrix, element (0, 1) is (1, 0) of the input
+
+    // The lazy path produces the same results
+    Tensor lazy = reduce_sum(relu(add(a, b)), {0, 1, 2, 3, 4, 5});
+    EXPECT_EQ(lazy.dims(), (Shape{2}));
+    std::vector<float> expected = math::reduce_sum(sum, {0, 1, 2, 3, 4, 5}).to_vector();
+    EXPECT_EQ(lazy.to_vector(), expected);
+    tt_lazy::get_evaluation_manager().clear_cache();
+}
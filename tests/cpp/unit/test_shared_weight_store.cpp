@@ -0,0 +1,184 @@
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "SharedWeightStore.hpp"
+#include "operations.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+class SharedWeightStoreTest : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        Context::instance().clear();
+        segment_ = "/tt_lazy_test_weights_" + std::to_string(getpid());
+        SharedWeightStore::unlink(segment_);
+    }
+
+    void TearDown() override {
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        SharedWeightStore::unlink(segment_);
+    }
+
+    // 2x3 weight and 1x3 bias
+    SharedWeightStore::WeightLoader make_loader(int* calls) {
+        return [this, calls]() {
+            (*calls)++;
+            return std::vector<SharedWeightStore::WeightSpec>{
+                {"w", {2, 3}, weight_.data(), SharedWeightStore::Layout::ROW_MAJOR},
+                {"w_packed", {2, 3}, weight_.data(), SharedWeightStore::Layout::MATMUL_RHS_PACKED},
+                {"b", {1, 3}, bias_.data(), SharedWeightStore::Layout::ROW_MAJOR},
+            };
+        };
+    }
+
+    std::string segment_;
+    std::vector<float> weight_ = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<float> bias_ = {0.5f, -0.5f, 1.5f};
+};
+
+TEST_F(SharedWeightStoreTest, FirstProcessPopulatesOthersAttach) {
+    int calls = 0;
+    auto creator = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+    EXPECT_TRUE(creator->is_creator());
+    EXPECT_EQ(calls, 1);
+
+    auto attached = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+    EXPECT_FALSE(attached->is_creator());
+    EXPECT_EQ(calls, 1) << "Attaching must not load weights again";
+    EXPECT_EQ(attached->names(), (std::vector<std::string>{"w", "w_packed", "b"}));
+
+    Tensor w = attached->get("w");
+    EXPECT_TRUE(w.is_constant());
+    EXPECT_EQ(w.size(0), 2);
+    EXPECT_EQ(w.size(1), 3);
+    EXPECT_FLOAT_EQ(w.const_data_ptr()[4], 5.0f);
+
+    // Packed weights are stored transposed and consumed with transpose_b
+    Tensor packed = attached->get("w_packed");
+    EXPECT_EQ(attached->layout("w_packed"), SharedWeightStore::Layout::MATMUL_RHS_PACKED);
+    EXPECT_EQ(packed.size(0), 3);
+    EXPECT_EQ(packed.size(1), 2);
+
+    float x_data[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+    Tensor x(x_data, {2, 2});
+    auto plain = matmul(x, w);
+    auto from_packed = matmul(x, packed, false, true);
+    plain.eval();
+    from_packed.eval();
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_FLOAT_EQ(from_packed.const_data_ptr()[i], plain.const_data_ptr()[i]);
+    }
+
+    EXPECT_THROW(attached->get("missing"), std::runtime_error);
+}
+
+TEST_F(SharedWeightStoreTest, TensorsKeepMappingAlive) {
+    int calls = 0;
+    Tensor bias;
+    {
+        auto store = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+        bias = store->get("b");
+    }
+    // The store is only referenced by the tensor now
+    EXPECT_TRUE(bias.owns_external_memory());
+    EXPECT_FLOAT_EQ(bias.const_data_ptr()[2], 1.5f);
+}
+
+TEST_F(SharedWeightStoreTest, WorkerProcessAttachesReadOnly) {
+    int calls = 0;
+    auto creator = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Worker: must attach without loading and see the creator's data
+        int child_calls = 0;
+        int status = 0;
+        try {
+            auto store = SharedWeightStore::create_or_attach(segment_, make_loader(&child_calls));
+            Tensor w = store->get("w");
+            if (store->is_creator() || child_calls != 0) {
+                status = 1;
+            } else if (w.const_data_ptr()[5] != 6.0f) {
+                status = 2;
+            }
+        } catch (...) {
+            status = 3;
+        }
+        _exit(status);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST_F(SharedWeightStoreTest, FailedPopulateUnlinksSegment) {
+    auto failing_loader = []() -> std::vector<SharedWeightStore::WeightSpec> {
+        throw std::runtime_error("weights unavailable");
+    };
+    EXPECT_THROW(SharedWeightStore::create_or_attach(segment_, failing_loader), std::runtime_error);
+    EXPECT_THROW(SharedWeightStore::attach(segment_, std::chrono::milliseconds(10)), std::runtime_error);
+
+    // A later process can still become the creator
+    int calls = 0;
+    auto store = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+    EXPECT_TRUE(store->is_creator());
+}
+
+TEST_F(SharedWeightStoreTest, DeadCreatorIsTakenOver) {
+    // The creator dies while loading, leaving the segment unpublished
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        SharedWeightStore::create_or_attach(segment_, []() -> std::vector<SharedWeightStore::WeightSpec> {
+            _exit(0);
+        });
+        _exit(1);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+
+    EXPECT_THROW(SharedWeightStore::attach(segment_, std::chrono::seconds(5)), std::runtime_error);
+    int calls = 0;
+    auto store = SharedWeightStore::create_or_attach(segment_, make_loader(&calls), std::chrono::seconds(5));
+    EXPECT_TRUE(store->is_creator());
+    EXPECT_EQ(calls, 1);
+    EXPECT_FLOAT_EQ(store->get("b").const_data_ptr()[0], 0.5f);
+}
+
+TEST_F(SharedWeightStoreTest, OlderLayoutVersionIsReplaced) {
+    // A published segment as an older version wrote it: magic, version 1, ready, size
+    constexpr size_t size = 4096;
+    int fd = shm_open(segment_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, size), 0);
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ASSERT_NE(base, MAP_FAILED);
+    uint64_t magic = 0x5454'4C5A'5357'4731ULL;
+    uint32_t version = 1;
+    uint32_t ready = 1;
+    uint64_t total_size = size;
+    auto* bytes = static_cast<char*>(base);
+    std::memcpy(bytes, &magic, sizeof(magic));
+    std::memcpy(bytes + 8, &version, sizeof(version));
+    std::memcpy(bytes + 12, &ready, sizeof(ready));
+    std::memcpy(bytes + 16, &total_size, sizeof(total_size));
+    munmap(base, size);
+    close(fd);
+
+    int calls = 0;
+    auto store = SharedWeightStore::create_or_attach(segment_, make_loader(&calls));
+    EXPECT_TRUE(store->is_creator());
+    EXPECT_EQ(store->names(), (std::vector<std::string>{"w", "w_packed", "b"}));
+}
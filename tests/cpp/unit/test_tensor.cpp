@@ -1,8 +1,11 @@
 #include "Context.hpp"
+#include "EvaluationManager.hpp"
 #include "Tensor.hpp"
 #include "common.hpp"
 #include "operations.hpp"
 
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <spdlog/spdlog.h>
 
@@ -32,6 +35,121 @@ TEST_F(TensorTest, ShapeAccess) {
     EXPECT_EQ(tensor.size(2), 5);
 }
 
+TEST_F(TensorTest, ExternalMemoryDeleterRunsAfterLastReference) {
+    int deleter_calls = 0;
+    auto* data = new float[4]{1.0f, -2.0f, 3.0f, -4.0f};
+    {
+        Tensor external(data, {2, 2}, [&deleter_calls](void* p) noexcept {
+            delete[] static_cast<float*>(p);
+            deleter_calls++;
+        });
+        EXPECT_TRUE(external.owns_external_memory());
+        EXPECT_EQ(external.data_ptr(), data);
+
+        // Graph nodes keep copies of their inputs
+        Tensor result = relu(external);
+        Tensor copy = external;
+        Tensor moved = std::move(copy);
+        EXPECT_TRUE(moved.owns_external_memory());
+        EXPECT_FALSE(copy.owns_external_memory());  // NOLINT(bugprone-use-after-move) - checking moved-from state
+
+        result.eval();
+        EXPECT_FLOAT_EQ(result.data_ptr()[0], 1.0f);
+        EXPECT_FLOAT_EQ(result.data_ptr()[1], 0.0f);
+    }
+    EXPECT_EQ(deleter_calls, 0);
+
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+    EXPECT_EQ(deleter_calls, 1);
+}
+
+TEST_F(TensorTest, ExternalMemorySharedOwner) {
+    // One owning allocation sliced into two weight views
+    auto storage = std::make_shared<std::vector<float>>(std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    std::weak_ptr<std::vector<float>> watch = storage;
+
+    Tensor first(storage, storage->data(), {1, 2});
+    Tensor second(storage, storage->data() + 2, {2, 2});
+    storage.reset();
+
+    EXPECT_FALSE(watch.expired());
+    EXPECT_FLOAT_EQ(first.data_ptr()[1], 2.0f);
+    EXPECT_FLOAT_EQ(second.data_ptr()[0], 3.0f);
+    EXPECT_EQ(second.size(0), 2);
+
+    first = Tensor();
+    EXPECT_FALSE(watch.expired());
+    second = Tensor();
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST_F(TensorTest, SmallTensorsStoreDataInline) {
+    auto inside = [](const Tensor& t) {
+        const auto* begin = reinterpret_cast<const char*>(&t);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* data = reinterpret_cast<const char*>(t.const_data_ptr());  // NOLINT
+        return data >= begin && data < begin + sizeof(Tensor);
+    };
+
+    Tensor small({4, 4});
+    EXPECT_TRUE(small.uses_inline_storage());
+    EXPECT_TRUE(inside(small));
+    EXPECT_FLOAT_EQ(small.data_ptr()[15], 0.0f);
+    for (size_t i = 0; i < small.total_elements(); ++i) {
+        small.data_ptr()[i] = static_cast<float>(i);
+    }
+
+    Tensor large({Tensor::INLINE_CAPACITY + 1});
+    EXPECT_FALSE(large.uses_inline_storage());
+    EXPECT_FALSE(inside(large));
+    float external[4] = {};
+    EXPECT_FALSE(Tensor(external, {4}).uses_inline_storage());
+    EXPECT_FALSE(relu(small).uses_inline_storage());  // Lazy
+
+    // Copies and moves carry the values in their own storage
+    Tensor copy = small;
+    Tensor moved = std::move(copy);
+    small.data_ptr()[0] = 100.0f;
+    EXPECT_TRUE(inside(moved));
+    EXPECT_EQ(moved.to_vector(), (std::vector<float>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}));
+    large = moved;
+    EXPECT_TRUE(large.uses_inline_storage());
+    EXPECT_FLOAT_EQ(large.data_ptr()[15], 15.0f);
+
+    // Evaluated results of small shapes are inline too
+    std::vector<float> values = small.to_vector();
+    Tensor sum = reduce_sum(Tensor(values.data(), {4, 4}), {1});
+    sum.eval();
+    EXPECT_TRUE(sum.uses_inline_storage());
+    EXPECT_EQ(sum.to_vector(), (std::vector<float>{106, 22, 38, 54}));
+}
+
+TEST_F(TensorTest, StorageKindsReplaceEachOther) {
+    // Inline, heap and constant data share one slot, so assignments switch between them
+    std::vector<float> values(Tensor::INLINE_CAPACITY + 4, 2.0f);
+    Tensor constant(values.data(), {static_cast<uint32_t>(values.size())});
+    Tensor heap({static_cast<uint32_t>(values.size())});
+    heap.fill(3.0f);
+    Tensor small({2});
+    small.fill(4.0f);
+
+    Tensor t = small;
+    t = heap;
+    EXPECT_FALSE(t.uses_inline_storage());
+    EXPECT_NE(t.const_data_ptr(), heap.const_data_ptr());
+    t = constant;
+    EXPECT_TRUE(t.is_constant());
+    EXPECT_EQ(t.const_data_ptr(), values.data());
+    t = std::move(small);
+    EXPECT_TRUE(t.uses_inline_storage());
+    EXPECT_EQ(t.to_vector(), (std::vector<float>{4.0f, 4.0f}));
+    t = std::move(heap);
+    EXPECT_EQ(t.to_vector(), std::vector<float>(values.size(), 3.0f));
+    t = relu(constant);
+    EXPECT_TRUE(t.is_lazy());
+    EXPECT_EQ(t.to_vector(), values);
+}
+
 TEST_F(TensorTest, ProducerNode) {
     float data[50];
     Tensor tensor(data, {5, 10});
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+End-to-end MLP benchmark: tt_lazy vs NumPy
+
+Measures latency (graph build + evaluation) and throughput of a two-layer MLP
+across batch sizes, and prints the tt_lazy per-op profile for the largest batch.
+
+Usage:
+    python3 benchmark_mlp.py [--batch-sizes 1 8 64 256] [--iters 50]
+"""
+
+import argparse
+import os
+import statistics
+import sys
+import time
+
+import numpy as np
+
+# Add the build directory to Python path to import the module
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "build"))
+
+import tt_lazy  # noqa: E402
+
+
+class NumpyMLP:
+    def __init__(self, w1, b1, w2, b2):
+        self.w1, self.b1, self.w2, self.b2 = w1, b1, w2, b2
+
+    def forward(self, x):
+        h = np.maximum(x @ self.w1 + self.b1, 0.0)
+        return h @ self.w2 + self.b2
+
+
+class LazyMLP:
+    def __init__(self, w1, b1, w2, b2):
+        self.w1 = tt_lazy.create_constant_tensor(w1, list(w1.shape))
+        self.b1 = tt_lazy.create_constant_tensor(b1, list(b1.shape))
+        self.w2 = tt_lazy.create_constant_tensor(w2, list(w2.shape))
+        self.b2 = tt_lazy.create_constant_tensor(b2, list(b2.shape))
+
+    def forward(self, x):
+        h = tt_lazy.relu(tt_lazy.add(tt_lazy.matmul(x, self.w1), self.b1))
+        return tt_lazy.add(tt_lazy.matmul(h, self.w2), self.b2)
+
+
+def reset_graph():
+    tt_lazy.Context.instance().clear()
+    tt_lazy.clear_cache()
+
+
+def time_numpy(model, x, iters):
+    samples = []
+    for _ in range(iters):
+        start = time.perf_counter()
+        model.forward(x)
+        samples.append(time.perf_counter() - start)
+    return samples
+
+
+def time_lazy(model, x_np, iters):
+    samples = []
+    for _ in range(iters):
+        reset_graph()
+        start = time.perf_counter()
+        x = tt_lazy.create_constant_tensor(x_np, list(x_np.shape))
+        model.forward(x).to_numpy()
+        samples.append(time.perf_counter() - start)
+    return samples
+
+
+def report(name, batch, samples):
+    median = statistics.median(samples)
+    p95 = sorted(samples)[int(0.95 * (len(samples) - 1))]
+    throughput = batch / median if median > 0 else float("inf")
+    print(
+        f"  {name:<8} batch={batch:<5} median={median * 1e6:10.1f} us  "
+        f"p95={p95 * 1e6:10.1f} us  throughput={throughput:12.0f} rows/s"
+    )
+    return median
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument("--batch-sizes", type=int, nargs="+", default=[1, 8, 64, 256])
+    parser.add_argument("--in-features", type=int, default=64)
+    parser.add_argument("--hidden", type=int, default=128)
+    parser.add_argument("--out-features", type=int, default=10)
+    parser.add_argument("--iters", type=int, default=50)
+    args = parser.parse_args()
+
+    rng = np.random.default_rng(0)
+    w1 = rng.standard_normal((args.in_features, args.hidden), dtype=np.float32)
+    b1 = rng.standard_normal((1, args.hidden), dtype=np.float32)
+    w2 = rng.standard_normal((args.hidden, args.out_features), dtype=np.float32)
+    b2 = rng.standard_normal((1, args.out_features), dtype=np.float32)
+
+    numpy_model = NumpyMLP(w1, b1, w2, b2)
+    lazy_model = LazyMLP(w1, b1, w2, b2)
+
+    print(f"MLP {args.in_features} -> {args.hidden} -> {args.out_features}, {args.iters} iterations")
+    for batch in args.batch_sizes:
+        x = rng.standard_normal((batch, args.in_features), dtype=np.float32)
+
+        # Correctness check before timing
+        reset_graph()
+        tx = tt_lazy.create_constant_tensor(x, list(x.shape))
+        lazy_out = lazy_model.forward(tx).to_numpy().reshape(batch, args.out_features)
+        if not np.allclose(lazy_out, numpy_model.forward(x), rtol=1e-3, atol=1e-3):
+            print(f"  batch={batch}: results differ from NumPy!")
+            return 1
+
+        np_median = report("numpy", batch, time_numpy(numpy_model, x, args.iters))
+        lazy_median = report("tt_lazy", batch, time_lazy(lazy_model, x, args.iters))
+        print(f"  tt_lazy / numpy latency ratio: {lazy_median / np_median:.2f}x")
+
+    # Per-op breakdown for the largest batch
+    batch = max(args.batch_sizes)
+    x = rng.standard_normal((batch, args.in_features), dtype=np.float32)
+    reset_graph()
+    with tt_lazy.Profiler() as prof:
+        tx = tt_lazy.create_constant_tensor(x, list(x.shape))
+        lazy_model.forward(tx).to_numpy()
+
+    print(f"\nPer-op profile (batch={batch}):")
+    for timing in prof.timings:
+        print(f"  node {timing.node_id:<4} {timing.op_name:<10} {timing.duration_ns / 1e3:10.1f} us")
+    print(f"  total op time: {prof.total_ns / 1e3:.1f} us")
+    print(f"  {tt_lazy.get_evaluation_stats()}")
+    print(f"  {tt_lazy.get_memory_stats()}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -135,6 +135,185 @@ def test_node_inspection():
     return True
 
 
+def test_stats_and_profiler():
+    """Test structured statistics and the profiler context manager"""
+    print("\n=== Testing Stats and Profiler ===")
+
+    try:
+        tt_lazy.Context.instance().clear()
+        tt_lazy.clear_cache()
+
+        x = np.ones((2, 4), dtype=np.float32)
+        w = np.full((4, 3), 0.5, dtype=np.float32)
+        tx = tt_lazy.create_constant_tensor(x, [2, 4])
+        tw = tt_lazy.create_constant_tensor(w, [4, 3])
+
+        with tt_lazy.Profiler() as prof:
+            out = tt_lazy.relu(tt_lazy.matmul(tx, tw))
+            result = out.to_numpy()
+
+        expected = np.maximum(x @ w, 0.0)
+        assert np.allclose(result.reshape(expected.shape), expected)
+
+        names = [t.op_name for t in prof.timings]
+        assert names == ["MatMul", "ReLU"], names
+        print(f"✓ Profiled ops: {prof.summary()}")
+
+        graph_stats = tt_lazy.Context.instance().stats()
+        assert graph_stats.op_counts["MatMul"] == 1
+        print(f"✓ {graph_stats} {graph_stats.op_counts}")
+
+        eval_stats = tt_lazy.get_evaluation_stats()
+        assert eval_stats.operations_executed >= 2
+        print(f"✓ {eval_stats}")
+        print(f"✓ {tt_lazy.get_memory_stats()}")
+
+    except Exception as e:
+        print(f"✗ Failed stats and profiler: {e}")
+        return False
+
+    return True
+
+
+def test_eval_into():
+    """Test evaluating straight into a preallocated numpy array"""
+    print("\n=== Testing eval_into ===")
+
+    try:
+        tt_lazy.Context.instance().clear()
+        tt_lazy.clear_cache()
+
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        w = np.ones((3, 2), dtype=np.float32)
+        out = tt_lazy.matmul(tt_lazy.create_constant_tensor(x, [2, 3]), tt_lazy.create_constant_tensor(w, [3, 2]))
+
+        dst = np.zeros((2, 2), dtype=np.float32)
+        tt_lazy.eval_into(out, dst)
+        assert np.allclose(dst, x @ w)
+        print("✓ Contiguous destination")
+
+        # Column slice of a wider response buffer
+        wide = np.zeros((2, 4), dtype=np.float32)
+        tt_lazy.eval_into(out, wide[:, 1:3])
+        assert np.allclose(wide[:, 1:3], x @ w) and not wide[:, 0].any()
+        print("✓ Strided destination")
+
+        try:
+            tt_lazy.eval_into(out, np.zeros((2, 2), dtype=np.float64))
+            print("✗ Accepted a float64 destination")
+            return False
+        except RuntimeError:
+            print("✓ Rejected mismatched dtype")
+
+    except Exception as e:
+        print(f"✗ Failed eval_into: {e}")
+        return False
+
+    return True
+
+
+def test_high_rank():
+    """Test tensors above rank 4 against numpy broadcasting"""
+    print("\n=== Testing High-Rank Tensors ===")
+
+    try:
+        tt_lazy.Context.instance().clear()
+        tt_lazy.clear_cache()
+
+        a = np.arange(2 * 3 * 1 * 4 * 2 * 5, dtype=np.float32).reshape(2, 3, 1, 4, 2, 5)
+        b = np.linspace(-1.0, 1.0, 3 * 4 * 1 * 5, dtype=np.float32).reshape(3, 4, 1, 5)
+        ta = tt_lazy.create_constant_tensor(a, list(a.shape))
+        tb = tt_lazy.create_constant_tensor(b, list(b.shape))
+
+        assert ta.rank() == 6 and ta.shape() == list(a.shape)
+        assert ta.strides() == [s // 4 for s in a.strides] and ta.numel() == a.size
+        print("✓ Rank-6 shape, strides and element count")
+
+        out = tt_lazy.add(tt_lazy.multiply(ta, tb), ta)
+        assert out.shape() == [2, 3, 3, 4, 2, 5]
+        assert np.allclose(out.to_numpy(), a * b + a)
+        print("✓ Broadcasting add and multiply at rank 6")
+
+    except Exception as e:
+        print(f"✗ Failed high-rank tensors: {e}")
+        return False
+
+    return True
+
+
+def test_evaluation_modes():
+    """Test switching between tape, immediate and adaptive evaluation"""
+    print("\n=== Testing Evaluation Modes ===")
+
+    try:
+        x = np.arange(6, dtype=np.float32).reshape(2, 3) - 2.0
+        w = np.ones((3, 2), dtype=np.float32)
+        expected = np.maximum(x @ w, 0.0)
+
+        for mode in ["immediate", "adaptive", "tape"]:
+            tt_lazy.set_evaluation_mode(mode)
+            assert tt_lazy.get_evaluation_mode() == mode
+            tt_lazy.Context.instance().clear()
+            out = tt_lazy.relu(
+                tt_lazy.matmul(tt_lazy.create_constant_tensor(x, [2, 3]), tt_lazy.create_constant_tensor(w, [3, 2]))
+            )
+            assert np.allclose(out.to_numpy(), expected)
+            print(f"✓ {mode} mode")
+
+        try:
+            tt_lazy.set_evaluation_mode("eager")
+            print("✗ Accepted an unknown mode")
+            return False
+        except ValueError:
+            print("✓ Rejected unknown mode")
+
+    except Exception as e:
+        print(f"✗ Failed evaluation modes: {e}")
+        return False
+
+    return True
+
+
+def test_optimizers():
+    """Test in-place optimizer steps on numpy-backed parameters"""
+    print("\n=== Testing Optimizers ===")
+
+    try:
+        tt_lazy.Context.instance().clear()
+        tt_lazy.clear_cache()
+
+        w = np.ones((3, 2), dtype=np.float32)
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        w_tensor = tt_lazy.create_constant_tensor(w, [3, 2])
+        loss = tt_lazy.reduce_sum(tt_lazy.matmul(tt_lazy.create_constant_tensor(x, [2, 3]), w_tensor))
+        grads = tt_lazy.grad(loss, [w_tensor])
+
+        sgd = tt_lazy.SgdMomentum([w_tensor], lr=0.1, momentum=0.0)
+        sgd.step(grads)
+        assert np.allclose(w, 1.0 - 0.1 * x.sum(axis=0)[:, None])
+        print("✓ SgdMomentum updates the array in place")
+
+        adam = tt_lazy.Adam([w_tensor], lr=0.01)
+        adam.step(grads)
+        assert adam.steps_taken == 1
+        print("✓ Adam step")
+
+        frozen = np.ones(4, dtype=np.float32)
+        frozen.setflags(write=False)
+        try:
+            tt_lazy.Adam([tt_lazy.create_constant_tensor(frozen, [4])])
+            print("✗ Accepted a read-only parameter")
+            return False
+        except RuntimeError:
+            print("✓ Rejected read-only parameter")
+
+    except Exception as e:
+        print(f"✗ Failed optimizers: {e}")
+        return False
+
+    return True
+
+
 def main():
     """Run all tests"""
     print("TT Lazy Python Bindings Test")
@@ -145,6 +324,11 @@ def main():
         test_context_operations,
         test_graph_operations,
         test_node_inspection,
+        test_stats_and_profiler,
+        test_eval_into,
+        test_high_rank,
+        test_evaluation_modes,
+        test_optimizers,
     ]
 
     passed = 0
@@ -0,0 +1,158 @@
+// tt_lazy_alloc_bench: heap allocations and latency of small tensors.
+//
+// Usage:
+//   tt_lazy_alloc_bench [--repeat N]
+//
+// Every operator new in the process is counted. The first table creates, copies and moves
+// materialized tensors around Tensor::INLINE_CAPACITY: tensors up to that size keep their data
+// inline and should show no allocations at all. The second runs a scalar-heavy computation -
+// per-row statistics over [rows, width] tensors, as eager kernels and as a lazy graph - at a
+// width whose intermediates fit inline and at one whose intermediates do not. Allocation counts
+// are per tensor or per operation; times are medians.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tensor.hpp"
+#include "allocation_counter.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t CALLS_PER_SAMPLE = 100;
+constexpr uint32_t STATISTIC_ROWS = 4;
+constexpr size_t STATISTIC_STEPS = 8;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+struct Measurement {
+    double allocations = 0.0;  // Per call
+    double ns = 0.0;           // Median per call
+};
+
+// Allocations per call of `fn`, and its median time over CALLS_PER_SAMPLE calls per sample
+template <typename Fn>
+Measurement measure(size_t repeat, Fn&& fn) {
+    fn();  // Warm-up
+    size_t before = allocation_count().load(std::memory_order_relaxed);
+    fn();
+    Measurement result;
+    result.allocations = static_cast<double>(allocation_count().load(std::memory_order_relaxed) - before);
+
+    std::vector<double> times;
+    for (size_t i = 0; i < repeat; ++i) {
+        auto start = Clock::now();
+        for (size_t call = 0; call < CALLS_PER_SAMPLE; ++call) {
+            fn();
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / CALLS_PER_SAMPLE);
+    }
+    std::sort(times.begin(), times.end());
+    result.ns = times[times.size() / 2];
+    return result;
+}
+
+void tensor_table(size_t repeat) {
+    const uint32_t sizes[] = {1, 4, 16, 17, 64};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    std::printf("%-8s %-7s %14s %14s %14s\n", "floats", "inline", "create", "copy", "move");
+    for (uint32_t size : sizes) {
+        Tensor source({size});
+        source.fill(1.0f);
+        Measurement create = measure(repeat, [&] {
+            Tensor t({size});
+            t.data_ptr()[0] = 2.0f;
+        });
+        Measurement copy = measure(repeat, [&] {
+            Tensor t(source);
+            t.data_ptr()[0] = 2.0f;
+        });
+        Tensor moving = source;
+        Measurement move = measure(repeat, [&] {  // Moves there and back
+            Tensor moved(std::move(moving));
+            moving = std::move(moved);
+        });
+        std::printf("%-8u %-7s %5.1f %6.1fns %5.1f %6.1fns %5.1f %6.1fns\n", size,
+                    source.uses_inline_storage() ? "yes" : "no", create.allocations, create.ns, copy.allocations,
+                    copy.ns, move.allocations, move.ns);
+    }
+}
+
+// Running sum of squares and its per-row total, STATISTIC_STEPS times: 3 kernels per step
+Tensor eager_statistics(const Tensor& x) {
+    Tensor sum = math::multiply(x, x);
+    Tensor total;
+    for (size_t step = 0; step < STATISTIC_STEPS; ++step) {
+        sum = math::add(sum, math::relu(x));
+        total = math::reduce_sum(sum, {1}, true);
+    }
+    return total;
+}
+
+Tensor lazy_statistics(const Tensor& x) {
+    Tensor sum = multiply(x, x);
+    Tensor total;
+    for (size_t step = 0; step < STATISTIC_STEPS; ++step) {
+        sum = add(sum, relu(x));
+        total = reduce_sum(sum, {1}, true);
+    }
+    return total;
+}
+
+void statistics_table(size_t repeat) {
+    constexpr double OPS = 1 + 3 * STATISTIC_STEPS;
+    const uint32_t widths[] = {4, 32};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    std::printf("\n%-14s %-7s %18s %18s\n", "rows x width", "inline", "eager kernels", "lazy graph");
+    for (uint32_t width : widths) {
+        std::vector<float> data(static_cast<size_t>(STATISTIC_ROWS) * width);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<float>(i % 7) * 0.25f - 0.5f;
+        }
+        Tensor x(data.data(), {STATISTIC_ROWS, width});
+        bool fits_inline = data.size() <= Tensor::INLINE_CAPACITY;
+
+        Measurement eager = measure(repeat, [&] { eager_statistics(x); });
+        Measurement lazy = measure(repeat, [&] {
+            Tensor total = lazy_statistics(x);
+            total.eval();
+            Context::instance().clear();
+            tt_lazy::get_evaluation_manager().clear_cache();
+        });
+        std::string name = std::to_string(STATISTIC_ROWS) + " x " + std::to_string(width);
+        std::printf("%-14s %-7s %5.1f/op %7.2fus %5.1f/op %7.2fus\n", name.c_str(), fits_inline ? "yes" : "no",
+                    eager.allocations / OPS, eager.ns / 1000.0, lazy.allocations / OPS, lazy.ns / 1000.0);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t repeat = std::max<size_t>(1, flag_value(flags, "--repeat", 50));
+    spdlog::set_level(spdlog::level::err);
+
+    tensor_table(repeat);
+    statistics_table(repeat);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#pragma once
+// Counts every call of the global operator new for the allocation benchmarks. Replacing the
+// global allocation functions is program-wide, so include this header from exactly one
+// translation unit of a tool.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<size_t>& allocation_count() {
+    static std::atomic<size_t> count{0};
+    return count;
+}
+
+void* operator new(std::size_t size) {
+    allocation_count().fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT(cppcoreguidelines-no-malloc)
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc)
+}
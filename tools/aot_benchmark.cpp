@@ -0,0 +1,135 @@
+// tt_lazy_aot_bench: the demo MLP interpreted against its ahead-of-time generated code.
+//
+// Usage:
+//   tt_lazy_aot_bench [--repeat N]
+//
+// Each configuration is run three ways: "lazy" builds the graph and evaluates it (what a
+// caller of the frontend pays per request), "tape" replays an already generated tape through
+// the TapeExecutor (the interpreter alone), and "generated" calls the source tt_lazy_codegen
+// emitted for that configuration at build time. Times are the median per run; "max diff"
+// compares the generated output with the interpreted one.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "Tensor.hpp"
+#include "demo_mlp.hpp"
+
+// Generated at build time by tt_lazy_codegen --demo-mlp
+#include "demo_mlp_256x512x64_b1.hpp"
+#include "demo_mlp_256x512x64_b64.hpp"
+#include "demo_mlp_4x8x1_b2.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    uint32_t input_size;
+    uint32_t hidden_size;
+    uint32_t output_size;
+    uint32_t rows;
+    void (*run)(const float* const* inputs, float* output, float* arena);
+    size_t arena_floats;
+    size_t output_floats;
+};
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+// Median time of `fn` in microseconds
+template <typename Fn>
+double median_us(size_t repeat, Fn&& fn) {
+    fn();  // Warm-up
+    std::vector<double> times;
+    for (size_t i = 0; i < repeat; ++i) {
+        auto start = Clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t repeat = std::max<size_t>(1, flag_value(flags, "--repeat", 200));
+    spdlog::set_level(spdlog::level::err);
+
+    const Config configs[] = {  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        {4, 8, 1, 2, &demo_mlp_4x8x1_b2::run, demo_mlp_4x8x1_b2::ARENA_FLOATS, demo_mlp_4x8x1_b2::OUTPUT_FLOATS},
+        {256, 512, 64, 1, &demo_mlp_256x512x64_b1::run, demo_mlp_256x512x64_b1::ARENA_FLOATS,
+         demo_mlp_256x512x64_b1::OUTPUT_FLOATS},
+        {256, 512, 64, 64, &demo_mlp_256x512x64_b64::run, demo_mlp_256x512x64_b64::ARENA_FLOATS,
+         demo_mlp_256x512x64_b64::OUTPUT_FLOATS},
+    };
+
+    std::printf("%-22s %10s %10s %10s %9s %10s\n", "mlp / batch", "lazy", "tape", "generated", "vs tape",
+                "max diff");
+    for (const Config& config : configs) {
+        DemoMlp mlp(config.input_size, config.hidden_size, config.output_size);
+        std::vector<float> input = DemoMlp::input(config.rows, config.input_size);
+        Tensor x(input.data(), {config.rows, config.input_size});
+        std::vector<float> interpreted(config.output_floats);
+
+        double lazy_us = median_us(repeat, [&] {
+            tt_lazy::eval_into(mlp.forward(x), interpreted.data(), interpreted.size());
+            Context::instance().clear();
+            tt_lazy::get_evaluation_manager().clear_cache();
+        });
+
+        Tensor output = mlp.forward(x);
+        TapeGenerator generator;
+        auto tape = generator.generate_tape({output});
+        TapeExecutor executor;
+        register_all_operations(executor);
+        double tape_us = median_us(repeat, [&] {
+            for (const auto& op : tape->operations()) {
+                op->is_evaluated = false;
+            }
+            executor.execute_tape(*tape);
+        });
+        interpreted = executor.get_result(output.producer_node())->to_vector();
+
+        std::vector<float> generated(config.output_floats);
+        std::vector<float> arena(config.arena_floats);
+        const float* inputs[] = {input.data()};  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        double generated_us = median_us(repeat, [&] { config.run(inputs, generated.data(), arena.data()); });
+
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < generated.size(); ++i) {
+            max_diff = std::max(max_diff, std::fabs(generated[i] - interpreted[i]));
+        }
+        std::string name = std::to_string(config.input_size) + "-" + std::to_string(config.hidden_size) + "-" +
+                           std::to_string(config.output_size) + " / " + std::to_string(config.rows);
+        std::printf("%-22s %8.2fus %8.2fus %8.2fus %8.1fx %10.2g\n", name.c_str(), lazy_us, tape_us, generated_us,
+                    tape_us / generated_us, static_cast<double>(max_diff));
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// tt_lazy_codegen: compiles a model's tape ahead of time into C++ source.
+//
+// Usage:
+//   tt_lazy_codegen --model PATH --batch-rows N --output FILE [--namespace NAME]
+//   tt_lazy_codegen --demo-mlp IN,HIDDEN,OUT --batch-rows N --output FILE [--namespace NAME]
+//
+// The graph is built for a batch of N rows, turned into an optimized tape and written out as a
+// self-contained source (see src/tape/CodeGenerator.hpp) with the weights compiled in. Include
+// or compile it in a binary linking tt_math_lib and call NAME::run(inputs, output, arena) with
+// one pointer per model input, an OUTPUT_FLOATS output buffer and an ARENA_FLOATS arena.
+// --demo-mlp generates the demo MLP of the given sizes instead of a saved model.
+
+#include "CodeGenerator.hpp"
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Model.hpp"
+#include "TapeGenerator.hpp"
+#include "Tensor.hpp"
+#include "demo_mlp.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+std::string flag_string(const std::map<std::string, std::string>& flags, const std::string& name,
+                        const std::string& fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : it->second;
+}
+
+std::vector<uint32_t> parse_sizes(const std::string& text) {
+    std::vector<uint32_t> sizes;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        sizes.push_back(static_cast<uint32_t>(std::stoul(part)));
+    }
+    if (sizes.size() != 3) {
+        throw std::runtime_error("expected IN,HIDDEN,OUT, got " + text);
+    }
+    return sizes;
+}
+
+GeneratedCode generate(const std::map<std::string, std::string>& flags, uint32_t rows, const CodegenOptions& options) {
+    // Input values do not matter: only their shapes and addresses reach the source
+    std::vector<std::vector<float>> buffers;
+    std::vector<Tensor> inputs;
+    std::unique_ptr<DemoMlp> mlp;
+    std::unique_ptr<Model> model;
+    Tensor output;
+    if (flags.count("--model") > 0) {
+        model = std::make_unique<Model>(Model::load(flags.at("--model")));
+        buffers.reserve(model->inputs().size());
+        for (size_t i = 0; i < model->inputs().size(); ++i) {
+            std::vector<uint32_t> shape{rows};
+            const auto& row_shape = model->inputs()[i].row_shape;
+            shape.insert(shape.end(), row_shape.begin(), row_shape.end());
+            buffers.emplace_back(rows * model->input_row_elements(i), 0.0f);
+            inputs.emplace_back(buffers.back().data(), shape);
+        }
+        output = model->build(inputs);
+    } else {
+        auto sizes = parse_sizes(flags.at("--demo-mlp"));
+        mlp = std::make_unique<DemoMlp>(sizes[0], sizes[1], sizes[2]);
+        buffers.emplace_back(static_cast<size_t>(rows) * sizes[0], 0.0f);
+        inputs.emplace_back(buffers.back().data(), std::vector<uint32_t>{rows, sizes[0]});
+        output = mlp->forward(inputs[0]);
+    }
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape({output});
+    GeneratedCode code = generate_cpp(*tape, inputs, output, options);
+    Context::instance().clear();
+    return code;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    spdlog::set_level(spdlog::level::err);
+
+    if ((flags.count("--model") == 0 && flags.count("--demo-mlp") == 0) || flags.count("--batch-rows") == 0 ||
+        flags.count("--output") == 0) {
+        std::fprintf(stderr, "usage: %s --model PATH | --demo-mlp IN,HIDDEN,OUT --batch-rows N --output FILE\n"
+                             "       [--namespace NAME]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    CodegenOptions options;
+    options.namespace_name = flag_string(flags, "--namespace", options.namespace_name);
+    options.embed_weights = true;
+    const std::string& path = flags.at("--output");
+    try {
+        auto rows = static_cast<uint32_t>(std::stoul(flags.at("--batch-rows")));
+        GeneratedCode code = generate(flags, rows, options);
+        std::ofstream file(path, std::ios::trunc);
+        file << code.source;
+        if (!file.flush()) {
+            throw std::runtime_error("cannot write " + path);
+        }
+        std::printf("%s: %zu kernel calls, arena %zu floats (%zu without reuse)\n", path.c_str(), code.kernel_calls,
+                    code.arena_floats, code.unplanned_floats);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "tt_lazy_codegen: %s\n", e.what());
+        return 1;
+    }
+    tt_lazy::get_evaluation_manager().clear_cache();
+    return 0;
+}
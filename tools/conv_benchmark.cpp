@@ -0,0 +1,200 @@
+// tt_lazy_conv_bench: implicit-GEMM conv2d against explicit im2col + GEMM.
+//
+// Usage:
+//   tt_lazy_conv_bench [--batch N] [--repeat N]
+//
+// Both paths use the same packed GEMM. The explicit path first materializes the
+// [pixels, C_in / groups * KH * KW] patch matrix of every image and group (im2col), which is
+// what the implicit kernel avoids; the table shows the time of each and the size of the
+// buffer the implicit kernel never allocates. "max diff" compares both against the lazy
+// conv2d operation.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tensor.hpp"
+#include "gemm.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ConvShape {
+    const char* name;
+    uint32_t channels;
+    uint32_t size;
+    uint32_t out_channels;
+    uint32_t kernel;
+    math::Conv2dParams params;
+};
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+std::vector<float> random_values(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(count);
+    for (float& value : values) {
+        value = dist(rng);
+    }
+    return values;
+}
+
+// NCHW convolution through an explicit patch matrix per image and group
+void im2col_conv(const float* input, const float* weight, const float* bias, float* output, size_t batch,
+                 const ConvShape& shape, size_t out_h, size_t out_w, std::vector<float>& columns) {
+    const math::Conv2dParams& p = shape.params;
+    size_t group_channels = shape.channels / p.groups;
+    size_t group_out = shape.out_channels / p.groups;
+    size_t depth = group_channels * shape.kernel * shape.kernel;
+    size_t pixels = out_h * out_w;
+    size_t plane = static_cast<size_t>(shape.size) * shape.size;
+    columns.resize(pixels * depth);
+
+    for (size_t n = 0; n < batch; ++n) {
+        for (size_t g = 0; g < p.groups; ++g) {
+            const float* image = input + (n * shape.channels + g * group_channels) * plane;
+            for (size_t pixel = 0; pixel < pixels; ++pixel) {
+                float* row = columns.data() + pixel * depth;
+                auto oy = static_cast<int64_t>(pixel / out_w * p.stride_h) - p.pad_h;
+                auto ox = static_cast<int64_t>(pixel % out_w * p.stride_w) - p.pad_w;
+                for (size_t c = 0; c < group_channels; ++c) {
+                    for (size_t ky = 0; ky < shape.kernel; ++ky) {
+                        for (size_t kx = 0; kx < shape.kernel; ++kx) {
+                            int64_t y = oy + static_cast<int64_t>(ky * p.dilation_h);
+                            int64_t x = ox + static_cast<int64_t>(kx * p.dilation_w);
+                            bool inside = y >= 0 && y < shape.size && x >= 0 && x < shape.size;
+                            *row++ = inside ? image[c * plane + static_cast<size_t>(y) * shape.size +
+                                                    static_cast<size_t>(x)]
+                                            : 0.0f;
+                        }
+                    }
+                }
+            }
+            // Weights [group_out, depth] times the transposed patches give the NCHW block
+            float* out = output + (n * shape.out_channels + g * group_out) * pixels;
+            math::gemm(group_out, pixels, depth, weight + g * group_out * depth, depth, false, columns.data(), depth,
+                       true, out, pixels);
+            if (bias) {
+                for (size_t oc = 0; oc < group_out; ++oc) {
+                    for (size_t i = 0; i < pixels; ++i) {
+                        out[oc * pixels + i] += bias[g * group_out + oc];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename Fn>
+double best_ms(size_t repeat, Fn&& fn) {
+    double best = 1e30;
+    for (size_t i = 0; i < repeat; ++i) {
+        auto start = Clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t batch = flag_value(flags, "--batch", 4);
+    size_t repeat = flag_value(flags, "--repeat", 5);
+    spdlog::set_level(spdlog::level::err);  // Keep the graph passes' progress out of the table
+
+    math::Conv2dParams same;
+    same.pad_h = same.pad_w = 1;
+    math::Conv2dParams strided = same;
+    strided.stride_h = strided.stride_w = 2;
+    math::Conv2dParams dilated;
+    dilated.pad_h = dilated.pad_w = 2;
+    dilated.dilation_h = dilated.dilation_w = 2;
+    math::Conv2dParams depthwise = same;
+    depthwise.groups = 128;
+    math::Conv2dParams pointwise;
+
+    std::vector<ConvShape> shapes = {
+        {"3x3 64->64 56x56", 64, 56, 64, 3, same},
+        {"3x3 128->128 28x28 s2", 128, 28, 128, 3, strided},
+        {"3x3 64->64 28x28 d2", 64, 28, 64, 3, dilated},
+        {"1x1 256->64 28x28", 256, 28, 64, 1, pointwise},
+        {"3x3 depthwise 128 28x28", 128, 28, 128, 3, depthwise},
+    };
+
+    std::printf("batch=%zu, best of %zu\n", batch, repeat);
+    std::printf("%-26s %10s %10s %8s %12s %10s\n", "shape", "implicit", "im2col", "speedup", "im2col MB",
+                "max diff");
+    for (const ConvShape& shape : shapes) {
+        uint32_t group_channels = shape.channels / shape.params.groups;
+        auto input = random_values(batch * shape.channels * shape.size * shape.size, 1);
+        auto weight = random_values(static_cast<size_t>(shape.out_channels) * group_channels * shape.kernel *
+                                        shape.kernel,
+                                    2);
+        auto bias = random_values(shape.out_channels, 3);
+
+        Tensor input_tensor(input.data(), {static_cast<uint32_t>(batch), shape.channels, shape.size, shape.size});
+        Tensor weight_tensor(weight.data(), {shape.out_channels, group_channels, shape.kernel, shape.kernel});
+        Tensor bias_tensor(bias.data(), {shape.out_channels});
+
+        Tensor implicit = math::conv2d(input_tensor, weight_tensor, bias_tensor, shape.params);
+        size_t out_h = implicit.size(2);
+        size_t out_w = implicit.size(3);
+        std::vector<float> explicit_output(implicit.total_elements());
+        std::vector<float> columns;
+
+        double implicit_ms = best_ms(repeat, [&] {
+            math::conv2d(input_tensor, weight_tensor, bias_tensor, implicit, shape.params);
+        });
+        double explicit_ms = best_ms(repeat, [&] {
+            im2col_conv(input.data(), weight.data(), bias.data(), explicit_output.data(), batch, shape, out_h, out_w,
+                        columns);
+        });
+
+        Conv2DArgs args;
+        args.stride_h = shape.params.stride_h;
+        args.stride_w = shape.params.stride_w;
+        args.pad_h = shape.params.pad_h;
+        args.pad_w = shape.params.pad_w;
+        args.dilation_h = shape.params.dilation_h;
+        args.dilation_w = shape.params.dilation_w;
+        args.groups = shape.params.groups;
+        auto lazy = conv2d(input_tensor, weight_tensor, bias_tensor, args).to_vector();
+        const float* result = implicit.const_data_ptr();
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < lazy.size(); ++i) {
+            max_diff = std::max({max_diff, std::fabs(result[i] - lazy[i]), std::fabs(explicit_output[i] - lazy[i])});
+        }
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+        std::printf("%-26s %8.2fms %8.2fms %7.2fx %12.2f %10.2e\n", shape.name, implicit_ms, explicit_ms,
+                    explicit_ms / implicit_ms, static_cast<double>(columns.size() * sizeof(float)) / (1 << 20),
+                    static_cast<double>(max_diff));
+    }
+    return 0;
+}
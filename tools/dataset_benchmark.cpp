@@ -0,0 +1,179 @@
+// tt_lazy_dataset_bench: end-to-end offline scoring throughput with DatasetReader.
+//
+// Usage:
+//   tt_lazy_dataset_bench --create <file.npy> [--rows N] [--width N]
+//   tt_lazy_dataset_bench <file.npy|file.f32> [--width N] [--batch N] [--prefetch N]
+//                         [--io pread|mmap] [--hidden N]
+//                         [--output <scores.npy> [--writer sync|async] [--direct 0|1]]
+//
+// Every batch runs through a two-layer ReLU MLP; compare --prefetch 0 (read, then compute)
+// with the default double buffering to see how much I/O the prefetch thread hides. With
+// --output the scores are written either synchronously after each batch or through
+// ResultWriter's background thread.
+
+#include "Context.hpp"
+#include "DatasetReader.hpp"
+#include "EvaluationManager.hpp"
+#include "NpyFormat.hpp"
+#include "ResultWriter.hpp"
+#include "operations.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv, int first) {
+    std::map<std::string, std::string> flags;
+    for (int i = first; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+int create_dataset(const std::string& path, const std::map<std::string, std::string>& flags) {
+    uint64_t rows = flag_value(flags, "--rows", 1'000'000);
+    auto width = static_cast<uint32_t>(flag_value(flags, "--width", 64));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << npy::make_header(rows, width);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> chunk(static_cast<size_t>(width) * 4096);
+    for (uint64_t row = 0; row < rows; row += 4096) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(4096, rows - row)) * width;
+        for (size_t i = 0; i < count; ++i) {
+            chunk[i] = dist(rng);
+        }
+        file.write(reinterpret_cast<const char*>(chunk.data()),  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                   static_cast<std::streamsize>(count * sizeof(float)));
+    }
+    if (!file) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << rows << " x " << width << " float32 rows to " << path << std::endl;
+    return 0;
+}
+
+int run(const std::string& path, const std::map<std::string, std::string>& flags) {
+    DatasetReader::Options options;
+    options.batch_rows = static_cast<uint32_t>(flag_value(flags, "--batch", 256));
+    options.row_width = static_cast<uint32_t>(flag_value(flags, "--width", 0));
+    options.prefetch_batches = flag_value(flags, "--prefetch", 1);
+    auto io = flags.find("--io");
+    options.io_mode = io != flags.end() && io->second == "mmap" ? DatasetReader::IoMode::MMAP
+                                                                 : DatasetReader::IoMode::PREAD;
+    auto hidden = static_cast<uint32_t>(flag_value(flags, "--hidden", 256));
+
+    DatasetReader reader(path, options);
+    uint32_t width = reader.row_width();
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> dist(0.0f, 0.05f);
+    auto random_vector = [&](size_t size) {
+        std::vector<float> values(size);
+        for (auto& value : values) {
+            value = dist(rng);
+        }
+        return values;
+    };
+    std::vector<float> w1 = random_vector(static_cast<size_t>(width) * hidden);
+    std::vector<float> b1 = random_vector(hidden);
+    std::vector<float> w2 = random_vector(static_cast<size_t>(hidden) * 16);
+    std::vector<float> b2 = random_vector(16);
+    std::vector<float> output(static_cast<size_t>(options.batch_rows) * 16);
+
+    auto output_path = flags.find("--output");
+    auto writer_mode = flags.find("--writer");
+    bool async_writer = writer_mode == flags.end() || writer_mode->second != "sync";
+    std::unique_ptr<ResultWriter> writer;
+    std::ofstream sync_output;
+    if (output_path != flags.end() && async_writer) {
+        ResultWriter::Options writer_options;
+        writer_options.format = ResultWriter::Format::RAW;
+        writer_options.direct_io = flag_value(flags, "--direct", 0) != 0;
+        writer = std::make_unique<ResultWriter>(output_path->second, writer_options);
+    } else if (output_path != flags.end()) {
+        sync_output.open(output_path->second, std::ios::binary | std::ios::trunc);
+    }
+
+    double checksum = 0.0;
+    auto start = Clock::now();
+    while (Tensor batch = reader.next()) {
+        Tensor h = fused_mlp(batch, Tensor(w1.data(), {width, hidden}), Tensor(b1.data(), {1, hidden}), true);
+        Tensor y = fused_mlp(h, Tensor(w2.data(), {hidden, 16}), Tensor(b2.data(), {1, 16}), false);
+        if (writer) {
+            writer->write(y);
+        } else {
+            tt_lazy::eval_into(y, output.data(), y.total_elements());
+            checksum += output[0];
+            if (sync_output.is_open()) {
+                sync_output.write(reinterpret_cast<const char*>(  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+                                      output.data()),
+                                  static_cast<std::streamsize>(y.total_elements() * sizeof(float)));
+                sync_output.flush();
+            }
+        }
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+    if (writer) {
+        writer->close();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto stats = reader.stats();
+    std::cout << "rows=" << stats.rows << " width=" << width << " batch=" << options.batch_rows
+              << " prefetch=" << options.prefetch_batches
+              << " io=" << (options.io_mode == DatasetReader::IoMode::MMAP ? "mmap" : "pread") << "\n"
+              << "  rows/s:         " << static_cast<double>(stats.rows) / seconds << "\n"
+              << "  read MiB/s:     " << static_cast<double>(stats.bytes_read) / (1024.0 * 1024.0) / seconds << "\n"
+              << "  reader wait:    " << static_cast<double>(stats.wait_ns) / 1e6 << " ms ("
+              << 100.0 * static_cast<double>(stats.wait_ns) / 1e9 / seconds << "% of wall time)\n"
+              << "  checksum:       " << checksum << std::endl;
+    if (writer) {
+        auto written = writer->stats();
+        std::cout << "  writer:         async" << (written.direct_io ? " O_DIRECT" : "") << ", "
+                  << static_cast<double>(written.bytes_written) / (1024.0 * 1024.0) << " MiB, producer wait "
+                  << static_cast<double>(written.producer_wait_ns) / 1e6 << " ms, I/O "
+                  << static_cast<double>(written.io_ns) / 1e6 << " ms" << std::endl;
+    } else if (sync_output.is_open()) {
+        std::cout << "  writer:         sync" << std::endl;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::string(argv[1]) == "--create") {
+        return create_dataset(argv[2], parse_flags(argc, argv, 3));
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: " << argv[0] << " --create <file.npy> [--rows N] [--width N]\n"
+                  << "       " << argv[0]
+                  << " <file> [--width N] [--batch N] [--prefetch N] [--io pread|mmap] [--hidden N]"
+                  << " [--output <file> [--writer sync|async] [--direct 0|1]]" << std::endl;
+        return 1;
+    }
+    try {
+        return run(argv[1], parse_flags(argc, argv, 2));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+// The demo MLP (tests/cpp/benchmarks/test_mlp_demo.cpp) at any size, for the code generator
+// and its benchmark: out = relu(x W1 + b1) W2 + b2, with the demo's deterministic weights.
+
+#include "Tensor.hpp"
+#include "operations.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class DemoMlp {
+   public:
+    DemoMlp(uint32_t input_size, uint32_t hidden_size, uint32_t output_size)
+        : w1_data_(pattern(input_size * hidden_size, 0.1f)),
+          b1_data_(pattern(hidden_size, 0.01f)),
+          w2_data_(pattern(hidden_size * output_size, 0.1f)),
+          b2_data_(pattern(output_size, 0.01f)),
+          w1_(w1_data_.data(), {input_size, hidden_size}),
+          b1_(b1_data_.data(), {1, hidden_size}),
+          w2_(w2_data_.data(), {hidden_size, output_size}),
+          b2_(b2_data_.data(), {1, output_size}) {}
+
+    // Non-copyable: the tensors point into the member buffers
+    DemoMlp(const DemoMlp&) = delete;
+    DemoMlp& operator=(const DemoMlp&) = delete;
+    DemoMlp(DemoMlp&&) = delete;
+    DemoMlp& operator=(DemoMlp&&) = delete;
+    ~DemoMlp() = default;
+
+    Tensor forward(const Tensor& x) const { return add(matmul(relu(add(matmul(x, w1_), b1_)), w2_), b2_); }
+
+    uint32_t input_size() const { return w1_.size(0); }
+    uint32_t output_size() const { return w2_.size(1); }
+
+    // Input rows with values in [-1, 1)
+    static std::vector<float> input(uint32_t rows, uint32_t input_size) {
+        std::vector<float> values(static_cast<size_t>(rows) * input_size);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<float>((i * 7919) % 200) * 0.01f - 1.0f;
+        }
+        return values;
+    }
+
+   private:
+    static std::vector<float> pattern(size_t count, float scale) {
+        std::vector<float> values(count);
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = scale * (1.0f + 0.1f * static_cast<float>(i % 10));
+        }
+        return values;
+    }
+
+    std::vector<float> w1_data_, b1_data_, w2_data_, b2_data_;
+    Tensor w1_, b1_;  // Layer 1: input_size -> hidden_size
+    Tensor w2_, b2_;  // Layer 2: hidden_size -> output_size
+};
@@ -0,0 +1,103 @@
+// tt_lazy_dispatch_bench: cost of building graph nodes through the frontend operations.
+//
+// Usage:
+//   tt_lazy_dispatch_bench [--repeat N] [--ops-per-batch N]
+//
+// Each sample builds a batch of nodes with one operation - chained on its own output where the
+// shapes allow - and then clears the context outside the timed region. Reports the median time
+// per operation and the heap allocations per operation (every operator new is counted).
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tensor.hpp"
+#include "allocation_counter.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t SIZE = 8;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+struct Operation {
+    const char* name;
+    std::function<Tensor(const Tensor&)> build;  // Next node from the previous result
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t repeat = std::max<size_t>(1, flag_value(flags, "--repeat", 50));
+    // The context reserves room for 1024 nodes; larger batches also time node array growth
+    size_t ops_per_batch = std::max<size_t>(1, flag_value(flags, "--ops-per-batch", 512));
+    spdlog::set_level(spdlog::level::err);
+
+    std::vector<float> square_data(SIZE * SIZE, 0.5f);
+    std::vector<float> row_data(SIZE, 0.25f);
+    std::vector<float> index_data(SIZE, 1.0f);
+    Tensor square(square_data.data(), {SIZE, SIZE});
+    Tensor row(row_data.data(), {1, SIZE});
+    Tensor indices(index_data.data(), {SIZE});
+
+    const std::vector<Operation> operations = {
+        {"relu", [](const Tensor& x) { return relu(x); }},
+        {"add", [&](const Tensor& x) { return add(x, square); }},
+        {"add (broadcast)", [&](const Tensor& x) { return add(x, row); }},
+        {"multiply", [&](const Tensor& x) { return multiply(x, square); }},
+        {"matmul", [&](const Tensor& x) { return matmul(x, square); }},
+        {"fused_mlp", [&](const Tensor& x) { return fused_mlp(x, square, row); }},
+        {"reduce_sum", [&](const Tensor& /*x*/) { return reduce_sum(square, {1}, true); }},
+        {"gather", [&](const Tensor& x) { return gather(x, indices); }},
+        {"argmax", [&](const Tensor& /*x*/) { return argmax(square); }},
+    };
+
+    std::printf("%-16s %10s %12s\n", "operation", "ns/op", "allocs/op");
+    for (const Operation& operation : operations) {
+        std::vector<double> times;
+        size_t allocations = 0;
+        for (size_t sample = 0; sample <= repeat; ++sample) {  // Sample 0 warms up
+            Tensor x = square;
+            size_t before = allocation_count().load(std::memory_order_relaxed);
+            auto start = Clock::now();
+            for (size_t i = 0; i < ops_per_batch; ++i) {
+                x = operation.build(x);
+            }
+            auto elapsed = Clock::now() - start;
+            if (sample > 0) {
+                allocations += allocation_count().load(std::memory_order_relaxed) - before;
+                times.push_back(std::chrono::duration<double, std::nano>(elapsed).count() /
+                                static_cast<double>(ops_per_batch));
+            }
+            Context::instance().clear();
+            tt_lazy::get_evaluation_manager().clear_cache();
+        }
+        std::sort(times.begin(), times.end());
+        std::printf("%-16s %10.1f %12.2f\n", operation.name, times[times.size() / 2],
+                    static_cast<double>(allocations) / static_cast<double>(repeat * ops_per_batch));
+    }
+    return 0;
+}
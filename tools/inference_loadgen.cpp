@@ -0,0 +1,167 @@
+// tt_lazy_loadgen: closed-loop load generator for tt_lazy_server.
+//
+// Usage:
+//   tt_lazy_loadgen --create-model <path> [--in N] [--hidden N] [--out N] [--layers N]
+//   tt_lazy_loadgen <socket-path> [--clients N] [--rows N] [--seconds N] [--timeout-us N]
+//
+// Each client thread keeps one request in flight and reports throughput plus end-to-end
+// latency percentiles; the server's own statistics are printed at the end.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "InferenceClient.hpp"
+#include "Model.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv, int first) {
+    std::map<std::string, std::string> flags;
+    for (int i = first; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+// Random ReLU MLP: in -> hidden x layers -> out
+int create_model(const std::string& path, const std::map<std::string, std::string>& flags) {
+    auto in = static_cast<uint32_t>(flag_value(flags, "--in", 256));
+    auto hidden = static_cast<uint32_t>(flag_value(flags, "--hidden", 512));
+    auto out = static_cast<uint32_t>(flag_value(flags, "--out", 64));
+    size_t layers = flag_value(flags, "--layers", 3);
+
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dist(0.0f, 0.05f);
+    std::vector<std::vector<float>> storage;
+    auto random_tensor = [&](uint32_t rows, uint32_t cols) {
+        storage.emplace_back(static_cast<size_t>(rows) * cols);
+        std::generate(storage.back().begin(), storage.back().end(), [&]() { return dist(rng); });
+        return Tensor(storage.back().data(), {rows, cols});
+    };
+
+    storage.reserve(2 * layers + 3);
+    storage.emplace_back(in, 0.0f);
+    Tensor input(storage.back().data(), {1, in});
+    Tensor x = input;
+    uint32_t width = in;
+    for (size_t layer = 0; layer < layers; ++layer) {
+        bool last = layer + 1 == layers;
+        uint32_t next = last ? out : hidden;
+        Tensor w = random_tensor(width, next);
+        Tensor b = random_tensor(1, next);
+        x = fused_mlp(x, w, b, !last);
+        width = next;
+    }
+
+    Model::save(path, {{"x", input}}, x);
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+    std::cout << "Wrote " << layers << "-layer MLP (" << in << " -> " << hidden << " -> " << out << ") to " << path
+              << std::endl;
+    return 0;
+}
+
+int run_load(const std::string& socket_path, const std::map<std::string, std::string>& flags) {
+    size_t num_clients = flag_value(flags, "--clients", 8);
+    auto rows = static_cast<uint32_t>(flag_value(flags, "--rows", 1));
+    auto seconds = flag_value(flags, "--seconds", 5);
+    std::chrono::microseconds timeout(flag_value(flags, "--timeout-us", 0));
+
+    std::atomic<bool> failed{false};
+    std::vector<std::vector<double>> latencies(num_clients);
+    std::vector<size_t> deadline_misses(num_clients, 0);
+    auto end_time = Clock::now() + std::chrono::seconds(seconds);
+
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < num_clients; ++c) {
+        threads.emplace_back([&, c]() {
+            try {
+                InferenceClient client(socket_path, 1);
+                std::fill(client.input(0), client.input(0) + rows * client.input_row_elements(), 0.5f);
+                uint64_t request_id = 0;
+                while (Clock::now() < end_time) {
+                    auto start = Clock::now();
+                    client.submit(request_id++, 0, rows, timeout);
+                    auto result = client.wait();
+                    auto us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+                    if (result.status == inference::Status::OK) {
+                        latencies[c].push_back(us);
+                    } else if (result.status == inference::Status::DEADLINE_EXCEEDED) {
+                        deadline_misses[c]++;
+                    } else {
+                        throw std::runtime_error(std::string("request failed: ") +
+                                                 inference::status_name(result.status));
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "client " << c << ": " << e.what() << std::endl;
+                failed = true;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<double> all;
+    size_t misses = 0;
+    for (size_t c = 0; c < num_clients; ++c) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        misses += deadline_misses[c];
+    }
+    std::sort(all.begin(), all.end());
+    auto pct = [&all](double p) { return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))]; };
+
+    double elapsed = static_cast<double>(seconds);
+    std::cout << "clients: " << num_clients << ", rows/request: " << rows << "\n"
+              << "requests: " << all.size() << " (" << all.size() / elapsed << " req/s, "
+              << all.size() * rows / elapsed << " rows/s), deadline misses: " << misses << "\n"
+              << "latency us: p50 " << pct(0.50) << ", p90 " << pct(0.90) << ", p99 " << pct(0.99) << ", max "
+              << (all.empty() ? 0.0 : all.back()) << "\n";
+
+    InferenceClient stats_client(socket_path, 1);
+    std::cout << "server stats: " << stats_client.stats_json() << std::endl;
+    return failed ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: tt_lazy_loadgen --create-model <path> [--in N] [--hidden N] [--out N] [--layers N]\n"
+                     "       tt_lazy_loadgen <socket-path> [--clients N] [--rows N] [--seconds N] [--timeout-us N]\n";
+        return 1;
+    }
+    try {
+        std::string first = argv[1];
+        if (first == "--create-model") {
+            if (argc < 3) {
+                std::cerr << "--create-model needs a path\n";
+                return 1;
+            }
+            return create_model(argv[2], parse_flags(argc, argv, 3));
+        }
+        return run_load(first, parse_flags(argc, argv, 2));
+    } catch (const std::exception& e) {
+        std::cerr << "tt_lazy_loadgen: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,78 @@
+// tt_lazy_server: serve a saved Model over a Unix domain socket.
+//
+// Usage: tt_lazy_server <model-file> <socket-path> [--max-batch-rows N] [--batch-window-us N]
+//                       [--max-rows-per-request N] [--shared-weights SEGMENT]
+
+#include "InferenceServer.hpp"
+#include "Model.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+InferenceServer* g_server = nullptr;
+
+void handle_signal(int /*signal*/) {
+    if (g_server) {
+        g_server->stop();
+    }
+}
+
+void usage() {
+    std::cerr << "Usage: tt_lazy_server <model-file> <socket-path> [--max-batch-rows N] [--batch-window-us N]\n"
+                 "                      [--max-rows-per-request N] [--shared-weights SEGMENT]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+
+    std::string model_path = argv[1];
+    InferenceServer::Options options;
+    options.socket_path = argv[2];
+    std::string shared_segment;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (flag == "--max-batch-rows") {
+            options.max_batch_rows = static_cast<uint32_t>(std::stoul(value));
+        } else if (flag == "--batch-window-us") {
+            options.batch_window_us = static_cast<uint32_t>(std::stoul(value));
+        } else if (flag == "--max-rows-per-request") {
+            options.max_rows_per_request = static_cast<uint32_t>(std::stoul(value));
+        } else if (flag == "--shared-weights") {
+            shared_segment = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    try {
+        InferenceServer server(Model::load(model_path, shared_segment), options);
+        g_server = &server;
+        std::signal(SIGINT, handle_signal);
+        std::signal(SIGTERM, handle_signal);
+        server.run();
+        g_server = nullptr;
+        std::cout << server.stats_json() << std::endl;
+    } catch (const std::exception& e) {
+        spdlog::error("tt_lazy_server: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
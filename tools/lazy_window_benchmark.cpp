@@ -0,0 +1,111 @@
+// tt_lazy_window_bench: a streaming loop that never reads its state, under several lazy windows.
+//
+// Usage:
+//   tt_lazy_window_bench [--steps N] [--dim N] [--windows 0,64,512,4096]
+//
+// Each step is x = relu(x @ w + b) on a dim x dim state, three graph nodes, and the state is
+// read once at the end. For each window (max pending nodes; 0 = unbounded), run in its own
+// process so peak RSS is comparable:
+//   - total:   wall time of building the whole loop plus the final read
+//   - flushes: automatic window flushes, and the operations on the largest tape compiled
+//   - peak:    peak resident set size of the process
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "TapeEvaluationManager.hpp"
+#include "operations.hpp"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::stoul(item));
+    }
+    return values;
+}
+
+void run(size_t window, size_t steps, uint32_t dim) {
+    auto manager = std::make_shared<tt_lazy::TapeEvaluationManager>();
+    tt_lazy::set_evaluation_manager(manager);
+    manager->set_lazy_window({window, 0});
+
+    std::vector<float> x_data(static_cast<size_t>(dim) * dim, 0.5f);
+    std::vector<float> w_data(static_cast<size_t>(dim) * dim, 1.0f / static_cast<float>(dim));
+    std::vector<float> b_data(dim, 0.01f);
+    Tensor w(w_data.data(), {dim, dim});
+    Tensor b(b_data.data(), {1, dim});
+
+    auto start = Clock::now();
+    Tensor x(x_data.data(), {dim, dim});
+    for (size_t i = 0; i < steps; ++i) {
+        x = relu(add(matmul(x, w), b));
+    }
+    float checksum = x.to_vector()[0];
+    double total_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const auto& stats = manager->window_stats();
+    size_t largest_tape = std::max(stats.largest_tape, manager->last_tape_timing().operations);
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("%-8zu %10.1f %9zu %14zu %12.1f %10.4f\n", window, total_ms, stats.flushes, largest_tape,
+                static_cast<double>(usage.ru_maxrss) / 1024.0, static_cast<double>(checksum));
+    tt_lazy::set_evaluation_manager(nullptr);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t steps = flags.count("--steps") ? std::stoul(flags["--steps"]) : 2000;
+    auto dim = static_cast<uint32_t>(flags.count("--dim") ? std::stoul(flags["--dim"]) : 64);
+    std::vector<size_t> windows = parse_list(flags.count("--windows") ? flags["--windows"] : "0,64,512,4096");
+    spdlog::set_level(spdlog::level::err);
+
+    std::printf("%zu steps, %ux%u state, %zu nodes\n", steps, dim, dim, steps * 3);
+    std::printf("%-8s %10s %9s %14s %12s %10s\n", "window", "total ms", "flushes", "largest tape", "peak MiB",
+                "checksum");
+    for (size_t window : windows) {
+        std::fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            run(window, steps, dim);
+            std::fflush(stdout);
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::fprintf(stderr, "window %zu failed\n", window);
+            return 1;
+        }
+    }
+    return 0;
+}
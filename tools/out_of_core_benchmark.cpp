@@ -0,0 +1,165 @@
+// tt_lazy_out_of_core_bench: run a deep MatMul chain with weights resident, memory-mapped,
+// or memory-mapped with executor-driven prefetch/release (WeightPrefetcher).
+//
+// Usage:
+//   tt_lazy_out_of_core_bench --create <weights-file> [--width N] [--layers N]
+//   tt_lazy_out_of_core_bench <weights-file> [--mode resident|mapped|prefetch] [--rows N]
+//                             [--iterations N] [--lookahead N]
+//
+// Run under tools/run_with_memory_limit.sh to compare the modes when the weights exceed RAM.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "MappedWeightFile.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "WeightPrefetcher.hpp"
+#include "operations.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv, int first) {
+    std::map<std::string, std::string> flags;
+    for (int i = first; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+std::string layer_name(size_t layer) {
+    return "layer" + std::to_string(layer);
+}
+
+size_t peak_rss_mib() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+}
+
+// Square layers, written one at a time so creating the file never holds every weight
+int create_weights(const std::string& path, const std::map<std::string, std::string>& flags) {
+    auto width = static_cast<uint32_t>(flag_value(flags, "--width", 2048));
+    size_t layers = flag_value(flags, "--layers", 16);
+
+    std::mt19937 rng(7);
+    std::normal_distribution<float> dist(0.0f, 1.0f / static_cast<float>(width));
+    std::vector<std::vector<float>> storage(layers);
+    std::vector<std::pair<std::string, Tensor>> weights;
+    for (size_t layer = 0; layer < layers; ++layer) {
+        storage[layer].resize(static_cast<size_t>(width) * width);
+        for (auto& value : storage[layer]) {
+            value = dist(rng);
+        }
+        weights.emplace_back(layer_name(layer), Tensor(storage[layer].data(), {width, width}));
+    }
+    MappedWeightFile::write(path, weights);
+    std::cout << "Wrote " << layers << " layers of " << width << "x" << width << " ("
+              << layers * width * width * sizeof(float) / (1024 * 1024) << " MiB) to " << path << std::endl;
+    return 0;
+}
+
+int run(const std::string& path, const std::map<std::string, std::string>& flags) {
+    auto it = flags.find("--mode");
+    std::string mode = it == flags.end() ? "prefetch" : it->second;
+    if (mode != "resident" && mode != "mapped" && mode != "prefetch") {
+        std::cerr << "Unknown mode '" << mode << "'" << std::endl;
+        return 1;
+    }
+    auto rows = static_cast<uint32_t>(flag_value(flags, "--rows", 8));
+    size_t iterations = flag_value(flags, "--iterations", 3);
+
+    auto file = MappedWeightFile::open(path);
+    auto names = file->names();
+    std::vector<std::vector<float>> resident(mode == "resident" ? names.size() : 0);
+    std::vector<Tensor> weights;
+    for (size_t layer = 0; layer < names.size(); ++layer) {
+        Tensor mapped = file->get(layer_name(layer));
+        if (mode != "resident") {
+            weights.push_back(mapped);
+            continue;
+        }
+        resident[layer].assign(mapped.const_data_ptr(), mapped.const_data_ptr() + mapped.total_elements());
+        weights.emplace_back(resident[layer].data(), std::vector<uint32_t>(mapped.shape(), mapped.shape() + 2));
+    }
+    uint32_t width = weights.front().shape()[0];
+
+    std::vector<float> input(static_cast<size_t>(rows) * width, 1.0f);
+    Tensor x(input.data(), {rows, width});
+    for (const auto& weight : weights) {
+        x = relu(matmul(x, weight));
+    }
+
+    TapeGenerator generator;
+    auto tape = generator.generate_tape(x);
+    TapeExecutor executor;
+    register_all_operations(executor);
+    WeightPrefetcher::Options options;
+    options.lookahead = flag_value(flags, "--lookahead", 2);
+    WeightPrefetcher prefetcher(file, options);
+    if (mode == "prefetch") {
+        executor.add_observer(&prefetcher);
+    }
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& op : tape->operations()) {
+            op->is_evaluated = false;
+            op->result.reset();
+        }
+        executor.clear_results();
+        executor.execute_tape(*tape);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto stats = prefetcher.stats();
+    std::cout << "mode=" << mode << " layers=" << weights.size() << " width=" << width << " rows=" << rows
+              << " iterations=" << iterations << "\n"
+              << "  rows/s:          " << static_cast<double>(rows * iterations) / seconds << "\n"
+              << "  seconds/pass:    " << seconds / static_cast<double>(iterations) << "\n"
+              << "  peak RSS:        " << peak_rss_mib() << " MiB\n"
+              << "  mapped resident: " << file->resident_bytes() / (1024 * 1024) << " MiB\n"
+              << "  prefetched:      " << stats.prefetched_bytes / (1024 * 1024) << " MiB\n"
+              << "  released:        " << stats.released_bytes / (1024 * 1024) << " MiB" << std::endl;
+
+    Context::instance().clear();
+    tt_lazy::get_evaluation_manager().clear_cache();
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::string(argv[1]) == "--create") {
+        return create_weights(argv[2], parse_flags(argc, argv, 3));
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        std::cerr << "Usage: " << argv[0] << " --create <weights-file> [--width N] [--layers N]\n"
+                  << "       " << argv[0]
+                  << " <weights-file> [--mode resident|mapped|prefetch] [--rows N] [--iterations N] [--lookahead N]"
+                  << std::endl;
+        return 1;
+    }
+    try {
+        return run(argv[1], parse_flags(argc, argv, 2));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+# Run a command with a hard memory limit (cgroup v2), e.g. to compare the
+# resident, mapped and prefetch modes of tt_lazy_out_of_core_bench when the
+# weights do not fit:
+#
+#   tools/run_with_memory_limit.sh 512M ./build/tt_lazy_out_of_core_bench weights.bin --mode prefetch
+#
+# Uses a transient systemd scope when available, otherwise a child cgroup of
+# the current one (requires write access to the cgroup v2 hierarchy).
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <limit, e.g. 512M> <command> [args...]" >&2
+    exit 1
+fi
+limit="$1"
+shift
+
+if command -v systemd-run >/dev/null 2>&1 && systemd-run --user --scope true >/dev/null 2>&1; then
+    exec systemd-run --user --scope --quiet -p MemoryMax="$limit" -p MemorySwapMax=0 "$@"
+fi
+
+parent="/sys/fs/cgroup$(sed -n 's/^0:://p' /proc/self/cgroup)"
+group="$parent/tt_lazy_limit_$$"
+mkdir "$group"
+trap 'rmdir "$group" 2>/dev/null || true' EXIT
+echo "$limit" > "$group/memory.max"
+echo 0 > "$group/memory.swap.max" 2>/dev/null || true
+sh -c 'echo $$ > "$1/cgroup.procs" && shift && exec "$@"' _ "$group" "$@"
@@ -0,0 +1,145 @@
+// tt_lazy_shape_bench: cost of shape handling per tensor rank, for graph building and kernels.
+//
+// Usage:
+//   tt_lazy_shape_bench [--repeat N] [--max-rank N] [--elements N]
+//
+// For each rank, with the elements spread over the dimensions as evenly as possible:
+//   - dispatch: median time to build a relu node through the frontend (shape copy + numel)
+//   - copy:     median time to copy a lazy tensor (the shape travels with it)
+//   - add:      median time of an eager same-shape math::add
+//   - bias add: median time of an eager math::add of a [.., 1, N] row broadcast into the tensor
+//   - reduce:   median time of an eager math::reduce_sum over the last dimension
+// --max-rank 4 limits a run to the ranks older trees support, for before/after comparisons.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "Tensor.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t NODES_PER_SAMPLE = 512;
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+// About `elements` elements over `rank` dimensions; the leading ones absorb the remainder
+std::vector<uint32_t> shape_for(size_t rank, size_t elements) {
+    auto side = static_cast<uint32_t>(
+        std::max(1.0, std::floor(std::pow(static_cast<double>(elements), 1.0 / static_cast<double>(rank)))));
+    std::vector<uint32_t> shape(rank, side);
+    size_t rest = elements;
+    for (size_t i = 1; i < rank; ++i) {
+        rest /= side;
+    }
+    shape[0] = static_cast<uint32_t>(std::max<size_t>(1, rest));
+    return shape;
+}
+
+void no_reset() {}
+
+// Median of `repeat` timed samples after one warm-up, in nanoseconds per `per_sample` operations;
+// `reset` runs untimed after every sample
+template <typename Sample, typename Reset = void (*)()>
+double median_ns(size_t repeat, size_t per_sample, const Sample& sample, const Reset& reset = no_reset) {
+    std::vector<double> times;
+    for (size_t i = 0; i <= repeat; ++i) {
+        auto start = Clock::now();
+        sample();
+        auto elapsed = Clock::now() - start;
+        reset();
+        if (i > 0) {
+            times.push_back(std::chrono::duration<double, std::nano>(elapsed).count() /
+                            static_cast<double>(per_sample));
+        }
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t repeat = std::max<size_t>(1, flag_value(flags, "--repeat", 50));
+    size_t max_rank = std::clamp<size_t>(flag_value(flags, "--max-rank", 8), 1, 8);
+    size_t elements = std::max<size_t>(1, flag_value(flags, "--elements", 1 << 16));
+    spdlog::set_level(spdlog::level::err);
+
+    std::printf("%-4s %-26s %12s %10s %10s %12s %12s\n", "rank", "shape", "dispatch ns", "copy ns", "add us",
+                "bias add us", "reduce us");
+    for (size_t rank = 1; rank <= max_rank; ++rank) {
+        std::vector<uint32_t> shape = shape_for(rank, elements);
+        std::vector<uint32_t> row_shape(rank, 1);
+        row_shape.back() = shape.back();
+
+        // Constants over our own memory, so nodes built from them never copy the data
+        Tensor out(shape);
+        std::vector<float> a_data(out.total_elements(), 0.5f);
+        std::vector<float> b_data(out.total_elements(), 0.25f);
+        std::vector<float> row_data(shape.back(), 1.0f);
+        Tensor a(a_data.data(), shape);
+        Tensor b(b_data.data(), shape);
+        Tensor row(row_data.data(), row_shape);
+
+        double dispatch = median_ns(
+            repeat, NODES_PER_SAMPLE,
+            [&] {
+                Tensor x = a;
+                for (size_t i = 0; i < NODES_PER_SAMPLE; ++i) {
+                    x = relu(x);
+                }
+            },
+            [] {
+                Context::instance().clear();
+                tt_lazy::get_evaluation_manager().clear_cache();
+            });
+
+        Tensor lazy = relu(a);
+        double copy = median_ns(repeat, NODES_PER_SAMPLE, [&] {
+            for (size_t i = 0; i < NODES_PER_SAMPLE; ++i) {
+                Tensor copied = lazy;
+                lazy = std::move(copied);
+            }
+        });
+        Context::instance().clear();
+
+        double add = median_ns(repeat, 1, [&] { math::add(a, b, out); }) / 1000.0;
+        // At rank 1 the row is the whole tensor
+        double bias_add = rank > 1 ? median_ns(repeat, 1, [&] { math::add(a, row, out); }) / 1000.0 : 0.0;
+        int32_t last = static_cast<int32_t>(rank) - 1;
+        double reduce = median_ns(repeat, 1, [&] { math::reduce_sum(a, {last}); }) / 1000.0;
+
+        std::string shape_text;
+        for (size_t i = 0; i < shape.size(); ++i) {
+            shape_text += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+        }
+        std::printf("%-4zu %-26s %12.1f %10.1f %10.2f %12.2f %12.2f\n", rank, shape_text.c_str(), dispatch, copy, add,
+                    bias_add, reduce);
+    }
+    return 0;
+}
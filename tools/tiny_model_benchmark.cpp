@@ -0,0 +1,201 @@
+// tt_lazy_tiny_bench: latency of tiny products and models with shape-specialized kernels.
+//
+// Usage:
+//   tt_lazy_tiny_bench [--repeat N]
+//
+// The first table times one product of each shape through the packed GEMM (math::matmul) and
+// through its small_gemm specialization (math::matmul_small). The second runs the demo MLP at
+// tiny sizes end to end: "lazy" builds and evaluates the graph, the "tape" columns replay one
+// generated tape with the small kernels disabled in the registry ("generic") and enabled
+// ("small"). Times are medians; "kernels" lists what the registry chose for the small run.
+// The third builds and reads the MLP output under each evaluation mode (see EvaluationMode.hpp),
+// from tiny graphs where tape generation dominates to sizes where the math does.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "EvaluationMode.hpp"
+#include "Tape.hpp"
+#include "TapeExecutor.hpp"
+#include "TapeGenerator.hpp"
+#include "Tensor.hpp"
+#include "demo_mlp.hpp"
+#include "math_operations.hpp"
+#include "operations.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t CALLS_PER_SAMPLE = 100;
+
+struct ProductShape {
+    uint32_t m;
+    uint32_t n;
+    uint32_t k;
+};
+
+struct ModelShape {
+    uint32_t input_size;
+    uint32_t hidden_size;
+    uint32_t output_size;
+    uint32_t rows;
+};
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+// Median time of `fn` in nanoseconds, timed over CALLS_PER_SAMPLE calls per sample
+template <typename Fn>
+double median_ns(size_t repeat, Fn&& fn) {
+    fn();  // Warm-up
+    std::vector<double> times;
+    for (size_t i = 0; i < repeat; ++i) {
+        auto start = Clock::now();
+        for (size_t call = 0; call < CALLS_PER_SAMPLE; ++call) {
+            fn();
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / CALLS_PER_SAMPLE);
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+std::vector<float> values(size_t count) {
+    std::vector<float> data(count);
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = static_cast<float>(i % 13) * 0.1f - 0.6f;
+    }
+    return data;
+}
+
+void product_table(size_t repeat) {
+    const ProductShape shapes[] = {{2, 8, 4}, {2, 1, 8}, {1, 16, 16}, {4, 4, 4}, {8, 16, 16}};  // NOLINT
+    std::printf("%-14s %12s %12s %9s\n", "m x n x k", "packed", "small", "speedup");
+    for (const ProductShape& shape : shapes) {
+        auto a_data = values(shape.m * shape.k);
+        auto b_data = values(shape.k * shape.n);
+        Tensor a(a_data.data(), {shape.m, shape.k});
+        Tensor b(b_data.data(), {shape.k, shape.n});
+        Tensor out({shape.m, shape.n});
+        double packed_ns = median_ns(repeat, [&] { math::matmul(a, b, out); });
+        double small_ns = median_ns(repeat, [&] { math::matmul_small(a, b, out); });
+        std::string name = std::to_string(shape.m) + "x" + std::to_string(shape.n) + "x" + std::to_string(shape.k);
+        std::printf("%-14s %10.1fns %10.1fns %8.1fx\n", name.c_str(), packed_ns, small_ns, packed_ns / small_ns);
+    }
+}
+
+// The small kernels stay registered under their names but never apply
+void disable_small_kernels(TapeExecutor& executor) {
+    auto never = [](const TapeOperation&) noexcept { return false; };
+    auto unused = [](TapeOperation&, TapeExecutor&) noexcept {};
+    executor.register_kernel(MatMulArgs::type_id(), {"matmul_small", never, {}, unused});
+    executor.register_kernel(FusedMLPArgs::type_id(), {"fused_mlp_small", never, {}, unused});
+}
+
+void model_table(size_t repeat) {
+    const ModelShape shapes[] = {{4, 8, 1, 2}, {4, 8, 1, 1}, {16, 16, 4, 8}};  // NOLINT
+    std::printf("\n%-18s %10s %12s %12s %9s  %s\n", "mlp / batch", "lazy", "tape generic", "tape small", "speedup",
+                "kernels");
+    for (const ModelShape& shape : shapes) {
+        DemoMlp mlp(shape.input_size, shape.hidden_size, shape.output_size);
+        std::vector<float> input = DemoMlp::input(shape.rows, shape.input_size);
+        Tensor x(input.data(), {shape.rows, shape.input_size});
+        std::vector<float> output_data(static_cast<size_t>(shape.rows) * shape.output_size);
+
+        double lazy_ns = median_ns(repeat, [&] {
+            tt_lazy::eval_into(mlp.forward(x), output_data.data(), output_data.size());
+            Context::instance().clear();
+            tt_lazy::get_evaluation_manager().clear_cache();
+        });
+
+        Tensor output = mlp.forward(x);
+        TapeGenerator generator;
+        auto tape = generator.generate_tape({output});
+        auto replay_ns = [&](TapeExecutor& executor) {
+            return median_ns(repeat, [&] {
+                for (const auto& op : tape->operations()) {
+                    op->is_evaluated = false;
+                }
+                executor.execute_tape(*tape);
+            });
+        };
+        TapeExecutor generic;
+        register_all_operations(generic);
+        disable_small_kernels(generic);
+        double generic_ns = replay_ns(generic);
+        TapeExecutor small;
+        register_all_operations(small);
+        double small_ns = replay_ns(small);
+
+        std::string kernels;
+        for (const auto& op : tape->operations()) {
+            kernels += (kernels.empty() ? "" : " ") + op->kernel->name;
+        }
+        std::string name = std::to_string(shape.input_size) + "-" + std::to_string(shape.hidden_size) + "-" +
+                           std::to_string(shape.output_size) + " / " + std::to_string(shape.rows);
+        std::printf("%-18s %8.2fus %10.2fus %10.2fus %8.1fx  %s\n", name.c_str(), lazy_ns / 1000.0,
+                    generic_ns / 1000.0, small_ns / 1000.0, generic_ns / small_ns, kernels.c_str());
+        Context::instance().clear();
+        tt_lazy::get_evaluation_manager().clear_cache();
+    }
+}
+
+void mode_table(size_t repeat) {
+    const ModelShape shapes[] = {{4, 8, 1, 2}, {16, 16, 4, 8}, {64, 128, 32, 32}, {256, 512, 128, 64}};  // NOLINT
+    const tt_lazy::EvaluationMode modes[] = {tt_lazy::EvaluationMode::TAPE, tt_lazy::EvaluationMode::IMMEDIATE,
+                                             tt_lazy::EvaluationMode::ADAPTIVE};
+    std::printf("\n%-18s %12s %12s %12s\n", "mlp / batch", "tape", "immediate", "adaptive");
+    for (const ModelShape& shape : shapes) {
+        DemoMlp mlp(shape.input_size, shape.hidden_size, shape.output_size);
+        std::vector<float> input = DemoMlp::input(shape.rows, shape.input_size);
+        Tensor x(input.data(), {shape.rows, shape.input_size});
+
+        std::string name = std::to_string(shape.input_size) + "-" + std::to_string(shape.hidden_size) + "-" +
+                           std::to_string(shape.output_size) + " / " + std::to_string(shape.rows);
+        std::printf("%-18s", name.c_str());
+        for (tt_lazy::EvaluationMode mode : modes) {
+            tt_lazy::set_evaluation_mode(mode);
+            double ns = median_ns(repeat, [&] {
+                Tensor output = mlp.forward(x);
+                output.eval();
+                Context::instance().clear();
+                tt_lazy::get_evaluation_manager().clear_cache();
+            });
+            std::printf(" %10.2fus", ns / 1000.0);
+        }
+        std::printf("\n");
+    }
+    tt_lazy::set_evaluation_manager(nullptr);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    size_t repeat = std::max<size_t>(1, flag_value(flags, "--repeat", 50));
+    spdlog::set_level(spdlog::level::err);
+
+    product_table(repeat);
+    model_table(repeat);
+    mode_table(repeat);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// tt_lazy_tune: tunes the GEMM blockings of a model ahead of time.
+//
+// Usage:
+//   tt_lazy_tune --model PATH [--batch-rows 1,8,64] [--repeat N] [--max-threads N] [--cache PATH]
+//   tt_lazy_tune --shapes MxNxK[,MxNxK...] [--repeat N] [--max-threads N] [--cache PATH]
+//
+// With --model, the model's graph is built for each batch size and every MatMul / FusedMLP
+// shape it runs is tuned; --shapes tunes plain (untransposed) problems. Results are saved to
+// the tuning cache (default: GemmTuningCache::default_path()), which every process loads on
+// its first GEMM, so serving starts with tuned blockings. The table compares the default
+// configuration with the tuned one.
+
+#include "Context.hpp"
+#include "EvaluationManager.hpp"
+#include "GemmAutotuner.hpp"
+#include "Model.hpp"
+#include "Tape.hpp"
+#include "TapeGenerator.hpp"
+#include "Tensor.hpp"
+#include "gemm_tuning.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+std::map<std::string, std::string> parse_flags(int argc, char** argv) {
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        flags[argv[i]] = argv[i + 1];
+    }
+    return flags;
+}
+
+std::string flag_string(const std::map<std::string, std::string>& flags, const std::string& name,
+                        const std::string& fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : it->second;
+}
+
+size_t flag_value(const std::map<std::string, std::string>& flags, const std::string& name, size_t fallback) {
+    auto it = flags.find(name);
+    return it == flags.end() ? fallback : std::stoul(it->second);
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+// GEMM shapes of the model's graph at each batch size
+std::vector<math::GemmKey> model_keys(const std::string& path, const std::vector<std::string>& batch_rows) {
+    Model model = Model::load(path);
+    std::vector<math::GemmKey> keys;
+    for (const auto& rows_text : batch_rows) {
+        auto rows = static_cast<uint32_t>(std::stoul(rows_text));
+        std::vector<std::vector<float>> buffers;
+        std::vector<Tensor> inputs;
+        buffers.reserve(model.inputs().size());
+        for (size_t i = 0; i < model.inputs().size(); ++i) {
+            std::vector<uint32_t> shape{rows};
+            const auto& row_shape = model.inputs()[i].row_shape;
+            shape.insert(shape.end(), row_shape.begin(), row_shape.end());
+            buffers.emplace_back(rows * model.input_row_elements(i), 0.0f);
+            inputs.emplace_back(buffers.back().data(), shape);
+        }
+        TapeGenerator generator;
+        auto tape = generator.generate_tape({model.build(inputs)});
+        for (const auto& key : tape_gemm_keys(*tape)) {
+            keys.push_back(key);
+        }
+        Context::instance().clear();
+    }
+    return keys;
+}
+
+std::vector<math::GemmKey> parse_shapes(const std::string& text) {
+    std::vector<math::GemmKey> keys;
+    for (const auto& shape : split(text, ',')) {
+        auto dims = split(shape, 'x');
+        if (dims.size() != 3) {
+            throw std::runtime_error("expected MxNxK, got " + shape);
+        }
+        keys.push_back({std::stoul(dims[0]), std::stoul(dims[1]), std::stoul(dims[2]), false, false});
+    }
+    return keys;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto flags = parse_flags(argc, argv);
+    spdlog::set_level(spdlog::level::err);
+
+    math::GemmTuneOptions options;
+    options.repeat = flag_value(flags, "--repeat", options.repeat);
+    options.max_threads = flag_value(flags, "--max-threads", options.max_threads);
+    std::string cache_path = flag_string(flags, "--cache", math::GemmTuningCache::default_path());
+
+    std::vector<math::GemmKey> keys;
+    try {
+        if (flags.count("--model") > 0) {
+            keys = model_keys(flags.at("--model"), split(flag_string(flags, "--batch-rows", "1,8,64"), ','));
+        } else if (flags.count("--shapes") > 0) {
+            keys = parse_shapes(flags.at("--shapes"));
+        } else {
+            std::fprintf(stderr, "usage: %s --model PATH [--batch-rows 1,8,64] | --shapes MxNxK[,...]\n"
+                                 "       [--repeat N] [--max-threads N] [--cache PATH]\n",
+                         argv[0]);
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "tt_lazy_tune: %s\n", e.what());
+        return 1;
+    }
+
+    auto& cache = math::GemmTuningCache::instance();
+    cache.load(cache_path);
+    std::printf("cpu: %s\n", math::GemmTuningCache::cpu_model().c_str());
+    std::printf("%-22s %10s %10s %8s  %s\n", "m x n x k", "default", "tuned", "speedup", "mc kc nc threads");
+    std::vector<math::GemmKey> done;
+    for (const auto& key : keys) {
+        if (std::find(done.begin(), done.end(), key) != done.end()) {
+            continue;
+        }
+        done.push_back(key);
+        double default_us = math::time_gemm(key, math::GemmConfig{}, options.repeat);
+        auto entry = math::tune_gemm(key, options);
+        const auto& config = entry.config;
+        std::string shape = std::to_string(key.m) + "x" + std::to_string(key.n) + "x" + std::to_string(key.k) +
+                            (key.transpose_a ? " tA" : "") + (key.transpose_b ? " tB" : "");
+        std::printf("%-22s %8.1fus %8.1fus %7.2fx  %zu %zu %zu %zu\n", shape.c_str(), default_us, entry.microseconds,
+                    default_us / entry.microseconds, config.blocking.mc, config.blocking.kc, config.blocking.nc,
+                    config.threads);
+    }
+
+    if (cache_path.empty()) {
+        std::fprintf(stderr, "tt_lazy_tune: no cache path (set --cache, TT_LAZY_TUNING_CACHE or HOME)\n");
+        return 1;
+    }
+    try {
+        cache.save(cache_path);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "tt_lazy_tune: %s\n", e.what());
+        return 1;
+    }
+    std::printf("saved %zu entries to %s\n", cache.size(), cache_path.c_str());
+    tt_lazy::get_evaluation_manager().clear_cache();
+    return 0;
+}